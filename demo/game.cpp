@@ -29,6 +29,7 @@
 #include <iostream>
 #include <cassert>
 #include <cstring>
+#include <cmath>
 
 demo::game::game(kengine::core* engine)
 	:
@@ -40,6 +41,11 @@ demo::game::game(kengine::core* engine)
 }
 
 demo::game::~game() {
+	delete m_shaderWatcher;
+	delete m_dynamicResolution;
+	delete m_uniformRing;
+	delete m_uploadWorker;
+	delete m_textureManager;
 	delete m_renderingSystem;
 	delete m_window;
 }
@@ -50,6 +56,8 @@ void demo::game::start()
 }
 
 void demo::game::createWindow(int x, int y, int width, int height, const std::string& name) {
+	m_windowWidth = width;
+	m_windowHeight = height;
 	m_window->create(x, y, width, height, name);
 }
 
@@ -59,8 +67,9 @@ void demo::game::showWindow() {
 
 void demo::game::beforeMainLoopEvent()
 {
-	auto c = kengine::cube(1.0f);
-	node.load(c, 1);
+	// the mesh is uploaded in background and the node is drawn as soon as it is ready
+	node.setName("cube");
+	m_uploadWorker->uploadMesh(node, kengine::cube(1.0f));
 
 	KGUI::init(m_window->getHandle());
 }
@@ -69,6 +78,12 @@ void demo::game::update(const int64_t frameTime)
 {
 	static float angleY = 0.0f;
 
+	m_renderingSystem->newFrame();
+	m_uploadWorker->update();
+	m_textureManager->update();
+	m_shaderWatcher->update();
+	m_dynamicResolution->update(static_cast<double>(frameTime) * 1000.0 / static_cast<double>(kengine::getHighResolutionTimerFrequency()));
+
 	angleY += 1.0f;
 
 	if (angleY > 360.0f)
@@ -84,20 +99,59 @@ void demo::game::update(const int64_t frameTime)
 	
 	kengine::matrix<float> projectionMatrix = kengine::frustum(m_projectionInfo.left, m_projectionInfo.right, m_projectionInfo.bottom, m_projectionInfo.top, m_projectionInfo.zNear, m_projectionInfo.zFar);
 
-	m_shader.setUniform("model", false, modelMatrix.value());
-	m_shader.setUniform("eye", false, eyeMatrix.value());
-	m_shader.setUniform("projection", false, projectionMatrix.value());
+	// the projected size of the cube chooses the streamed levels of its texture
+	float cubeDistance = std::sqrt(3.0f * 3.0f + 10.0f * 10.0f);
+	float cubePixels = (angleY / 100.0f) * (m_projectionInfo.zNear / cubeDistance) / (m_projectionInfo.top - m_projectionInfo.bottom) * static_cast<float>(m_windowHeight);
+	m_textureManager->setScreenSize(m_checker, cubePixels);
+
+	m_uniformRing->beginFrame();
+
+	// the camera block is written once per frame
+	camera_block camera;
+	std::memcpy(camera.projection, projectionMatrix.value(), sizeof(camera.projection));
+	std::memcpy(camera.eye, eyeMatrix.value(), sizeof(camera.eye));
+	m_uniformRing->bind(0, m_uniformRing->write(camera));
+
+	// the object block is written once per draw batch and bound by the submitter
+	object_block object;
+	std::memcpy(object.model, modelMatrix.value(), sizeof(object.model));
+	kengine::ring_allocation objectAllocation = m_uniformRing->write(object);
+
+	// the packets are sorted by state and depth (the cube is at the origin)
+	kengine::render_packet packet;
+	packet.program = m_shader.getProgramID();
+	packet.node = &node;
+	packet.userData = &objectAllocation;
+
+	float depth = cubeDistance / m_projectionInfo.zFar;
+
+	m_renderQueue.clear();
+	m_renderQueue.push(kengine::render_queue::makeKey(0, 0, false, packet.program, packet.material, static_cast<unsigned int>(node.getVertexFormat()), depth), packet);
+	m_renderQueue.sort();
 
 	// ----------------------------------------------------------------------------
 	//	rendering here
 	// ----------------------------------------------------------------------------
 
-	m_renderingSystem->clearBuffers();	
+	// the scene is rendered at the scale of the dynamic resolution and upscaled into the backbuffer
+	m_dynamicResolution->begin();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	m_textureManager->bind(0, m_checker);
 
-	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-	node.drawArrays();
+	{
+		kengine::gpu_scope scope("scene");
+		kengine::glState().apply(m_wireframeState);
+		m_renderQueue.submit(m_submitter);
+		m_uniformRing->endFrame();
+	}
 
-	KGUI::draw();
+	m_dynamicResolution->end();
+
+	{
+		kengine::gpu_scope scope("gui");
+		KGUI::draw();
+		kengine::glState().invalidate(); // the GUI changes the state behind the cache
+	}
 
 // (!) Unificar a chamada abaixo de SwapBuffer para facilitar o usurio
 #ifdef __ANDROID__
@@ -146,13 +200,25 @@ void demo::game::onWindowReady(kengine::window* window)
 
 	glCullFace(GL_BACK);
 
+	// per-pass GPU times (read back 3 frames later, see the profile)
+	kengine::gpuProfiler().init();
+
+	// the GPU time of the scene drives its resolution (between 50% and 100% of the window)
+	m_dynamicResolution = new kengine::dynamic_resolution();
+	m_dynamicResolution->resize(m_windowWidth, m_windowHeight);
+	m_profile.setResolutionController(&m_dynamicResolution->getController());
+
 	kengine::ShaderInfo shaders[] = {
 		{GL_VERTEX_SHADER, KENGINE_SHADER_PATH_STR + "/shaders/vs_example.vert"},
 		{GL_FRAGMENT_SHADER, KENGINE_SHADER_PATH_STR + "/shaders/fs_example.frag"},
 		{GL_NONE, ""}
 	};
 
-	if (!m_shader.loadShaders(shaders)) {
+	// the linked programs are reused by the next runs (the cache is refreshed if the sources or the driver change)
+	kengine::programCache().setDirectory("shader_cache");
+
+	// the SPIR-V modules (KENGINE_SPIRV build option) skip the GLSL front-end of the driver
+	if (!m_shader.loadSPIRVShaders(shaders) && !m_shader.loadShaders(shaders)) {
 		// (!) showstopper
 		assert(false && "(!) SHOWSTOPPER - FAILED TO LOAD SHADERS!");
 	}
@@ -160,6 +226,57 @@ void demo::game::onWindowReady(kengine::window* window)
 	m_shader.print();
 	m_shader.useProgram();
 
+	// the C++ block layouts must match the layouts reflected from the program
+	kengine::buffer_block_layout cameraLayout;
+	kengine::buffer_block_layout objectLayout;
+
+	if (cameraLayout.reflect(m_shader.getProgramID(), "camera")) {
+		K_VALIDATE_BLOCK_MEMBER(cameraLayout, camera_block, projection);
+		K_VALIDATE_BLOCK_MEMBER(cameraLayout, camera_block, eye);
+		cameraLayout.validateSize(sizeof(camera_block));
+	}
+
+	if (objectLayout.reflect(m_shader.getProgramID(), "object")) {
+		K_VALIDATE_BLOCK_MEMBER(objectLayout, object_block, model);
+		objectLayout.validateSize(sizeof(object_block));
+	}
+
+	m_uniformRing = new kengine::uniform_ring_buffer();
+
+	kengine::pipeline_state_desc wireframe;
+	wireframe.polygonMode = GL_LINE;
+	m_wireframeState = kengine::pipeline_state(wireframe);
+
+	m_submitter.beforeDraw = [this](const kengine::render_packet& packet) {
+		m_uniformRing->bind(1, *static_cast<const kengine::ring_allocation*>(packet.userData));
+	};
+
+	// the edited shaders are reloaded while the demo runs (the previous program is kept if the new one doesn't link)
+	m_shaderWatcher = new kengine::shader_watcher();
+	m_shaderWatcher->watch(m_shader, shaders, [this](bool linked) {
+		if (linked)
+			m_shader.useProgram();
+	});
+
+	m_uploadWorker = new kengine::upload_worker(m_renderingSystem->createSharedContext());
+
+	// procedural checker: the tail is resident after the first frame and the other levels follow the size of the cube
+	std::vector<unsigned char> checker(512 * 512 * 4);
+
+	for (int y = 0; y < 512; y++) {
+		for (int x = 0; x < 512; x++) {
+			unsigned char value = ((x / 32 + y / 32) % 2) == 0 ? 255 : 64;
+			std::memset(&checker[(static_cast<size_t>(y) * 512 + static_cast<size_t>(x)) * 4], value, 4);
+		}
+	}
+
+	kengine::texture_desc checkerDesc;
+	checkerDesc.width = checkerDesc.height = 512;
+
+	m_textureManager = new kengine::texture_manager(64 * 1024 * 1024);
+	m_textureManager->setUploadWorker(m_uploadWorker);
+	m_checker = m_textureManager->create("checker", checkerDesc, kengine::mipChainLoader(512, 512, std::move(checker)));
+
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
 	// setting the projection
@@ -196,6 +313,21 @@ void demo::game::closeButtonEvent()
 
 	KGUI::destroy();
 
+	delete m_uploadWorker; // it must be finished while the main context is current
+	m_uploadWorker = nullptr;
+
+	delete m_textureManager;
+	m_textureManager = nullptr;
+
+	delete m_shaderWatcher;
+	m_shaderWatcher = nullptr;
+
+	delete m_dynamicResolution;
+	m_dynamicResolution = nullptr;
+
+	delete m_uniformRing;
+	m_uniformRing = nullptr;
+
 	m_renderingSystem->finish();
 	m_window->destroy();
 	//m_engine->stopMainLoop(); no android a janela  fechada 
@@ -203,6 +335,11 @@ void demo::game::closeButtonEvent()
 
 void demo::game::onResizeWindowEvent(const int width, const int height)
 {
+	m_windowWidth = width;
+	m_windowHeight = height;
+
+	if (m_dynamicResolution)
+		m_dynamicResolution->resize(width, height);
 }
 
 void demo::game::onMoveWindowEvent(const int x, const int y)
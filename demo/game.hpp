@@ -29,6 +29,15 @@
 #include <core.hpp>
 #include <profile.hpp>
 #include <rendering_system.hpp>
+#include <vertex_format.hpp>
+#include <upload_worker.hpp>
+#include <program_cache.hpp>
+#include <uniform_block.hpp>
+#include <shader_watcher.hpp>
+#include <render_queue.hpp>
+#include <gpu_profiler.hpp>
+#include <dynamic_resolution.hpp>
+#include <texture_manager.hpp>
 #include <logger.hpp>
 
 // third-party library
@@ -36,6 +45,20 @@
 
 namespace demo
 {
+	/*
+		C++ layouts of the uniform blocks declared in shaders/vs_example.vert (std140)
+	*/
+	struct camera_block
+	{
+		float projection[16];
+		float eye[16];
+	};
+
+	struct object_block
+	{
+		float model[16];
+	};
+
 	class game : public kengine::events_callback
 	{
 	public:
@@ -136,8 +159,19 @@ namespace demo
 		kengine::core* m_engine = nullptr;
 		kengine::window* m_window = nullptr;
 		kengine::rendering_system* m_renderingSystem = nullptr;
+		kengine::upload_worker* m_uploadWorker = nullptr;
 		kengine::profile m_profile;
 		kengine::GLSLprogram m_shader;
+		kengine::uniform_ring_buffer* m_uniformRing = nullptr;
+		kengine::shader_watcher* m_shaderWatcher = nullptr;
+		kengine::dynamic_resolution* m_dynamicResolution = nullptr;
+		kengine::texture_manager* m_textureManager = nullptr;
+		kengine::texture_handle m_checker = kengine::texture_manager::INVALID_TEXTURE;
+		int m_windowWidth = 0;
+		int m_windowHeight = 0;
+		kengine::render_queue m_renderQueue;
+		kengine::gl_render_submitter m_submitter;
+		kengine::pipeline_state m_wireframeState;
 		kengine::mesh_node node;
 		kengine::projection_info<float> m_projectionInfo;
 	};
@@ -33,6 +33,8 @@
 #include <cassert>
 // android/linux headers
 #include <time.h>
+#include <climits>
+#include <cstdlib>
 
 
 /*
@@ -289,6 +291,16 @@ int64_t kengine::getHighResolutionTimerFrequency()
     return t.tv_nsec * LINUX_TIME_RESOLUTION;
 }
 
+std::string kengine::getCanonicalPath(const std::string& filename)
+{
+    char path[PATH_MAX];
+
+    if (realpath(filename.c_str(), path) == nullptr)
+        return filename;
+
+    return path;
+}
+
 /*
     Creating a debug console
 */
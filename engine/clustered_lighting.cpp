@@ -0,0 +1,337 @@
+/*
+	K-Engine Clustered Lighting
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <clustered_lighting.hpp>
+#include <gl_state.hpp>
+#include <gpu_memory.hpp>
+#include <os_api_wrapper.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	/*
+		The buffers grow by doubling, so a varying number of lights doesn't reallocate them every frame
+	*/
+	void reserve(GLuint& buffer, GLsizeiptr& capacity, GLsizeiptr size)
+	{
+		if (buffer != 0 && size <= capacity)
+			return;
+
+		kengine::deleteTrackedBuffer(buffer);
+
+		capacity = std::max<GLsizeiptr>(capacity * 2, std::max<GLsizeiptr>(size, 256));
+
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, capacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+		kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::BUFFER, buffer, static_cast<size_t>(capacity), "light_clusters");
+	}
+
+	double elapsedMilliseconds(int64_t startTime)
+	{
+		return static_cast<double>(kengine::getHighResolutionTimerCounter() - startTime) * 1000.0 / static_cast<double>(kengine::getHighResolutionTimerFrequency());
+	}
+
+	unsigned int toTile(float ndc, unsigned int tiles)
+	{
+		float tile = std::floor((ndc + 1.0f) * 0.5f * static_cast<float>(tiles));
+
+		return static_cast<unsigned int>(std::min(std::max(tile, 0.0f), static_cast<float>(tiles - 1)));
+	}
+}
+
+/*
+	kengine::light_clusters class - member class definition
+*/
+
+kengine::light_clusters::light_clusters(unsigned int tilesX, unsigned int tilesY, unsigned int slices, unsigned int maxLightsPerCluster) :
+	m_tilesX(std::max(tilesX, 1u)), m_tilesY(std::max(tilesY, 1u)), m_slices(std::max(slices, 1u)), m_maxLightsPerCluster(std::max(maxLightsPerCluster, 1u))
+{
+	// 90 degrees, square viewport
+	float projection[16] = { 0.0f };
+	projection[0] = 1.0f;
+	projection[5] = 1.0f;
+	projection[10] = (m_far + m_near) / (m_near - m_far);
+	projection[11] = -1.0f;
+	projection[14] = 2.0f * m_far * m_near / (m_near - m_far);
+
+	m_clusters.resize(getClusterCount());
+	m_clusterLights.resize(static_cast<size_t>(getClusterCount()) * m_maxLightsPerCluster);
+	m_sliceOverflows.resize(m_slices);
+
+	setProjection(projection, m_near, m_far, 1, 1);
+}
+
+kengine::light_clusters::~light_clusters()
+{
+	kengine::deleteTrackedBuffer(m_lightBuffer);
+	kengine::deleteTrackedBuffer(m_clusterBuffer);
+	kengine::deleteTrackedBuffer(m_indexBuffer);
+}
+
+void kengine::light_clusters::setProjection(const float* projection, float nearPlane, float farPlane, int viewportWidth, int viewportHeight)
+{
+	std::copy(projection, projection + 16, m_projection);
+	m_near = std::max(nearPlane, 1e-4f);
+	m_far = std::max(farPlane, m_near * 1.001f);
+
+	float logRatio = std::log(m_far / m_near);
+
+	m_header.size[0] = m_tilesX;
+	m_header.size[1] = m_tilesY;
+	m_header.size[2] = m_slices;
+	m_header.size[3] = m_maxLightsPerCluster;
+	m_header.params[0] = 1.0f / static_cast<float>(std::max(viewportWidth, 1));
+	m_header.params[1] = 1.0f / static_cast<float>(std::max(viewportHeight, 1));
+	m_header.params[2] = static_cast<float>(m_slices) / logRatio;
+	m_header.params[3] = -static_cast<float>(m_slices) * std::log(m_near) / logRatio;
+
+	buildBounds();
+}
+
+unsigned int kengine::light_clusters::getSlice(float depth) const
+{
+	if (depth <= m_near)
+		return 0;
+
+	float slice = std::floor(std::log(depth) * m_header.params[2] + m_header.params[3]);
+
+	return static_cast<unsigned int>(std::min(std::max(slice, 0.0f), static_cast<float>(m_slices - 1)));
+}
+
+void kengine::light_clusters::buildBounds()
+{
+	m_bounds.resize(static_cast<size_t>(getClusterCount()) * 6);
+
+	// view x = (ndc x + P[8]) * depth / P[0] (and the same for y) for a perspective projection
+	for (unsigned int slice = 0; slice < m_slices; slice++) {
+		float depths[2] = {
+			m_near * std::pow(m_far / m_near, static_cast<float>(slice) / static_cast<float>(m_slices)),
+			m_near * std::pow(m_far / m_near, static_cast<float>(slice + 1) / static_cast<float>(m_slices))
+		};
+
+		for (unsigned int y = 0; y < m_tilesY; y++) {
+			float ndcY[2] = { -1.0f + 2.0f * static_cast<float>(y) / static_cast<float>(m_tilesY), -1.0f + 2.0f * static_cast<float>(y + 1) / static_cast<float>(m_tilesY) };
+
+			for (unsigned int x = 0; x < m_tilesX; x++) {
+				float ndcX[2] = { -1.0f + 2.0f * static_cast<float>(x) / static_cast<float>(m_tilesX), -1.0f + 2.0f * static_cast<float>(x + 1) / static_cast<float>(m_tilesX) };
+				float* bounds = &m_bounds[static_cast<size_t>(getClusterIndex(x, y, slice)) * 6];
+
+				bounds[0] = bounds[1] = bounds[2] = HUGE_VALF;
+				bounds[3] = bounds[4] = bounds[5] = -HUGE_VALF;
+
+				for (int corner = 0; corner < 8; corner++) {
+					float depth = depths[corner >> 2];
+					float position[3] = {
+						(ndcX[corner & 1] + m_projection[8]) * depth / m_projection[0],
+						(ndcY[(corner >> 1) & 1] + m_projection[9]) * depth / m_projection[5],
+						-depth
+					};
+
+					for (int axis = 0; axis < 3; axis++) {
+						bounds[axis] = std::min(bounds[axis], position[axis]);
+						bounds[axis + 3] = std::max(bounds[axis + 3], position[axis]);
+					}
+				}
+			}
+		}
+	}
+}
+
+void kengine::light_clusters::computeRange(const point_light& light, const float* view, light_range& range) const
+{
+	const float* position = light.position;
+
+	for (int axis = 0; axis < 3; axis++)
+		range.center[axis] = view[axis] * position[0] + view[4 + axis] * position[1] + view[8 + axis] * position[2] + view[12 + axis];
+
+	range.radius = light.radius;
+
+	float depth = -range.center[2];
+	float radius = light.radius;
+
+	range.visible = radius > 0.0f && depth + radius >= m_near && depth - radius <= m_far;
+
+	if (!range.visible)
+		return;
+
+	range.min[2] = getSlice(depth - radius);
+	range.max[2] = getSlice(depth + radius);
+
+	// the projection of the bounding box of the sphere (its extremes are at the corners), the part behind the
+	// near plane is clipped
+	const float depths[2] = { std::max(depth - radius, m_near), depth + radius };
+	const float scale[2] = { m_projection[0], m_projection[5] };
+	const float offset[2] = { m_projection[8], m_projection[9] };
+	const unsigned int tiles[2] = { m_tilesX, m_tilesY };
+
+	for (int axis = 0; axis < 2; axis++) {
+		float ndcMin = HUGE_VALF;
+		float ndcMax = -HUGE_VALF;
+
+		for (int corner = 0; corner < 4; corner++) {
+			float coordinate = range.center[axis] + ((corner & 1) ? radius : -radius);
+			float ndc = scale[axis] * coordinate / depths[(corner >> 1) & 1] - offset[axis];
+
+			ndcMin = std::min(ndcMin, ndc);
+			ndcMax = std::max(ndcMax, ndc);
+		}
+
+		if (ndcMax < -1.0f || ndcMin > 1.0f) {
+			range.visible = false;
+			return;
+		}
+
+		range.min[axis] = toTile(ndcMin, tiles[axis]);
+		range.max[axis] = toTile(ndcMax, tiles[axis]);
+	}
+}
+
+unsigned int kengine::light_clusters::binSlice(unsigned int slice)
+{
+	unsigned int overflows = 0;
+	unsigned int first = getClusterIndex(0, 0, slice);
+
+	for (unsigned int index = first; index < first + m_tilesX * m_tilesY; index++)
+		m_clusters[index].count = 0;
+
+	// the lights are visited in order, so the lists of a cluster are sorted
+	for (size_t light = 0; light < m_ranges.size(); light++) {
+		const light_range& range = m_ranges[light];
+
+		if (!range.visible || slice < range.min[2] || slice > range.max[2])
+			continue;
+
+		float radiusSquared = range.radius * range.radius;
+
+		for (unsigned int y = range.min[1]; y <= range.max[1]; y++) {
+			for (unsigned int x = range.min[0]; x <= range.max[0]; x++) {
+				unsigned int cluster = getClusterIndex(x, y, slice);
+				const float* bounds = &m_bounds[static_cast<size_t>(cluster) * 6];
+				float distanceSquared = 0.0f;
+
+				for (int axis = 0; axis < 3; axis++) {
+					float closest = std::min(std::max(range.center[axis], bounds[axis]), bounds[axis + 3]);
+					distanceSquared += (range.center[axis] - closest) * (range.center[axis] - closest);
+				}
+
+				if (distanceSquared > radiusSquared)
+					continue;
+
+				light_cluster& current = m_clusters[cluster];
+
+				if (current.count < m_maxLightsPerCluster)
+					m_clusterLights[static_cast<size_t>(cluster) * m_maxLightsPerCluster + current.count++] = static_cast<uint32_t>(light);
+				else
+					overflows++;
+			}
+		}
+	}
+
+	return overflows;
+}
+
+void kengine::light_clusters::bin(const float* view, const point_light* lights, size_t count)
+{
+	int64_t startTime = kengine::getHighResolutionTimerCounter();
+	kengine::thread_pool& pool = kengine::threadPool();
+
+	m_stats = clustered_lighting_stats();
+	m_lights.assign(lights, lights + count);
+	m_ranges.resize(count);
+
+	pool.parallelFor(count, [this, view](size_t begin, size_t end, unsigned int) {
+		for (size_t index = begin; index < end; index++)
+			computeRange(m_lights[index], view, m_ranges[index]);
+	});
+
+	// each depth slice is owned by one thread, so the clusters are written without synchronization
+	pool.parallelFor(m_slices, [this](size_t begin, size_t end, unsigned int) {
+		for (size_t slice = begin; slice < end; slice++)
+			m_sliceOverflows[slice] = binSlice(static_cast<unsigned int>(slice));
+	}, 1);
+
+	// compaction into a single index list
+	uint32_t offset = 0;
+
+	for (auto& cluster : m_clusters) {
+		cluster.offset = offset;
+		offset += cluster.count;
+		m_stats.activeClusters += cluster.count > 0 ? 1 : 0;
+	}
+
+	m_indices.resize(offset);
+
+	pool.parallelFor(m_clusters.size(), [this](size_t begin, size_t end, unsigned int) {
+		for (size_t index = begin; index < end; index++) {
+			const uint32_t* source = &m_clusterLights[index * m_maxLightsPerCluster];
+			std::copy(source, source + m_clusters[index].count, m_indices.begin() + m_clusters[index].offset);
+		}
+	});
+
+	for (const auto& range : m_ranges)
+		m_stats.visibleLights += range.visible ? 1 : 0;
+
+	for (unsigned int overflows : m_sliceOverflows)
+		m_stats.overflows += overflows;
+
+	m_stats.lights = static_cast<unsigned int>(count);
+	m_stats.indices = offset;
+	m_stats.binMilliseconds = elapsedMilliseconds(startTime);
+}
+
+void kengine::light_clusters::upload()
+{
+	int64_t startTime = kengine::getHighResolutionTimerCounter();
+
+	GLsizeiptr lightSize = static_cast<GLsizeiptr>(m_lights.size() * sizeof(point_light));
+	GLsizeiptr clusterSize = static_cast<GLsizeiptr>(m_clusters.size() * sizeof(light_cluster));
+	GLsizeiptr indexSize = static_cast<GLsizeiptr>(m_indices.size() * sizeof(uint32_t));
+
+	reserve(m_lightBuffer, m_lightCapacity, lightSize);
+	reserve(m_clusterBuffer, m_clusterCapacity, static_cast<GLsizeiptr>(sizeof(grid_header)) + clusterSize);
+	reserve(m_indexBuffer, m_indexCapacity, indexSize);
+
+	if (lightSize > 0)
+		glNamedBufferSubData(m_lightBuffer, 0, lightSize, m_lights.data());
+
+	glNamedBufferSubData(m_clusterBuffer, 0, sizeof(grid_header), &m_header);
+	glNamedBufferSubData(m_clusterBuffer, sizeof(grid_header), clusterSize, m_clusters.data());
+
+	if (indexSize > 0)
+		glNamedBufferSubData(m_indexBuffer, 0, indexSize, m_indices.data());
+
+	m_stats.uploadMilliseconds = elapsedMilliseconds(startTime);
+}
+
+void kengine::light_clusters::bind(GLuint lightBinding, GLuint clusterBinding, GLuint indexBinding) const
+{
+	kengine::glState().bindBufferBase(GL_SHADER_STORAGE_BUFFER, lightBinding, m_lightBuffer);
+	kengine::glState().bindBufferBase(GL_SHADER_STORAGE_BUFFER, clusterBinding, m_clusterBuffer);
+	kengine::glState().bindBufferBase(GL_SHADER_STORAGE_BUFFER, indexBinding, m_indexBuffer);
+}
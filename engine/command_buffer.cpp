@@ -0,0 +1,145 @@
+/*
+	K-Engine Command Buffer
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <command_buffer.hpp>
+#include <vertex_format.hpp>
+
+namespace
+{
+	template <typename T>
+	T read(const unsigned char* data)
+	{
+		const size_t headerSize = (sizeof(kengine::command_header) + 7) & ~size_t(7);
+		T command;
+		std::memcpy(&command, data + headerSize, sizeof(T));
+		return command;
+	}
+}
+
+/*
+	kengine::command_buffer class - member class definition
+*/
+
+void kengine::command_buffer::reset()
+{
+	m_data.clear();
+	m_count = 0;
+}
+
+void kengine::command_buffer::useProgram(GLuint program)
+{
+	use_program_command command = { program };
+	push(COMMAND_TYPE::USE_PROGRAM, command);
+}
+
+void kengine::command_buffer::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	bind_buffer_range_command command = { target, index, buffer, offset, size };
+	push(COMMAND_TYPE::BIND_BUFFER_RANGE, command);
+}
+
+void kengine::command_buffer::bindTexture(GLuint unit, GLuint texture)
+{
+	bind_texture_command command = { unit, texture };
+	push(COMMAND_TYPE::BIND_TEXTURE, command);
+}
+
+void kengine::command_buffer::bindSampler(GLuint unit, GLuint sampler)
+{
+	bind_sampler_command command = { unit, sampler };
+	push(COMMAND_TYPE::BIND_SAMPLER, command);
+}
+
+void kengine::command_buffer::applyState(const pipeline_state& state)
+{
+	apply_state_command command = { &state };
+	push(COMMAND_TYPE::APPLY_STATE, command);
+}
+
+void kengine::command_buffer::drawNode(const mesh_node& node)
+{
+	draw_node_command command = { &node };
+	push(COMMAND_TYPE::DRAW_NODE, command);
+}
+
+void kengine::command_buffer::drawArrays(GLenum mode, int vertexFormat, GLuint buffer, GLintptr offset, GLsizei stride, GLint first, GLsizei count)
+{
+	draw_arrays_command command = { mode, vertexFormat, buffer, offset, stride, first, count };
+	push(COMMAND_TYPE::DRAW_ARRAYS, command);
+}
+
+void kengine::command_buffer::execute() const
+{
+	kengine::gl_state_cache& state = kengine::glState();
+	const unsigned char* data = m_data.data();
+	const unsigned char* end = data + m_data.size();
+
+	while (data < end) {
+		command_header header;
+		std::memcpy(&header, data, sizeof(header));
+
+		switch (header.type) {
+		case COMMAND_TYPE::USE_PROGRAM:
+			state.useProgram(read<use_program_command>(data).program);
+			break;
+		case COMMAND_TYPE::BIND_BUFFER_RANGE: {
+			bind_buffer_range_command command = read<bind_buffer_range_command>(data);
+			state.bindBufferRange(command.target, command.index, command.buffer, command.offset, command.size);
+			break;
+		}
+		case COMMAND_TYPE::BIND_TEXTURE: {
+			bind_texture_command command = read<bind_texture_command>(data);
+			state.bindTexture(command.unit, command.texture);
+			break;
+		}
+		case COMMAND_TYPE::BIND_SAMPLER: {
+			bind_sampler_command command = read<bind_sampler_command>(data);
+			state.bindSampler(command.unit, command.sampler);
+			break;
+		}
+		case COMMAND_TYPE::APPLY_STATE:
+			state.apply(*read<apply_state_command>(data).state);
+			break;
+		case COMMAND_TYPE::DRAW_NODE:
+			read<draw_node_command>(data).node->drawArrays();
+			break;
+		case COMMAND_TYPE::DRAW_ARRAYS: {
+			draw_arrays_command command = read<draw_arrays_command>(data);
+			kengine::vertexFormatRegistry().bind(command.vertexFormat, command.buffer, command.offset, command.stride);
+			glDrawArrays(command.mode, command.first, command.count);
+			break;
+		}
+		}
+
+		data += header.size;
+	}
+}
+
+void kengine::executeCommandBuffers(const command_buffer* buffers, size_t count)
+{
+	for (size_t index = 0; index < count; index++)
+		buffers[index].execute();
+}
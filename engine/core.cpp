@@ -24,6 +24,7 @@
 */
 
 #include <core.hpp>
+#include <render_thread.hpp>
 #include <iostream>
 #include <cassert>
 
@@ -74,8 +75,14 @@ void kengine::core::startMainLoop()
 			user's update
 		*/
 
-		userEventsCallback->update(frameTime);
-
+		if (m_renderThread != nullptr) {
+			m_renderThread->beginFrame(frameTime);
+			userEventsCallback->update(frameTime);
+			m_renderThread->endFrame();
+		}
+		else {
+			userEventsCallback->update(frameTime);
+		}
 
 		/*
 			end of main loop
@@ -85,6 +92,10 @@ void kengine::core::startMainLoop()
 		endTime = getHighResolutionTimerCounter();
 		frameTime += (endTime - startTime);
 	}
+
+	// the last packets are drawn before the resources can be deleted
+	if (m_renderThread != nullptr)
+		m_renderThread->sync();
 }
 
 void kengine::core::stopMainLoop()
@@ -109,6 +120,11 @@ void kengine::core::setEventsCallback(events_callback* eventsCallback)
 	kengine::setGlobalUserEventsCallback(eventsCallback);
 }
 
+void kengine::core::setRenderThread(render_thread* renderThread)
+{
+	m_renderThread = renderThread;
+}
+
 std::string kengine::getDataTypeInfo()
 {
 	return std::string("> Platform data types:") +
@@ -0,0 +1,286 @@
+/*
+	K-Engine Dynamic Resolution
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <dynamic_resolution.hpp>
+#include <gl_state.hpp>
+#include <gpu_memory.hpp>
+#include <gpu_profiler.hpp>
+#include <logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	int scaledSize(int size, float scale)
+	{
+		return std::max(1, static_cast<int>(std::lround(static_cast<double>(size) * scale)));
+	}
+}
+
+/*
+	kengine::resolution_controller class - member class definition
+*/
+
+kengine::resolution_controller::resolution_controller(const dynamic_resolution_settings& settings)
+{
+	setSettings(settings);
+}
+
+void kengine::resolution_controller::setSettings(const dynamic_resolution_settings& settings)
+{
+	m_settings = settings;
+	m_settings.minScale = std::max(m_settings.minScale, 0.01f);
+	m_settings.maxScale = std::max(m_settings.maxScale, m_settings.minScale);
+	m_scale = std::min(std::max(m_scale, m_settings.minScale), m_settings.maxScale);
+}
+
+void kengine::resolution_controller::setScale(float scale)
+{
+	m_scale = std::min(std::max(scale, m_settings.minScale), m_settings.maxScale);
+	m_average = -1.0;
+	m_overFrames = 0;
+	m_underFrames = 0;
+	m_cooldown = m_settings.cooldownFrames;
+}
+
+bool kengine::resolution_controller::change(float scale, double cpuMilliseconds)
+{
+	scale = std::min(std::max(scale, m_settings.minScale), m_settings.maxScale);
+
+	// the bounds are always reached, even by a small step
+	bool atBound = scale == m_settings.minScale || scale == m_settings.maxScale;
+
+	if (scale == m_scale || (!atBound && std::fabs(scale - m_scale) < m_settings.minStep))
+		return false;
+
+	resolution_change record;
+	record.frame = m_stats.frames;
+	record.fromScale = m_scale;
+	record.toScale = scale;
+	record.cpuMilliseconds = cpuMilliseconds;
+	record.gpuMilliseconds = m_average;
+	m_changes.push_back(record);
+
+	if (scale > m_scale)
+		m_stats.increases++;
+	else
+		m_stats.decreases++;
+
+	setScale(scale);
+
+	return true;
+}
+
+bool kengine::resolution_controller::update(double cpuMilliseconds, double gpuMilliseconds)
+{
+	m_stats.frames++;
+
+	double frameMilliseconds = gpuMilliseconds >= 0.0 ? gpuMilliseconds : cpuMilliseconds;
+
+	// the frames measured during the cooldown were rendered at the previous scale
+	if (m_cooldown > 0) {
+		m_cooldown--;
+		return false;
+	}
+
+	// the effect of the last change
+	if (!m_changes.empty() && m_changes.back().resultMilliseconds < 0.0)
+		m_changes.back().resultMilliseconds = frameMilliseconds;
+
+	if (m_average < 0.0)
+		m_average = frameMilliseconds;
+	else
+		m_average += (frameMilliseconds - m_average) * m_settings.smoothing;
+
+	const double target = m_settings.targetMilliseconds;
+	const double goal = target * (m_settings.upperThreshold + m_settings.lowerThreshold) * 0.5;
+
+	// a CPU bound frame is not faster at a lower resolution (the GPU time stays in or under the band)
+	if (gpuMilliseconds >= 0.0 && cpuMilliseconds > target && m_average <= target * m_settings.upperThreshold)
+		m_stats.cpuBoundFrames++;
+
+	if (m_average > target * m_settings.upperThreshold) {
+		m_underFrames = 0;
+
+		if (++m_overFrames < m_settings.downFrames)
+			return false;
+
+		// the cost is proportional to the area: the scale of each axis follows the square root
+		return change(m_scale * static_cast<float>(std::sqrt(goal / m_average)), cpuMilliseconds);
+	}
+
+	m_overFrames = 0;
+
+	if (m_average < target * m_settings.lowerThreshold && m_scale < m_settings.maxScale) {
+		if (++m_underFrames < m_settings.upFrames)
+			return false;
+
+		float scale = m_scale * static_cast<float>(std::sqrt(goal / std::max(m_average, 1e-3)));
+
+		return change(std::min(scale, m_scale + m_settings.maxStepUp), cpuMilliseconds);
+	}
+
+	m_underFrames = 0;
+
+	return false;
+}
+
+/*
+	kengine::dynamic_resolution class - member class definition
+*/
+
+const char* const kengine::dynamic_resolution::SCOPE_NAME = "dynamic resolution";
+
+kengine::dynamic_resolution::dynamic_resolution(const dynamic_resolution_settings& settings) :
+	m_controller(settings)
+{
+}
+
+kengine::dynamic_resolution::~dynamic_resolution()
+{
+	destroyTarget();
+}
+
+void kengine::dynamic_resolution::destroyTarget()
+{
+	if (m_framebuffer != 0) {
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+
+	kengine::deleteTrackedTexture(m_colorTexture, GPU_MEMORY_CATEGORY::RENDER_TARGET);
+	kengine::deleteTrackedTexture(m_depthTexture, GPU_MEMORY_CATEGORY::RENDER_TARGET);
+
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+}
+
+bool kengine::dynamic_resolution::resize(int outputWidth, int outputHeight, GLenum colorFormat)
+{
+	destroyTarget();
+
+	m_outputWidth = outputWidth;
+	m_outputHeight = outputHeight;
+
+	if (outputWidth <= 0 || outputHeight <= 0)
+		return false;
+
+	// the whole range of scales fits in the target (and the border of the linear filter, see end)
+	int width = scaledSize(outputWidth, m_controller.getSettings().maxScale) + 1;
+	int height = scaledSize(outputHeight, m_controller.getSettings().maxScale) + 1;
+
+	m_targetWidth = width;
+	m_targetHeight = height;
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &m_colorTexture);
+	glTextureStorage2D(m_colorTexture, 1, colorFormat, width, height);
+	glTextureParameteri(m_colorTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTextureParameteri(m_colorTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::RENDER_TARGET, m_colorTexture, static_cast<size_t>(width) * height * 4, "dynamic_resolution");
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &m_depthTexture);
+	glTextureStorage2D(m_depthTexture, 1, GL_DEPTH24_STENCIL8, width, height);
+	kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::RENDER_TARGET, m_depthTexture, static_cast<size_t>(width) * height * 4, "dynamic_resolution");
+
+	glCreateFramebuffers(1, &m_framebuffer);
+	glNamedFramebufferTexture(m_framebuffer, GL_COLOR_ATTACHMENT0, m_colorTexture, 0);
+	glNamedFramebufferTexture(m_framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, m_depthTexture, 0);
+
+	if (glCheckNamedFramebufferStatus(m_framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		K_LOG_OUTPUT_RAW("dynamic_resolution: the offscreen target is incomplete (" << width << "x" << height << ")");
+		destroyTarget();
+		return false;
+	}
+
+	return true;
+}
+
+int kengine::dynamic_resolution::getRenderWidth() const
+{
+	return std::min(scaledSize(m_outputWidth, m_controller.getScale()), std::max(m_targetWidth - 1, 1));
+}
+
+int kengine::dynamic_resolution::getRenderHeight() const
+{
+	return std::min(scaledSize(m_outputHeight, m_controller.getScale()), std::max(m_targetHeight - 1, 1));
+}
+
+bool kengine::dynamic_resolution::update(double cpuMilliseconds)
+{
+	kengine::gpu_profiler& profiler = kengine::gpuProfiler();
+	double gpuMilliseconds = -1.0;
+
+	if (profiler.isEnabled()) {
+		// a new frame is read back once every frame (or dropped): no new time, no decision
+		if (profiler.getLastFrameNumber() == m_lastGPUFrame)
+			return false;
+
+		m_lastGPUFrame = profiler.getLastFrameNumber();
+
+		for (const kengine::gpu_pass_stats& pass : profiler.getFrameStats()) {
+			if (pass.name == SCOPE_NAME) {
+				gpuMilliseconds = pass.milliseconds;
+				break;
+			}
+		}
+	}
+
+	bool changed = m_controller.update(cpuMilliseconds, gpuMilliseconds);
+
+	if (changed) {
+		const kengine::resolution_change& last = m_controller.getChanges().back();
+		K_LOG_OUTPUT_RAW("dynamic_resolution: scale " << last.fromScale << " -> " << last.toScale << " (" << getRenderWidth() << "x" << getRenderHeight() << ", " << last.gpuMilliseconds << " ms)");
+	}
+
+	return changed;
+}
+
+void kengine::dynamic_resolution::begin()
+{
+	m_renderWidth = getRenderWidth();
+	m_renderHeight = getRenderHeight();
+
+	kengine::gpuProfiler().beginScope(SCOPE_NAME);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_renderWidth, m_renderHeight);
+}
+
+void kengine::dynamic_resolution::end(GLuint outputFramebuffer, GLenum filter)
+{
+	kengine::gpuProfiler().endScope();
+
+	// the linear filter reads one texel beyond the region: the last column and row are copied there (clamp to edge)
+	if (filter == GL_LINEAR) {
+		glBlitNamedFramebuffer(m_framebuffer, m_framebuffer, m_renderWidth - 1, 0, m_renderWidth, m_renderHeight, m_renderWidth, 0, m_renderWidth + 1, m_renderHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glBlitNamedFramebuffer(m_framebuffer, m_framebuffer, 0, m_renderHeight - 1, m_renderWidth + 1, m_renderHeight, 0, m_renderHeight, m_renderWidth + 1, m_renderHeight + 1, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+
+	// the upscale writes every pixel of the output
+	glBlitNamedFramebuffer(m_framebuffer, outputFramebuffer, 0, 0, m_renderWidth, m_renderHeight, 0, 0, m_outputWidth, m_outputHeight, GL_COLOR_BUFFER_BIT, filter);
+	glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+	glViewport(0, 0, m_outputWidth, m_outputHeight);
+}
@@ -0,0 +1,2009 @@
+/*
+	K-Engine GL Capture
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+// the recording functions call the functions of the system library
+#define K_ENGINE_GL_NO_REDIRECT
+
+#include <gl_capture.hpp>
+#include <logger.hpp>
+
+#include <cstdlib>
+#include <cstring>
+
+#ifndef __ANDROID__
+decltype(&glClear) kglClear = glClear;
+decltype(&glClearColor) kglClearColor = glClearColor;
+decltype(&glDrawArrays) kglDrawArrays = glDrawArrays;
+decltype(&glEnable) kglEnable = glEnable;
+decltype(&glDisable) kglDisable = glDisable;
+decltype(&glViewport) kglViewport = glViewport;
+decltype(&glPolygonMode) kglPolygonMode = glPolygonMode;
+decltype(&glDepthFunc) kglDepthFunc = glDepthFunc;
+decltype(&glDepthMask) kglDepthMask = glDepthMask;
+decltype(&glCullFace) kglCullFace = glCullFace;
+decltype(&glFrontFace) kglFrontFace = glFrontFace;
+decltype(&glLineWidth) kglLineWidth = glLineWidth;
+decltype(&glPointSize) kglPointSize = glPointSize;
+decltype(&glDeleteTextures) kglDeleteTextures = glDeleteTextures;
+decltype(&glPixelStorei) kglPixelStorei = glPixelStorei;
+#endif
+
+namespace
+{
+	const char* callNames[] = {
+		"FRAME", "MAPPED_DATA",
+		"glCreateBuffers", "glGenBuffers", "glDeleteBuffers", "glBindBuffer", "glNamedBufferStorage", "glBufferStorage",
+		"glNamedBufferSubData", "glMapNamedBufferRange", "glUnmapNamedBuffer", "glBindBufferBase", "glBindBufferRange",
+		"glCreateVertexArrays", "glDeleteVertexArrays", "glBindVertexArray", "glEnableVertexArrayAttrib", "glVertexArrayAttribFormat",
+		"glVertexArrayAttribBinding", "glVertexArrayVertexBuffer", "glBindVertexBuffer", "glEnableVertexAttribArray", "glVertexAttribPointer",
+		"glCreateShader", "glShaderSource", "glCompileShader", "glShaderBinary", "glSpecializeShader", "glDeleteShader",
+		"glCreateProgram", "glAttachShader", "glDetachShader", "glProgramParameteri", "glLinkProgram", "glProgramBinary",
+		"glDeleteProgram", "glUseProgram", "glCreateShaderProgramv", "glCreateProgramPipelines", "glDeleteProgramPipelines",
+		"glUseProgramStages", "glBindProgramPipeline", "glUniformMatrix4fv",
+		"glBindTextureUnit", "glBindSampler", "glBlendFuncSeparate", "glBlendEquationSeparate",
+		"glCreateFramebuffers", "glDeleteFramebuffers", "glBindFramebuffer", "glCreateRenderbuffers", "glDeleteRenderbuffers",
+		"glNamedRenderbufferStorage", "glNamedFramebufferRenderbuffer",
+		"glFenceSync", "glClientWaitSync", "glDeleteSync",
+		"glClear", "glClearColor", "glDrawArrays", "glEnable", "glDisable", "glViewport", "glPolygonMode", "glDepthFunc",
+		"glDepthMask", "glCullFace", "glFrontFace", "glLineWidth", "glPointSize",
+		"glNamedBufferData", "glBufferData", "glBufferSubData", "glClearNamedBufferData", "glClearBufferData",
+		"glCopyNamedBufferSubData", "glCopyBufferSubData", "glMapNamedBuffer", "glMapBuffer", "glMapBufferRange",
+		"glUnmapBuffer", "glFlushMappedNamedBufferRange", "glFlushMappedBufferRange", "glInvalidateBufferData",
+		"glInvalidateBufferSubData", "glClearBufferfv",
+		"glGenVertexArrays", "glDisableVertexArrayAttrib", "glDisableVertexAttribArray", "glVertexAttribIPointer",
+		"glVertexAttribLPointer", "glVertexArrayVertexBuffers", "glVertexAttribFormat", "glVertexAttribBinding",
+		"glBindAttribLocation", "glDrawArraysInstancedBaseInstance", "glPrimitiveRestartIndex",
+		"glProgramUniform3f", "glActiveShaderProgram",
+		"glUniform1fv", "glUniform2fv", "glUniform3fv", "glUniform4fv", "glUniform1iv", "glUniform2iv", "glUniform3iv",
+		"glUniform4iv", "glUniform1uiv", "glUniform2uiv", "glUniform3uiv", "glUniform4uiv", "glUniform1dv", "glUniform2dv",
+		"glUniform3dv", "glUniform4dv",
+		"glUniformMatrix2fv", "glUniformMatrix3fv", "glUniformMatrix2x3fv", "glUniformMatrix3x2fv", "glUniformMatrix2x4fv",
+		"glUniformMatrix4x2fv", "glUniformMatrix3x4fv", "glUniformMatrix4x3fv", "glUniformMatrix2dv", "glUniformMatrix3dv",
+		"glUniformMatrix4dv", "glUniformMatrix2x3dv", "glUniformMatrix3x2dv", "glUniformMatrix2x4dv", "glUniformMatrix4x2dv",
+		"glUniformMatrix3x4dv", "glUniformMatrix4x3dv",
+		"glCreateTextures", "glTextureStorage2D", "glTextureParameteri", "glBindImageTexture", "glNamedFramebufferTexture",
+		"glBlitNamedFramebuffer", "glNamedFramebufferDrawBuffers", "glVertexArrayAttribIFormat", "glVertexArrayBindingDivisor",
+		"glDispatchCompute", "glMemoryBarrier", "glDrawArraysIndirect", "glMultiDrawArraysIndirect",
+		"glTextureStorage3D", "glTextureSubImage3D", "glGenerateTextureMipmap", "glDeleteTextures",
+		"glTextureSubImage2D", "glCopyImageSubData", "glCreateSamplers", "glDeleteSamplers", "glSamplerParameteri",
+		"glSamplerParameterf", "glPixelStorei"
+	};
+
+	static_assert(sizeof(callNames) / sizeof(callNames[0]) == static_cast<size_t>(kengine::GL_CALL::COUNT), "a GL call has no name");
+
+	/*
+		Payload of a call: a presence flag, the size and the bytes (nullptr and empty data are different)
+	*/
+	struct payload
+	{
+		payload(const void* data, size_t size) : data(data), size(data != nullptr ? size : 0) {}
+
+		const void* data;
+		size_t size;
+	};
+
+	payload names(GLsizei count, const GLuint* names)
+	{
+		return payload(names, sizeof(GLuint) * static_cast<size_t>(count > 0 ? count : 0));
+	}
+
+	/*
+		Arguments of a call: they are written to the trace when the record is destroyed (at the end of the
+		expression). The buffer is reused by each thread.
+	*/
+	class record
+	{
+	public:
+		explicit record(kengine::GL_CALL call)
+			: m_call(call), m_arguments(buffer())
+		{
+			m_arguments.clear();
+		}
+
+		~record() {
+			kengine::glCapture().write(m_call, m_arguments);
+		}
+
+		template <typename T>
+		record& operator<<(const T& value) {
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+			m_arguments.insert(m_arguments.end(), bytes, bytes + sizeof(T));
+			return *this;
+		}
+
+		record& operator<<(const payload& value) {
+			*this << static_cast<uint8_t>(value.data != nullptr) << static_cast<uint64_t>(value.size);
+
+			if (value.data != nullptr) {
+				const unsigned char* bytes = static_cast<const unsigned char*>(value.data);
+				m_arguments.insert(m_arguments.end(), bytes, bytes + value.size);
+			}
+
+			return *this;
+		}
+
+	private:
+		static std::vector<unsigned char>& buffer() {
+			static thread_local std::vector<unsigned char> arguments;
+			return arguments;
+		}
+
+		kengine::GL_CALL m_call;
+		std::vector<unsigned char>& m_arguments;
+	};
+
+	uint64_t syncHandle(GLsync sync)
+	{
+		return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(sync));
+	}
+
+	/*
+		Size of a pixel (or of a clear value) described by a format and a type (0 if they are not known)
+	*/
+	size_t pixelSize(GLenum format, GLenum type)
+	{
+		switch (type) {
+		case GL_UNSIGNED_BYTE_3_3_2:
+		case GL_UNSIGNED_BYTE_2_3_3_REV:
+			return 1;
+		case GL_UNSIGNED_SHORT_5_6_5:
+		case GL_UNSIGNED_SHORT_5_6_5_REV:
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+		case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+		case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+			return 2;
+		case GL_UNSIGNED_INT_8_8_8_8:
+		case GL_UNSIGNED_INT_8_8_8_8_REV:
+		case GL_UNSIGNED_INT_10_10_10_2:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_24_8:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+			return 4;
+		case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+			return 8;
+		default:
+			break;
+		}
+
+		size_t components = 0;
+
+		switch (format) {
+		case GL_RED:
+		case GL_GREEN:
+		case GL_BLUE:
+		case GL_RED_INTEGER:
+		case GL_DEPTH_COMPONENT:
+		case GL_STENCIL_INDEX:
+			components = 1;
+			break;
+		case GL_RG:
+		case GL_RG_INTEGER:
+		case GL_DEPTH_STENCIL:
+			components = 2;
+			break;
+		case GL_RGB:
+		case GL_BGR:
+		case GL_RGB_INTEGER:
+		case GL_BGR_INTEGER:
+			components = 3;
+			break;
+		case GL_RGBA:
+		case GL_BGRA:
+		case GL_RGBA_INTEGER:
+		case GL_BGRA_INTEGER:
+			components = 4;
+			break;
+		default:
+			return 0;
+		}
+
+		switch (type) {
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			return components;
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			return components * 2;
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+		case GL_FLOAT:
+			return components * 4;
+		default:
+			return 0;
+		}
+	}
+
+	/*
+		Name of the buffer bound to a target (the target-based calls are recorded with the name)
+	*/
+	GLuint boundBuffer(GLenum target)
+	{
+		GLenum binding = 0;
+
+		switch (target) {
+		case GL_ARRAY_BUFFER: binding = GL_ARRAY_BUFFER_BINDING; break;
+		case GL_ELEMENT_ARRAY_BUFFER: binding = GL_ELEMENT_ARRAY_BUFFER_BINDING; break;
+		case GL_UNIFORM_BUFFER: binding = GL_UNIFORM_BUFFER_BINDING; break;
+		case GL_SHADER_STORAGE_BUFFER: binding = GL_SHADER_STORAGE_BUFFER_BINDING; break;
+		case GL_COPY_READ_BUFFER: binding = GL_COPY_READ_BUFFER_BINDING; break;
+		case GL_COPY_WRITE_BUFFER: binding = GL_COPY_WRITE_BUFFER_BINDING; break;
+		case GL_DRAW_INDIRECT_BUFFER: binding = GL_DRAW_INDIRECT_BUFFER_BINDING; break;
+		case GL_DISPATCH_INDIRECT_BUFFER: binding = GL_DISPATCH_INDIRECT_BUFFER_BINDING; break;
+		case GL_PIXEL_PACK_BUFFER: binding = GL_PIXEL_PACK_BUFFER_BINDING; break;
+		case GL_PIXEL_UNPACK_BUFFER: binding = GL_PIXEL_UNPACK_BUFFER_BINDING; break;
+		case GL_ATOMIC_COUNTER_BUFFER: binding = GL_ATOMIC_COUNTER_BUFFER_BINDING; break;
+		case GL_TRANSFORM_FEEDBACK_BUFFER: binding = GL_TRANSFORM_FEEDBACK_BUFFER_BINDING; break;
+		case GL_QUERY_BUFFER: binding = GL_QUERY_BUFFER_BINDING; break;
+		default: return 0;
+		}
+
+		GLint buffer = 0;
+		glGetIntegerv(binding, &buffer);
+		return static_cast<GLuint>(buffer);
+	}
+
+	/*
+		Pixels read by glTextureSubImage* (the rows are aligned by GL_UNPACK_ALIGNMENT). The pixels are an offset
+		into the buffer bound to GL_PIXEL_UNPACK_BUFFER if there is one, so there is no payload.
+	*/
+	payload imagePayload(GLenum format, GLenum type, GLsizei width, GLsizei height, GLsizei depth, const void* pixels)
+	{
+		GLint unpackBuffer = 0;
+		glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+
+		if (unpackBuffer != 0 || width <= 0 || height <= 0 || depth <= 0)
+			return payload(nullptr, 0);
+
+		GLint alignment = 4;
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+
+		size_t row = pixelSize(format, type) * static_cast<size_t>(width);
+		size_t alignedRow = (row + static_cast<size_t>(alignment) - 1) / static_cast<size_t>(alignment) * static_cast<size_t>(alignment);
+		size_t rows = static_cast<size_t>(height) * static_cast<size_t>(depth);
+
+		// the last row is not padded
+		return payload(pixels, alignedRow * (rows - 1) + row);
+	}
+
+	GLsizeiptr bufferSize(GLuint buffer)
+	{
+		GLint64 size = 0;
+
+		if (buffer != 0)
+			glGetNamedBufferParameteri64v(buffer, GL_BUFFER_SIZE, &size);
+
+		return static_cast<GLsizeiptr>(size);
+	}
+
+	/*
+		Access of glMapBuffer as the bits of glMapBufferRange
+	*/
+	GLbitfield accessBits(GLenum access)
+	{
+		switch (access) {
+		case GL_READ_ONLY: return GL_MAP_READ_BIT;
+		case GL_WRITE_ONLY: return GL_MAP_WRITE_BIT;
+		default: return GL_MAP_READ_BIT | GL_MAP_WRITE_BIT;
+		}
+	}
+
+	/*
+		Functions replaced by the capture (the loaded pointer is kept in real_<name>)
+	*/
+	PFNGLCREATEBUFFERSPROC real_glCreateBuffers = nullptr;
+	PFNGLGENBUFFERSPROC real_glGenBuffers = nullptr;
+	PFNGLDELETEBUFFERSPROC real_glDeleteBuffers = nullptr;
+	PFNGLBINDBUFFERPROC real_glBindBuffer = nullptr;
+	PFNGLNAMEDBUFFERSTORAGEPROC real_glNamedBufferStorage = nullptr;
+	PFNGLBUFFERSTORAGEPROC real_glBufferStorage = nullptr;
+	PFNGLNAMEDBUFFERSUBDATAPROC real_glNamedBufferSubData = nullptr;
+	PFNGLMAPNAMEDBUFFERRANGEPROC real_glMapNamedBufferRange = nullptr;
+	PFNGLUNMAPNAMEDBUFFERPROC real_glUnmapNamedBuffer = nullptr;
+	PFNGLBINDBUFFERBASEPROC real_glBindBufferBase = nullptr;
+	PFNGLBINDBUFFERRANGEPROC real_glBindBufferRange = nullptr;
+	PFNGLCREATEVERTEXARRAYSPROC real_glCreateVertexArrays = nullptr;
+	PFNGLDELETEVERTEXARRAYSPROC real_glDeleteVertexArrays = nullptr;
+	PFNGLBINDVERTEXARRAYPROC real_glBindVertexArray = nullptr;
+	PFNGLENABLEVERTEXARRAYATTRIBPROC real_glEnableVertexArrayAttrib = nullptr;
+	PFNGLVERTEXARRAYATTRIBFORMATPROC real_glVertexArrayAttribFormat = nullptr;
+	PFNGLVERTEXARRAYATTRIBBINDINGPROC real_glVertexArrayAttribBinding = nullptr;
+	PFNGLVERTEXARRAYVERTEXBUFFERPROC real_glVertexArrayVertexBuffer = nullptr;
+	PFNGLBINDVERTEXBUFFERPROC real_glBindVertexBuffer = nullptr;
+	PFNGLENABLEVERTEXATTRIBARRAYPROC real_glEnableVertexAttribArray = nullptr;
+	PFNGLVERTEXATTRIBPOINTERPROC real_glVertexAttribPointer = nullptr;
+	PFNGLCREATESHADERPROC real_glCreateShader = nullptr;
+	PFNGLSHADERSOURCEPROC real_glShaderSource = nullptr;
+	PFNGLCOMPILESHADERPROC real_glCompileShader = nullptr;
+	PFNGLSHADERBINARYPROC real_glShaderBinary = nullptr;
+	PFNGLSPECIALIZESHADERPROC real_glSpecializeShader = nullptr;
+	PFNGLDELETESHADERPROC real_glDeleteShader = nullptr;
+	PFNGLCREATEPROGRAMPROC real_glCreateProgram = nullptr;
+	PFNGLATTACHSHADERPROC real_glAttachShader = nullptr;
+	PFNGLDETACHSHADERPROC real_glDetachShader = nullptr;
+	PFNGLPROGRAMPARAMETERIPROC real_glProgramParameteri = nullptr;
+	PFNGLLINKPROGRAMPROC real_glLinkProgram = nullptr;
+	PFNGLPROGRAMBINARYPROC real_glProgramBinary = nullptr;
+	PFNGLDELETEPROGRAMPROC real_glDeleteProgram = nullptr;
+	PFNGLUSEPROGRAMPROC real_glUseProgram = nullptr;
+	PFNGLCREATESHADERPROGRAMVPROC real_glCreateShaderProgramv = nullptr;
+	PFNGLCREATEPROGRAMPIPELINESPROC real_glCreateProgramPipelines = nullptr;
+	PFNGLDELETEPROGRAMPIPELINESPROC real_glDeleteProgramPipelines = nullptr;
+	PFNGLUSEPROGRAMSTAGESPROC real_glUseProgramStages = nullptr;
+	PFNGLBINDPROGRAMPIPELINEPROC real_glBindProgramPipeline = nullptr;
+	PFNGLUNIFORMMATRIX4FVPROC real_glUniformMatrix4fv = nullptr;
+	PFNGLBINDTEXTUREUNITPROC real_glBindTextureUnit = nullptr;
+	PFNGLBINDSAMPLERPROC real_glBindSampler = nullptr;
+	PFNGLBLENDFUNCSEPARATEPROC real_glBlendFuncSeparate = nullptr;
+	PFNGLBLENDEQUATIONSEPARATEPROC real_glBlendEquationSeparate = nullptr;
+	PFNGLCREATEFRAMEBUFFERSPROC real_glCreateFramebuffers = nullptr;
+	PFNGLDELETEFRAMEBUFFERSPROC real_glDeleteFramebuffers = nullptr;
+	PFNGLBINDFRAMEBUFFERPROC real_glBindFramebuffer = nullptr;
+	PFNGLCREATERENDERBUFFERSPROC real_glCreateRenderbuffers = nullptr;
+	PFNGLDELETERENDERBUFFERSPROC real_glDeleteRenderbuffers = nullptr;
+	PFNGLNAMEDRENDERBUFFERSTORAGEPROC real_glNamedRenderbufferStorage = nullptr;
+	PFNGLNAMEDFRAMEBUFFERRENDERBUFFERPROC real_glNamedFramebufferRenderbuffer = nullptr;
+	PFNGLFENCESYNCPROC real_glFenceSync = nullptr;
+	PFNGLCLIENTWAITSYNCPROC real_glClientWaitSync = nullptr;
+	PFNGLDELETESYNCPROC real_glDeleteSync = nullptr;
+	PFNGLNAMEDBUFFERDATAPROC real_glNamedBufferData = nullptr;
+	PFNGLBUFFERDATAPROC real_glBufferData = nullptr;
+	PFNGLBUFFERSUBDATAPROC real_glBufferSubData = nullptr;
+	PFNGLCLEARNAMEDBUFFERDATAPROC real_glClearNamedBufferData = nullptr;
+	PFNGLCLEARBUFFERDATAPROC real_glClearBufferData = nullptr;
+	PFNGLCOPYNAMEDBUFFERSUBDATAPROC real_glCopyNamedBufferSubData = nullptr;
+	PFNGLCOPYBUFFERSUBDATAPROC real_glCopyBufferSubData = nullptr;
+	PFNGLMAPNAMEDBUFFERPROC real_glMapNamedBuffer = nullptr;
+	PFNGLMAPBUFFERPROC real_glMapBuffer = nullptr;
+	PFNGLMAPBUFFERRANGEPROC real_glMapBufferRange = nullptr;
+	PFNGLUNMAPBUFFERPROC real_glUnmapBuffer = nullptr;
+	PFNGLFLUSHMAPPEDNAMEDBUFFERRANGEPROC real_glFlushMappedNamedBufferRange = nullptr;
+	PFNGLFLUSHMAPPEDBUFFERRANGEPROC real_glFlushMappedBufferRange = nullptr;
+	PFNGLINVALIDATEBUFFERDATAPROC real_glInvalidateBufferData = nullptr;
+	PFNGLINVALIDATEBUFFERSUBDATAPROC real_glInvalidateBufferSubData = nullptr;
+	PFNGLCLEARBUFFERFVPROC real_glClearBufferfv = nullptr;
+	PFNGLGENVERTEXARRAYSPROC real_glGenVertexArrays = nullptr;
+	PFNGLDISABLEVERTEXARRAYATTRIBPROC real_glDisableVertexArrayAttrib = nullptr;
+	PFNGLDISABLEVERTEXATTRIBARRAYPROC real_glDisableVertexAttribArray = nullptr;
+	PFNGLVERTEXATTRIBIPOINTERPROC real_glVertexAttribIPointer = nullptr;
+	PFNGLVERTEXATTRIBLPOINTERPROC real_glVertexAttribLPointer = nullptr;
+	PFNGLVERTEXARRAYVERTEXBUFFERSPROC real_glVertexArrayVertexBuffers = nullptr;
+	PFNGLVERTEXATTRIBFORMATPROC real_glVertexAttribFormat = nullptr;
+	PFNGLVERTEXATTRIBBINDINGPROC real_glVertexAttribBinding = nullptr;
+	PFNGLBINDATTRIBLOCATIONPROC real_glBindAttribLocation = nullptr;
+	PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC real_glDrawArraysInstancedBaseInstance = nullptr;
+	PFNGLPRIMITIVERESTARTINDEXPROC real_glPrimitiveRestartIndex = nullptr;
+	PFNGLPROGRAMUNIFORM3FPROC real_glProgramUniform3f = nullptr;
+	PFNGLACTIVESHADERPROGRAMPROC real_glActiveShaderProgram = nullptr;
+	PFNGLUNIFORM1FVPROC real_glUniform1fv = nullptr;
+	PFNGLUNIFORM2FVPROC real_glUniform2fv = nullptr;
+	PFNGLUNIFORM3FVPROC real_glUniform3fv = nullptr;
+	PFNGLUNIFORM4FVPROC real_glUniform4fv = nullptr;
+	PFNGLUNIFORM1IVPROC real_glUniform1iv = nullptr;
+	PFNGLUNIFORM2IVPROC real_glUniform2iv = nullptr;
+	PFNGLUNIFORM3IVPROC real_glUniform3iv = nullptr;
+	PFNGLUNIFORM4IVPROC real_glUniform4iv = nullptr;
+	PFNGLUNIFORM1UIVPROC real_glUniform1uiv = nullptr;
+	PFNGLUNIFORM2UIVPROC real_glUniform2uiv = nullptr;
+	PFNGLUNIFORM3UIVPROC real_glUniform3uiv = nullptr;
+	PFNGLUNIFORM4UIVPROC real_glUniform4uiv = nullptr;
+	PFNGLUNIFORM1DVPROC real_glUniform1dv = nullptr;
+	PFNGLUNIFORM2DVPROC real_glUniform2dv = nullptr;
+	PFNGLUNIFORM3DVPROC real_glUniform3dv = nullptr;
+	PFNGLUNIFORM4DVPROC real_glUniform4dv = nullptr;
+	PFNGLUNIFORMMATRIX2FVPROC real_glUniformMatrix2fv = nullptr;
+	PFNGLUNIFORMMATRIX3FVPROC real_glUniformMatrix3fv = nullptr;
+	PFNGLUNIFORMMATRIX2X3FVPROC real_glUniformMatrix2x3fv = nullptr;
+	PFNGLUNIFORMMATRIX3X2FVPROC real_glUniformMatrix3x2fv = nullptr;
+	PFNGLUNIFORMMATRIX2X4FVPROC real_glUniformMatrix2x4fv = nullptr;
+	PFNGLUNIFORMMATRIX4X2FVPROC real_glUniformMatrix4x2fv = nullptr;
+	PFNGLUNIFORMMATRIX3X4FVPROC real_glUniformMatrix3x4fv = nullptr;
+	PFNGLUNIFORMMATRIX4X3FVPROC real_glUniformMatrix4x3fv = nullptr;
+	PFNGLUNIFORMMATRIX2DVPROC real_glUniformMatrix2dv = nullptr;
+	PFNGLUNIFORMMATRIX3DVPROC real_glUniformMatrix3dv = nullptr;
+	PFNGLUNIFORMMATRIX4DVPROC real_glUniformMatrix4dv = nullptr;
+	PFNGLUNIFORMMATRIX2X3DVPROC real_glUniformMatrix2x3dv = nullptr;
+	PFNGLUNIFORMMATRIX3X2DVPROC real_glUniformMatrix3x2dv = nullptr;
+	PFNGLUNIFORMMATRIX2X4DVPROC real_glUniformMatrix2x4dv = nullptr;
+	PFNGLUNIFORMMATRIX4X2DVPROC real_glUniformMatrix4x2dv = nullptr;
+	PFNGLUNIFORMMATRIX3X4DVPROC real_glUniformMatrix3x4dv = nullptr;
+	PFNGLUNIFORMMATRIX4X3DVPROC real_glUniformMatrix4x3dv = nullptr;
+	PFNGLCREATETEXTURESPROC real_glCreateTextures = nullptr;
+	PFNGLTEXTURESTORAGE2DPROC real_glTextureStorage2D = nullptr;
+	PFNGLTEXTUREPARAMETERIPROC real_glTextureParameteri = nullptr;
+	PFNGLBINDIMAGETEXTUREPROC real_glBindImageTexture = nullptr;
+	PFNGLNAMEDFRAMEBUFFERTEXTUREPROC real_glNamedFramebufferTexture = nullptr;
+	PFNGLBLITNAMEDFRAMEBUFFERPROC real_glBlitNamedFramebuffer = nullptr;
+	PFNGLNAMEDFRAMEBUFFERDRAWBUFFERSPROC real_glNamedFramebufferDrawBuffers = nullptr;
+	PFNGLVERTEXARRAYATTRIBIFORMATPROC real_glVertexArrayAttribIFormat = nullptr;
+	PFNGLVERTEXARRAYBINDINGDIVISORPROC real_glVertexArrayBindingDivisor = nullptr;
+	PFNGLDISPATCHCOMPUTEPROC real_glDispatchCompute = nullptr;
+	PFNGLMEMORYBARRIERPROC real_glMemoryBarrier = nullptr;
+	PFNGLDRAWARRAYSINDIRECTPROC real_glDrawArraysIndirect = nullptr;
+	PFNGLMULTIDRAWARRAYSINDIRECTPROC real_glMultiDrawArraysIndirect = nullptr;
+	PFNGLTEXTURESTORAGE3DPROC real_glTextureStorage3D = nullptr;
+	PFNGLTEXTURESUBIMAGE3DPROC real_glTextureSubImage3D = nullptr;
+	PFNGLGENERATETEXTUREMIPMAPPROC real_glGenerateTextureMipmap = nullptr;
+	PFNGLTEXTURESUBIMAGE2DPROC real_glTextureSubImage2D = nullptr;
+	PFNGLCOPYIMAGESUBDATAPROC real_glCopyImageSubData = nullptr;
+	PFNGLCREATESAMPLERSPROC real_glCreateSamplers = nullptr;
+	PFNGLDELETESAMPLERSPROC real_glDeleteSamplers = nullptr;
+	PFNGLSAMPLERPARAMETERIPROC real_glSamplerParameteri = nullptr;
+	PFNGLSAMPLERPARAMETERFPROC real_glSamplerParameterf = nullptr;
+
+#ifndef __ANDROID__
+	decltype(&glClear) real_glClear = nullptr;
+	decltype(&glClearColor) real_glClearColor = nullptr;
+	decltype(&glDrawArrays) real_glDrawArrays = nullptr;
+	decltype(&glEnable) real_glEnable = nullptr;
+	decltype(&glDisable) real_glDisable = nullptr;
+	decltype(&glViewport) real_glViewport = nullptr;
+	decltype(&glPolygonMode) real_glPolygonMode = nullptr;
+	decltype(&glDepthFunc) real_glDepthFunc = nullptr;
+	decltype(&glDepthMask) real_glDepthMask = nullptr;
+	decltype(&glCullFace) real_glCullFace = nullptr;
+	decltype(&glFrontFace) real_glFrontFace = nullptr;
+	decltype(&glLineWidth) real_glLineWidth = nullptr;
+	decltype(&glPointSize) real_glPointSize = nullptr;
+	decltype(&glDeleteTextures) real_glDeleteTextures = nullptr;
+	decltype(&glPixelStorei) real_glPixelStorei = nullptr;
+#endif
+
+
+	/*
+		Recording functions (the call is recorded after the driver call, so the new object names are known)
+	*/
+
+	using kengine::GL_CALL;
+
+	void APIENTRY capture_glCreateBuffers(GLsizei n, GLuint* buffers)
+	{
+		real_glCreateBuffers(n, buffers);
+		record(GL_CALL::CREATE_BUFFERS) << n << names(n, buffers);
+	}
+
+	void APIENTRY capture_glGenBuffers(GLsizei n, GLuint* buffers)
+	{
+		real_glGenBuffers(n, buffers);
+		record(GL_CALL::GEN_BUFFERS) << n << names(n, buffers);
+	}
+
+	void APIENTRY capture_glDeleteBuffers(GLsizei n, const GLuint* buffers)
+	{
+		for (GLsizei index = 0; index < n; index++)
+			kengine::glCapture().unmapRange(buffers[index]);
+
+		real_glDeleteBuffers(n, buffers);
+		record(GL_CALL::DELETE_BUFFERS) << n << names(n, buffers);
+	}
+
+	void APIENTRY capture_glBindBuffer(GLenum target, GLuint buffer)
+	{
+		real_glBindBuffer(target, buffer);
+		record(GL_CALL::BIND_BUFFER) << target << buffer;
+	}
+
+	void APIENTRY capture_glNamedBufferStorage(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags)
+	{
+		real_glNamedBufferStorage(buffer, size, data, flags);
+		record(GL_CALL::NAMED_BUFFER_STORAGE) << buffer << static_cast<int64_t>(size) << payload(data, static_cast<size_t>(size)) << flags;
+	}
+
+	void APIENTRY capture_glBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+	{
+		real_glBufferStorage(target, size, data, flags);
+		record(GL_CALL::BUFFER_STORAGE) << target << static_cast<int64_t>(size) << payload(data, static_cast<size_t>(size)) << flags;
+	}
+
+	void APIENTRY capture_glNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data)
+	{
+		real_glNamedBufferSubData(buffer, offset, size, data);
+		record(GL_CALL::NAMED_BUFFER_SUB_DATA) << buffer << static_cast<int64_t>(offset) << payload(data, static_cast<size_t>(size));
+	}
+
+	void* APIENTRY capture_glMapNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access)
+	{
+		void* data = real_glMapNamedBufferRange(buffer, offset, length, access);
+		record(GL_CALL::MAP_NAMED_BUFFER_RANGE) << buffer << static_cast<int64_t>(offset) << static_cast<int64_t>(length) << access;
+
+		kengine::glCapture().mapRange(buffer, offset, length, access, data);
+		return data;
+	}
+
+	GLboolean APIENTRY capture_glUnmapNamedBuffer(GLuint buffer)
+	{
+		kengine::glCapture().unmapRange(buffer);
+
+		GLboolean result = real_glUnmapNamedBuffer(buffer);
+		record(GL_CALL::UNMAP_NAMED_BUFFER) << buffer;
+		return result;
+	}
+
+	void APIENTRY capture_glBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		real_glBindBufferBase(target, index, buffer);
+		record(GL_CALL::BIND_BUFFER_BASE) << target << index << buffer;
+	}
+
+	void APIENTRY capture_glBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		// the CPU has written the range in the mapped memory (e.g. kengine::uniform_ring_buffer)
+		kengine::glCapture().writeMappedRange(buffer, offset, size);
+
+		real_glBindBufferRange(target, index, buffer, offset, size);
+		record(GL_CALL::BIND_BUFFER_RANGE) << target << index << buffer << static_cast<int64_t>(offset) << static_cast<int64_t>(size);
+	}
+
+	void APIENTRY capture_glCreateVertexArrays(GLsizei n, GLuint* arrays)
+	{
+		real_glCreateVertexArrays(n, arrays);
+		record(GL_CALL::CREATE_VERTEX_ARRAYS) << n << names(n, arrays);
+	}
+
+	void APIENTRY capture_glDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+	{
+		real_glDeleteVertexArrays(n, arrays);
+		record(GL_CALL::DELETE_VERTEX_ARRAYS) << n << names(n, arrays);
+	}
+
+	void APIENTRY capture_glBindVertexArray(GLuint array)
+	{
+		real_glBindVertexArray(array);
+		record(GL_CALL::BIND_VERTEX_ARRAY) << array;
+	}
+
+	void APIENTRY capture_glEnableVertexArrayAttrib(GLuint vaobj, GLuint index)
+	{
+		real_glEnableVertexArrayAttrib(vaobj, index);
+		record(GL_CALL::ENABLE_VERTEX_ARRAY_ATTRIB) << vaobj << index;
+	}
+
+	void APIENTRY capture_glVertexArrayAttribFormat(GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset)
+	{
+		real_glVertexArrayAttribFormat(vaobj, attribindex, size, type, normalized, relativeoffset);
+		record(GL_CALL::VERTEX_ARRAY_ATTRIB_FORMAT) << vaobj << attribindex << size << type << normalized << relativeoffset;
+	}
+
+	void APIENTRY capture_glVertexArrayAttribBinding(GLuint vaobj, GLuint attribindex, GLuint bindingindex)
+	{
+		real_glVertexArrayAttribBinding(vaobj, attribindex, bindingindex);
+		record(GL_CALL::VERTEX_ARRAY_ATTRIB_BINDING) << vaobj << attribindex << bindingindex;
+	}
+
+	void APIENTRY capture_glVertexArrayVertexBuffer(GLuint vaobj, GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride)
+	{
+		real_glVertexArrayVertexBuffer(vaobj, bindingindex, buffer, offset, stride);
+		record(GL_CALL::VERTEX_ARRAY_VERTEX_BUFFER) << vaobj << bindingindex << buffer << static_cast<int64_t>(offset) << stride;
+	}
+
+	void APIENTRY capture_glBindVertexBuffer(GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride)
+	{
+		real_glBindVertexBuffer(bindingindex, buffer, offset, stride);
+		record(GL_CALL::BIND_VERTEX_BUFFER) << bindingindex << buffer << static_cast<int64_t>(offset) << stride;
+	}
+
+	void APIENTRY capture_glEnableVertexAttribArray(GLuint index)
+	{
+		real_glEnableVertexAttribArray(index);
+		record(GL_CALL::ENABLE_VERTEX_ATTRIB_ARRAY) << index;
+	}
+
+	void APIENTRY capture_glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+	{
+		// the pointer is an offset into the bound GL_ARRAY_BUFFER
+		real_glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+		record(GL_CALL::VERTEX_ATTRIB_POINTER) << index << size << type << normalized << stride << static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+	}
+
+	GLuint APIENTRY capture_glCreateShader(GLenum type)
+	{
+		GLuint shader = real_glCreateShader(type);
+		record(GL_CALL::CREATE_SHADER) << type << shader;
+		return shader;
+	}
+
+	void APIENTRY capture_glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+	{
+		real_glShaderSource(shader, count, string, length);
+
+		record sources(GL_CALL::SHADER_SOURCE);
+		sources << shader << count;
+
+		for (GLsizei index = 0; index < count; index++) {
+			size_t size = (length == nullptr || length[index] < 0) ? std::strlen(string[index]) : static_cast<size_t>(length[index]);
+			sources << payload(string[index], size);
+		}
+	}
+
+	void APIENTRY capture_glCompileShader(GLuint shader)
+	{
+		real_glCompileShader(shader);
+		record(GL_CALL::COMPILE_SHADER) << shader;
+	}
+
+	void APIENTRY capture_glShaderBinary(GLsizei count, const GLuint* shaders, GLenum binaryFormat, const void* binary, GLsizei length)
+	{
+		real_glShaderBinary(count, shaders, binaryFormat, binary, length);
+		record(GL_CALL::SHADER_BINARY) << count << names(count, shaders) << binaryFormat << payload(binary, static_cast<size_t>(length));
+	}
+
+	void APIENTRY capture_glSpecializeShader(GLuint shader, const GLchar* entryPoint, GLuint count, const GLuint* indices, const GLuint* values)
+	{
+		real_glSpecializeShader(shader, entryPoint, count, indices, values);
+		record(GL_CALL::SPECIALIZE_SHADER) << shader << payload(entryPoint, std::strlen(entryPoint) + 1) << count <<
+			names(static_cast<GLsizei>(count), indices) << names(static_cast<GLsizei>(count), values);
+	}
+
+	void APIENTRY capture_glDeleteShader(GLuint shader)
+	{
+		real_glDeleteShader(shader);
+		record(GL_CALL::DELETE_SHADER) << shader;
+	}
+
+	GLuint APIENTRY capture_glCreateProgram()
+	{
+		GLuint program = real_glCreateProgram();
+		record(GL_CALL::CREATE_PROGRAM) << program;
+		return program;
+	}
+
+	void APIENTRY capture_glAttachShader(GLuint program, GLuint shader)
+	{
+		real_glAttachShader(program, shader);
+		record(GL_CALL::ATTACH_SHADER) << program << shader;
+	}
+
+	void APIENTRY capture_glDetachShader(GLuint program, GLuint shader)
+	{
+		real_glDetachShader(program, shader);
+		record(GL_CALL::DETACH_SHADER) << program << shader;
+	}
+
+	void APIENTRY capture_glProgramParameteri(GLuint program, GLenum pname, GLint value)
+	{
+		real_glProgramParameteri(program, pname, value);
+		record(GL_CALL::PROGRAM_PARAMETERI) << program << pname << value;
+	}
+
+	void APIENTRY capture_glLinkProgram(GLuint program)
+	{
+		real_glLinkProgram(program);
+		record(GL_CALL::LINK_PROGRAM) << program;
+	}
+
+	void APIENTRY capture_glProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+	{
+		real_glProgramBinary(program, binaryFormat, binary, length);
+		record(GL_CALL::PROGRAM_BINARY) << program << binaryFormat << payload(binary, static_cast<size_t>(length));
+	}
+
+	void APIENTRY capture_glDeleteProgram(GLuint program)
+	{
+		real_glDeleteProgram(program);
+		record(GL_CALL::DELETE_PROGRAM) << program;
+	}
+
+	void APIENTRY capture_glUseProgram(GLuint program)
+	{
+		real_glUseProgram(program);
+		record(GL_CALL::USE_PROGRAM) << program;
+	}
+
+	GLuint APIENTRY capture_glCreateShaderProgramv(GLenum type, GLsizei count, const GLchar* const* strings)
+	{
+		GLuint program = real_glCreateShaderProgramv(type, count, strings);
+
+		record sources(GL_CALL::CREATE_SHADER_PROGRAMV);
+		sources << type << program << count;
+
+		for (GLsizei index = 0; index < count; index++)
+			sources << payload(strings[index], std::strlen(strings[index]));
+
+		return program;
+	}
+
+	void APIENTRY capture_glCreateProgramPipelines(GLsizei n, GLuint* pipelines)
+	{
+		real_glCreateProgramPipelines(n, pipelines);
+		record(GL_CALL::CREATE_PROGRAM_PIPELINES) << n << names(n, pipelines);
+	}
+
+	void APIENTRY capture_glDeleteProgramPipelines(GLsizei n, const GLuint* pipelines)
+	{
+		real_glDeleteProgramPipelines(n, pipelines);
+		record(GL_CALL::DELETE_PROGRAM_PIPELINES) << n << names(n, pipelines);
+	}
+
+	void APIENTRY capture_glUseProgramStages(GLuint pipeline, GLbitfield stages, GLuint program)
+	{
+		real_glUseProgramStages(pipeline, stages, program);
+		record(GL_CALL::USE_PROGRAM_STAGES) << pipeline << stages << program;
+	}
+
+	void APIENTRY capture_glBindProgramPipeline(GLuint pipeline)
+	{
+		real_glBindProgramPipeline(pipeline);
+		record(GL_CALL::BIND_PROGRAM_PIPELINE) << pipeline;
+	}
+
+	void APIENTRY capture_glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix4fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_4FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 16 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glBindTextureUnit(GLuint unit, GLuint texture)
+	{
+		real_glBindTextureUnit(unit, texture);
+		record(GL_CALL::BIND_TEXTURE_UNIT) << unit << texture;
+	}
+
+	void APIENTRY capture_glBindSampler(GLuint unit, GLuint sampler)
+	{
+		real_glBindSampler(unit, sampler);
+		record(GL_CALL::BIND_SAMPLER) << unit << sampler;
+	}
+
+	void APIENTRY capture_glBlendFuncSeparate(GLenum sourceRGB, GLenum destinationRGB, GLenum sourceAlpha, GLenum destinationAlpha)
+	{
+		real_glBlendFuncSeparate(sourceRGB, destinationRGB, sourceAlpha, destinationAlpha);
+		record(GL_CALL::BLEND_FUNC_SEPARATE) << sourceRGB << destinationRGB << sourceAlpha << destinationAlpha;
+	}
+
+	void APIENTRY capture_glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+	{
+		real_glBlendEquationSeparate(modeRGB, modeAlpha);
+		record(GL_CALL::BLEND_EQUATION_SEPARATE) << modeRGB << modeAlpha;
+	}
+
+	void APIENTRY capture_glCreateFramebuffers(GLsizei n, GLuint* framebuffers)
+	{
+		real_glCreateFramebuffers(n, framebuffers);
+		record(GL_CALL::CREATE_FRAMEBUFFERS) << n << names(n, framebuffers);
+	}
+
+	void APIENTRY capture_glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+	{
+		real_glDeleteFramebuffers(n, framebuffers);
+		record(GL_CALL::DELETE_FRAMEBUFFERS) << n << names(n, framebuffers);
+	}
+
+	void APIENTRY capture_glBindFramebuffer(GLenum target, GLuint framebuffer)
+	{
+		real_glBindFramebuffer(target, framebuffer);
+		record(GL_CALL::BIND_FRAMEBUFFER) << target << framebuffer;
+	}
+
+	void APIENTRY capture_glCreateRenderbuffers(GLsizei n, GLuint* renderbuffers)
+	{
+		real_glCreateRenderbuffers(n, renderbuffers);
+		record(GL_CALL::CREATE_RENDERBUFFERS) << n << names(n, renderbuffers);
+	}
+
+	void APIENTRY capture_glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+	{
+		real_glDeleteRenderbuffers(n, renderbuffers);
+		record(GL_CALL::DELETE_RENDERBUFFERS) << n << names(n, renderbuffers);
+	}
+
+	void APIENTRY capture_glNamedRenderbufferStorage(GLuint renderbuffer, GLenum internalformat, GLsizei width, GLsizei height)
+	{
+		real_glNamedRenderbufferStorage(renderbuffer, internalformat, width, height);
+		record(GL_CALL::NAMED_RENDERBUFFER_STORAGE) << renderbuffer << internalformat << width << height;
+	}
+
+	void APIENTRY capture_glNamedFramebufferRenderbuffer(GLuint framebuffer, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+	{
+		real_glNamedFramebufferRenderbuffer(framebuffer, attachment, renderbuffertarget, renderbuffer);
+		record(GL_CALL::NAMED_FRAMEBUFFER_RENDERBUFFER) << framebuffer << attachment << renderbuffertarget << renderbuffer;
+	}
+
+	GLsync APIENTRY capture_glFenceSync(GLenum condition, GLbitfield flags)
+	{
+		GLsync sync = real_glFenceSync(condition, flags);
+		record(GL_CALL::FENCE_SYNC) << condition << flags << syncHandle(sync);
+		return sync;
+	}
+
+	GLenum APIENTRY capture_glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+	{
+		GLenum result = real_glClientWaitSync(sync, flags, timeout);
+		record(GL_CALL::CLIENT_WAIT_SYNC) << syncHandle(sync) << flags << static_cast<uint64_t>(timeout);
+		return result;
+	}
+
+	void APIENTRY capture_glDeleteSync(GLsync sync)
+	{
+		real_glDeleteSync(sync);
+		record(GL_CALL::DELETE_SYNC) << syncHandle(sync);
+	}
+
+	void APIENTRY capture_glNamedBufferData(GLuint buffer, GLsizeiptr size, const void* data, GLenum usage)
+	{
+		real_glNamedBufferData(buffer, size, data, usage);
+		record(GL_CALL::NAMED_BUFFER_DATA) << buffer << static_cast<int64_t>(size) << payload(data, static_cast<size_t>(size)) << usage;
+	}
+
+	void APIENTRY capture_glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+	{
+		real_glBufferData(target, size, data, usage);
+		record(GL_CALL::BUFFER_DATA) << target << static_cast<int64_t>(size) << payload(data, static_cast<size_t>(size)) << usage;
+	}
+
+	void APIENTRY capture_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+	{
+		real_glBufferSubData(target, offset, size, data);
+		record(GL_CALL::BUFFER_SUB_DATA) << target << static_cast<int64_t>(offset) << payload(data, static_cast<size_t>(size));
+	}
+
+	void APIENTRY capture_glClearNamedBufferData(GLuint buffer, GLenum internalformat, GLenum format, GLenum type, const void* data)
+	{
+		real_glClearNamedBufferData(buffer, internalformat, format, type, data);
+		record(GL_CALL::CLEAR_NAMED_BUFFER_DATA) << buffer << internalformat << format << type << payload(data, pixelSize(format, type));
+	}
+
+	void APIENTRY capture_glClearBufferData(GLenum target, GLenum internalformat, GLenum format, GLenum type, const void* data)
+	{
+		real_glClearBufferData(target, internalformat, format, type, data);
+		record(GL_CALL::CLEAR_BUFFER_DATA) << target << internalformat << format << type << payload(data, pixelSize(format, type));
+	}
+
+	void APIENTRY capture_glCopyNamedBufferSubData(GLuint readBuffer, GLuint writeBuffer, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size)
+	{
+		real_glCopyNamedBufferSubData(readBuffer, writeBuffer, readOffset, writeOffset, size);
+		record(GL_CALL::COPY_NAMED_BUFFER_SUB_DATA) << readBuffer << writeBuffer << static_cast<int64_t>(readOffset) <<
+			static_cast<int64_t>(writeOffset) << static_cast<int64_t>(size);
+	}
+
+	void APIENTRY capture_glCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size)
+	{
+		real_glCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+		record(GL_CALL::COPY_BUFFER_SUB_DATA) << readTarget << writeTarget << static_cast<int64_t>(readOffset) <<
+			static_cast<int64_t>(writeOffset) << static_cast<int64_t>(size);
+	}
+
+	void* APIENTRY capture_glMapNamedBuffer(GLuint buffer, GLenum access)
+	{
+		void* data = real_glMapNamedBuffer(buffer, access);
+		record(GL_CALL::MAP_NAMED_BUFFER) << buffer << access;
+
+		kengine::glCapture().mapRange(buffer, 0, bufferSize(buffer), accessBits(access), data);
+		return data;
+	}
+
+	void* APIENTRY capture_glMapBuffer(GLenum target, GLenum access)
+	{
+		GLuint buffer = boundBuffer(target);
+		void* data = real_glMapBuffer(target, access);
+		record(GL_CALL::MAP_BUFFER) << target << buffer << access;
+
+		kengine::glCapture().mapRange(buffer, 0, bufferSize(buffer), accessBits(access), data);
+		return data;
+	}
+
+	void* APIENTRY capture_glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+	{
+		GLuint buffer = boundBuffer(target);
+		void* data = real_glMapBufferRange(target, offset, length, access);
+		record(GL_CALL::MAP_BUFFER_RANGE) << target << buffer << static_cast<int64_t>(offset) << static_cast<int64_t>(length) << access;
+
+		kengine::glCapture().mapRange(buffer, offset, length, access, data);
+		return data;
+	}
+
+	GLboolean APIENTRY capture_glUnmapBuffer(GLenum target)
+	{
+		GLuint buffer = boundBuffer(target);
+		kengine::glCapture().unmapRange(buffer);
+
+		GLboolean result = real_glUnmapBuffer(target);
+		record(GL_CALL::UNMAP_BUFFER) << target << buffer;
+		return result;
+	}
+
+	void APIENTRY capture_glFlushMappedNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length)
+	{
+		kengine::glCapture().flushMappedRange(buffer, offset, length);
+
+		real_glFlushMappedNamedBufferRange(buffer, offset, length);
+		record(GL_CALL::FLUSH_MAPPED_NAMED_BUFFER_RANGE) << buffer << static_cast<int64_t>(offset) << static_cast<int64_t>(length);
+	}
+
+	void APIENTRY capture_glFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length)
+	{
+		kengine::glCapture().flushMappedRange(boundBuffer(target), offset, length);
+
+		real_glFlushMappedBufferRange(target, offset, length);
+		record(GL_CALL::FLUSH_MAPPED_BUFFER_RANGE) << target << static_cast<int64_t>(offset) << static_cast<int64_t>(length);
+	}
+
+	void APIENTRY capture_glInvalidateBufferData(GLuint buffer)
+	{
+		real_glInvalidateBufferData(buffer);
+		record(GL_CALL::INVALIDATE_BUFFER_DATA) << buffer;
+	}
+
+	void APIENTRY capture_glInvalidateBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr length)
+	{
+		real_glInvalidateBufferSubData(buffer, offset, length);
+		record(GL_CALL::INVALIDATE_BUFFER_SUB_DATA) << buffer << static_cast<int64_t>(offset) << static_cast<int64_t>(length);
+	}
+
+	void APIENTRY capture_glClearBufferfv(GLenum buffer, GLint drawbuffer, const GLfloat* value)
+	{
+		// a color has 4 values, the depth has 1
+		real_glClearBufferfv(buffer, drawbuffer, value);
+		record(GL_CALL::CLEAR_BUFFERFV) << buffer << drawbuffer << payload(value, sizeof(GLfloat) * (buffer == GL_COLOR ? 4 : 1));
+	}
+
+	void APIENTRY capture_glGenVertexArrays(GLsizei n, GLuint* arrays)
+	{
+		real_glGenVertexArrays(n, arrays);
+		record(GL_CALL::GEN_VERTEX_ARRAYS) << n << names(n, arrays);
+	}
+
+	void APIENTRY capture_glDisableVertexArrayAttrib(GLuint vaobj, GLuint index)
+	{
+		real_glDisableVertexArrayAttrib(vaobj, index);
+		record(GL_CALL::DISABLE_VERTEX_ARRAY_ATTRIB) << vaobj << index;
+	}
+
+	void APIENTRY capture_glDisableVertexAttribArray(GLuint index)
+	{
+		real_glDisableVertexAttribArray(index);
+		record(GL_CALL::DISABLE_VERTEX_ATTRIB_ARRAY) << index;
+	}
+
+	void APIENTRY capture_glVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer)
+	{
+		real_glVertexAttribIPointer(index, size, type, stride, pointer);
+		record(GL_CALL::VERTEX_ATTRIB_I_POINTER) << index << size << type << stride << static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+	}
+
+	void APIENTRY capture_glVertexAttribLPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer)
+	{
+		real_glVertexAttribLPointer(index, size, type, stride, pointer);
+		record(GL_CALL::VERTEX_ATTRIB_L_POINTER) << index << size << type << stride << static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+	}
+
+	void APIENTRY capture_glVertexArrayVertexBuffers(GLuint vaobj, GLuint first, GLsizei count, const GLuint* buffers, const GLintptr* offsets, const GLsizei* strides)
+	{
+		real_glVertexArrayVertexBuffers(vaobj, first, count, buffers, offsets, strides);
+
+		// the offsets are stored with 64 bits (as the other offsets of the trace)
+		std::vector<int64_t> offsets64;
+
+		if (offsets != nullptr)
+			offsets64.assign(offsets, offsets + count);
+
+		record(GL_CALL::VERTEX_ARRAY_VERTEX_BUFFERS) << vaobj << first << count << names(count, buffers) <<
+			payload(offsets != nullptr ? offsets64.data() : nullptr, sizeof(int64_t) * offsets64.size()) <<
+			payload(strides, sizeof(GLsizei) * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glVertexAttribFormat(GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset)
+	{
+		real_glVertexAttribFormat(attribindex, size, type, normalized, relativeoffset);
+		record(GL_CALL::VERTEX_ATTRIB_FORMAT) << attribindex << size << type << normalized << relativeoffset;
+	}
+
+	void APIENTRY capture_glVertexAttribBinding(GLuint attribindex, GLuint bindingindex)
+	{
+		real_glVertexAttribBinding(attribindex, bindingindex);
+		record(GL_CALL::VERTEX_ATTRIB_BINDING) << attribindex << bindingindex;
+	}
+
+	void APIENTRY capture_glBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+	{
+		real_glBindAttribLocation(program, index, name);
+		record(GL_CALL::BIND_ATTRIB_LOCATION) << program << index << payload(name, std::strlen(name) + 1);
+	}
+
+	void APIENTRY capture_glDrawArraysInstancedBaseInstance(GLenum mode, GLint first, GLsizei count, GLsizei instancecount, GLuint baseinstance)
+	{
+		real_glDrawArraysInstancedBaseInstance(mode, first, count, instancecount, baseinstance);
+		record(GL_CALL::DRAW_ARRAYS_INSTANCED_BASE_INSTANCE) << mode << first << count << instancecount << baseinstance;
+	}
+
+	void APIENTRY capture_glPrimitiveRestartIndex(GLuint index)
+	{
+		real_glPrimitiveRestartIndex(index);
+		record(GL_CALL::PRIMITIVE_RESTART_INDEX) << index;
+	}
+
+	void APIENTRY capture_glProgramUniform3f(GLuint program, GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+	{
+		real_glProgramUniform3f(program, location, v0, v1, v2);
+		record(GL_CALL::PROGRAM_UNIFORM_3F) << program << location << v0 << v1 << v2;
+	}
+
+	void APIENTRY capture_glActiveShaderProgram(GLuint pipeline, GLuint program)
+	{
+		real_glActiveShaderProgram(pipeline, program);
+		record(GL_CALL::ACTIVE_SHADER_PROGRAM) << pipeline << program;
+	}
+
+	void APIENTRY capture_glUniform1fv(GLint location, GLsizei count, const GLfloat* value)
+	{
+		real_glUniform1fv(location, count, value);
+		record(GL_CALL::UNIFORM_1FV) << location << count << payload(value, sizeof(GLfloat) * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+	{
+		real_glUniform2fv(location, count, value);
+		record(GL_CALL::UNIFORM_2FV) << location << count << payload(value, sizeof(GLfloat) * 2 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+	{
+		real_glUniform3fv(location, count, value);
+		record(GL_CALL::UNIFORM_3FV) << location << count << payload(value, sizeof(GLfloat) * 3 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+	{
+		real_glUniform4fv(location, count, value);
+		record(GL_CALL::UNIFORM_4FV) << location << count << payload(value, sizeof(GLfloat) * 4 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform1iv(GLint location, GLsizei count, const GLint* value)
+	{
+		real_glUniform1iv(location, count, value);
+		record(GL_CALL::UNIFORM_1IV) << location << count << payload(value, sizeof(GLint) * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform2iv(GLint location, GLsizei count, const GLint* value)
+	{
+		real_glUniform2iv(location, count, value);
+		record(GL_CALL::UNIFORM_2IV) << location << count << payload(value, sizeof(GLint) * 2 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform3iv(GLint location, GLsizei count, const GLint* value)
+	{
+		real_glUniform3iv(location, count, value);
+		record(GL_CALL::UNIFORM_3IV) << location << count << payload(value, sizeof(GLint) * 3 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform4iv(GLint location, GLsizei count, const GLint* value)
+	{
+		real_glUniform4iv(location, count, value);
+		record(GL_CALL::UNIFORM_4IV) << location << count << payload(value, sizeof(GLint) * 4 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform1uiv(GLint location, GLsizei count, const GLuint* value)
+	{
+		real_glUniform1uiv(location, count, value);
+		record(GL_CALL::UNIFORM_1UIV) << location << count << payload(value, sizeof(GLuint) * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform2uiv(GLint location, GLsizei count, const GLuint* value)
+	{
+		real_glUniform2uiv(location, count, value);
+		record(GL_CALL::UNIFORM_2UIV) << location << count << payload(value, sizeof(GLuint) * 2 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform3uiv(GLint location, GLsizei count, const GLuint* value)
+	{
+		real_glUniform3uiv(location, count, value);
+		record(GL_CALL::UNIFORM_3UIV) << location << count << payload(value, sizeof(GLuint) * 3 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform4uiv(GLint location, GLsizei count, const GLuint* value)
+	{
+		real_glUniform4uiv(location, count, value);
+		record(GL_CALL::UNIFORM_4UIV) << location << count << payload(value, sizeof(GLuint) * 4 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform1dv(GLint location, GLsizei count, const GLdouble* value)
+	{
+		real_glUniform1dv(location, count, value);
+		record(GL_CALL::UNIFORM_1DV) << location << count << payload(value, sizeof(GLdouble) * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform2dv(GLint location, GLsizei count, const GLdouble* value)
+	{
+		real_glUniform2dv(location, count, value);
+		record(GL_CALL::UNIFORM_2DV) << location << count << payload(value, sizeof(GLdouble) * 2 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform3dv(GLint location, GLsizei count, const GLdouble* value)
+	{
+		real_glUniform3dv(location, count, value);
+		record(GL_CALL::UNIFORM_3DV) << location << count << payload(value, sizeof(GLdouble) * 3 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniform4dv(GLint location, GLsizei count, const GLdouble* value)
+	{
+		real_glUniform4dv(location, count, value);
+		record(GL_CALL::UNIFORM_4DV) << location << count << payload(value, sizeof(GLdouble) * 4 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix2fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_2FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 4 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix3fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_3FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 9 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix2x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix2x3fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_2X3FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 6 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix3x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix3x2fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_3X2FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 6 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix2x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix2x4fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_2X4FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 8 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix4x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix4x2fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_4X2FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 8 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix3x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix3x4fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_3X4FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 12 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix4x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		real_glUniformMatrix4x3fv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_4X3FV) << location << count << transpose << payload(value, sizeof(GLfloat) * 12 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix2dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_2DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 4 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix3dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_3DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 9 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix4dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_4DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 16 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix2x3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix2x3dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_2X3DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 6 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix3x2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix3x2dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_3X2DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 6 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix2x4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix2x4dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_2X4DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 8 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix4x2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix4x2dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_4X2DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 8 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix3x4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix3x4dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_3X4DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 12 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glUniformMatrix4x3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble* value)
+	{
+		real_glUniformMatrix4x3dv(location, count, transpose, value);
+		record(GL_CALL::UNIFORM_MATRIX_4X3DV) << location << count << transpose << payload(value, sizeof(GLdouble) * 12 * static_cast<size_t>(count));
+	}
+
+	void APIENTRY capture_glCreateTextures(GLenum target, GLsizei n, GLuint* textures)
+	{
+		real_glCreateTextures(target, n, textures);
+		record(GL_CALL::CREATE_TEXTURES) << target << n << names(n, textures);
+	}
+
+	void APIENTRY capture_glTextureStorage2D(GLuint texture, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+	{
+		real_glTextureStorage2D(texture, levels, internalformat, width, height);
+		record(GL_CALL::TEXTURE_STORAGE_2D) << texture << levels << internalformat << width << height;
+	}
+
+	void APIENTRY capture_glTextureParameteri(GLuint texture, GLenum pname, GLint param)
+	{
+		real_glTextureParameteri(texture, pname, param);
+		record(GL_CALL::TEXTURE_PARAMETERI) << texture << pname << param;
+	}
+
+	void APIENTRY capture_glBindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format)
+	{
+		real_glBindImageTexture(unit, texture, level, layered, layer, access, format);
+		record(GL_CALL::BIND_IMAGE_TEXTURE) << unit << texture << level << layered << layer << access << format;
+	}
+
+	void APIENTRY capture_glNamedFramebufferTexture(GLuint framebuffer, GLenum attachment, GLuint texture, GLint level)
+	{
+		real_glNamedFramebufferTexture(framebuffer, attachment, texture, level);
+		record(GL_CALL::NAMED_FRAMEBUFFER_TEXTURE) << framebuffer << attachment << texture << level;
+	}
+
+	void APIENTRY capture_glBlitNamedFramebuffer(GLuint readFramebuffer, GLuint drawFramebuffer, GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1,
+		GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+	{
+		real_glBlitNamedFramebuffer(readFramebuffer, drawFramebuffer, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+		record(GL_CALL::BLIT_NAMED_FRAMEBUFFER) << readFramebuffer << drawFramebuffer << srcX0 << srcY0 << srcX1 << srcY1 <<
+			dstX0 << dstY0 << dstX1 << dstY1 << mask << filter;
+	}
+
+	void APIENTRY capture_glNamedFramebufferDrawBuffers(GLuint framebuffer, GLsizei n, const GLenum* bufs)
+	{
+		real_glNamedFramebufferDrawBuffers(framebuffer, n, bufs);
+		record(GL_CALL::NAMED_FRAMEBUFFER_DRAW_BUFFERS) << framebuffer << n << payload(bufs, sizeof(GLenum) * static_cast<size_t>(n));
+	}
+
+	void APIENTRY capture_glVertexArrayAttribIFormat(GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset)
+	{
+		real_glVertexArrayAttribIFormat(vaobj, attribindex, size, type, relativeoffset);
+		record(GL_CALL::VERTEX_ARRAY_ATTRIB_I_FORMAT) << vaobj << attribindex << size << type << relativeoffset;
+	}
+
+	void APIENTRY capture_glVertexArrayBindingDivisor(GLuint vaobj, GLuint bindingindex, GLuint divisor)
+	{
+		real_glVertexArrayBindingDivisor(vaobj, bindingindex, divisor);
+		record(GL_CALL::VERTEX_ARRAY_BINDING_DIVISOR) << vaobj << bindingindex << divisor;
+	}
+
+	void APIENTRY capture_glDispatchCompute(GLuint numGroupsX, GLuint numGroupsY, GLuint numGroupsZ)
+	{
+		real_glDispatchCompute(numGroupsX, numGroupsY, numGroupsZ);
+		record(GL_CALL::DISPATCH_COMPUTE) << numGroupsX << numGroupsY << numGroupsZ;
+	}
+
+	void APIENTRY capture_glMemoryBarrier(GLbitfield barriers)
+	{
+		real_glMemoryBarrier(barriers);
+		record(GL_CALL::MEMORY_BARRIER) << barriers;
+	}
+
+	void APIENTRY capture_glDrawArraysIndirect(GLenum mode, const void* indirect)
+	{
+		// the pointer is an offset into the bound GL_DRAW_INDIRECT_BUFFER
+		real_glDrawArraysIndirect(mode, indirect);
+		record(GL_CALL::DRAW_ARRAYS_INDIRECT) << mode << static_cast<uint64_t>(reinterpret_cast<uintptr_t>(indirect));
+	}
+
+	void APIENTRY capture_glMultiDrawArraysIndirect(GLenum mode, const void* indirect, GLsizei drawcount, GLsizei stride)
+	{
+		real_glMultiDrawArraysIndirect(mode, indirect, drawcount, stride);
+		record(GL_CALL::MULTI_DRAW_ARRAYS_INDIRECT) << mode << static_cast<uint64_t>(reinterpret_cast<uintptr_t>(indirect)) << drawcount << stride;
+	}
+
+	void APIENTRY capture_glTextureStorage3D(GLuint texture, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth)
+	{
+		real_glTextureStorage3D(texture, levels, internalformat, width, height, depth);
+		record(GL_CALL::TEXTURE_STORAGE_3D) << texture << levels << internalformat << width << height << depth;
+	}
+
+	void APIENTRY capture_glTextureSubImage3D(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height,
+		GLsizei depth, GLenum format, GLenum type, const void* pixels)
+	{
+		real_glTextureSubImage3D(texture, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels);
+		record(GL_CALL::TEXTURE_SUB_IMAGE_3D) << texture << level << xoffset << yoffset << zoffset << width << height << depth << format << type <<
+			static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pixels)) << imagePayload(format, type, width, height, depth, pixels);
+	}
+
+	void APIENTRY capture_glGenerateTextureMipmap(GLuint texture)
+	{
+		real_glGenerateTextureMipmap(texture);
+		record(GL_CALL::GENERATE_TEXTURE_MIPMAP) << texture;
+	}
+
+	void APIENTRY capture_glTextureSubImage2D(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+		GLenum format, GLenum type, const void* pixels)
+	{
+		real_glTextureSubImage2D(texture, level, xoffset, yoffset, width, height, format, type, pixels);
+		record(GL_CALL::TEXTURE_SUB_IMAGE_2D) << texture << level << xoffset << yoffset << width << height << format << type <<
+			static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pixels)) << imagePayload(format, type, width, height, 1, pixels);
+	}
+
+	void APIENTRY capture_glCopyImageSubData(GLuint srcName, GLenum srcTarget, GLint srcLevel, GLint srcX, GLint srcY, GLint srcZ,
+		GLuint dstName, GLenum dstTarget, GLint dstLevel, GLint dstX, GLint dstY, GLint dstZ, GLsizei srcWidth, GLsizei srcHeight, GLsizei srcDepth)
+	{
+		real_glCopyImageSubData(srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, srcWidth, srcHeight, srcDepth);
+		record(GL_CALL::COPY_IMAGE_SUB_DATA) << srcName << srcTarget << srcLevel << srcX << srcY << srcZ <<
+			dstName << dstTarget << dstLevel << dstX << dstY << dstZ << srcWidth << srcHeight << srcDepth;
+	}
+
+	void APIENTRY capture_glCreateSamplers(GLsizei n, GLuint* samplers)
+	{
+		real_glCreateSamplers(n, samplers);
+		record(GL_CALL::CREATE_SAMPLERS) << n << names(n, samplers);
+	}
+
+	void APIENTRY capture_glDeleteSamplers(GLsizei count, const GLuint* samplers)
+	{
+		real_glDeleteSamplers(count, samplers);
+		record(GL_CALL::DELETE_SAMPLERS) << count << names(count, samplers);
+	}
+
+	void APIENTRY capture_glSamplerParameteri(GLuint sampler, GLenum pname, GLint param)
+	{
+		real_glSamplerParameteri(sampler, pname, param);
+		record(GL_CALL::SAMPLER_PARAMETERI) << sampler << pname << param;
+	}
+
+	void APIENTRY capture_glSamplerParameterf(GLuint sampler, GLenum pname, GLfloat param)
+	{
+		real_glSamplerParameterf(sampler, pname, param);
+		record(GL_CALL::SAMPLER_PARAMETERF) << sampler << pname << param;
+	}
+
+#ifndef __ANDROID__
+	void APIENTRY capture_glClear(GLbitfield mask)
+	{
+		real_glClear(mask);
+		record(GL_CALL::CLEAR) << mask;
+	}
+
+	void APIENTRY capture_glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+	{
+		real_glClearColor(red, green, blue, alpha);
+		record(GL_CALL::CLEAR_COLOR) << red << green << blue << alpha;
+	}
+
+	void APIENTRY capture_glDrawArrays(GLenum mode, GLint first, GLsizei count)
+	{
+		real_glDrawArrays(mode, first, count);
+		record(GL_CALL::DRAW_ARRAYS) << mode << first << count;
+	}
+
+	void APIENTRY capture_glEnable(GLenum capability)
+	{
+		real_glEnable(capability);
+		record(GL_CALL::ENABLE) << capability;
+	}
+
+	void APIENTRY capture_glDisable(GLenum capability)
+	{
+		real_glDisable(capability);
+		record(GL_CALL::DISABLE) << capability;
+	}
+
+	void APIENTRY capture_glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		real_glViewport(x, y, width, height);
+		record(GL_CALL::VIEWPORT) << x << y << width << height;
+	}
+
+	void APIENTRY capture_glPolygonMode(GLenum face, GLenum mode)
+	{
+		real_glPolygonMode(face, mode);
+		record(GL_CALL::POLYGON_MODE) << face << mode;
+	}
+
+	void APIENTRY capture_glDepthFunc(GLenum func)
+	{
+		real_glDepthFunc(func);
+		record(GL_CALL::DEPTH_FUNC) << func;
+	}
+
+	void APIENTRY capture_glDepthMask(GLboolean flag)
+	{
+		real_glDepthMask(flag);
+		record(GL_CALL::DEPTH_MASK) << flag;
+	}
+
+	void APIENTRY capture_glCullFace(GLenum mode)
+	{
+		real_glCullFace(mode);
+		record(GL_CALL::CULL_FACE) << mode;
+	}
+
+	void APIENTRY capture_glFrontFace(GLenum mode)
+	{
+		real_glFrontFace(mode);
+		record(GL_CALL::FRONT_FACE) << mode;
+	}
+
+	void APIENTRY capture_glLineWidth(GLfloat width)
+	{
+		real_glLineWidth(width);
+		record(GL_CALL::LINE_WIDTH) << width;
+	}
+
+	void APIENTRY capture_glPointSize(GLfloat size)
+	{
+		real_glPointSize(size);
+		record(GL_CALL::POINT_SIZE) << size;
+	}
+
+	void APIENTRY capture_glDeleteTextures(GLsizei n, const GLuint* textures)
+	{
+		real_glDeleteTextures(n, textures);
+		record(GL_CALL::DELETE_TEXTURES) << n << names(n, textures);
+	}
+
+	void APIENTRY capture_glPixelStorei(GLenum pname, GLint param)
+	{
+		real_glPixelStorei(pname, param);
+		record(GL_CALL::PIXEL_STOREI) << pname << param;
+	}
+#endif
+}
+
+/*
+	The pointer is only saved if it is not the recording function (attach can be called twice without a reload)
+*/
+#define K_CAPTURE_INSTALL(pointer, name) if (pointer != capture_##name) real_##name = pointer; pointer = capture_##name;
+#define K_CAPTURE_UNINSTALL(pointer, name) pointer = real_##name;
+
+/*
+	kengine::gl_capture class - member class definition
+*/
+
+kengine::gl_capture::~gl_capture()
+{
+	stop();
+}
+
+bool kengine::gl_capture::start(const std::string& filename, unsigned int frameCount)
+{
+	stop();
+
+	FILE* file = std::fopen(filename.c_str(), "wb");
+
+	if (file == nullptr) {
+		K_LOG_OUTPUT_RAW("gl_capture: it was not possible to create the trace " << filename);
+		return false;
+	}
+
+	gl_trace_header header;
+	std::fwrite(&header, sizeof(header), 1, file);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_file = file;
+		m_frameCount = frameCount;
+		m_stats = gl_capture_stats();
+		m_stats.bytes = sizeof(header);
+	}
+
+	// the functions are installed by getAllGLProcedures if they are not loaded yet
+	if (glCreateBuffers != nullptr)
+		install();
+
+	K_LOG_OUTPUT_RAW("gl_capture: capturing to " << filename);
+	return true;
+}
+
+void kengine::gl_capture::stop()
+{
+	uninstall();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_file == nullptr)
+		return;
+
+	std::fclose(m_file);
+	m_file = nullptr;
+	m_mappedRanges.clear();
+
+	K_LOG_OUTPUT_RAW("gl_capture: " << m_stats.frames << " frames, " << m_stats.calls << " calls and " << m_stats.bytes << " bytes captured");
+}
+
+void kengine::gl_capture::attach()
+{
+	if (!m_environmentChecked) {
+		m_environmentChecked = true;
+
+		const char* filename = std::getenv("KENGINE_GL_CAPTURE");
+		const char* frames = std::getenv("KENGINE_GL_CAPTURE_FRAMES");
+
+		if (filename != nullptr && filename[0] != '\0' && !isCapturing())
+			start(filename, frames != nullptr ? static_cast<unsigned int>(std::atoi(frames)) : 60);
+	}
+
+	if (isCapturing())
+		install();
+}
+
+void kengine::gl_capture::newFrame()
+{
+	if (!isCapturing())
+		return;
+
+	if (m_frameCount != 0 && m_stats.frames >= m_frameCount) {
+		stop();
+		return;
+	}
+
+	write(GL_CALL::FRAME, std::vector<unsigned char>());
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.frames++;
+}
+
+kengine::gl_capture_stats kengine::gl_capture::getStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void kengine::gl_capture::write(GL_CALL call, const std::vector<unsigned char>& arguments)
+{
+	gl_trace_record header;
+	header.call = static_cast<uint16_t>(call);
+	header.size = static_cast<uint32_t>(arguments.size());
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_file == nullptr)
+		return;
+
+	std::fwrite(&header, sizeof(header), 1, m_file);
+
+	if (!arguments.empty())
+		std::fwrite(arguments.data(), 1, arguments.size(), m_file);
+
+	m_stats.calls++;
+	m_stats.bytes += sizeof(header) + arguments.size();
+}
+
+void kengine::gl_capture::mapRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access, void* data)
+{
+	if (data == nullptr)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	mapped_range& range = m_mappedRanges[buffer];
+	range.offset = offset;
+	range.length = length;
+	range.access = access;
+	range.data = static_cast<unsigned char*>(data);
+}
+
+void kengine::gl_capture::unmapRange(GLuint buffer)
+{
+	mapped_range range;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_mappedRanges.find(buffer);
+
+		if (it == m_mappedRanges.end())
+			return;
+
+		range = it->second;
+		m_mappedRanges.erase(it);
+	}
+
+	// the unmap flushes the whole range, unless the application flushes it (or writes it persistently)
+	if ((range.access & GL_MAP_WRITE_BIT) != 0 && (range.access & (GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT)) == 0)
+		record(GL_CALL::MAPPED_DATA) << buffer << static_cast<int64_t>(range.offset) << payload(range.data, static_cast<size_t>(range.length));
+}
+
+void kengine::gl_capture::writeMappedRange(GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	const unsigned char* data = nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_mappedRanges.find(buffer);
+
+		if (it == m_mappedRanges.end() || offset < it->second.offset || offset + size > it->second.offset + it->second.length)
+			return;
+
+		data = it->second.data + (offset - it->second.offset);
+	}
+
+	record(GL_CALL::MAPPED_DATA) << buffer << static_cast<int64_t>(offset) << payload(data, static_cast<size_t>(size));
+}
+
+void kengine::gl_capture::flushMappedRange(GLuint buffer, GLintptr offset, GLsizeiptr length)
+{
+	GLintptr mappedOffset = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_mappedRanges.find(buffer);
+
+		if (it == m_mappedRanges.end())
+			return;
+
+		mappedOffset = it->second.offset;
+	}
+
+	// the offset of the flush is relative to the mapped range
+	writeMappedRange(buffer, mappedOffset + offset, length);
+}
+
+void kengine::gl_capture::install()
+{
+	K_CAPTURE_INSTALL(glCreateBuffers, glCreateBuffers);
+	K_CAPTURE_INSTALL(glGenBuffers, glGenBuffers);
+	K_CAPTURE_INSTALL(glDeleteBuffers, glDeleteBuffers);
+	K_CAPTURE_INSTALL(glBindBuffer, glBindBuffer);
+	K_CAPTURE_INSTALL(glNamedBufferStorage, glNamedBufferStorage);
+	K_CAPTURE_INSTALL(glBufferStorage, glBufferStorage);
+	K_CAPTURE_INSTALL(glNamedBufferSubData, glNamedBufferSubData);
+	K_CAPTURE_INSTALL(glMapNamedBufferRange, glMapNamedBufferRange);
+	K_CAPTURE_INSTALL(glUnmapNamedBuffer, glUnmapNamedBuffer);
+	K_CAPTURE_INSTALL(glBindBufferBase, glBindBufferBase);
+	K_CAPTURE_INSTALL(glBindBufferRange, glBindBufferRange);
+	K_CAPTURE_INSTALL(glCreateVertexArrays, glCreateVertexArrays);
+	K_CAPTURE_INSTALL(glDeleteVertexArrays, glDeleteVertexArrays);
+	K_CAPTURE_INSTALL(glBindVertexArray, glBindVertexArray);
+	K_CAPTURE_INSTALL(glEnableVertexArrayAttrib, glEnableVertexArrayAttrib);
+	K_CAPTURE_INSTALL(glVertexArrayAttribFormat, glVertexArrayAttribFormat);
+	K_CAPTURE_INSTALL(glVertexArrayAttribBinding, glVertexArrayAttribBinding);
+	K_CAPTURE_INSTALL(glVertexArrayVertexBuffer, glVertexArrayVertexBuffer);
+	K_CAPTURE_INSTALL(glBindVertexBuffer, glBindVertexBuffer);
+	K_CAPTURE_INSTALL(glEnableVertexAttribArray, glEnableVertexAttribArray);
+	K_CAPTURE_INSTALL(glVertexAttribPointer, glVertexAttribPointer);
+	K_CAPTURE_INSTALL(glCreateShader, glCreateShader);
+	K_CAPTURE_INSTALL(glShaderSource, glShaderSource);
+	K_CAPTURE_INSTALL(glCompileShader, glCompileShader);
+	K_CAPTURE_INSTALL(glShaderBinary, glShaderBinary);
+	K_CAPTURE_INSTALL(glSpecializeShader, glSpecializeShader);
+	K_CAPTURE_INSTALL(glDeleteShader, glDeleteShader);
+	K_CAPTURE_INSTALL(glCreateProgram, glCreateProgram);
+	K_CAPTURE_INSTALL(glAttachShader, glAttachShader);
+	K_CAPTURE_INSTALL(glDetachShader, glDetachShader);
+	K_CAPTURE_INSTALL(glProgramParameteri, glProgramParameteri);
+	K_CAPTURE_INSTALL(glLinkProgram, glLinkProgram);
+	K_CAPTURE_INSTALL(glProgramBinary, glProgramBinary);
+	K_CAPTURE_INSTALL(glDeleteProgram, glDeleteProgram);
+	K_CAPTURE_INSTALL(glUseProgram, glUseProgram);
+	K_CAPTURE_INSTALL(glCreateShaderProgramv, glCreateShaderProgramv);
+	K_CAPTURE_INSTALL(glCreateProgramPipelines, glCreateProgramPipelines);
+	K_CAPTURE_INSTALL(glDeleteProgramPipelines, glDeleteProgramPipelines);
+	K_CAPTURE_INSTALL(glUseProgramStages, glUseProgramStages);
+	K_CAPTURE_INSTALL(glBindProgramPipeline, glBindProgramPipeline);
+	K_CAPTURE_INSTALL(glUniformMatrix4fv, glUniformMatrix4fv);
+	K_CAPTURE_INSTALL(glBindTextureUnit, glBindTextureUnit);
+	K_CAPTURE_INSTALL(glBindSampler, glBindSampler);
+	K_CAPTURE_INSTALL(glBlendFuncSeparate, glBlendFuncSeparate);
+	K_CAPTURE_INSTALL(glBlendEquationSeparate, glBlendEquationSeparate);
+	K_CAPTURE_INSTALL(glCreateFramebuffers, glCreateFramebuffers);
+	K_CAPTURE_INSTALL(glDeleteFramebuffers, glDeleteFramebuffers);
+	K_CAPTURE_INSTALL(glBindFramebuffer, glBindFramebuffer);
+	K_CAPTURE_INSTALL(glCreateRenderbuffers, glCreateRenderbuffers);
+	K_CAPTURE_INSTALL(glDeleteRenderbuffers, glDeleteRenderbuffers);
+	K_CAPTURE_INSTALL(glNamedRenderbufferStorage, glNamedRenderbufferStorage);
+	K_CAPTURE_INSTALL(glNamedFramebufferRenderbuffer, glNamedFramebufferRenderbuffer);
+	K_CAPTURE_INSTALL(glFenceSync, glFenceSync);
+	K_CAPTURE_INSTALL(glClientWaitSync, glClientWaitSync);
+	K_CAPTURE_INSTALL(glDeleteSync, glDeleteSync);
+	K_CAPTURE_INSTALL(glNamedBufferData, glNamedBufferData);
+	K_CAPTURE_INSTALL(glBufferData, glBufferData);
+	K_CAPTURE_INSTALL(glBufferSubData, glBufferSubData);
+	K_CAPTURE_INSTALL(glClearNamedBufferData, glClearNamedBufferData);
+	K_CAPTURE_INSTALL(glClearBufferData, glClearBufferData);
+	K_CAPTURE_INSTALL(glCopyNamedBufferSubData, glCopyNamedBufferSubData);
+	K_CAPTURE_INSTALL(glCopyBufferSubData, glCopyBufferSubData);
+	K_CAPTURE_INSTALL(glMapNamedBuffer, glMapNamedBuffer);
+	K_CAPTURE_INSTALL(glMapBuffer, glMapBuffer);
+	K_CAPTURE_INSTALL(glMapBufferRange, glMapBufferRange);
+	K_CAPTURE_INSTALL(glUnmapBuffer, glUnmapBuffer);
+	K_CAPTURE_INSTALL(glFlushMappedNamedBufferRange, glFlushMappedNamedBufferRange);
+	K_CAPTURE_INSTALL(glFlushMappedBufferRange, glFlushMappedBufferRange);
+	K_CAPTURE_INSTALL(glInvalidateBufferData, glInvalidateBufferData);
+	K_CAPTURE_INSTALL(glInvalidateBufferSubData, glInvalidateBufferSubData);
+	K_CAPTURE_INSTALL(glClearBufferfv, glClearBufferfv);
+	K_CAPTURE_INSTALL(glGenVertexArrays, glGenVertexArrays);
+	K_CAPTURE_INSTALL(glDisableVertexArrayAttrib, glDisableVertexArrayAttrib);
+	K_CAPTURE_INSTALL(glDisableVertexAttribArray, glDisableVertexAttribArray);
+	K_CAPTURE_INSTALL(glVertexAttribIPointer, glVertexAttribIPointer);
+	K_CAPTURE_INSTALL(glVertexAttribLPointer, glVertexAttribLPointer);
+	K_CAPTURE_INSTALL(glVertexArrayVertexBuffers, glVertexArrayVertexBuffers);
+	K_CAPTURE_INSTALL(glVertexAttribFormat, glVertexAttribFormat);
+	K_CAPTURE_INSTALL(glVertexAttribBinding, glVertexAttribBinding);
+	K_CAPTURE_INSTALL(glBindAttribLocation, glBindAttribLocation);
+	K_CAPTURE_INSTALL(glDrawArraysInstancedBaseInstance, glDrawArraysInstancedBaseInstance);
+	K_CAPTURE_INSTALL(glPrimitiveRestartIndex, glPrimitiveRestartIndex);
+	K_CAPTURE_INSTALL(glProgramUniform3f, glProgramUniform3f);
+	K_CAPTURE_INSTALL(glActiveShaderProgram, glActiveShaderProgram);
+	K_CAPTURE_INSTALL(glUniform1fv, glUniform1fv);
+	K_CAPTURE_INSTALL(glUniform2fv, glUniform2fv);
+	K_CAPTURE_INSTALL(glUniform3fv, glUniform3fv);
+	K_CAPTURE_INSTALL(glUniform4fv, glUniform4fv);
+	K_CAPTURE_INSTALL(glUniform1iv, glUniform1iv);
+	K_CAPTURE_INSTALL(glUniform2iv, glUniform2iv);
+	K_CAPTURE_INSTALL(glUniform3iv, glUniform3iv);
+	K_CAPTURE_INSTALL(glUniform4iv, glUniform4iv);
+	K_CAPTURE_INSTALL(glUniform1uiv, glUniform1uiv);
+	K_CAPTURE_INSTALL(glUniform2uiv, glUniform2uiv);
+	K_CAPTURE_INSTALL(glUniform3uiv, glUniform3uiv);
+	K_CAPTURE_INSTALL(glUniform4uiv, glUniform4uiv);
+	K_CAPTURE_INSTALL(glUniform1dv, glUniform1dv);
+	K_CAPTURE_INSTALL(glUniform2dv, glUniform2dv);
+	K_CAPTURE_INSTALL(glUniform3dv, glUniform3dv);
+	K_CAPTURE_INSTALL(glUniform4dv, glUniform4dv);
+	K_CAPTURE_INSTALL(glUniformMatrix2fv, glUniformMatrix2fv);
+	K_CAPTURE_INSTALL(glUniformMatrix3fv, glUniformMatrix3fv);
+	K_CAPTURE_INSTALL(glUniformMatrix2x3fv, glUniformMatrix2x3fv);
+	K_CAPTURE_INSTALL(glUniformMatrix3x2fv, glUniformMatrix3x2fv);
+	K_CAPTURE_INSTALL(glUniformMatrix2x4fv, glUniformMatrix2x4fv);
+	K_CAPTURE_INSTALL(glUniformMatrix4x2fv, glUniformMatrix4x2fv);
+	K_CAPTURE_INSTALL(glUniformMatrix3x4fv, glUniformMatrix3x4fv);
+	K_CAPTURE_INSTALL(glUniformMatrix4x3fv, glUniformMatrix4x3fv);
+	K_CAPTURE_INSTALL(glUniformMatrix2dv, glUniformMatrix2dv);
+	K_CAPTURE_INSTALL(glUniformMatrix3dv, glUniformMatrix3dv);
+	K_CAPTURE_INSTALL(glUniformMatrix4dv, glUniformMatrix4dv);
+	K_CAPTURE_INSTALL(glUniformMatrix2x3dv, glUniformMatrix2x3dv);
+	K_CAPTURE_INSTALL(glUniformMatrix3x2dv, glUniformMatrix3x2dv);
+	K_CAPTURE_INSTALL(glUniformMatrix2x4dv, glUniformMatrix2x4dv);
+	K_CAPTURE_INSTALL(glUniformMatrix4x2dv, glUniformMatrix4x2dv);
+	K_CAPTURE_INSTALL(glUniformMatrix3x4dv, glUniformMatrix3x4dv);
+	K_CAPTURE_INSTALL(glUniformMatrix4x3dv, glUniformMatrix4x3dv);
+	K_CAPTURE_INSTALL(glCreateTextures, glCreateTextures);
+	K_CAPTURE_INSTALL(glTextureStorage2D, glTextureStorage2D);
+	K_CAPTURE_INSTALL(glTextureParameteri, glTextureParameteri);
+	K_CAPTURE_INSTALL(glBindImageTexture, glBindImageTexture);
+	K_CAPTURE_INSTALL(glNamedFramebufferTexture, glNamedFramebufferTexture);
+	K_CAPTURE_INSTALL(glBlitNamedFramebuffer, glBlitNamedFramebuffer);
+	K_CAPTURE_INSTALL(glNamedFramebufferDrawBuffers, glNamedFramebufferDrawBuffers);
+	K_CAPTURE_INSTALL(glVertexArrayAttribIFormat, glVertexArrayAttribIFormat);
+	K_CAPTURE_INSTALL(glVertexArrayBindingDivisor, glVertexArrayBindingDivisor);
+	K_CAPTURE_INSTALL(glDispatchCompute, glDispatchCompute);
+	K_CAPTURE_INSTALL(glMemoryBarrier, glMemoryBarrier);
+	K_CAPTURE_INSTALL(glDrawArraysIndirect, glDrawArraysIndirect);
+	K_CAPTURE_INSTALL(glMultiDrawArraysIndirect, glMultiDrawArraysIndirect);
+	K_CAPTURE_INSTALL(glTextureStorage3D, glTextureStorage3D);
+	K_CAPTURE_INSTALL(glTextureSubImage3D, glTextureSubImage3D);
+	K_CAPTURE_INSTALL(glGenerateTextureMipmap, glGenerateTextureMipmap);
+	K_CAPTURE_INSTALL(glTextureSubImage2D, glTextureSubImage2D);
+	K_CAPTURE_INSTALL(glCopyImageSubData, glCopyImageSubData);
+	K_CAPTURE_INSTALL(glCreateSamplers, glCreateSamplers);
+	K_CAPTURE_INSTALL(glDeleteSamplers, glDeleteSamplers);
+	K_CAPTURE_INSTALL(glSamplerParameteri, glSamplerParameteri);
+	K_CAPTURE_INSTALL(glSamplerParameterf, glSamplerParameterf);
+
+#ifndef __ANDROID__
+	K_CAPTURE_INSTALL(kglClear, glClear);
+	K_CAPTURE_INSTALL(kglClearColor, glClearColor);
+	K_CAPTURE_INSTALL(kglDrawArrays, glDrawArrays);
+	K_CAPTURE_INSTALL(kglEnable, glEnable);
+	K_CAPTURE_INSTALL(kglDisable, glDisable);
+	K_CAPTURE_INSTALL(kglViewport, glViewport);
+	K_CAPTURE_INSTALL(kglPolygonMode, glPolygonMode);
+	K_CAPTURE_INSTALL(kglDepthFunc, glDepthFunc);
+	K_CAPTURE_INSTALL(kglDepthMask, glDepthMask);
+	K_CAPTURE_INSTALL(kglCullFace, glCullFace);
+	K_CAPTURE_INSTALL(kglFrontFace, glFrontFace);
+	K_CAPTURE_INSTALL(kglLineWidth, glLineWidth);
+	K_CAPTURE_INSTALL(kglPointSize, glPointSize);
+	K_CAPTURE_INSTALL(kglDeleteTextures, glDeleteTextures);
+	K_CAPTURE_INSTALL(kglPixelStorei, glPixelStorei);
+#endif
+
+	m_installed = true;
+}
+
+void kengine::gl_capture::uninstall()
+{
+	if (!m_installed)
+		return;
+
+	K_CAPTURE_UNINSTALL(glCreateBuffers, glCreateBuffers);
+	K_CAPTURE_UNINSTALL(glGenBuffers, glGenBuffers);
+	K_CAPTURE_UNINSTALL(glDeleteBuffers, glDeleteBuffers);
+	K_CAPTURE_UNINSTALL(glBindBuffer, glBindBuffer);
+	K_CAPTURE_UNINSTALL(glNamedBufferStorage, glNamedBufferStorage);
+	K_CAPTURE_UNINSTALL(glBufferStorage, glBufferStorage);
+	K_CAPTURE_UNINSTALL(glNamedBufferSubData, glNamedBufferSubData);
+	K_CAPTURE_UNINSTALL(glMapNamedBufferRange, glMapNamedBufferRange);
+	K_CAPTURE_UNINSTALL(glUnmapNamedBuffer, glUnmapNamedBuffer);
+	K_CAPTURE_UNINSTALL(glBindBufferBase, glBindBufferBase);
+	K_CAPTURE_UNINSTALL(glBindBufferRange, glBindBufferRange);
+	K_CAPTURE_UNINSTALL(glCreateVertexArrays, glCreateVertexArrays);
+	K_CAPTURE_UNINSTALL(glDeleteVertexArrays, glDeleteVertexArrays);
+	K_CAPTURE_UNINSTALL(glBindVertexArray, glBindVertexArray);
+	K_CAPTURE_UNINSTALL(glEnableVertexArrayAttrib, glEnableVertexArrayAttrib);
+	K_CAPTURE_UNINSTALL(glVertexArrayAttribFormat, glVertexArrayAttribFormat);
+	K_CAPTURE_UNINSTALL(glVertexArrayAttribBinding, glVertexArrayAttribBinding);
+	K_CAPTURE_UNINSTALL(glVertexArrayVertexBuffer, glVertexArrayVertexBuffer);
+	K_CAPTURE_UNINSTALL(glBindVertexBuffer, glBindVertexBuffer);
+	K_CAPTURE_UNINSTALL(glEnableVertexAttribArray, glEnableVertexAttribArray);
+	K_CAPTURE_UNINSTALL(glVertexAttribPointer, glVertexAttribPointer);
+	K_CAPTURE_UNINSTALL(glCreateShader, glCreateShader);
+	K_CAPTURE_UNINSTALL(glShaderSource, glShaderSource);
+	K_CAPTURE_UNINSTALL(glCompileShader, glCompileShader);
+	K_CAPTURE_UNINSTALL(glShaderBinary, glShaderBinary);
+	K_CAPTURE_UNINSTALL(glSpecializeShader, glSpecializeShader);
+	K_CAPTURE_UNINSTALL(glDeleteShader, glDeleteShader);
+	K_CAPTURE_UNINSTALL(glCreateProgram, glCreateProgram);
+	K_CAPTURE_UNINSTALL(glAttachShader, glAttachShader);
+	K_CAPTURE_UNINSTALL(glDetachShader, glDetachShader);
+	K_CAPTURE_UNINSTALL(glProgramParameteri, glProgramParameteri);
+	K_CAPTURE_UNINSTALL(glLinkProgram, glLinkProgram);
+	K_CAPTURE_UNINSTALL(glProgramBinary, glProgramBinary);
+	K_CAPTURE_UNINSTALL(glDeleteProgram, glDeleteProgram);
+	K_CAPTURE_UNINSTALL(glUseProgram, glUseProgram);
+	K_CAPTURE_UNINSTALL(glCreateShaderProgramv, glCreateShaderProgramv);
+	K_CAPTURE_UNINSTALL(glCreateProgramPipelines, glCreateProgramPipelines);
+	K_CAPTURE_UNINSTALL(glDeleteProgramPipelines, glDeleteProgramPipelines);
+	K_CAPTURE_UNINSTALL(glUseProgramStages, glUseProgramStages);
+	K_CAPTURE_UNINSTALL(glBindProgramPipeline, glBindProgramPipeline);
+	K_CAPTURE_UNINSTALL(glUniformMatrix4fv, glUniformMatrix4fv);
+	K_CAPTURE_UNINSTALL(glBindTextureUnit, glBindTextureUnit);
+	K_CAPTURE_UNINSTALL(glBindSampler, glBindSampler);
+	K_CAPTURE_UNINSTALL(glBlendFuncSeparate, glBlendFuncSeparate);
+	K_CAPTURE_UNINSTALL(glBlendEquationSeparate, glBlendEquationSeparate);
+	K_CAPTURE_UNINSTALL(glCreateFramebuffers, glCreateFramebuffers);
+	K_CAPTURE_UNINSTALL(glDeleteFramebuffers, glDeleteFramebuffers);
+	K_CAPTURE_UNINSTALL(glBindFramebuffer, glBindFramebuffer);
+	K_CAPTURE_UNINSTALL(glCreateRenderbuffers, glCreateRenderbuffers);
+	K_CAPTURE_UNINSTALL(glDeleteRenderbuffers, glDeleteRenderbuffers);
+	K_CAPTURE_UNINSTALL(glNamedRenderbufferStorage, glNamedRenderbufferStorage);
+	K_CAPTURE_UNINSTALL(glNamedFramebufferRenderbuffer, glNamedFramebufferRenderbuffer);
+	K_CAPTURE_UNINSTALL(glFenceSync, glFenceSync);
+	K_CAPTURE_UNINSTALL(glClientWaitSync, glClientWaitSync);
+	K_CAPTURE_UNINSTALL(glDeleteSync, glDeleteSync);
+	K_CAPTURE_UNINSTALL(glNamedBufferData, glNamedBufferData);
+	K_CAPTURE_UNINSTALL(glBufferData, glBufferData);
+	K_CAPTURE_UNINSTALL(glBufferSubData, glBufferSubData);
+	K_CAPTURE_UNINSTALL(glClearNamedBufferData, glClearNamedBufferData);
+	K_CAPTURE_UNINSTALL(glClearBufferData, glClearBufferData);
+	K_CAPTURE_UNINSTALL(glCopyNamedBufferSubData, glCopyNamedBufferSubData);
+	K_CAPTURE_UNINSTALL(glCopyBufferSubData, glCopyBufferSubData);
+	K_CAPTURE_UNINSTALL(glMapNamedBuffer, glMapNamedBuffer);
+	K_CAPTURE_UNINSTALL(glMapBuffer, glMapBuffer);
+	K_CAPTURE_UNINSTALL(glMapBufferRange, glMapBufferRange);
+	K_CAPTURE_UNINSTALL(glUnmapBuffer, glUnmapBuffer);
+	K_CAPTURE_UNINSTALL(glFlushMappedNamedBufferRange, glFlushMappedNamedBufferRange);
+	K_CAPTURE_UNINSTALL(glFlushMappedBufferRange, glFlushMappedBufferRange);
+	K_CAPTURE_UNINSTALL(glInvalidateBufferData, glInvalidateBufferData);
+	K_CAPTURE_UNINSTALL(glInvalidateBufferSubData, glInvalidateBufferSubData);
+	K_CAPTURE_UNINSTALL(glClearBufferfv, glClearBufferfv);
+	K_CAPTURE_UNINSTALL(glGenVertexArrays, glGenVertexArrays);
+	K_CAPTURE_UNINSTALL(glDisableVertexArrayAttrib, glDisableVertexArrayAttrib);
+	K_CAPTURE_UNINSTALL(glDisableVertexAttribArray, glDisableVertexAttribArray);
+	K_CAPTURE_UNINSTALL(glVertexAttribIPointer, glVertexAttribIPointer);
+	K_CAPTURE_UNINSTALL(glVertexAttribLPointer, glVertexAttribLPointer);
+	K_CAPTURE_UNINSTALL(glVertexArrayVertexBuffers, glVertexArrayVertexBuffers);
+	K_CAPTURE_UNINSTALL(glVertexAttribFormat, glVertexAttribFormat);
+	K_CAPTURE_UNINSTALL(glVertexAttribBinding, glVertexAttribBinding);
+	K_CAPTURE_UNINSTALL(glBindAttribLocation, glBindAttribLocation);
+	K_CAPTURE_UNINSTALL(glDrawArraysInstancedBaseInstance, glDrawArraysInstancedBaseInstance);
+	K_CAPTURE_UNINSTALL(glPrimitiveRestartIndex, glPrimitiveRestartIndex);
+	K_CAPTURE_UNINSTALL(glProgramUniform3f, glProgramUniform3f);
+	K_CAPTURE_UNINSTALL(glActiveShaderProgram, glActiveShaderProgram);
+	K_CAPTURE_UNINSTALL(glUniform1fv, glUniform1fv);
+	K_CAPTURE_UNINSTALL(glUniform2fv, glUniform2fv);
+	K_CAPTURE_UNINSTALL(glUniform3fv, glUniform3fv);
+	K_CAPTURE_UNINSTALL(glUniform4fv, glUniform4fv);
+	K_CAPTURE_UNINSTALL(glUniform1iv, glUniform1iv);
+	K_CAPTURE_UNINSTALL(glUniform2iv, glUniform2iv);
+	K_CAPTURE_UNINSTALL(glUniform3iv, glUniform3iv);
+	K_CAPTURE_UNINSTALL(glUniform4iv, glUniform4iv);
+	K_CAPTURE_UNINSTALL(glUniform1uiv, glUniform1uiv);
+	K_CAPTURE_UNINSTALL(glUniform2uiv, glUniform2uiv);
+	K_CAPTURE_UNINSTALL(glUniform3uiv, glUniform3uiv);
+	K_CAPTURE_UNINSTALL(glUniform4uiv, glUniform4uiv);
+	K_CAPTURE_UNINSTALL(glUniform1dv, glUniform1dv);
+	K_CAPTURE_UNINSTALL(glUniform2dv, glUniform2dv);
+	K_CAPTURE_UNINSTALL(glUniform3dv, glUniform3dv);
+	K_CAPTURE_UNINSTALL(glUniform4dv, glUniform4dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix2fv, glUniformMatrix2fv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix3fv, glUniformMatrix3fv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix2x3fv, glUniformMatrix2x3fv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix3x2fv, glUniformMatrix3x2fv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix2x4fv, glUniformMatrix2x4fv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix4x2fv, glUniformMatrix4x2fv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix3x4fv, glUniformMatrix3x4fv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix4x3fv, glUniformMatrix4x3fv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix2dv, glUniformMatrix2dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix3dv, glUniformMatrix3dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix4dv, glUniformMatrix4dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix2x3dv, glUniformMatrix2x3dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix3x2dv, glUniformMatrix3x2dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix2x4dv, glUniformMatrix2x4dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix4x2dv, glUniformMatrix4x2dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix3x4dv, glUniformMatrix3x4dv);
+	K_CAPTURE_UNINSTALL(glUniformMatrix4x3dv, glUniformMatrix4x3dv);
+	K_CAPTURE_UNINSTALL(glCreateTextures, glCreateTextures);
+	K_CAPTURE_UNINSTALL(glTextureStorage2D, glTextureStorage2D);
+	K_CAPTURE_UNINSTALL(glTextureParameteri, glTextureParameteri);
+	K_CAPTURE_UNINSTALL(glBindImageTexture, glBindImageTexture);
+	K_CAPTURE_UNINSTALL(glNamedFramebufferTexture, glNamedFramebufferTexture);
+	K_CAPTURE_UNINSTALL(glBlitNamedFramebuffer, glBlitNamedFramebuffer);
+	K_CAPTURE_UNINSTALL(glNamedFramebufferDrawBuffers, glNamedFramebufferDrawBuffers);
+	K_CAPTURE_UNINSTALL(glVertexArrayAttribIFormat, glVertexArrayAttribIFormat);
+	K_CAPTURE_UNINSTALL(glVertexArrayBindingDivisor, glVertexArrayBindingDivisor);
+	K_CAPTURE_UNINSTALL(glDispatchCompute, glDispatchCompute);
+	K_CAPTURE_UNINSTALL(glMemoryBarrier, glMemoryBarrier);
+	K_CAPTURE_UNINSTALL(glDrawArraysIndirect, glDrawArraysIndirect);
+	K_CAPTURE_UNINSTALL(glMultiDrawArraysIndirect, glMultiDrawArraysIndirect);
+	K_CAPTURE_UNINSTALL(glTextureStorage3D, glTextureStorage3D);
+	K_CAPTURE_UNINSTALL(glTextureSubImage3D, glTextureSubImage3D);
+	K_CAPTURE_UNINSTALL(glGenerateTextureMipmap, glGenerateTextureMipmap);
+	K_CAPTURE_UNINSTALL(glTextureSubImage2D, glTextureSubImage2D);
+	K_CAPTURE_UNINSTALL(glCopyImageSubData, glCopyImageSubData);
+	K_CAPTURE_UNINSTALL(glCreateSamplers, glCreateSamplers);
+	K_CAPTURE_UNINSTALL(glDeleteSamplers, glDeleteSamplers);
+	K_CAPTURE_UNINSTALL(glSamplerParameteri, glSamplerParameteri);
+	K_CAPTURE_UNINSTALL(glSamplerParameterf, glSamplerParameterf);
+
+#ifndef __ANDROID__
+	K_CAPTURE_UNINSTALL(kglClear, glClear);
+	K_CAPTURE_UNINSTALL(kglClearColor, glClearColor);
+	K_CAPTURE_UNINSTALL(kglDrawArrays, glDrawArrays);
+	K_CAPTURE_UNINSTALL(kglEnable, glEnable);
+	K_CAPTURE_UNINSTALL(kglDisable, glDisable);
+	K_CAPTURE_UNINSTALL(kglViewport, glViewport);
+	K_CAPTURE_UNINSTALL(kglPolygonMode, glPolygonMode);
+	K_CAPTURE_UNINSTALL(kglDepthFunc, glDepthFunc);
+	K_CAPTURE_UNINSTALL(kglDepthMask, glDepthMask);
+	K_CAPTURE_UNINSTALL(kglCullFace, glCullFace);
+	K_CAPTURE_UNINSTALL(kglFrontFace, glFrontFace);
+	K_CAPTURE_UNINSTALL(kglLineWidth, glLineWidth);
+	K_CAPTURE_UNINSTALL(kglPointSize, glPointSize);
+	K_CAPTURE_UNINSTALL(kglDeleteTextures, glDeleteTextures);
+	K_CAPTURE_UNINSTALL(kglPixelStorei, glPixelStorei);
+#endif
+
+	m_installed = false;
+}
+
+const char* kengine::getGLCallName(GL_CALL call)
+{
+	return call < GL_CALL::COUNT ? callNames[static_cast<size_t>(call)] : "unknown";
+}
+
+kengine::gl_capture& kengine::glCapture()
+{
+	static gl_capture capture;
+	return capture;
+}
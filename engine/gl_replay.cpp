@@ -0,0 +1,1562 @@
+/*
+	K-Engine GL Replay
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <gl_replay.hpp>
+#include <logger.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+	/*
+		Reads the arguments in the order they were written by the recording functions
+	*/
+	class argument_reader
+	{
+	public:
+		argument_reader(const unsigned char* data, size_t size)
+			: m_data(data), m_end(data + size)
+		{
+		}
+
+		template <typename T>
+		T get() {
+			T value = T();
+
+			if (m_data + sizeof(T) > m_end) {
+				m_valid = false;
+				return value;
+			}
+
+			std::memcpy(&value, m_data, sizeof(T));
+			m_data += sizeof(T);
+			return value;
+		}
+
+		/*
+			Payload (nullptr if the recorded pointer was nullptr)
+		*/
+		const void* payload(size_t& size) {
+			uint8_t present = get<uint8_t>();
+			size = static_cast<size_t>(get<uint64_t>());
+
+			if (!present || !m_valid)
+				return nullptr;
+
+			if (m_data + size > m_end) {
+				m_valid = false;
+				return nullptr;
+			}
+
+			const void* data = m_data;
+			m_data += size;
+			return data;
+		}
+
+		const GLuint* names(GLsizei count) {
+			size_t size = 0;
+			const GLuint* names = static_cast<const GLuint*>(payload(size));
+
+			if (size != sizeof(GLuint) * static_cast<size_t>(count))
+				m_valid = false;
+
+			return names;
+		}
+
+		bool isValid() const { return m_valid; }
+
+	private:
+		const unsigned char* m_data;
+		const unsigned char* m_end;
+		bool m_valid = true;
+	};
+
+	/*
+		glUniform*v and glUniformMatrix*v: the payload has "components" values for each of the "count" uniforms
+	*/
+	template <typename T>
+	bool replayUniform(argument_reader& reader, size_t components, void (APIENTRY* function)(GLint, GLsizei, const T*))
+	{
+		GLint location = reader.get<GLint>();
+		GLsizei count = reader.get<GLsizei>();
+		size_t size = 0;
+		const T* value = static_cast<const T*>(reader.payload(size));
+
+		if (!reader.isValid() || size != sizeof(T) * components * static_cast<size_t>(count))
+			return false;
+
+		function(location, count, value);
+		return true;
+	}
+
+	template <typename T>
+	bool replayUniformMatrix(argument_reader& reader, size_t components, void (APIENTRY* function)(GLint, GLsizei, GLboolean, const T*))
+	{
+		GLint location = reader.get<GLint>();
+		GLsizei count = reader.get<GLsizei>();
+		GLboolean transpose = reader.get<GLboolean>();
+		size_t size = 0;
+		const T* value = static_cast<const T*>(reader.payload(size));
+
+		if (!reader.isValid() || size != sizeof(T) * components * static_cast<size_t>(count))
+			return false;
+
+		function(location, count, transpose, value);
+		return true;
+	}
+}
+
+/*
+	kengine::gl_replay class - member class definition
+*/
+
+bool kengine::gl_replay::load(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+
+	if (!file.is_open()) {
+		K_LOG_OUTPUT_RAW("gl_replay: it was not possible to open the trace " << filename);
+		return false;
+	}
+
+	m_trace.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	m_frames.clear();
+	m_callStats.assign(static_cast<size_t>(GL_CALL::COUNT), gl_replay_call_stats());
+
+	gl_trace_header header;
+	gl_trace_header expected;
+
+	if (m_trace.size() < sizeof(header)) {
+		K_LOG_OUTPUT_RAW("gl_replay: " << filename << " is not a trace");
+		return false;
+	}
+
+	std::memcpy(&header, m_trace.data(), sizeof(header));
+
+	if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version) {
+		K_LOG_OUTPUT_RAW("gl_replay: " << filename << " is not a trace (or its version is not supported)");
+		return false;
+	}
+
+	// index the frame markers
+	size_t offset = sizeof(header);
+	m_setupEnd = m_trace.size();
+
+	while (offset + sizeof(gl_trace_record) <= m_trace.size()) {
+		gl_trace_record record;
+		std::memcpy(&record, m_trace.data() + offset, sizeof(record));
+
+		if (static_cast<GL_CALL>(record.call) == GL_CALL::FRAME) {
+			if (m_frames.empty())
+				m_setupEnd = offset;
+
+			m_frames.push_back(offset);
+		}
+
+		offset += sizeof(record) + record.size;
+	}
+
+	// a truncated record (e.g. the application has crashed during the capture) is dropped
+	if (offset > m_trace.size()) {
+		gl_trace_record record;
+		size_t last = sizeof(header);
+
+		while (last + sizeof(record) <= m_trace.size()) {
+			std::memcpy(&record, m_trace.data() + last, sizeof(record));
+
+			if (last + sizeof(record) + record.size > m_trace.size())
+				break;
+
+			last += sizeof(record) + record.size;
+		}
+
+		m_trace.resize(last);
+	}
+
+	return true;
+}
+
+bool kengine::gl_replay::replaySetup()
+{
+	uint64_t calls = 0;
+	return execute(sizeof(gl_trace_header), m_setupEnd, &calls);
+}
+
+bool kengine::gl_replay::replayFrame(size_t frame, gl_replay_frame_stats* stats)
+{
+	if (frame >= m_frames.size())
+		return false;
+
+	size_t end = (frame + 1 < m_frames.size()) ? m_frames[frame + 1] : m_trace.size();
+	uint64_t calls = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	bool result = execute(m_frames[frame], end, &calls);
+	auto submitted = std::chrono::steady_clock::now();
+	glFinish();
+	auto finished = std::chrono::steady_clock::now();
+
+	if (stats != nullptr) {
+		stats->calls = calls;
+		stats->submitMilliseconds = std::chrono::duration<double, std::milli>(submitted - start).count();
+		stats->milliseconds = std::chrono::duration<double, std::milli>(finished - start).count();
+	}
+
+	return result;
+}
+
+bool kengine::gl_replay::execute(size_t begin, size_t end, uint64_t* calls)
+{
+	size_t offset = begin;
+
+	while (offset + sizeof(gl_trace_record) <= end) {
+		gl_trace_record record;
+		std::memcpy(&record, m_trace.data() + offset, sizeof(record));
+		offset += sizeof(record);
+
+		GL_CALL call = static_cast<GL_CALL>(record.call);
+
+		if (call >= GL_CALL::COUNT || offset + record.size > end) {
+			K_LOG_OUTPUT_RAW("gl_replay: invalid record at offset " << offset - sizeof(record));
+			return false;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		bool result = executeCall(call, m_trace.data() + offset, record.size);
+		auto finished = std::chrono::steady_clock::now();
+
+		if (!result) {
+			K_LOG_OUTPUT_RAW("gl_replay: invalid arguments of " << getGLCallName(call) << " at offset " << offset - sizeof(record));
+			return false;
+		}
+
+		gl_replay_call_stats& stats = m_callStats[record.call];
+		stats.calls++;
+		stats.milliseconds += std::chrono::duration<double, std::milli>(finished - start).count();
+
+		(*calls)++;
+		offset += record.size;
+	}
+
+	return true;
+}
+
+GLuint kengine::gl_replay::getName(NAMESPACE space, GLuint name) const
+{
+	auto it = m_names[space].find(name);
+
+	if (it != m_names[space].end())
+		return it->second;
+
+	return space == FRAMEBUFFER ? m_defaultFramebuffer : 0;
+}
+
+void kengine::gl_replay::createNames(NAMESPACE space, GLsizei count, const GLuint* traceNames, const GLuint* names)
+{
+	for (GLsizei index = 0; index < count; index++)
+		m_names[space][traceNames[index]] = names[index];
+}
+
+void kengine::gl_replay::deleteNames(NAMESPACE space, GLsizei count, const GLuint* traceNames, std::vector<GLuint>& names)
+{
+	names.resize(static_cast<size_t>(count));
+
+	for (GLsizei index = 0; index < count; index++) {
+		names[index] = getName(space, traceNames[index]);
+		m_names[space].erase(traceNames[index]);
+	}
+}
+
+bool kengine::gl_replay::executeCall(GL_CALL call, const unsigned char* arguments, size_t size)
+{
+	argument_reader reader(arguments, size);
+	std::vector<GLuint> names;
+	size_t payloadSize = 0;
+
+	switch (call) {
+	case GL_CALL::FRAME:
+		break;
+
+	case GL_CALL::MAPPED_DATA: {
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = reader.get<int64_t>();
+		const void* data = reader.payload(payloadSize);
+		auto it = m_mappedRanges.find(buffer);
+
+		if (reader.isValid() && data != nullptr && it != m_mappedRanges.end())
+			std::memcpy(it->second.data + (offset - it->second.offset), data, payloadSize);
+
+		break;
+	}
+
+	case GL_CALL::CREATE_BUFFERS:
+	case GL_CALL::GEN_BUFFERS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		names.resize(static_cast<size_t>(count));
+
+		if (call == GL_CALL::CREATE_BUFFERS)
+			glCreateBuffers(count, names.data());
+		else
+			glGenBuffers(count, names.data());
+
+		createNames(BUFFER, count, traceNames, names.data());
+		break;
+	}
+
+	case GL_CALL::DELETE_BUFFERS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		for (GLsizei index = 0; index < count; index++)
+			m_mappedRanges.erase(traceNames[index]);
+
+		deleteNames(BUFFER, count, traceNames, names);
+		glDeleteBuffers(count, names.data());
+		break;
+	}
+
+	case GL_CALL::BIND_BUFFER: {
+		GLenum target = reader.get<GLenum>();
+		GLuint buffer = reader.get<GLuint>();
+		glBindBuffer(target, getName(BUFFER, buffer));
+		break;
+	}
+
+	case GL_CALL::NAMED_BUFFER_STORAGE: {
+		GLuint buffer = reader.get<GLuint>();
+		int64_t bufferSize = reader.get<int64_t>();
+		const void* data = reader.payload(payloadSize);
+		GLbitfield flags = reader.get<GLbitfield>();
+		glNamedBufferStorage(getName(BUFFER, buffer), static_cast<GLsizeiptr>(bufferSize), data, flags);
+		break;
+	}
+
+	case GL_CALL::BUFFER_STORAGE: {
+		GLenum target = reader.get<GLenum>();
+		int64_t bufferSize = reader.get<int64_t>();
+		const void* data = reader.payload(payloadSize);
+		GLbitfield flags = reader.get<GLbitfield>();
+		glBufferStorage(target, static_cast<GLsizeiptr>(bufferSize), data, flags);
+		break;
+	}
+
+	case GL_CALL::NAMED_BUFFER_SUB_DATA: {
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = reader.get<int64_t>();
+		const void* data = reader.payload(payloadSize);
+		glNamedBufferSubData(getName(BUFFER, buffer), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(payloadSize), data);
+		break;
+	}
+
+	case GL_CALL::MAP_NAMED_BUFFER_RANGE: {
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = reader.get<int64_t>();
+		int64_t length = reader.get<int64_t>();
+		GLbitfield access = reader.get<GLbitfield>();
+
+		if (!reader.isValid())
+			return false;
+
+		void* data = glMapNamedBufferRange(getName(BUFFER, buffer), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(length), access);
+
+		if (data != nullptr) {
+			mapped_range& range = m_mappedRanges[buffer];
+			range.data = static_cast<unsigned char*>(data);
+			range.offset = offset;
+		}
+
+		break;
+	}
+
+	case GL_CALL::UNMAP_NAMED_BUFFER: {
+		GLuint buffer = reader.get<GLuint>();
+		m_mappedRanges.erase(buffer);
+		glUnmapNamedBuffer(getName(BUFFER, buffer));
+		break;
+	}
+
+	case GL_CALL::BIND_BUFFER_BASE: {
+		GLenum target = reader.get<GLenum>();
+		GLuint index = reader.get<GLuint>();
+		GLuint buffer = reader.get<GLuint>();
+		glBindBufferBase(target, index, getName(BUFFER, buffer));
+		break;
+	}
+
+	case GL_CALL::BIND_BUFFER_RANGE: {
+		GLenum target = reader.get<GLenum>();
+		GLuint index = reader.get<GLuint>();
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = reader.get<int64_t>();
+		int64_t rangeSize = reader.get<int64_t>();
+		glBindBufferRange(target, index, getName(BUFFER, buffer), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(rangeSize));
+		break;
+	}
+
+	case GL_CALL::CREATE_VERTEX_ARRAYS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		names.resize(static_cast<size_t>(count));
+		glCreateVertexArrays(count, names.data());
+		createNames(VERTEX_ARRAY, count, traceNames, names.data());
+		break;
+	}
+
+	case GL_CALL::DELETE_VERTEX_ARRAYS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		deleteNames(VERTEX_ARRAY, count, traceNames, names);
+		glDeleteVertexArrays(count, names.data());
+		break;
+	}
+
+	case GL_CALL::BIND_VERTEX_ARRAY:
+		glBindVertexArray(getName(VERTEX_ARRAY, reader.get<GLuint>()));
+		break;
+
+	case GL_CALL::ENABLE_VERTEX_ARRAY_ATTRIB: {
+		GLuint vertexArray = reader.get<GLuint>();
+		GLuint index = reader.get<GLuint>();
+		glEnableVertexArrayAttrib(getName(VERTEX_ARRAY, vertexArray), index);
+		break;
+	}
+
+	case GL_CALL::VERTEX_ARRAY_ATTRIB_FORMAT: {
+		GLuint vertexArray = reader.get<GLuint>();
+		GLuint index = reader.get<GLuint>();
+		GLint components = reader.get<GLint>();
+		GLenum type = reader.get<GLenum>();
+		GLboolean normalized = reader.get<GLboolean>();
+		GLuint relativeOffset = reader.get<GLuint>();
+		glVertexArrayAttribFormat(getName(VERTEX_ARRAY, vertexArray), index, components, type, normalized, relativeOffset);
+		break;
+	}
+
+	case GL_CALL::VERTEX_ARRAY_ATTRIB_BINDING: {
+		GLuint vertexArray = reader.get<GLuint>();
+		GLuint index = reader.get<GLuint>();
+		GLuint binding = reader.get<GLuint>();
+		glVertexArrayAttribBinding(getName(VERTEX_ARRAY, vertexArray), index, binding);
+		break;
+	}
+
+	case GL_CALL::VERTEX_ARRAY_VERTEX_BUFFER: {
+		GLuint vertexArray = reader.get<GLuint>();
+		GLuint binding = reader.get<GLuint>();
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = reader.get<int64_t>();
+		GLsizei stride = reader.get<GLsizei>();
+		glVertexArrayVertexBuffer(getName(VERTEX_ARRAY, vertexArray), binding, getName(BUFFER, buffer), static_cast<GLintptr>(offset), stride);
+		break;
+	}
+
+	case GL_CALL::BIND_VERTEX_BUFFER: {
+		GLuint binding = reader.get<GLuint>();
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = reader.get<int64_t>();
+		GLsizei stride = reader.get<GLsizei>();
+		glBindVertexBuffer(binding, getName(BUFFER, buffer), static_cast<GLintptr>(offset), stride);
+		break;
+	}
+
+	case GL_CALL::ENABLE_VERTEX_ATTRIB_ARRAY:
+		glEnableVertexAttribArray(reader.get<GLuint>());
+		break;
+
+	case GL_CALL::VERTEX_ATTRIB_POINTER: {
+		GLuint index = reader.get<GLuint>();
+		GLint components = reader.get<GLint>();
+		GLenum type = reader.get<GLenum>();
+		GLboolean normalized = reader.get<GLboolean>();
+		GLsizei stride = reader.get<GLsizei>();
+		uint64_t offset = reader.get<uint64_t>();
+		glVertexAttribPointer(index, components, type, normalized, stride, reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)));
+		break;
+	}
+
+	case GL_CALL::CREATE_SHADER: {
+		GLenum type = reader.get<GLenum>();
+		GLuint shader = reader.get<GLuint>();
+		m_names[PROGRAM][shader] = glCreateShader(type);
+		break;
+	}
+
+	case GL_CALL::SHADER_SOURCE: {
+		GLuint shader = reader.get<GLuint>();
+		GLsizei count = reader.get<GLsizei>();
+		std::vector<const GLchar*> strings;
+		std::vector<GLint> lengths;
+
+		for (GLsizei index = 0; index < count && reader.isValid(); index++) {
+			strings.push_back(static_cast<const GLchar*>(reader.payload(payloadSize)));
+			lengths.push_back(static_cast<GLint>(payloadSize));
+		}
+
+		if (!reader.isValid())
+			return false;
+
+		glShaderSource(getName(PROGRAM, shader), count, strings.data(), lengths.data());
+		break;
+	}
+
+	case GL_CALL::COMPILE_SHADER:
+		glCompileShader(getName(PROGRAM, reader.get<GLuint>()));
+		break;
+
+	case GL_CALL::SHADER_BINARY: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+		GLenum format = reader.get<GLenum>();
+		const void* binary = reader.payload(payloadSize);
+
+		if (!reader.isValid())
+			return false;
+
+		for (GLsizei index = 0; index < count; index++)
+			names.push_back(getName(PROGRAM, traceNames[index]));
+
+		glShaderBinary(count, names.data(), format, binary, static_cast<GLsizei>(payloadSize));
+		break;
+	}
+
+	case GL_CALL::SPECIALIZE_SHADER: {
+		GLuint shader = reader.get<GLuint>();
+		const GLchar* entryPoint = static_cast<const GLchar*>(reader.payload(payloadSize));
+		GLuint count = reader.get<GLuint>();
+		const GLuint* indices = reader.names(static_cast<GLsizei>(count));
+		const GLuint* values = reader.names(static_cast<GLsizei>(count));
+
+		if (!reader.isValid() || entryPoint == nullptr)
+			return false;
+
+		glSpecializeShader(getName(PROGRAM, shader), entryPoint, count, indices, values);
+		break;
+	}
+
+	case GL_CALL::DELETE_SHADER:
+	case GL_CALL::DELETE_PROGRAM: {
+		GLuint object = reader.get<GLuint>();
+		GLuint name = getName(PROGRAM, object);
+		m_names[PROGRAM].erase(object);
+
+		if (call == GL_CALL::DELETE_SHADER)
+			glDeleteShader(name);
+		else
+			glDeleteProgram(name);
+
+		break;
+	}
+
+	case GL_CALL::CREATE_PROGRAM:
+		m_names[PROGRAM][reader.get<GLuint>()] = glCreateProgram();
+		break;
+
+	case GL_CALL::ATTACH_SHADER:
+	case GL_CALL::DETACH_SHADER: {
+		GLuint program = getName(PROGRAM, reader.get<GLuint>());
+		GLuint shader = getName(PROGRAM, reader.get<GLuint>());
+
+		if (call == GL_CALL::ATTACH_SHADER)
+			glAttachShader(program, shader);
+		else
+			glDetachShader(program, shader);
+
+		break;
+	}
+
+	case GL_CALL::PROGRAM_PARAMETERI: {
+		GLuint program = reader.get<GLuint>();
+		GLenum name = reader.get<GLenum>();
+		GLint value = reader.get<GLint>();
+		glProgramParameteri(getName(PROGRAM, program), name, value);
+		break;
+	}
+
+	case GL_CALL::LINK_PROGRAM:
+		glLinkProgram(getName(PROGRAM, reader.get<GLuint>()));
+		break;
+
+	case GL_CALL::PROGRAM_BINARY: {
+		GLuint program = reader.get<GLuint>();
+		GLenum format = reader.get<GLenum>();
+		const void* binary = reader.payload(payloadSize);
+		glProgramBinary(getName(PROGRAM, program), format, binary, static_cast<GLsizei>(payloadSize));
+		break;
+	}
+
+	case GL_CALL::USE_PROGRAM:
+		glUseProgram(getName(PROGRAM, reader.get<GLuint>()));
+		break;
+
+	case GL_CALL::CREATE_SHADER_PROGRAMV: {
+		GLenum type = reader.get<GLenum>();
+		GLuint program = reader.get<GLuint>();
+		GLsizei count = reader.get<GLsizei>();
+		std::vector<std::string> sources;
+		std::vector<const GLchar*> strings;
+
+		for (GLsizei index = 0; index < count && reader.isValid(); index++) {
+			const GLchar* source = static_cast<const GLchar*>(reader.payload(payloadSize));
+			sources.push_back(source != nullptr ? std::string(source, payloadSize) : std::string());
+		}
+
+		if (!reader.isValid())
+			return false;
+
+		// glCreateShaderProgramv needs null-terminated strings
+		for (const std::string& source : sources)
+			strings.push_back(source.c_str());
+
+		m_names[PROGRAM][program] = glCreateShaderProgramv(type, count, strings.data());
+		break;
+	}
+
+	case GL_CALL::CREATE_PROGRAM_PIPELINES: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		names.resize(static_cast<size_t>(count));
+		glCreateProgramPipelines(count, names.data());
+		createNames(PIPELINE, count, traceNames, names.data());
+		break;
+	}
+
+	case GL_CALL::DELETE_PROGRAM_PIPELINES: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		deleteNames(PIPELINE, count, traceNames, names);
+		glDeleteProgramPipelines(count, names.data());
+		break;
+	}
+
+	case GL_CALL::USE_PROGRAM_STAGES: {
+		GLuint pipeline = reader.get<GLuint>();
+		GLbitfield stages = reader.get<GLbitfield>();
+		GLuint program = reader.get<GLuint>();
+		glUseProgramStages(getName(PIPELINE, pipeline), stages, getName(PROGRAM, program));
+		break;
+	}
+
+	case GL_CALL::BIND_PROGRAM_PIPELINE:
+		glBindProgramPipeline(getName(PIPELINE, reader.get<GLuint>()));
+		break;
+
+	case GL_CALL::UNIFORM_MATRIX_4FV:
+		return replayUniformMatrix(reader, 16, glUniformMatrix4fv);
+
+	case GL_CALL::BIND_TEXTURE_UNIT: {
+		GLuint unit = reader.get<GLuint>();
+		GLuint texture = reader.get<GLuint>();
+		glBindTextureUnit(unit, getName(TEXTURE, texture));
+		break;
+	}
+
+	case GL_CALL::BIND_SAMPLER: {
+		GLuint unit = reader.get<GLuint>();
+		GLuint sampler = reader.get<GLuint>();
+		glBindSampler(unit, getName(SAMPLER, sampler));
+		break;
+	}
+
+	case GL_CALL::BLEND_FUNC_SEPARATE: {
+		GLenum sourceRGB = reader.get<GLenum>();
+		GLenum destinationRGB = reader.get<GLenum>();
+		GLenum sourceAlpha = reader.get<GLenum>();
+		GLenum destinationAlpha = reader.get<GLenum>();
+		glBlendFuncSeparate(sourceRGB, destinationRGB, sourceAlpha, destinationAlpha);
+		break;
+	}
+
+	case GL_CALL::BLEND_EQUATION_SEPARATE: {
+		GLenum modeRGB = reader.get<GLenum>();
+		GLenum modeAlpha = reader.get<GLenum>();
+		glBlendEquationSeparate(modeRGB, modeAlpha);
+		break;
+	}
+
+	case GL_CALL::CREATE_FRAMEBUFFERS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		names.resize(static_cast<size_t>(count));
+		glCreateFramebuffers(count, names.data());
+		createNames(FRAMEBUFFER, count, traceNames, names.data());
+		break;
+	}
+
+	case GL_CALL::DELETE_FRAMEBUFFERS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		// the framebuffers that are not created by the trace are never deleted (e.g. the default framebuffer)
+		for (GLsizei index = 0; index < count; index++) {
+			auto it = m_names[FRAMEBUFFER].find(traceNames[index]);
+
+			if (it != m_names[FRAMEBUFFER].end()) {
+				names.push_back(it->second);
+				m_names[FRAMEBUFFER].erase(it);
+			}
+		}
+
+		glDeleteFramebuffers(static_cast<GLsizei>(names.size()), names.data());
+		break;
+	}
+
+	case GL_CALL::BIND_FRAMEBUFFER: {
+		GLenum target = reader.get<GLenum>();
+		GLuint framebuffer = reader.get<GLuint>();
+		glBindFramebuffer(target, getName(FRAMEBUFFER, framebuffer));
+		break;
+	}
+
+	case GL_CALL::CREATE_RENDERBUFFERS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		names.resize(static_cast<size_t>(count));
+		glCreateRenderbuffers(count, names.data());
+		createNames(RENDERBUFFER, count, traceNames, names.data());
+		break;
+	}
+
+	case GL_CALL::DELETE_RENDERBUFFERS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		deleteNames(RENDERBUFFER, count, traceNames, names);
+		glDeleteRenderbuffers(count, names.data());
+		break;
+	}
+
+	case GL_CALL::NAMED_RENDERBUFFER_STORAGE: {
+		GLuint renderbuffer = reader.get<GLuint>();
+		GLenum format = reader.get<GLenum>();
+		GLsizei width = reader.get<GLsizei>();
+		GLsizei height = reader.get<GLsizei>();
+		glNamedRenderbufferStorage(getName(RENDERBUFFER, renderbuffer), format, width, height);
+		break;
+	}
+
+	case GL_CALL::NAMED_FRAMEBUFFER_RENDERBUFFER: {
+		GLuint framebuffer = reader.get<GLuint>();
+		GLenum attachment = reader.get<GLenum>();
+		GLenum target = reader.get<GLenum>();
+		GLuint renderbuffer = reader.get<GLuint>();
+		glNamedFramebufferRenderbuffer(getName(FRAMEBUFFER, framebuffer), attachment, target, getName(RENDERBUFFER, renderbuffer));
+		break;
+	}
+
+	case GL_CALL::FENCE_SYNC: {
+		GLenum condition = reader.get<GLenum>();
+		GLbitfield flags = reader.get<GLbitfield>();
+		uint64_t sync = reader.get<uint64_t>();
+		m_syncs[sync] = glFenceSync(condition, flags);
+		break;
+	}
+
+	case GL_CALL::CLIENT_WAIT_SYNC: {
+		uint64_t sync = reader.get<uint64_t>();
+		GLbitfield flags = reader.get<GLbitfield>();
+		uint64_t timeout = reader.get<uint64_t>();
+		auto it = m_syncs.find(sync);
+
+		if (it != m_syncs.end())
+			glClientWaitSync(it->second, flags, static_cast<GLuint64>(timeout));
+
+		break;
+	}
+
+	case GL_CALL::DELETE_SYNC: {
+		auto it = m_syncs.find(reader.get<uint64_t>());
+
+		if (it != m_syncs.end()) {
+			glDeleteSync(it->second);
+			m_syncs.erase(it);
+		}
+
+		break;
+	}
+
+	case GL_CALL::CLEAR:
+		glClear(reader.get<GLbitfield>());
+		break;
+
+	case GL_CALL::CLEAR_COLOR: {
+		GLfloat red = reader.get<GLfloat>();
+		GLfloat green = reader.get<GLfloat>();
+		GLfloat blue = reader.get<GLfloat>();
+		GLfloat alpha = reader.get<GLfloat>();
+		glClearColor(red, green, blue, alpha);
+		break;
+	}
+
+	case GL_CALL::DRAW_ARRAYS: {
+		GLenum mode = reader.get<GLenum>();
+		GLint first = reader.get<GLint>();
+		GLsizei count = reader.get<GLsizei>();
+		glDrawArrays(mode, first, count);
+		break;
+	}
+
+	case GL_CALL::ENABLE:
+		glEnable(reader.get<GLenum>());
+		break;
+
+	case GL_CALL::DISABLE:
+		glDisable(reader.get<GLenum>());
+		break;
+
+	case GL_CALL::VIEWPORT: {
+		GLint x = reader.get<GLint>();
+		GLint y = reader.get<GLint>();
+		GLsizei width = reader.get<GLsizei>();
+		GLsizei height = reader.get<GLsizei>();
+		glViewport(x, y, width, height);
+		break;
+	}
+
+	case GL_CALL::POLYGON_MODE: {
+		GLenum face = reader.get<GLenum>();
+		GLenum mode = reader.get<GLenum>();
+		glPolygonMode(face, mode);
+		break;
+	}
+
+	case GL_CALL::DEPTH_FUNC:
+		glDepthFunc(reader.get<GLenum>());
+		break;
+
+	case GL_CALL::DEPTH_MASK:
+		glDepthMask(reader.get<GLboolean>());
+		break;
+
+	case GL_CALL::CULL_FACE:
+		glCullFace(reader.get<GLenum>());
+		break;
+
+	case GL_CALL::FRONT_FACE:
+		glFrontFace(reader.get<GLenum>());
+		break;
+
+	case GL_CALL::LINE_WIDTH:
+		glLineWidth(reader.get<GLfloat>());
+		break;
+
+	case GL_CALL::POINT_SIZE:
+		glPointSize(reader.get<GLfloat>());
+		break;
+
+	case GL_CALL::NAMED_BUFFER_DATA: {
+		GLuint buffer = reader.get<GLuint>();
+		int64_t bufferSize = reader.get<int64_t>();
+		const void* data = reader.payload(payloadSize);
+		GLenum usage = reader.get<GLenum>();
+		glNamedBufferData(getName(BUFFER, buffer), static_cast<GLsizeiptr>(bufferSize), data, usage);
+		break;
+	}
+
+	case GL_CALL::BUFFER_DATA: {
+		GLenum target = reader.get<GLenum>();
+		int64_t bufferSize = reader.get<int64_t>();
+		const void* data = reader.payload(payloadSize);
+		GLenum usage = reader.get<GLenum>();
+		glBufferData(target, static_cast<GLsizeiptr>(bufferSize), data, usage);
+		break;
+	}
+
+	case GL_CALL::BUFFER_SUB_DATA: {
+		GLenum target = reader.get<GLenum>();
+		int64_t offset = reader.get<int64_t>();
+		const void* data = reader.payload(payloadSize);
+		glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(payloadSize), data);
+		break;
+	}
+
+	case GL_CALL::CLEAR_NAMED_BUFFER_DATA: {
+		GLuint buffer = reader.get<GLuint>();
+		GLenum internalFormat = reader.get<GLenum>();
+		GLenum format = reader.get<GLenum>();
+		GLenum type = reader.get<GLenum>();
+		const void* data = reader.payload(payloadSize);
+		glClearNamedBufferData(getName(BUFFER, buffer), internalFormat, format, type, data);
+		break;
+	}
+
+	case GL_CALL::CLEAR_BUFFER_DATA: {
+		GLenum target = reader.get<GLenum>();
+		GLenum internalFormat = reader.get<GLenum>();
+		GLenum format = reader.get<GLenum>();
+		GLenum type = reader.get<GLenum>();
+		const void* data = reader.payload(payloadSize);
+		glClearBufferData(target, internalFormat, format, type, data);
+		break;
+	}
+
+	case GL_CALL::COPY_NAMED_BUFFER_SUB_DATA: {
+		GLuint readBuffer = reader.get<GLuint>();
+		GLuint writeBuffer = reader.get<GLuint>();
+		int64_t readOffset = reader.get<int64_t>();
+		int64_t writeOffset = reader.get<int64_t>();
+		int64_t copySize = reader.get<int64_t>();
+		glCopyNamedBufferSubData(getName(BUFFER, readBuffer), getName(BUFFER, writeBuffer), static_cast<GLintptr>(readOffset),
+			static_cast<GLintptr>(writeOffset), static_cast<GLsizeiptr>(copySize));
+		break;
+	}
+
+	case GL_CALL::COPY_BUFFER_SUB_DATA: {
+		GLenum readTarget = reader.get<GLenum>();
+		GLenum writeTarget = reader.get<GLenum>();
+		int64_t readOffset = reader.get<int64_t>();
+		int64_t writeOffset = reader.get<int64_t>();
+		int64_t copySize = reader.get<int64_t>();
+		glCopyBufferSubData(readTarget, writeTarget, static_cast<GLintptr>(readOffset), static_cast<GLintptr>(writeOffset), static_cast<GLsizeiptr>(copySize));
+		break;
+	}
+
+	case GL_CALL::MAP_NAMED_BUFFER:
+	case GL_CALL::MAP_BUFFER:
+	case GL_CALL::MAP_BUFFER_RANGE: {
+		// the target-based calls are recorded with the name of the bound buffer
+		GLenum target = (call != GL_CALL::MAP_NAMED_BUFFER) ? reader.get<GLenum>() : 0;
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = (call == GL_CALL::MAP_BUFFER_RANGE) ? reader.get<int64_t>() : 0;
+		int64_t length = (call == GL_CALL::MAP_BUFFER_RANGE) ? reader.get<int64_t>() : 0;
+		GLenum access = reader.get<GLenum>();
+
+		if (!reader.isValid())
+			return false;
+
+		void* data = nullptr;
+
+		if (call == GL_CALL::MAP_NAMED_BUFFER)
+			data = glMapNamedBuffer(getName(BUFFER, buffer), access);
+		else if (call == GL_CALL::MAP_BUFFER)
+			data = glMapBuffer(target, access);
+		else
+			data = glMapBufferRange(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(length), access);
+
+		if (data != nullptr) {
+			mapped_range& range = m_mappedRanges[buffer];
+			range.data = static_cast<unsigned char*>(data);
+			range.offset = offset;
+		}
+
+		break;
+	}
+
+	case GL_CALL::UNMAP_BUFFER: {
+		GLenum target = reader.get<GLenum>();
+		m_mappedRanges.erase(reader.get<GLuint>());
+		glUnmapBuffer(target);
+		break;
+	}
+
+	case GL_CALL::FLUSH_MAPPED_NAMED_BUFFER_RANGE: {
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = reader.get<int64_t>();
+		int64_t length = reader.get<int64_t>();
+		glFlushMappedNamedBufferRange(getName(BUFFER, buffer), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(length));
+		break;
+	}
+
+	case GL_CALL::FLUSH_MAPPED_BUFFER_RANGE: {
+		GLenum target = reader.get<GLenum>();
+		int64_t offset = reader.get<int64_t>();
+		int64_t length = reader.get<int64_t>();
+		glFlushMappedBufferRange(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(length));
+		break;
+	}
+
+	case GL_CALL::INVALIDATE_BUFFER_DATA:
+		glInvalidateBufferData(getName(BUFFER, reader.get<GLuint>()));
+		break;
+
+	case GL_CALL::INVALIDATE_BUFFER_SUB_DATA: {
+		GLuint buffer = reader.get<GLuint>();
+		int64_t offset = reader.get<int64_t>();
+		int64_t length = reader.get<int64_t>();
+		glInvalidateBufferSubData(getName(BUFFER, buffer), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(length));
+		break;
+	}
+
+	case GL_CALL::CLEAR_BUFFERFV: {
+		GLenum buffer = reader.get<GLenum>();
+		GLint drawBuffer = reader.get<GLint>();
+		const GLfloat* value = static_cast<const GLfloat*>(reader.payload(payloadSize));
+
+		if (!reader.isValid() || payloadSize != sizeof(GLfloat) * (buffer == GL_COLOR ? 4 : 1))
+			return false;
+
+		glClearBufferfv(buffer, drawBuffer, value);
+		break;
+	}
+
+	case GL_CALL::GEN_VERTEX_ARRAYS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		names.resize(static_cast<size_t>(count));
+		glGenVertexArrays(count, names.data());
+		createNames(VERTEX_ARRAY, count, traceNames, names.data());
+		break;
+	}
+
+	case GL_CALL::DISABLE_VERTEX_ARRAY_ATTRIB: {
+		GLuint vertexArray = reader.get<GLuint>();
+		GLuint index = reader.get<GLuint>();
+		glDisableVertexArrayAttrib(getName(VERTEX_ARRAY, vertexArray), index);
+		break;
+	}
+
+	case GL_CALL::DISABLE_VERTEX_ATTRIB_ARRAY:
+		glDisableVertexAttribArray(reader.get<GLuint>());
+		break;
+
+	case GL_CALL::VERTEX_ATTRIB_I_POINTER:
+	case GL_CALL::VERTEX_ATTRIB_L_POINTER: {
+		GLuint index = reader.get<GLuint>();
+		GLint components = reader.get<GLint>();
+		GLenum type = reader.get<GLenum>();
+		GLsizei stride = reader.get<GLsizei>();
+		const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(reader.get<uint64_t>()));
+
+		if (call == GL_CALL::VERTEX_ATTRIB_I_POINTER)
+			glVertexAttribIPointer(index, components, type, stride, offset);
+		else
+			glVertexAttribLPointer(index, components, type, stride, offset);
+
+		break;
+	}
+
+	case GL_CALL::VERTEX_ARRAY_VERTEX_BUFFERS: {
+		GLuint vertexArray = reader.get<GLuint>();
+		GLuint first = reader.get<GLuint>();
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = static_cast<const GLuint*>(reader.payload(payloadSize));
+		const int64_t* offsets = static_cast<const int64_t*>(reader.payload(payloadSize));
+		const GLsizei* strides = static_cast<const GLsizei*>(reader.payload(payloadSize));
+
+		if (!reader.isValid())
+			return false;
+
+		// nullptr buffers unbind the range (the offsets and the strides are ignored)
+		std::vector<GLintptr> bufferOffsets;
+
+		for (GLsizei index = 0; index < count && traceNames != nullptr; index++) {
+			names.push_back(getName(BUFFER, traceNames[index]));
+			bufferOffsets.push_back(offsets != nullptr ? static_cast<GLintptr>(offsets[index]) : 0);
+		}
+
+		glVertexArrayVertexBuffers(getName(VERTEX_ARRAY, vertexArray), first, count, traceNames != nullptr ? names.data() : nullptr,
+			traceNames != nullptr ? bufferOffsets.data() : nullptr, strides);
+		break;
+	}
+
+	case GL_CALL::VERTEX_ATTRIB_FORMAT: {
+		GLuint index = reader.get<GLuint>();
+		GLint components = reader.get<GLint>();
+		GLenum type = reader.get<GLenum>();
+		GLboolean normalized = reader.get<GLboolean>();
+		GLuint relativeOffset = reader.get<GLuint>();
+		glVertexAttribFormat(index, components, type, normalized, relativeOffset);
+		break;
+	}
+
+	case GL_CALL::VERTEX_ATTRIB_BINDING: {
+		GLuint index = reader.get<GLuint>();
+		GLuint binding = reader.get<GLuint>();
+		glVertexAttribBinding(index, binding);
+		break;
+	}
+
+	case GL_CALL::BIND_ATTRIB_LOCATION: {
+		GLuint program = reader.get<GLuint>();
+		GLuint index = reader.get<GLuint>();
+		const GLchar* name = static_cast<const GLchar*>(reader.payload(payloadSize));
+
+		if (!reader.isValid() || name == nullptr)
+			return false;
+
+		glBindAttribLocation(getName(PROGRAM, program), index, name);
+		break;
+	}
+
+	case GL_CALL::DRAW_ARRAYS_INSTANCED_BASE_INSTANCE: {
+		GLenum mode = reader.get<GLenum>();
+		GLint first = reader.get<GLint>();
+		GLsizei count = reader.get<GLsizei>();
+		GLsizei instanceCount = reader.get<GLsizei>();
+		GLuint baseInstance = reader.get<GLuint>();
+		glDrawArraysInstancedBaseInstance(mode, first, count, instanceCount, baseInstance);
+		break;
+	}
+
+	case GL_CALL::PRIMITIVE_RESTART_INDEX:
+		glPrimitiveRestartIndex(reader.get<GLuint>());
+		break;
+
+	case GL_CALL::PROGRAM_UNIFORM_3F: {
+		GLuint program = reader.get<GLuint>();
+		GLint location = reader.get<GLint>();
+		GLfloat v0 = reader.get<GLfloat>();
+		GLfloat v1 = reader.get<GLfloat>();
+		GLfloat v2 = reader.get<GLfloat>();
+		glProgramUniform3f(getName(PROGRAM, program), location, v0, v1, v2);
+		break;
+	}
+
+	case GL_CALL::ACTIVE_SHADER_PROGRAM: {
+		GLuint pipeline = reader.get<GLuint>();
+		GLuint program = reader.get<GLuint>();
+		glActiveShaderProgram(getName(PIPELINE, pipeline), getName(PROGRAM, program));
+		break;
+	}
+
+	case GL_CALL::UNIFORM_1FV:
+		return replayUniform(reader, 1, glUniform1fv);
+
+	case GL_CALL::UNIFORM_2FV:
+		return replayUniform(reader, 2, glUniform2fv);
+
+	case GL_CALL::UNIFORM_3FV:
+		return replayUniform(reader, 3, glUniform3fv);
+
+	case GL_CALL::UNIFORM_4FV:
+		return replayUniform(reader, 4, glUniform4fv);
+
+	case GL_CALL::UNIFORM_1IV:
+		return replayUniform(reader, 1, glUniform1iv);
+
+	case GL_CALL::UNIFORM_2IV:
+		return replayUniform(reader, 2, glUniform2iv);
+
+	case GL_CALL::UNIFORM_3IV:
+		return replayUniform(reader, 3, glUniform3iv);
+
+	case GL_CALL::UNIFORM_4IV:
+		return replayUniform(reader, 4, glUniform4iv);
+
+	case GL_CALL::UNIFORM_1UIV:
+		return replayUniform(reader, 1, glUniform1uiv);
+
+	case GL_CALL::UNIFORM_2UIV:
+		return replayUniform(reader, 2, glUniform2uiv);
+
+	case GL_CALL::UNIFORM_3UIV:
+		return replayUniform(reader, 3, glUniform3uiv);
+
+	case GL_CALL::UNIFORM_4UIV:
+		return replayUniform(reader, 4, glUniform4uiv);
+
+	case GL_CALL::UNIFORM_1DV:
+		return replayUniform(reader, 1, glUniform1dv);
+
+	case GL_CALL::UNIFORM_2DV:
+		return replayUniform(reader, 2, glUniform2dv);
+
+	case GL_CALL::UNIFORM_3DV:
+		return replayUniform(reader, 3, glUniform3dv);
+
+	case GL_CALL::UNIFORM_4DV:
+		return replayUniform(reader, 4, glUniform4dv);
+
+	case GL_CALL::UNIFORM_MATRIX_2FV:
+		return replayUniformMatrix(reader, 4, glUniformMatrix2fv);
+
+	case GL_CALL::UNIFORM_MATRIX_3FV:
+		return replayUniformMatrix(reader, 9, glUniformMatrix3fv);
+
+	case GL_CALL::UNIFORM_MATRIX_2X3FV:
+		return replayUniformMatrix(reader, 6, glUniformMatrix2x3fv);
+
+	case GL_CALL::UNIFORM_MATRIX_3X2FV:
+		return replayUniformMatrix(reader, 6, glUniformMatrix3x2fv);
+
+	case GL_CALL::UNIFORM_MATRIX_2X4FV:
+		return replayUniformMatrix(reader, 8, glUniformMatrix2x4fv);
+
+	case GL_CALL::UNIFORM_MATRIX_4X2FV:
+		return replayUniformMatrix(reader, 8, glUniformMatrix4x2fv);
+
+	case GL_CALL::UNIFORM_MATRIX_3X4FV:
+		return replayUniformMatrix(reader, 12, glUniformMatrix3x4fv);
+
+	case GL_CALL::UNIFORM_MATRIX_4X3FV:
+		return replayUniformMatrix(reader, 12, glUniformMatrix4x3fv);
+
+	case GL_CALL::UNIFORM_MATRIX_2DV:
+		return replayUniformMatrix(reader, 4, glUniformMatrix2dv);
+
+	case GL_CALL::UNIFORM_MATRIX_3DV:
+		return replayUniformMatrix(reader, 9, glUniformMatrix3dv);
+
+	case GL_CALL::UNIFORM_MATRIX_4DV:
+		return replayUniformMatrix(reader, 16, glUniformMatrix4dv);
+
+	case GL_CALL::UNIFORM_MATRIX_2X3DV:
+		return replayUniformMatrix(reader, 6, glUniformMatrix2x3dv);
+
+	case GL_CALL::UNIFORM_MATRIX_3X2DV:
+		return replayUniformMatrix(reader, 6, glUniformMatrix3x2dv);
+
+	case GL_CALL::UNIFORM_MATRIX_2X4DV:
+		return replayUniformMatrix(reader, 8, glUniformMatrix2x4dv);
+
+	case GL_CALL::UNIFORM_MATRIX_4X2DV:
+		return replayUniformMatrix(reader, 8, glUniformMatrix4x2dv);
+
+	case GL_CALL::UNIFORM_MATRIX_3X4DV:
+		return replayUniformMatrix(reader, 12, glUniformMatrix3x4dv);
+
+	case GL_CALL::UNIFORM_MATRIX_4X3DV:
+		return replayUniformMatrix(reader, 12, glUniformMatrix4x3dv);
+
+	case GL_CALL::CREATE_TEXTURES: {
+		GLenum target = reader.get<GLenum>();
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		names.resize(static_cast<size_t>(count));
+		glCreateTextures(target, count, names.data());
+		createNames(TEXTURE, count, traceNames, names.data());
+		break;
+	}
+
+	case GL_CALL::DELETE_TEXTURES: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		deleteNames(TEXTURE, count, traceNames, names);
+		glDeleteTextures(count, names.data());
+		break;
+	}
+
+	case GL_CALL::TEXTURE_STORAGE_2D: {
+		GLuint texture = reader.get<GLuint>();
+		GLsizei levels = reader.get<GLsizei>();
+		GLenum format = reader.get<GLenum>();
+		GLsizei width = reader.get<GLsizei>();
+		GLsizei height = reader.get<GLsizei>();
+		glTextureStorage2D(getName(TEXTURE, texture), levels, format, width, height);
+		break;
+	}
+
+	case GL_CALL::TEXTURE_STORAGE_3D: {
+		GLuint texture = reader.get<GLuint>();
+		GLsizei levels = reader.get<GLsizei>();
+		GLenum format = reader.get<GLenum>();
+		GLsizei width = reader.get<GLsizei>();
+		GLsizei height = reader.get<GLsizei>();
+		GLsizei depth = reader.get<GLsizei>();
+		glTextureStorage3D(getName(TEXTURE, texture), levels, format, width, height, depth);
+		break;
+	}
+
+	case GL_CALL::TEXTURE_SUB_IMAGE_3D: {
+		GLuint texture = reader.get<GLuint>();
+		GLint level = reader.get<GLint>();
+		GLint x = reader.get<GLint>();
+		GLint y = reader.get<GLint>();
+		GLint z = reader.get<GLint>();
+		GLsizei width = reader.get<GLsizei>();
+		GLsizei height = reader.get<GLsizei>();
+		GLsizei depth = reader.get<GLsizei>();
+		GLenum format = reader.get<GLenum>();
+		GLenum type = reader.get<GLenum>();
+		uint64_t offset = reader.get<uint64_t>();
+		const void* pixels = reader.payload(payloadSize);
+
+		if (!reader.isValid())
+			return false;
+
+		// without a payload the pixels are an offset into the bound GL_PIXEL_UNPACK_BUFFER
+		if (pixels == nullptr)
+			pixels = reinterpret_cast<const void*>(static_cast<uintptr_t>(offset));
+
+		glTextureSubImage3D(getName(TEXTURE, texture), level, x, y, z, width, height, depth, format, type, pixels);
+		break;
+	}
+
+	case GL_CALL::TEXTURE_PARAMETERI: {
+		GLuint texture = reader.get<GLuint>();
+		GLenum name = reader.get<GLenum>();
+		GLint value = reader.get<GLint>();
+		glTextureParameteri(getName(TEXTURE, texture), name, value);
+		break;
+	}
+
+	case GL_CALL::GENERATE_TEXTURE_MIPMAP:
+		glGenerateTextureMipmap(getName(TEXTURE, reader.get<GLuint>()));
+		break;
+
+	case GL_CALL::BIND_IMAGE_TEXTURE: {
+		GLuint unit = reader.get<GLuint>();
+		GLuint texture = reader.get<GLuint>();
+		GLint level = reader.get<GLint>();
+		GLboolean layered = reader.get<GLboolean>();
+		GLint layer = reader.get<GLint>();
+		GLenum access = reader.get<GLenum>();
+		GLenum format = reader.get<GLenum>();
+		glBindImageTexture(unit, getName(TEXTURE, texture), level, layered, layer, access, format);
+		break;
+	}
+
+	case GL_CALL::NAMED_FRAMEBUFFER_TEXTURE: {
+		GLuint framebuffer = reader.get<GLuint>();
+		GLenum attachment = reader.get<GLenum>();
+		GLuint texture = reader.get<GLuint>();
+		GLint level = reader.get<GLint>();
+		glNamedFramebufferTexture(getName(FRAMEBUFFER, framebuffer), attachment, getName(TEXTURE, texture), level);
+		break;
+	}
+
+	case GL_CALL::BLIT_NAMED_FRAMEBUFFER: {
+		GLuint readFramebuffer = reader.get<GLuint>();
+		GLuint drawFramebuffer = reader.get<GLuint>();
+		GLint source[4];
+		GLint destination[4];
+
+		for (GLint& value : source)
+			value = reader.get<GLint>();
+
+		for (GLint& value : destination)
+			value = reader.get<GLint>();
+
+		GLbitfield mask = reader.get<GLbitfield>();
+		GLenum filter = reader.get<GLenum>();
+		glBlitNamedFramebuffer(getName(FRAMEBUFFER, readFramebuffer), getName(FRAMEBUFFER, drawFramebuffer), source[0], source[1], source[2], source[3],
+			destination[0], destination[1], destination[2], destination[3], mask, filter);
+		break;
+	}
+
+	case GL_CALL::NAMED_FRAMEBUFFER_DRAW_BUFFERS: {
+		GLuint framebuffer = reader.get<GLuint>();
+		GLsizei count = reader.get<GLsizei>();
+		const GLenum* buffers = static_cast<const GLenum*>(reader.payload(payloadSize));
+
+		if (!reader.isValid() || payloadSize != sizeof(GLenum) * static_cast<size_t>(count))
+			return false;
+
+		glNamedFramebufferDrawBuffers(getName(FRAMEBUFFER, framebuffer), count, buffers);
+		break;
+	}
+
+	case GL_CALL::VERTEX_ARRAY_ATTRIB_I_FORMAT: {
+		GLuint vertexArray = reader.get<GLuint>();
+		GLuint index = reader.get<GLuint>();
+		GLint components = reader.get<GLint>();
+		GLenum type = reader.get<GLenum>();
+		GLuint relativeOffset = reader.get<GLuint>();
+		glVertexArrayAttribIFormat(getName(VERTEX_ARRAY, vertexArray), index, components, type, relativeOffset);
+		break;
+	}
+
+	case GL_CALL::VERTEX_ARRAY_BINDING_DIVISOR: {
+		GLuint vertexArray = reader.get<GLuint>();
+		GLuint binding = reader.get<GLuint>();
+		GLuint divisor = reader.get<GLuint>();
+		glVertexArrayBindingDivisor(getName(VERTEX_ARRAY, vertexArray), binding, divisor);
+		break;
+	}
+
+	case GL_CALL::DISPATCH_COMPUTE: {
+		GLuint x = reader.get<GLuint>();
+		GLuint y = reader.get<GLuint>();
+		GLuint z = reader.get<GLuint>();
+		glDispatchCompute(x, y, z);
+		break;
+	}
+
+	case GL_CALL::MEMORY_BARRIER:
+		glMemoryBarrier(reader.get<GLbitfield>());
+		break;
+
+	case GL_CALL::DRAW_ARRAYS_INDIRECT: {
+		GLenum mode = reader.get<GLenum>();
+		uint64_t offset = reader.get<uint64_t>();
+		glDrawArraysIndirect(mode, reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)));
+		break;
+	}
+
+	case GL_CALL::MULTI_DRAW_ARRAYS_INDIRECT: {
+		GLenum mode = reader.get<GLenum>();
+		uint64_t offset = reader.get<uint64_t>();
+		GLsizei drawCount = reader.get<GLsizei>();
+		GLsizei stride = reader.get<GLsizei>();
+		glMultiDrawArraysIndirect(mode, reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)), drawCount, stride);
+		break;
+	}
+
+	case GL_CALL::TEXTURE_SUB_IMAGE_2D: {
+		GLuint texture = reader.get<GLuint>();
+		GLint level = reader.get<GLint>();
+		GLint x = reader.get<GLint>();
+		GLint y = reader.get<GLint>();
+		GLsizei width = reader.get<GLsizei>();
+		GLsizei height = reader.get<GLsizei>();
+		GLenum format = reader.get<GLenum>();
+		GLenum type = reader.get<GLenum>();
+		uint64_t offset = reader.get<uint64_t>();
+		const void* pixels = reader.payload(payloadSize);
+
+		if (!reader.isValid())
+			return false;
+
+		if (pixels == nullptr)
+			pixels = reinterpret_cast<const void*>(static_cast<uintptr_t>(offset));
+
+		glTextureSubImage2D(getName(TEXTURE, texture), level, x, y, width, height, format, type, pixels);
+		break;
+	}
+
+	case GL_CALL::COPY_IMAGE_SUB_DATA: {
+		// the renderbuffers can be copied as well
+		GLuint sourceName = reader.get<GLuint>();
+		GLenum sourceTarget = reader.get<GLenum>();
+		GLint source[4];
+
+		for (GLint& value : source)
+			value = reader.get<GLint>();
+
+		GLuint destinationName = reader.get<GLuint>();
+		GLenum destinationTarget = reader.get<GLenum>();
+		GLint destination[4];
+
+		for (GLint& value : destination)
+			value = reader.get<GLint>();
+
+		GLsizei width = reader.get<GLsizei>();
+		GLsizei height = reader.get<GLsizei>();
+		GLsizei depth = reader.get<GLsizei>();
+
+		sourceName = getName(sourceTarget == GL_RENDERBUFFER ? RENDERBUFFER : TEXTURE, sourceName);
+		destinationName = getName(destinationTarget == GL_RENDERBUFFER ? RENDERBUFFER : TEXTURE, destinationName);
+		glCopyImageSubData(sourceName, sourceTarget, source[0], source[1], source[2], source[3],
+			destinationName, destinationTarget, destination[0], destination[1], destination[2], destination[3], width, height, depth);
+		break;
+	}
+
+	case GL_CALL::CREATE_SAMPLERS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		names.resize(static_cast<size_t>(count));
+		glCreateSamplers(count, names.data());
+		createNames(SAMPLER, count, traceNames, names.data());
+		break;
+	}
+
+	case GL_CALL::DELETE_SAMPLERS: {
+		GLsizei count = reader.get<GLsizei>();
+		const GLuint* traceNames = reader.names(count);
+
+		if (!reader.isValid())
+			return false;
+
+		deleteNames(SAMPLER, count, traceNames, names);
+		glDeleteSamplers(count, names.data());
+		break;
+	}
+
+	case GL_CALL::SAMPLER_PARAMETERI: {
+		GLuint sampler = reader.get<GLuint>();
+		GLenum name = reader.get<GLenum>();
+		GLint value = reader.get<GLint>();
+		glSamplerParameteri(getName(SAMPLER, sampler), name, value);
+		break;
+	}
+
+	case GL_CALL::SAMPLER_PARAMETERF: {
+		GLuint sampler = reader.get<GLuint>();
+		GLenum name = reader.get<GLenum>();
+		GLfloat value = reader.get<GLfloat>();
+		glSamplerParameterf(getName(SAMPLER, sampler), name, value);
+		break;
+	}
+
+	case GL_CALL::PIXEL_STOREI: {
+		GLenum name = reader.get<GLenum>();
+		GLint value = reader.get<GLint>();
+		glPixelStorei(name, value);
+		break;
+	}
+
+	default:
+		return false;
+	}
+
+	return reader.isValid();
+}
@@ -0,0 +1,441 @@
+/*
+	K-Engine GL State
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <gl_state.hpp>
+
+namespace
+{
+	// no object has this name, so the first call is always issued
+	const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+	const GLenum BUFFER_TARGETS[] = {
+		GL_ARRAY_BUFFER,
+		GL_ELEMENT_ARRAY_BUFFER,
+		GL_UNIFORM_BUFFER,
+		GL_SHADER_STORAGE_BUFFER,
+		GL_ATOMIC_COUNTER_BUFFER,
+		GL_DRAW_INDIRECT_BUFFER,
+		GL_DISPATCH_INDIRECT_BUFFER,
+		GL_PIXEL_PACK_BUFFER,
+		GL_PIXEL_UNPACK_BUFFER,
+		GL_COPY_READ_BUFFER,
+		GL_COPY_WRITE_BUFFER
+	};
+
+	const GLenum INDEXED_TARGETS[] = {
+		GL_UNIFORM_BUFFER,
+		GL_SHADER_STORAGE_BUFFER,
+		GL_ATOMIC_COUNTER_BUFFER
+	};
+
+	void setCapability(GLenum capability, bool enable)
+	{
+		if (enable)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+}
+
+/*
+	kengine::pipeline_state class - member class definition
+*/
+
+uint64_t kengine::pipeline_state::computeHash(const pipeline_state_desc& desc)
+{
+	// the fields are hashed one by one (the padding of the struct is not initialized)
+	GLenum fields[] = {
+		desc.blend, desc.blendSrcRGB, desc.blendDstRGB, desc.blendSrcAlpha, desc.blendDstAlpha,
+		desc.blendEquationRGB, desc.blendEquationAlpha,
+		desc.depthTest, desc.depthWrite, desc.depthFunc,
+		desc.cull, desc.cullFace, desc.frontFace,
+		desc.polygonMode
+	};
+
+	return kengine::fnv1a64(fields, sizeof(fields));
+}
+
+/*
+	kengine::gl_state_cache class - member class definition
+*/
+
+int kengine::gl_state_cache::getBufferTargetIndex(GLenum target)
+{
+	static_assert(sizeof(BUFFER_TARGETS) / sizeof(BUFFER_TARGETS[0]) == BUFFER_TARGET_COUNT, "the buffer targets must match the shadow state");
+
+	for (int index = 0; index < BUFFER_TARGET_COUNT; index++) {
+		if (BUFFER_TARGETS[index] == target)
+			return index;
+	}
+
+	return -1;
+}
+
+int kengine::gl_state_cache::getIndexedTargetIndex(GLenum target)
+{
+	for (int index = 0; index < static_cast<int>(sizeof(INDEXED_TARGETS) / sizeof(INDEXED_TARGETS[0])); index++) {
+		if (INDEXED_TARGETS[index] == target)
+			return index;
+	}
+
+	return -1;
+}
+
+bool kengine::gl_state_cache::useProgram(GLuint program)
+{
+	if (!changed(m_program != program))
+		return false;
+
+	glUseProgram(program);
+	m_program = program;
+	return true;
+}
+
+bool kengine::gl_state_cache::bindProgramPipeline(GLuint pipeline)
+{
+	if (!changed(m_programPipeline != pipeline))
+		return false;
+
+	glBindProgramPipeline(pipeline);
+	m_programPipeline = pipeline;
+	return true;
+}
+
+bool kengine::gl_state_cache::bindVertexArray(GLuint vao)
+{
+	if (!changed(m_vao != vao))
+		return false;
+
+	glBindVertexArray(vao);
+	m_vao = vao;
+
+	// the element array buffer is a state of the vertex array
+	m_buffers[getBufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+	return true;
+}
+
+bool kengine::gl_state_cache::bindBuffer(GLenum target, GLuint buffer)
+{
+	int index = getBufferTargetIndex(target);
+
+	if (!changed(index < 0 || m_buffers[index] != buffer))
+		return false;
+
+	glBindBuffer(target, buffer);
+
+	if (index >= 0)
+		m_buffers[index] = buffer;
+
+	return true;
+}
+
+bool kengine::gl_state_cache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	int targetIndex = getIndexedTargetIndex(target);
+	bool cached = targetIndex >= 0 && index < MAX_BUFFER_BINDINGS;
+
+	if (cached) {
+		const buffer_range& range = m_indexedBuffers[targetIndex][index];
+
+		if (!changed(range.buffer != buffer || range.offset != offset || range.size != size))
+			return false;
+	}
+	else {
+		changed(true);
+	}
+
+	glBindBufferRange(target, index, buffer, offset, size);
+
+	if (cached) {
+		buffer_range& range = m_indexedBuffers[targetIndex][index];
+		range.buffer = buffer;
+		range.offset = offset;
+		range.size = size;
+	}
+
+	// the generic binding point is changed too
+	int genericIndex = getBufferTargetIndex(target);
+
+	if (genericIndex >= 0)
+		m_buffers[genericIndex] = buffer;
+
+	return true;
+}
+
+bool kengine::gl_state_cache::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	// the whole buffer is stored as the range (0, 0)
+	int targetIndex = getIndexedTargetIndex(target);
+	bool cached = targetIndex >= 0 && index < MAX_BUFFER_BINDINGS;
+
+	if (cached) {
+		const buffer_range& range = m_indexedBuffers[targetIndex][index];
+
+		if (!changed(range.buffer != buffer || range.offset != 0 || range.size != 0))
+			return false;
+	}
+	else {
+		changed(true);
+	}
+
+	glBindBufferBase(target, index, buffer);
+
+	if (cached) {
+		buffer_range& range = m_indexedBuffers[targetIndex][index];
+		range.buffer = buffer;
+		range.offset = 0;
+		range.size = 0;
+	}
+
+	int genericIndex = getBufferTargetIndex(target);
+
+	if (genericIndex >= 0)
+		m_buffers[genericIndex] = buffer;
+
+	return true;
+}
+
+bool kengine::gl_state_cache::bindTexture(GLuint unit, GLuint texture)
+{
+	bool cached = unit < MAX_TEXTURE_UNITS;
+
+	if (!changed(!cached || m_textures[unit] != texture))
+		return false;
+
+	glBindTextureUnit(unit, texture);
+
+	if (cached)
+		m_textures[unit] = texture;
+
+	return true;
+}
+
+bool kengine::gl_state_cache::bindSampler(GLuint unit, GLuint sampler)
+{
+	bool cached = unit < MAX_TEXTURE_UNITS;
+
+	if (!changed(!cached || m_samplers[unit] != sampler))
+		return false;
+
+	glBindSampler(unit, sampler);
+
+	if (cached)
+		m_samplers[unit] = sampler;
+
+	return true;
+}
+
+void kengine::gl_state_cache::apply(const pipeline_state& state)
+{
+	const pipeline_state_desc& desc = state.getDesc();
+
+	if (changed(BLEND, m_pipeline.blend != desc.blend))
+		setCapability(GL_BLEND, desc.blend);
+
+	// the blend function and the blend equation are only relevant (and compared) if the blend is enabled
+	if (desc.blend) {
+		if (changed(BLEND_FUNC, m_pipeline.blendSrcRGB != desc.blendSrcRGB || m_pipeline.blendDstRGB != desc.blendDstRGB ||
+			m_pipeline.blendSrcAlpha != desc.blendSrcAlpha || m_pipeline.blendDstAlpha != desc.blendDstAlpha))
+			glBlendFuncSeparate(desc.blendSrcRGB, desc.blendDstRGB, desc.blendSrcAlpha, desc.blendDstAlpha);
+
+		if (changed(BLEND_EQUATION, m_pipeline.blendEquationRGB != desc.blendEquationRGB || m_pipeline.blendEquationAlpha != desc.blendEquationAlpha))
+			glBlendEquationSeparate(desc.blendEquationRGB, desc.blendEquationAlpha);
+
+		m_pipeline.blendSrcRGB = desc.blendSrcRGB;
+		m_pipeline.blendDstRGB = desc.blendDstRGB;
+		m_pipeline.blendSrcAlpha = desc.blendSrcAlpha;
+		m_pipeline.blendDstAlpha = desc.blendDstAlpha;
+		m_pipeline.blendEquationRGB = desc.blendEquationRGB;
+		m_pipeline.blendEquationAlpha = desc.blendEquationAlpha;
+		m_validFields |= BLEND_FUNC | BLEND_EQUATION;
+	}
+
+	if (changed(DEPTH_TEST, m_pipeline.depthTest != desc.depthTest))
+		setCapability(GL_DEPTH_TEST, desc.depthTest);
+
+	if (changed(DEPTH_WRITE, m_pipeline.depthWrite != desc.depthWrite))
+		glDepthMask(desc.depthWrite ? GL_TRUE : GL_FALSE);
+
+	if (desc.depthTest && changed(DEPTH_FUNC, m_pipeline.depthFunc != desc.depthFunc)) {
+		glDepthFunc(desc.depthFunc);
+		m_pipeline.depthFunc = desc.depthFunc;
+		m_validFields |= DEPTH_FUNC;
+	}
+
+	if (changed(CULL, m_pipeline.cull != desc.cull))
+		setCapability(GL_CULL_FACE, desc.cull);
+
+	if (desc.cull) {
+		if (changed(CULL_FACE, m_pipeline.cullFace != desc.cullFace))
+			glCullFace(desc.cullFace);
+
+		if (changed(FRONT_FACE, m_pipeline.frontFace != desc.frontFace))
+			glFrontFace(desc.frontFace);
+
+		m_pipeline.cullFace = desc.cullFace;
+		m_pipeline.frontFace = desc.frontFace;
+		m_validFields |= CULL_FACE | FRONT_FACE;
+	}
+
+	setPolygonMode(desc.polygonMode);
+
+	m_pipeline.blend = desc.blend;
+	m_pipeline.depthTest = desc.depthTest;
+	m_pipeline.depthWrite = desc.depthWrite;
+	m_pipeline.cull = desc.cull;
+	m_validFields |= BLEND | DEPTH_TEST | DEPTH_WRITE | CULL;
+}
+
+bool kengine::gl_state_cache::setPolygonMode(GLenum mode)
+{
+	if (!changed(POLYGON_MODE, m_pipeline.polygonMode != mode))
+		return false;
+
+#if !defined(__ANDROID__)
+	glPolygonMode(GL_FRONT_AND_BACK, mode);
+#endif
+	m_pipeline.polygonMode = mode;
+	m_validFields |= POLYGON_MODE;
+	return true;
+}
+
+void kengine::gl_state_cache::invalidate()
+{
+	m_thread = std::this_thread::get_id();
+	m_program = UNKNOWN;
+	m_programPipeline = UNKNOWN;
+	m_vao = UNKNOWN;
+
+	for (auto& buffer : m_buffers)
+		buffer = UNKNOWN;
+
+	for (auto& target : m_indexedBuffers) {
+		for (auto& range : target) {
+			range.buffer = UNKNOWN;
+			range.offset = 0;
+			range.size = 0;
+		}
+	}
+
+	for (GLuint unit = 0; unit < MAX_TEXTURE_UNITS; unit++) {
+		m_textures[unit] = UNKNOWN;
+		m_samplers[unit] = UNKNOWN;
+	}
+
+	m_validFields = 0;
+}
+
+void kengine::gl_state_cache::releaseBuffer(GLuint buffer)
+{
+	if (!isOwnerThread())
+		return;
+
+	for (auto& bound : m_buffers) {
+		if (bound == buffer)
+			bound = UNKNOWN;
+	}
+
+	for (auto& target : m_indexedBuffers) {
+		for (auto& range : target) {
+			if (range.buffer == buffer)
+				range.buffer = UNKNOWN;
+		}
+	}
+}
+
+void kengine::gl_state_cache::releaseTexture(GLuint texture)
+{
+	if (!isOwnerThread())
+		return;
+
+	for (auto& bound : m_textures) {
+		if (bound == texture)
+			bound = UNKNOWN;
+	}
+}
+
+void kengine::gl_state_cache::releaseSampler(GLuint sampler)
+{
+	if (!isOwnerThread())
+		return;
+
+	for (auto& bound : m_samplers) {
+		if (bound == sampler)
+			bound = UNKNOWN;
+	}
+}
+
+void kengine::gl_state_cache::releaseVertexArray(GLuint vao)
+{
+	if (isOwnerThread() && m_vao == vao)
+		m_vao = UNKNOWN;
+}
+
+void kengine::gl_state_cache::releaseProgram(GLuint program)
+{
+	if (isOwnerThread() && m_program == program)
+		m_program = UNKNOWN;
+}
+
+void kengine::gl_state_cache::releaseProgramPipeline(GLuint pipeline)
+{
+	if (isOwnerThread() && m_programPipeline == pipeline)
+		m_programPipeline = UNKNOWN;
+}
+
+void kengine::gl_state_cache::newFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = gl_state_stats();
+}
+
+kengine::gl_state_cache& kengine::glState()
+{
+	static gl_state_cache state;
+	return state;
+}
+
+void kengine::deleteTrackedBuffer(GLuint& buffer)
+{
+	if (buffer == 0)
+		return;
+
+	kengine::gpuMemoryTracker().release(GPU_MEMORY_CATEGORY::BUFFER, buffer);
+	kengine::glState().releaseBuffer(buffer);
+	glDeleteBuffers(1, &buffer);
+	buffer = 0;
+}
+
+void kengine::deleteTrackedTexture(GLuint& texture, GPU_MEMORY_CATEGORY category)
+{
+	if (texture == 0)
+		return;
+
+	kengine::gpuMemoryTracker().release(category, texture);
+	kengine::glState().releaseTexture(texture);
+	glDeleteTextures(1, &texture);
+	texture = 0;
+}
@@ -24,8 +24,16 @@
 */
 
 #include <gl_wrapper.hpp>
+#include <vertex_format.hpp>
+#include <gpu_memory.hpp>
+#include <program_cache.hpp>
+#include <shader_preprocessor.hpp>
+#include <gl_state.hpp>
+#include <gl_capture.hpp>
 #include <logger.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <fstream>
 #include <cstring>
@@ -45,6 +53,7 @@ PFNGLCOPYNAMEDBUFFERSUBDATAPROC glCopyNamedBufferSubData = 0;
 PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData = 0;
 PFNGLGETNAMEDBUFFERSUBDATAPROC glGetNamedBufferSubData = 0;
 PFNGLGETBUFFERSUBDATAPROC glGetBufferSubData = 0;
+PFNGLGETNAMEDBUFFERPARAMETERI64VPROC glGetNamedBufferParameteri64v = 0;
 PFNGLMAPNAMEDBUFFERPROC glMapNamedBuffer = 0;
 PFNGLMAPBUFFERPROC glMapBuffer = 0;
 PFNGLUNMAPNAMEDBUFFERPROC glUnmapNamedBuffer = 0;
@@ -72,12 +81,47 @@ PFNGLENABLEVERTEXARRAYATTRIBPROC glEnableVertexArrayAttrib = 0;
 PFNGLDISABLEVERTEXARRAYATTRIBPROC glDisableVertexArrayAttrib = 0;
 PFNGLVERTEXARRAYATTRIBFORMATPROC glVertexArrayAttribFormat = 0;
 PFNGLVERTEXARRAYVERTEXBUFFERSPROC glVertexArrayVertexBuffers = 0;
+PFNGLVERTEXARRAYVERTEXBUFFERPROC glVertexArrayVertexBuffer = 0;
+PFNGLVERTEXARRAYATTRIBBINDINGPROC glVertexArrayAttribBinding = 0;
 PFNGLBINDVERTEXBUFFERPROC glBindVertexBuffer = 0;
-PFNGLVERTEXATTRIBFORMATPROC glVertexAtttribFormat = 0;
+PFNGLVERTEXATTRIBFORMATPROC glVertexAttribFormat = 0;
 PFNGLVERTEXATTRIBBINDINGPROC glVertexAttribBinding = 0;
 PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation = 0;
 PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC glDrawArraysInstancedBaseInstance = 0;
 PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv = 0;
+PFNGLUNIFORM1FVPROC glUniform1fv = 0;
+PFNGLUNIFORM2FVPROC glUniform2fv = 0;
+PFNGLUNIFORM3FVPROC glUniform3fv = 0;
+PFNGLUNIFORM4FVPROC glUniform4fv = 0;
+PFNGLUNIFORM1IVPROC glUniform1iv = 0;
+PFNGLUNIFORM2IVPROC glUniform2iv = 0;
+PFNGLUNIFORM3IVPROC glUniform3iv = 0;
+PFNGLUNIFORM4IVPROC glUniform4iv = 0;
+PFNGLUNIFORM1UIVPROC glUniform1uiv = 0;
+PFNGLUNIFORM2UIVPROC glUniform2uiv = 0;
+PFNGLUNIFORM3UIVPROC glUniform3uiv = 0;
+PFNGLUNIFORM4UIVPROC glUniform4uiv = 0;
+PFNGLUNIFORM1DVPROC glUniform1dv = 0;
+PFNGLUNIFORM2DVPROC glUniform2dv = 0;
+PFNGLUNIFORM3DVPROC glUniform3dv = 0;
+PFNGLUNIFORM4DVPROC glUniform4dv = 0;
+PFNGLUNIFORMMATRIX2FVPROC glUniformMatrix2fv = 0;
+PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv = 0;
+PFNGLUNIFORMMATRIX2X3FVPROC glUniformMatrix2x3fv = 0;
+PFNGLUNIFORMMATRIX3X2FVPROC glUniformMatrix3x2fv = 0;
+PFNGLUNIFORMMATRIX2X4FVPROC glUniformMatrix2x4fv = 0;
+PFNGLUNIFORMMATRIX4X2FVPROC glUniformMatrix4x2fv = 0;
+PFNGLUNIFORMMATRIX3X4FVPROC glUniformMatrix3x4fv = 0;
+PFNGLUNIFORMMATRIX4X3FVPROC glUniformMatrix4x3fv = 0;
+PFNGLUNIFORMMATRIX2DVPROC glUniformMatrix2dv = 0;
+PFNGLUNIFORMMATRIX3DVPROC glUniformMatrix3dv = 0;
+PFNGLUNIFORMMATRIX4DVPROC glUniformMatrix4dv = 0;
+PFNGLUNIFORMMATRIX2X3DVPROC glUniformMatrix2x3dv = 0;
+PFNGLUNIFORMMATRIX3X2DVPROC glUniformMatrix3x2dv = 0;
+PFNGLUNIFORMMATRIX2X4DVPROC glUniformMatrix2x4dv = 0;
+PFNGLUNIFORMMATRIX4X2DVPROC glUniformMatrix4x2dv = 0;
+PFNGLUNIFORMMATRIX3X4DVPROC glUniformMatrix3x4dv = 0;
+PFNGLUNIFORMMATRIX4X3DVPROC glUniformMatrix4x3dv = 0;
 PFNGLGETSTRINGIPROC glGetStringi = 0;
 PFNGLCREATESHADERPROC glCreateShader = 0;
 PFNGLDELETESHADERPROC glDeleteShader = 0;
@@ -100,6 +144,7 @@ PFNGLSPECIALIZESHADERPROC glSpecializeShader = 0;
 PFNGLGETPROGRAMINTERFACEIVPROC glGetProgramInterfaceiv = 0;
 PFNGLGETPROGRAMRESOURCEIVPROC glGetProgramResourceiv = 0;
 PFNGLGETPROGRAMRESOURCENAMEPROC glGetProgramResourceName = 0;
+PFNGLGETPROGRAMRESOURCEINDEXPROC glGetProgramResourceIndex = 0;
 PFNGLGETACTIVEATTRIBPROC glGetActiveAttrib = 0;
 PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation = 0;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = 0;
@@ -110,11 +155,19 @@ PFNGLGETACTIVEUNIFORMBLOCKIVPROC glGetActiveUniformBlockiv = 0;
 PFNGLGETUNIFORMINDICESPROC glGetUniformIndices = 0;
 PFNGLGETACTIVEUNIFORMSIVPROC glGetActiveUniformsiv = 0;
 PFNGLBINDBUFFERBASEPROC glBindBufferBase = 0;
+PFNGLBINDBUFFERRANGEPROC glBindBufferRange = 0;
+PFNGLBINDTEXTUREUNITPROC glBindTextureUnit = 0;
+PFNGLBINDSAMPLERPROC glBindSampler = 0;
+PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate = 0;
+PFNGLBLENDEQUATIONSEPARATEPROC glBlendEquationSeparate = 0;
 PFNGLCREATESHADERPROGRAMVPROC glCreateShaderProgramv = 0;
 PFNGLCREATEPROGRAMPIPELINESPROC glCreateProgramPipelines = 0;
 PFNGLDELETEPROGRAMPIPELINESPROC glDeleteProgramPipelines = 0;
 PFNGLUSEPROGRAMSTAGESPROC glUseProgramStages = 0;
 PFNGLBINDPROGRAMPIPELINEPROC glBindProgramPipeline = 0;
+PFNGLVALIDATEPROGRAMPIPELINEPROC glValidateProgramPipeline = 0;
+PFNGLGETPROGRAMPIPELINEIVPROC glGetProgramPipelineiv = 0;
+PFNGLGETPROGRAMPIPELINEINFOLOGPROC glGetProgramPipelineInfoLog = 0;
 PFNGLPROGRAMUNIFORM3FPROC glProgramUniform3f = 0;
 PFNGLACTIVESHADERPROGRAMPROC glActiveShaderProgram = 0;
 PFNGLPROGRAMPARAMETERIPROC glProgramParameteri = 0;
@@ -122,6 +175,48 @@ PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback = 0;
 PFNGLDEBUGMESSAGECONTROLPROC glDebugMessageControl = 0;
 PFNGLPUSHDEBUGGROUPPROC glPushDebugGroup = 0;
 PFNGLPOPDEBUGGROUPPROC glPopDebugGroup = 0;
+PFNGLGENQUERIESPROC glGenQueries = 0;
+PFNGLDELETEQUERIESPROC glDeleteQueries = 0;
+PFNGLBEGINQUERYPROC glBeginQuery = 0;
+PFNGLENDQUERYPROC glEndQuery = 0;
+PFNGLGETQUERYOBJECTUIVPROC glGetQueryObjectuiv = 0;
+PFNGLQUERYCOUNTERPROC glQueryCounter = 0;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = 0;
+PFNGLCREATEFRAMEBUFFERSPROC glCreateFramebuffers = 0;
+PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers = 0;
+PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer = 0;
+PFNGLCREATERENDERBUFFERSPROC glCreateRenderbuffers = 0;
+PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers = 0;
+PFNGLNAMEDRENDERBUFFERSTORAGEPROC glNamedRenderbufferStorage = 0;
+PFNGLNAMEDFRAMEBUFFERRENDERBUFFERPROC glNamedFramebufferRenderbuffer = 0;
+PFNGLCHECKNAMEDFRAMEBUFFERSTATUSPROC glCheckNamedFramebufferStatus = 0;
+PFNGLDISPATCHCOMPUTEPROC glDispatchCompute = 0;
+PFNGLMEMORYBARRIERPROC glMemoryBarrier = 0;
+PFNGLDRAWARRAYSINDIRECTPROC glDrawArraysIndirect = 0;
+PFNGLMULTIDRAWARRAYSINDIRECTPROC glMultiDrawArraysIndirect = 0;
+PFNGLBINDIMAGETEXTUREPROC glBindImageTexture = 0;
+PFNGLCREATETEXTURESPROC glCreateTextures = 0;
+PFNGLTEXTURESTORAGE2DPROC glTextureStorage2D = 0;
+PFNGLTEXTUREPARAMETERIPROC glTextureParameteri = 0;
+PFNGLNAMEDFRAMEBUFFERTEXTUREPROC glNamedFramebufferTexture = 0;
+PFNGLBLITNAMEDFRAMEBUFFERPROC glBlitNamedFramebuffer = 0;
+PFNGLVERTEXARRAYATTRIBIFORMATPROC glVertexArrayAttribIFormat = 0;
+PFNGLVERTEXARRAYBINDINGDIVISORPROC glVertexArrayBindingDivisor = 0;
+PFNGLNAMEDFRAMEBUFFERDRAWBUFFERSPROC glNamedFramebufferDrawBuffers = 0;
+PFNGLCREATESAMPLERSPROC glCreateSamplers = 0;
+PFNGLDELETESAMPLERSPROC glDeleteSamplers = 0;
+PFNGLSAMPLERPARAMETERIPROC glSamplerParameteri = 0;
+PFNGLSAMPLERPARAMETERFPROC glSamplerParameterf = 0;
+PFNGLCOPYIMAGESUBDATAPROC glCopyImageSubData = 0;
+PFNGLTEXTURESUBIMAGE2DPROC glTextureSubImage2D = 0;
+PFNGLGETTEXTUREIMAGEPROC glGetTextureImage = 0;
+PFNGLTEXTURESTORAGE3DPROC glTextureStorage3D = 0;
+PFNGLTEXTURESUBIMAGE3DPROC glTextureSubImage3D = 0;
+PFNGLGENERATETEXTUREMIPMAPPROC glGenerateTextureMipmap = 0;
+PFNGLFENCESYNCPROC glFenceSync = 0;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync = 0;
+PFNGLDELETESYNCPROC glDeleteSync = 0;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR = 0;
 PFNGLPRIMITIVERESTARTINDEXPROC glPrimitiveRestartIndex = 0;
 
 bool kengine::getAllGLProcedures()
@@ -141,6 +236,7 @@ bool kengine::getAllGLProcedures()
 	glCopyBufferSubData = (PFNGLCOPYBUFFERSUBDATAPROC)getGLFunctionAddress("glCopyBufferSubData");
 	glGetNamedBufferSubData = (PFNGLGETNAMEDBUFFERSUBDATAPROC)getGLFunctionAddress("glGetNamedBufferSubData");
 	glGetBufferSubData = (PFNGLGETBUFFERSUBDATAPROC)getGLFunctionAddress("glGetBufferSubData");
+	glGetNamedBufferParameteri64v = (PFNGLGETNAMEDBUFFERPARAMETERI64VPROC)getGLFunctionAddress("glGetNamedBufferParameteri64v");
 	glMapNamedBuffer = (PFNGLMAPNAMEDBUFFERPROC)getGLFunctionAddress("glMapNamedBuffer");
 	glMapBuffer = (PFNGLMAPBUFFERPROC)getGLFunctionAddress("glMapBuffer");
 	glUnmapNamedBuffer = (PFNGLUNMAPNAMEDBUFFERPROC)getGLFunctionAddress("glUnmapNamedBuffer");
@@ -168,12 +264,47 @@ bool kengine::getAllGLProcedures()
 	glDisableVertexArrayAttrib = (PFNGLDISABLEVERTEXARRAYATTRIBPROC)getGLFunctionAddress("glDisableVertexArrayAttrib");
 	glVertexArrayAttribFormat = (PFNGLVERTEXARRAYATTRIBFORMATPROC)getGLFunctionAddress("glVertexArrayAttribFormat");
 	glVertexArrayVertexBuffers = (PFNGLVERTEXARRAYVERTEXBUFFERSPROC)getGLFunctionAddress("glVertexArrayVertexBuffers");
+	glVertexArrayVertexBuffer = (PFNGLVERTEXARRAYVERTEXBUFFERPROC)getGLFunctionAddress("glVertexArrayVertexBuffer");
+	glVertexArrayAttribBinding = (PFNGLVERTEXARRAYATTRIBBINDINGPROC)getGLFunctionAddress("glVertexArrayAttribBinding");
 	glBindVertexBuffer = (PFNGLBINDVERTEXBUFFERPROC)getGLFunctionAddress("glBindVertexBuffer");
-	glVertexAtttribFormat = (PFNGLVERTEXATTRIBFORMATPROC)getGLFunctionAddress("glVertexAtttribFormat");
+	glVertexAttribFormat = (PFNGLVERTEXATTRIBFORMATPROC)getGLFunctionAddress("glVertexAttribFormat");
 	glVertexAttribBinding = (PFNGLVERTEXATTRIBBINDINGPROC)getGLFunctionAddress("glVertexAttribBinding");
 	glBindAttribLocation = (PFNGLBINDATTRIBLOCATIONPROC)getGLFunctionAddress("glBindAttribLocation");
 	glDrawArraysInstancedBaseInstance = (PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC)getGLFunctionAddress("glDrawArraysInstancedBaseInstance");
 	glUniformMatrix4fv = (PFNGLUNIFORMMATRIX4FVPROC)getGLFunctionAddress("glUniformMatrix4fv");
+	glUniform1fv = (PFNGLUNIFORM1FVPROC)getGLFunctionAddress("glUniform1fv");
+	glUniform2fv = (PFNGLUNIFORM2FVPROC)getGLFunctionAddress("glUniform2fv");
+	glUniform3fv = (PFNGLUNIFORM3FVPROC)getGLFunctionAddress("glUniform3fv");
+	glUniform4fv = (PFNGLUNIFORM4FVPROC)getGLFunctionAddress("glUniform4fv");
+	glUniform1iv = (PFNGLUNIFORM1IVPROC)getGLFunctionAddress("glUniform1iv");
+	glUniform2iv = (PFNGLUNIFORM2IVPROC)getGLFunctionAddress("glUniform2iv");
+	glUniform3iv = (PFNGLUNIFORM3IVPROC)getGLFunctionAddress("glUniform3iv");
+	glUniform4iv = (PFNGLUNIFORM4IVPROC)getGLFunctionAddress("glUniform4iv");
+	glUniform1uiv = (PFNGLUNIFORM1UIVPROC)getGLFunctionAddress("glUniform1uiv");
+	glUniform2uiv = (PFNGLUNIFORM2UIVPROC)getGLFunctionAddress("glUniform2uiv");
+	glUniform3uiv = (PFNGLUNIFORM3UIVPROC)getGLFunctionAddress("glUniform3uiv");
+	glUniform4uiv = (PFNGLUNIFORM4UIVPROC)getGLFunctionAddress("glUniform4uiv");
+	glUniform1dv = (PFNGLUNIFORM1DVPROC)getGLFunctionAddress("glUniform1dv");
+	glUniform2dv = (PFNGLUNIFORM2DVPROC)getGLFunctionAddress("glUniform2dv");
+	glUniform3dv = (PFNGLUNIFORM3DVPROC)getGLFunctionAddress("glUniform3dv");
+	glUniform4dv = (PFNGLUNIFORM4DVPROC)getGLFunctionAddress("glUniform4dv");
+	glUniformMatrix2fv = (PFNGLUNIFORMMATRIX2FVPROC)getGLFunctionAddress("glUniformMatrix2fv");
+	glUniformMatrix3fv = (PFNGLUNIFORMMATRIX3FVPROC)getGLFunctionAddress("glUniformMatrix3fv");
+	glUniformMatrix2x3fv = (PFNGLUNIFORMMATRIX2X3FVPROC)getGLFunctionAddress("glUniformMatrix2x3fv");
+	glUniformMatrix3x2fv = (PFNGLUNIFORMMATRIX3X2FVPROC)getGLFunctionAddress("glUniformMatrix3x2fv");
+	glUniformMatrix2x4fv = (PFNGLUNIFORMMATRIX2X4FVPROC)getGLFunctionAddress("glUniformMatrix2x4fv");
+	glUniformMatrix4x2fv = (PFNGLUNIFORMMATRIX4X2FVPROC)getGLFunctionAddress("glUniformMatrix4x2fv");
+	glUniformMatrix3x4fv = (PFNGLUNIFORMMATRIX3X4FVPROC)getGLFunctionAddress("glUniformMatrix3x4fv");
+	glUniformMatrix4x3fv = (PFNGLUNIFORMMATRIX4X3FVPROC)getGLFunctionAddress("glUniformMatrix4x3fv");
+	glUniformMatrix2dv = (PFNGLUNIFORMMATRIX2DVPROC)getGLFunctionAddress("glUniformMatrix2dv");
+	glUniformMatrix3dv = (PFNGLUNIFORMMATRIX3DVPROC)getGLFunctionAddress("glUniformMatrix3dv");
+	glUniformMatrix4dv = (PFNGLUNIFORMMATRIX4DVPROC)getGLFunctionAddress("glUniformMatrix4dv");
+	glUniformMatrix2x3dv = (PFNGLUNIFORMMATRIX2X3DVPROC)getGLFunctionAddress("glUniformMatrix2x3dv");
+	glUniformMatrix3x2dv = (PFNGLUNIFORMMATRIX3X2DVPROC)getGLFunctionAddress("glUniformMatrix3x2dv");
+	glUniformMatrix2x4dv = (PFNGLUNIFORMMATRIX2X4DVPROC)getGLFunctionAddress("glUniformMatrix2x4dv");
+	glUniformMatrix4x2dv = (PFNGLUNIFORMMATRIX4X2DVPROC)getGLFunctionAddress("glUniformMatrix4x2dv");
+	glUniformMatrix3x4dv = (PFNGLUNIFORMMATRIX3X4DVPROC)getGLFunctionAddress("glUniformMatrix3x4dv");
+	glUniformMatrix4x3dv = (PFNGLUNIFORMMATRIX4X3DVPROC)getGLFunctionAddress("glUniformMatrix4x3dv");
 	glGetStringi = (PFNGLGETSTRINGIPROC)getGLFunctionAddress("glGetStringi");
 	glCreateShader = (PFNGLCREATESHADERPROC)getGLFunctionAddress("glCreateShader");
 	glDeleteShader = (PFNGLDELETESHADERPROC)getGLFunctionAddress("glDeleteShader");
@@ -196,6 +327,7 @@ bool kengine::getAllGLProcedures()
 	glGetProgramInterfaceiv = (PFNGLGETPROGRAMINTERFACEIVPROC)getGLFunctionAddress("glGetProgramInterfaceiv");
 	glGetProgramResourceiv = (PFNGLGETPROGRAMRESOURCEIVPROC)getGLFunctionAddress("glGetProgramResourceiv");
 	glGetProgramResourceName = (PFNGLGETPROGRAMRESOURCENAMEPROC)getGLFunctionAddress("glGetProgramResourceName");
+	glGetProgramResourceIndex = (PFNGLGETPROGRAMRESOURCEINDEXPROC)getGLFunctionAddress("glGetProgramResourceIndex");
 	glGetActiveAttrib = (PFNGLGETACTIVEATTRIBPROC)getGLFunctionAddress("glGetActiveAttrib");
 	glGetAttribLocation = (PFNGLGETATTRIBLOCATIONPROC)getGLFunctionAddress("glGetAttribLocation");
 	glGetUniformLocation = (PFNGLGETUNIFORMLOCATIONPROC)getGLFunctionAddress("glGetUniformLocation");
@@ -206,11 +338,19 @@ bool kengine::getAllGLProcedures()
 	glGetUniformIndices = (PFNGLGETUNIFORMINDICESPROC)getGLFunctionAddress("glGetUniformIndices");
 	glGetActiveUniformsiv = (PFNGLGETACTIVEUNIFORMSIVPROC)getGLFunctionAddress("glGetActiveUniformsiv");
 	glBindBufferBase = (PFNGLBINDBUFFERBASEPROC)getGLFunctionAddress("glBindBufferBase");
+	glBindBufferRange = (PFNGLBINDBUFFERRANGEPROC)getGLFunctionAddress("glBindBufferRange");
+	glBindTextureUnit = (PFNGLBINDTEXTUREUNITPROC)getGLFunctionAddress("glBindTextureUnit");
+	glBindSampler = (PFNGLBINDSAMPLERPROC)getGLFunctionAddress("glBindSampler");
+	glBlendFuncSeparate = (PFNGLBLENDFUNCSEPARATEPROC)getGLFunctionAddress("glBlendFuncSeparate");
+	glBlendEquationSeparate = (PFNGLBLENDEQUATIONSEPARATEPROC)getGLFunctionAddress("glBlendEquationSeparate");
 	glCreateShaderProgramv = (PFNGLCREATESHADERPROGRAMVPROC)getGLFunctionAddress("glCreateShaderProgramv");
 	glCreateProgramPipelines = (PFNGLCREATEPROGRAMPIPELINESPROC)getGLFunctionAddress("glCreateProgramPipelines");
 	glDeleteProgramPipelines = (PFNGLDELETEPROGRAMPIPELINESPROC)getGLFunctionAddress("glDeleteProgramPipelines");
 	glUseProgramStages = (PFNGLUSEPROGRAMSTAGESPROC)getGLFunctionAddress("glUseProgramStages");
 	glBindProgramPipeline = (PFNGLBINDPROGRAMPIPELINEPROC)getGLFunctionAddress("glBindProgramPipeline");
+	glValidateProgramPipeline = (PFNGLVALIDATEPROGRAMPIPELINEPROC)getGLFunctionAddress("glValidateProgramPipeline");
+	glGetProgramPipelineiv = (PFNGLGETPROGRAMPIPELINEIVPROC)getGLFunctionAddress("glGetProgramPipelineiv");
+	glGetProgramPipelineInfoLog = (PFNGLGETPROGRAMPIPELINEINFOLOGPROC)getGLFunctionAddress("glGetProgramPipelineInfoLog");
 	glProgramUniform3f = (PFNGLPROGRAMUNIFORM3FPROC)getGLFunctionAddress("glProgramUniform3f");
 	glActiveShaderProgram = (PFNGLACTIVESHADERPROGRAMPROC)getGLFunctionAddress("glActiveShaderProgram");
 	glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)getGLFunctionAddress("glProgramParameteri");
@@ -218,6 +358,48 @@ bool kengine::getAllGLProcedures()
 	glDebugMessageControl = (PFNGLDEBUGMESSAGECONTROLPROC)getGLFunctionAddress("glDebugMessageControl");
 	glPushDebugGroup = (PFNGLPUSHDEBUGGROUPPROC)getGLFunctionAddress("glPushDebugGroup");
 	glPopDebugGroup = (PFNGLPOPDEBUGGROUPPROC)getGLFunctionAddress("glPopDebugGroup");
+	glGenQueries = (PFNGLGENQUERIESPROC)getGLFunctionAddress("glGenQueries");
+	glDeleteQueries = (PFNGLDELETEQUERIESPROC)getGLFunctionAddress("glDeleteQueries");
+	glBeginQuery = (PFNGLBEGINQUERYPROC)getGLFunctionAddress("glBeginQuery");
+	glEndQuery = (PFNGLENDQUERYPROC)getGLFunctionAddress("glEndQuery");
+	glGetQueryObjectuiv = (PFNGLGETQUERYOBJECTUIVPROC)getGLFunctionAddress("glGetQueryObjectuiv");
+	glQueryCounter = (PFNGLQUERYCOUNTERPROC)getGLFunctionAddress("glQueryCounter");
+	glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)getGLFunctionAddress("glGetQueryObjectui64v");
+	glCreateFramebuffers = (PFNGLCREATEFRAMEBUFFERSPROC)getGLFunctionAddress("glCreateFramebuffers");
+	glDeleteFramebuffers = (PFNGLDELETEFRAMEBUFFERSPROC)getGLFunctionAddress("glDeleteFramebuffers");
+	glBindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)getGLFunctionAddress("glBindFramebuffer");
+	glCreateRenderbuffers = (PFNGLCREATERENDERBUFFERSPROC)getGLFunctionAddress("glCreateRenderbuffers");
+	glDeleteRenderbuffers = (PFNGLDELETERENDERBUFFERSPROC)getGLFunctionAddress("glDeleteRenderbuffers");
+	glNamedRenderbufferStorage = (PFNGLNAMEDRENDERBUFFERSTORAGEPROC)getGLFunctionAddress("glNamedRenderbufferStorage");
+	glNamedFramebufferRenderbuffer = (PFNGLNAMEDFRAMEBUFFERRENDERBUFFERPROC)getGLFunctionAddress("glNamedFramebufferRenderbuffer");
+	glCheckNamedFramebufferStatus = (PFNGLCHECKNAMEDFRAMEBUFFERSTATUSPROC)getGLFunctionAddress("glCheckNamedFramebufferStatus");
+	glDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)getGLFunctionAddress("glDispatchCompute");
+	glMemoryBarrier = (PFNGLMEMORYBARRIERPROC)getGLFunctionAddress("glMemoryBarrier");
+	glDrawArraysIndirect = (PFNGLDRAWARRAYSINDIRECTPROC)getGLFunctionAddress("glDrawArraysIndirect");
+	glMultiDrawArraysIndirect = (PFNGLMULTIDRAWARRAYSINDIRECTPROC)getGLFunctionAddress("glMultiDrawArraysIndirect");
+	glBindImageTexture = (PFNGLBINDIMAGETEXTUREPROC)getGLFunctionAddress("glBindImageTexture");
+	glCreateTextures = (PFNGLCREATETEXTURESPROC)getGLFunctionAddress("glCreateTextures");
+	glTextureStorage2D = (PFNGLTEXTURESTORAGE2DPROC)getGLFunctionAddress("glTextureStorage2D");
+	glTextureParameteri = (PFNGLTEXTUREPARAMETERIPROC)getGLFunctionAddress("glTextureParameteri");
+	glNamedFramebufferTexture = (PFNGLNAMEDFRAMEBUFFERTEXTUREPROC)getGLFunctionAddress("glNamedFramebufferTexture");
+	glBlitNamedFramebuffer = (PFNGLBLITNAMEDFRAMEBUFFERPROC)getGLFunctionAddress("glBlitNamedFramebuffer");
+	glVertexArrayAttribIFormat = (PFNGLVERTEXARRAYATTRIBIFORMATPROC)getGLFunctionAddress("glVertexArrayAttribIFormat");
+	glVertexArrayBindingDivisor = (PFNGLVERTEXARRAYBINDINGDIVISORPROC)getGLFunctionAddress("glVertexArrayBindingDivisor");
+	glNamedFramebufferDrawBuffers = (PFNGLNAMEDFRAMEBUFFERDRAWBUFFERSPROC)getGLFunctionAddress("glNamedFramebufferDrawBuffers");
+	glCreateSamplers = (PFNGLCREATESAMPLERSPROC)getGLFunctionAddress("glCreateSamplers");
+	glDeleteSamplers = (PFNGLDELETESAMPLERSPROC)getGLFunctionAddress("glDeleteSamplers");
+	glSamplerParameteri = (PFNGLSAMPLERPARAMETERIPROC)getGLFunctionAddress("glSamplerParameteri");
+	glSamplerParameterf = (PFNGLSAMPLERPARAMETERFPROC)getGLFunctionAddress("glSamplerParameterf");
+	glCopyImageSubData = (PFNGLCOPYIMAGESUBDATAPROC)getGLFunctionAddress("glCopyImageSubData");
+	glTextureSubImage2D = (PFNGLTEXTURESUBIMAGE2DPROC)getGLFunctionAddress("glTextureSubImage2D");
+	glGetTextureImage = (PFNGLGETTEXTUREIMAGEPROC)getGLFunctionAddress("glGetTextureImage");
+	glTextureStorage3D = (PFNGLTEXTURESTORAGE3DPROC)getGLFunctionAddress("glTextureStorage3D");
+	glTextureSubImage3D = (PFNGLTEXTURESUBIMAGE3DPROC)getGLFunctionAddress("glTextureSubImage3D");
+	glGenerateTextureMipmap = (PFNGLGENERATETEXTUREMIPMAPPROC)getGLFunctionAddress("glGenerateTextureMipmap");
+	glFenceSync = (PFNGLFENCESYNCPROC)getGLFunctionAddress("glFenceSync");
+	glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)getGLFunctionAddress("glClientWaitSync");
+	glDeleteSync = (PFNGLDELETESYNCPROC)getGLFunctionAddress("glDeleteSync");
+	glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)getGLFunctionAddress("glMaxShaderCompilerThreadsKHR");
 	glPrimitiveRestartIndex = (PFNGLPRIMITIVERESTARTINDEXPROC)getGLFunctionAddress("glPrimitiveRestartIndex");
 
 	if (glClearBufferfv == nullptr ||
@@ -235,6 +417,7 @@ bool kengine::getAllGLProcedures()
 		glCopyBufferSubData == nullptr ||
 		glGetNamedBufferSubData == nullptr ||
 		glGetBufferSubData == nullptr ||
+		glGetNamedBufferParameteri64v == nullptr ||
 		glMapNamedBuffer == nullptr ||
 		glMapBuffer == nullptr ||
 		glUnmapNamedBuffer == nullptr ||
@@ -262,12 +445,47 @@ bool kengine::getAllGLProcedures()
 		glDisableVertexArrayAttrib == nullptr ||
 		glVertexArrayAttribFormat == nullptr ||
 		glVertexArrayVertexBuffers == nullptr ||
+		glVertexArrayVertexBuffer == nullptr ||
+		glVertexArrayAttribBinding == nullptr ||
 		glBindVertexBuffer == nullptr ||
-		glVertexAtttribFormat == nullptr ||
+		glVertexAttribFormat == nullptr ||
 		glVertexAttribBinding == nullptr ||
 		glBindAttribLocation == nullptr ||
 		glDrawArraysInstancedBaseInstance == nullptr ||
 		glUniformMatrix4fv == nullptr ||
+		glUniform1fv == nullptr ||
+		glUniform2fv == nullptr ||
+		glUniform3fv == nullptr ||
+		glUniform4fv == nullptr ||
+		glUniform1iv == nullptr ||
+		glUniform2iv == nullptr ||
+		glUniform3iv == nullptr ||
+		glUniform4iv == nullptr ||
+		glUniform1uiv == nullptr ||
+		glUniform2uiv == nullptr ||
+		glUniform3uiv == nullptr ||
+		glUniform4uiv == nullptr ||
+		glUniform1dv == nullptr ||
+		glUniform2dv == nullptr ||
+		glUniform3dv == nullptr ||
+		glUniform4dv == nullptr ||
+		glUniformMatrix2fv == nullptr ||
+		glUniformMatrix3fv == nullptr ||
+		glUniformMatrix2x3fv == nullptr ||
+		glUniformMatrix3x2fv == nullptr ||
+		glUniformMatrix2x4fv == nullptr ||
+		glUniformMatrix4x2fv == nullptr ||
+		glUniformMatrix3x4fv == nullptr ||
+		glUniformMatrix4x3fv == nullptr ||
+		glUniformMatrix2dv == nullptr ||
+		glUniformMatrix3dv == nullptr ||
+		glUniformMatrix4dv == nullptr ||
+		glUniformMatrix2x3dv == nullptr ||
+		glUniformMatrix3x2dv == nullptr ||
+		glUniformMatrix2x4dv == nullptr ||
+		glUniformMatrix4x2dv == nullptr ||
+		glUniformMatrix3x4dv == nullptr ||
+		glUniformMatrix4x3dv == nullptr ||
 		glGetStringi == nullptr ||
 		glCreateShader == nullptr ||
 		glDeleteShader == nullptr ||
@@ -290,6 +508,7 @@ bool kengine::getAllGLProcedures()
 		glGetProgramInterfaceiv == nullptr ||
 		glGetProgramResourceiv == nullptr ||
 		glGetProgramResourceName == nullptr ||
+		glGetProgramResourceIndex == nullptr ||
 		glGetActiveAttrib == nullptr ||
 		glGetAttribLocation == nullptr ||
 		glGetUniformLocation == nullptr ||
@@ -300,11 +519,19 @@ bool kengine::getAllGLProcedures()
 		glGetUniformIndices == nullptr ||
 		glGetActiveUniformsiv == nullptr ||
 		glBindBufferBase == nullptr ||
+		glBindBufferRange == nullptr ||
+		glBindTextureUnit == nullptr ||
+		glBindSampler == nullptr ||
+		glBlendFuncSeparate == nullptr ||
+		glBlendEquationSeparate == nullptr ||
 		glCreateShaderProgramv == nullptr ||
 		glCreateProgramPipelines == nullptr ||
 		glDeleteProgramPipelines == nullptr ||
 		glUseProgramStages == nullptr ||
 		glBindProgramPipeline == nullptr ||
+		glValidateProgramPipeline == nullptr ||
+		glGetProgramPipelineiv == nullptr ||
+		glGetProgramPipelineInfoLog == nullptr ||
 		glProgramUniform3f == nullptr ||
 		glActiveShaderProgram == nullptr ||
 		glProgramParameteri == nullptr ||
@@ -312,104 +539,458 @@ bool kengine::getAllGLProcedures()
 		glDebugMessageControl == nullptr ||
 		glPushDebugGroup == nullptr ||
 		glPopDebugGroup == nullptr ||
+		glGenQueries == nullptr ||
+		glDeleteQueries == nullptr ||
+		glBeginQuery == nullptr ||
+		glEndQuery == nullptr ||
+		glGetQueryObjectuiv == nullptr ||
+		glQueryCounter == nullptr ||
+		glGetQueryObjectui64v == nullptr ||
+		glCreateFramebuffers == nullptr ||
+		glDeleteFramebuffers == nullptr ||
+		glBindFramebuffer == nullptr ||
+		glCreateRenderbuffers == nullptr ||
+		glDeleteRenderbuffers == nullptr ||
+		glNamedRenderbufferStorage == nullptr ||
+		glNamedFramebufferRenderbuffer == nullptr ||
+		glCheckNamedFramebufferStatus == nullptr ||
+		glDispatchCompute == nullptr ||
+		glMemoryBarrier == nullptr ||
+		glDrawArraysIndirect == nullptr ||
+		glMultiDrawArraysIndirect == nullptr ||
+		glBindImageTexture == nullptr ||
+		glCreateTextures == nullptr ||
+		glTextureStorage2D == nullptr ||
+		glTextureParameteri == nullptr ||
+		glNamedFramebufferTexture == nullptr ||
+		glBlitNamedFramebuffer == nullptr ||
+		glVertexArrayAttribIFormat == nullptr ||
+		glVertexArrayBindingDivisor == nullptr ||
+		glNamedFramebufferDrawBuffers == nullptr ||
+		glCreateSamplers == nullptr ||
+		glDeleteSamplers == nullptr ||
+		glSamplerParameteri == nullptr ||
+		glSamplerParameterf == nullptr ||
+		glCopyImageSubData == nullptr ||
+		glTextureSubImage2D == nullptr ||
+		glGetTextureImage == nullptr ||
+		glTextureStorage3D == nullptr ||
+		glTextureSubImage3D == nullptr ||
+		glGenerateTextureMipmap == nullptr ||
+		glFenceSync == nullptr ||
+		glClientWaitSync == nullptr ||
+		glDeleteSync == nullptr ||
 		glPrimitiveRestartIndex == nullptr)
 	{
 		return false;
 	}
 
+	// the recording functions replace the loaded ones if a capture is active (or requested by KENGINE_GL_CAPTURE)
+	kengine::glCapture().attach();
+
 	return true;
 }
 
+/*
+	kengine::uniform_table class - member class definition
+*/
+
+void kengine::uniform_table::clear()
+{
+	m_slots.clear();
+	m_count = 0;
+}
+
+bool kengine::uniform_table::insert(uint32_t hash, const uniform_info& info)
+{
+	// the load factor is kept under 0.5, so the probe sequences are short
+	if ((m_count + 1) * 2 > m_slots.size())
+		rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+
+	size_t mask = m_slots.size() - 1;
+
+	for (size_t index = hash & mask; ; index = (index + 1) & mask) {
+		slot& s = m_slots[index];
+
+		if (!s.used) {
+			s.used = true;
+			s.hash = hash;
+			s.info = info;
+			m_count++;
+			return true;
+		}
+
+		if (s.hash == hash)
+			return false;
+	}
+}
+
+const kengine::uniform_info* kengine::uniform_table::find(uint32_t hash) const
+{
+	if (m_slots.empty())
+		return nullptr;
+
+	size_t mask = m_slots.size() - 1;
+
+	for (size_t index = hash & mask; m_slots[index].used; index = (index + 1) & mask) {
+		if (m_slots[index].hash == hash)
+			return &m_slots[index].info;
+	}
+
+	return nullptr;
+}
+
+void kengine::uniform_table::getEntries(std::vector<std::pair<uint32_t, uniform_info>>& entries) const
+{
+	entries.clear();
+
+	for (const auto& s : m_slots) {
+		if (s.used)
+			entries.push_back(std::make_pair(s.hash, s.info));
+	}
+}
+
+void kengine::uniform_table::rehash(size_t capacity)
+{
+	std::vector<slot> slots(capacity);
+	slots.swap(m_slots);
+	m_count = 0;
+
+	for (const auto& s : slots) {
+		if (s.used)
+			insert(s.hash, s.info);
+	}
+}
+
+bool kengine::isUniformTypeCompatible(GLenum type, GLenum handleType)
+{
+	if (type == handleType)
+		return true;
+
+	if (handleType != GL_INT)
+		return false;
+
+	// the opaque types are set by glUniform1i
+	switch (type) {
+	case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+	case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY:
+	case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW: case GL_SAMPLER_2D_MULTISAMPLE:
+	case GL_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_SAMPLER_CUBE_SHADOW: case GL_SAMPLER_BUFFER: case GL_SAMPLER_2D_RECT:
+	case GL_SAMPLER_2D_RECT_SHADOW: case GL_SAMPLER_CUBE_MAP_ARRAY: case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+	case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+	case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_2D_MULTISAMPLE:
+	case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_INT_SAMPLER_BUFFER: case GL_INT_SAMPLER_2D_RECT:
+	case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D:
+	case GL_UNSIGNED_INT_SAMPLER_CUBE: case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_2D_RECT: case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+	case GL_IMAGE_1D: case GL_IMAGE_2D: case GL_IMAGE_3D: case GL_IMAGE_2D_RECT: case GL_IMAGE_CUBE: case GL_IMAGE_BUFFER:
+	case GL_IMAGE_1D_ARRAY: case GL_IMAGE_2D_ARRAY: case GL_IMAGE_CUBE_MAP_ARRAY: case GL_IMAGE_2D_MULTISAMPLE:
+	case GL_IMAGE_2D_MULTISAMPLE_ARRAY:
+	case GL_INT_IMAGE_1D: case GL_INT_IMAGE_2D: case GL_INT_IMAGE_3D: case GL_INT_IMAGE_2D_RECT: case GL_INT_IMAGE_CUBE:
+	case GL_INT_IMAGE_BUFFER: case GL_INT_IMAGE_1D_ARRAY: case GL_INT_IMAGE_2D_ARRAY: case GL_INT_IMAGE_CUBE_MAP_ARRAY:
+	case GL_INT_IMAGE_2D_MULTISAMPLE: case GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_1D: case GL_UNSIGNED_INT_IMAGE_2D: case GL_UNSIGNED_INT_IMAGE_3D:
+	case GL_UNSIGNED_INT_IMAGE_2D_RECT: case GL_UNSIGNED_INT_IMAGE_CUBE: case GL_UNSIGNED_INT_IMAGE_BUFFER:
+	case GL_UNSIGNED_INT_IMAGE_1D_ARRAY: case GL_UNSIGNED_INT_IMAGE_2D_ARRAY: case GL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE: case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+	case GL_UNSIGNED_INT_ATOMIC_COUNTER:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+/*
+	Register the program in the GPU memory tracker (the binary length is the best estimate that OpenGL provides)
+*/
+static void trackProgramMemory(GLuint program, const std::string& owner)
+{
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::PROGRAM, program, static_cast<size_t>(length), owner);
+}
+
+/*
+	readFromFile stops at the first '\0', so the binary files (e.g. SPIR-V modules) are read by this function
+*/
+static std::string readBinaryFromFile(const std::string& filename)
+{
+	std::ifstream filestream(filename, std::ios::in | std::ios::binary);
+	std::istreambuf_iterator<char> startIt(filestream), endIt;
+	return std::string(startIt, endIt);
+}
+
+/*
+	kengine::specialization_constants class - member class definition
+*/
+
+void kengine::specialization_constants::set(GLuint id, GLuint value)
+{
+	auto it = std::lower_bound(m_indices.begin(), m_indices.end(), id);
+	size_t position = static_cast<size_t>(it - m_indices.begin());
+
+	if (it != m_indices.end() && *it == id) {
+		m_values[position] = value;
+		return;
+	}
+
+	m_indices.insert(it, id);
+	m_values.insert(m_values.begin() + static_cast<std::ptrdiff_t>(position), value);
+}
+
+void kengine::specialization_constants::set(GLuint id, GLint value)
+{
+	GLuint bits;
+	memcpy(&bits, &value, sizeof(bits));
+	set(id, bits);
+}
+
+void kengine::specialization_constants::set(GLuint id, GLfloat value)
+{
+	GLuint bits;
+	memcpy(&bits, &value, sizeof(bits));
+	set(id, bits);
+}
+
+uint64_t kengine::specialization_constants::getKey() const
+{
+	if (m_indices.empty())
+		return 0;
+
+	uint64_t key = kengine::fnv1a64(m_indices.data(), m_indices.size() * sizeof(GLuint));
+	return kengine::fnv1a64(m_values.data(), m_values.size() * sizeof(GLuint), key);
+}
+
 /*
 	GLSLprogram class - member class definition
 */
 
 kengine::GLSLprogram::~GLSLprogram()
 {
+	kengine::gpuMemoryTracker().release(kengine::GPU_MEMORY_CATEGORY::PROGRAM, programID);
+	kengine::glState().releaseProgram(programID);
 	glDeleteProgram(programID);
 }
 
 bool kengine::GLSLprogram::loadShaders(const ShaderInfo* shaderInfo)
 {
-	bool ret = false;
+	if (!shaderInfo)
+		return false;
 
-	if (shaderInfo)
-	{
-		if (programID) {
-			glDeleteProgram(programID);
-			uniformMap.clear();
-		}
+	setProgram(0, "");
 
-		GLuint shaders[6] = { 0 };
+	GLuint types[6] = { 0 };
+	std::string sources[6];
+	int count = 0;
 
-		for (int index = 0; shaderInfo[index].type != GL_NONE && index < 6; index++) {
-			shaders[index] = compileShader(shaderInfo[index].type, shaderInfo[index].filename);
-		}
+	for (; count < 6 && shaderInfo[count].type != GL_NONE; count++) {
+		types[count] = shaderInfo[count].type;
+		shaderPreprocessor().process(shaderInfo[count].filename, shaderInfo[count].defines, sources[count]);
+	}
 
-		programID = glCreateProgram();
+	uint64_t key = 0;
 
-		if (programID) {
-			ret = true;
+	if (loadCachedProgram(types, sources, count, shaderInfo[0].filename, key))
+		return true;
+
+	GLuint shaders[6] = { 0 };
+
+	for (int index = 0; index < count; index++) {
+		if (!sources[index].empty())
+			shaders[index] = compileShaderSource(types[index], sources[index]);
+	}
+
+	return linkShaders(shaders, shaderInfo[0].filename, key);
+}
+
+bool kengine::GLSLprogram::loadSPIRVShaders(const ShaderInfo* shaderInfo)
+{
+	if (!shaderInfo || !isExtensionSupported("GL_ARB_gl_spirv"))
+		return false;
 
-			for (int index = 0; index < 6; index++) {
-				if (shaders[index])
-					glAttachShader(programID, shaders[index]);
-			}
-
-			glLinkProgram(programID);
-
-			GLint status;
-			glGetProgramiv(programID, GL_LINK_STATUS, &status);
-
-			if (status == GL_TRUE) {
-				// query the location of a uniform variable
-				GLint numUniforms = 0;
-				glGetProgramInterfaceiv(programID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &numUniforms);
-				GLenum properties[] = { GL_NAME_LENGTH, GL_LOCATION };
-
-				for (GLint i = 0; i < numUniforms; i++) {
-					GLint results[2];
-					glGetProgramResourceiv(programID, GL_UNIFORM, static_cast<GLuint>(i), 2, properties, 2, nullptr, results);
-					GLint nameBufferSize = results[0] + 1;
-					char* name = new char[static_cast<size_t>(nameBufferSize)];
-					glGetProgramResourceName(programID, GL_UNIFORM, static_cast<GLuint>(i), nameBufferSize, nullptr, name);
-					uniformMap[name] = results[1];
-				}
-			} else {
-				std::string log = "It was not possible to link a shader program";
-
-				GLint logLength;
-				glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &logLength);
-
-				if (logLength > 0) {
-					std::string infoLog(static_cast<unsigned int>(logLength), ' ');
-					GLsizei logWrittenLength;
-					glGetProgramInfoLog(programID, logLength, &logWrittenLength, &infoLog[0]);
-					log += ": " + infoLog;
-				}
-
-				K_LOG_OUTPUT_RAW(log);
-				ret = false;
-			}
+	GLuint types[6] = { 0 };
+	std::string binaries[6];
+	std::string keySources[6];
+	int count = 0;
+
+	for (; count < 6 && shaderInfo[count].type != GL_NONE; count++) {
+		types[count] = shaderInfo[count].type;
+		binaries[count] = readBinaryFromFile(shaderInfo[count].filename + ".spv");
+
+		if (binaries[count].empty()) {
+			K_LOG_OUTPUT_RAW("The SPIR-V module " << shaderInfo[count].filename << ".spv cannot be opened.");
+			return false;
 		}
-		else
-			K_LOG_OUTPUT_RAW("It was not possible to create a shader program!");
 
-		// clean up shader objects
+		// the constants are a part of the program, so they are a part of the cache key
+		uint64_t constantsKey = shaderInfo[count].constants.getKey();
+		keySources[count] = binaries[count] + std::string(reinterpret_cast<const char*>(&constantsKey), sizeof(constantsKey));
+	}
+
+	setProgram(0, "");
+
+	uint64_t key = 0;
+
+	if (loadCachedProgram(types, keySources, count, shaderInfo[0].filename, key))
+		return true;
+
+	GLuint shaders[6] = { 0 };
+
+	for (int index = 0; index < count; index++)
+		shaders[index] = compileSPIRVShaderBinary(types[index], binaries[index], &shaderInfo[index].constants);
+
+	return linkShaders(shaders, shaderInfo[0].filename, key);
+}
+
+bool kengine::GLSLprogram::loadCachedProgram(const GLuint* types, const std::string* sources, int count, const std::string& owner, uint64_t& key)
+{
+	// the cached binary skips the compilation, the link and the uniform reflection
+	kengine::program_cache& cache = kengine::programCache();
+
+	if (!cache.isEnabled())
+		return false;
+
+	key = cache.makeKey(types, sources, count);
+	uniform_table reflection;
+	GLuint program = cache.load(key, binaryFormat, reflection);
+
+	if (!program)
+		return false;
+
+	setProgram(program, owner);
+	uniforms = reflection;
+	return true;
+}
+
+bool kengine::GLSLprogram::linkShaders(GLuint* shaders, const std::string& owner, uint64_t key)
+{
+	kengine::program_cache& cache = kengine::programCache();
+	bool cacheEnabled = cache.isEnabled();
+	GLuint program = glCreateProgram();
+	bool ret = false;
+
+	if (program) {
 		for (int index = 0; index < 6; index++) {
-			if (shaders[index]) {
-				glDetachShader(programID, shaders[index]);
-				glDeleteShader(shaders[index]);
-			}
+			if (shaders[index])
+				glAttachShader(program, shaders[index]);
+		}
+
+		if (cacheEnabled)
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+		glLinkProgram(program);
+
+		if (checkLinkStatus(program)) {
+			setProgram(program, owner);
+			reflectUniforms();
+
+			if (cacheEnabled)
+				cache.save(key, programID, uniforms);
+
+			ret = true;
+		}
+	}
+	else
+		K_LOG_OUTPUT_RAW("It was not possible to create a shader program!");
+
+	// clean up shader objects
+	for (int index = 0; index < 6; index++) {
+		if (shaders[index]) {
+			glDetachShader(program, shaders[index]);
+			glDeleteShader(shaders[index]);
 		}
 	}
 
+	if (!ret)
+		glDeleteProgram(program);
+
 	return ret;
 }
 
+void kengine::GLSLprogram::setProgram(GLuint program, const std::string& owner)
+{
+	if (programID) {
+		kengine::gpuMemoryTracker().release(kengine::GPU_MEMORY_CATEGORY::PROGRAM, programID);
+		kengine::glState().releaseProgram(programID);
+		glDeleteProgram(programID);
+	}
+
+	programID = program;
+	uniforms.clear();
+
+	if (programID)
+		trackProgramMemory(programID, owner);
+}
+
+void kengine::GLSLprogram::reflectUniforms()
+{
+	// query the location of a uniform variable
+	GLint numUniforms = 0;
+	glGetProgramInterfaceiv(programID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &numUniforms);
+	GLenum properties[] = { GL_NAME_LENGTH, GL_LOCATION, GL_TYPE, GL_ARRAY_SIZE };
+	std::vector<char> name;
+
+	uniforms.clear();
+
+	for (GLint i = 0; i < numUniforms; i++) {
+		GLint results[4];
+		glGetProgramResourceiv(programID, GL_UNIFORM, static_cast<GLuint>(i), 4, properties, 4, nullptr, results);
+
+		// the members of the uniform blocks don't have a location
+		if (results[1] < 0)
+			continue;
+
+		GLint nameBufferSize = results[0] + 1;
+		name.resize(static_cast<size_t>(nameBufferSize));
+		glGetProgramResourceName(programID, GL_UNIFORM, static_cast<GLuint>(i), nameBufferSize, nullptr, name.data());
+
+		uniform_info info;
+		info.location = results[1];
+		info.type = static_cast<GLenum>(results[2]);
+		info.size = results[3];
+
+		// the arrays are reported as "name[0]", so they can be found by both names
+		std::string uniformName = name.data();
+		size_t bracket = uniformName.find("[0]");
+
+		if (bracket != std::string::npos && bracket + 3 == uniformName.size())
+			uniforms.insert(fnv1a(uniformName.substr(0, bracket).c_str()), info);
+
+		if (!uniforms.insert(fnv1a(uniformName.c_str()), info))
+			K_LOG_OUTPUT_RAW("> the uniform variable " << uniformName << " has the same hash of another uniform variable");
+	}
+}
+
+bool kengine::GLSLprogram::resolveUniform(uint32_t nameHash, GLenum type, uniform_info& info) const
+{
+	const uniform_info* found = uniforms.find(nameHash);
+
+	if (found == nullptr) {
+		K_LOG_OUTPUT_RAW("> the uniform variable [" << nameHash << "] is not active in the program " << programID);
+		return false;
+	}
+
+	if (!isUniformTypeCompatible(found->type, type)) {
+		K_LOG_OUTPUT_RAW("> the uniform variable [" << nameHash << "] is a " << getGLSLType(static_cast<GLint>(found->type)) << " (program " << programID << ")");
+		return false;
+	}
+
+	info = *found;
+	return true;
+}
+
+GLint kengine::GLSLprogram::getLocation(const std::string& name) const
+{
+	const uniform_info* info = uniforms.find(fnv1a(name.c_str()));
+	return info != nullptr ? info->location : -1;
+}
+
 void kengine::GLSLprogram::useProgram()
 {
-	glUseProgram(programID);
+	kengine::glState().useProgram(programID);
 }
 
 void kengine::GLSLprogram::saveBinary(const std::string& name)
@@ -431,7 +1012,9 @@ void kengine::GLSLprogram::saveBinary(const std::string& name)
 	std::vector<GLubyte> buffer(static_cast<size_t>(length));
 	glGetProgramBinary(programID, length, nullptr, &binaryFormat, buffer.data());
 
+	// the binary format is stored before the binary because glProgramBinary needs it
 	std::ofstream shaderBinary(name.c_str(), std::ios::binary);
+	shaderBinary.write(reinterpret_cast<char*>(&binaryFormat), sizeof(binaryFormat));
 	shaderBinary.write(reinterpret_cast<char*>(buffer.data()), length);
 	shaderBinary.close();
 }
@@ -446,49 +1029,52 @@ void kengine::GLSLprogram::loadBinary(const std::string& name)
 		return;
 	}
 
-	if (programID)
-	{
-		uniformMap.clear();
-		glDeleteProgram(programID);
-	}
+	// the previous program is released through setProgram, so the state cache forgets its name
+	setProgram(0, "");
 
-	programID = glCreateProgram();
+	GLuint program = glCreateProgram();
 
 	std::ifstream shaderBinary(name, std::ios::binary);
+	shaderBinary.read(reinterpret_cast<char*>(&binaryFormat), sizeof(binaryFormat));
 	std::istreambuf_iterator<char> iter(shaderBinary), endIter;
 	std::vector<char> buffer(iter, endIter);
 	shaderBinary.close();
 
-	glProgramBinary(programID, binaryFormat, buffer.data(), static_cast<GLsizei>(buffer.size()));
+	glProgramBinary(program, binaryFormat, buffer.data(), static_cast<GLsizei>(buffer.size()));
 
 	GLint status;
-	glGetProgramiv(programID, GL_LINK_STATUS, &status);
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
 
 	if (status == GL_FALSE) {
 		std::string log = "It was not possible to link a binary shader program";
 
 		GLint logLength;
-		glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &logLength);
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
 
 		if (logLength > 0) {
 			std::string infoLog(static_cast<unsigned int>(logLength), ' ');
 			GLsizei logWrittenLength;
-			glGetProgramInfoLog(programID, logLength, &logWrittenLength, &infoLog[0]);
+			glGetProgramInfoLog(program, logLength, &logWrittenLength, &infoLog[0]);
 			log += ": " + infoLog;
 		}
 
 		K_LOG_OUTPUT_RAW(log);
+		glDeleteProgram(program);
+		return;
 	}
+
+	setProgram(program, name);
+	reflectUniforms();
 }
 
-void kengine::GLSLprogram::setUniform(std::string name, bool transpose, GLfloat* value)
+void kengine::GLSLprogram::setUniform(const std::string& name, bool transpose, GLfloat* value)
 {
 	/*
 		It is inefficient to query the location of a uniform variable in each frame [Wolf, 2018]
 	*/
 	// GLint location = glGetUniformLocation(programID, name.c_str());
 
-	GLint location = uniformMap[name];
+	GLint location = getLocation(name);
 
 	if (location == -1) {
 		K_LOG_OUTPUT_RAW("Failed to set uniform (kengine::matrix): " << name);
@@ -574,8 +1160,11 @@ void kengine::mesh_node::load(kengine::mesh& m, size_t size)
 	GLsizeiptr totalSizeInBytes = static_cast<GLsizeiptr>(m.getSizeInBytes());
 	const float* const data = m.getInterleavedData();
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_vbo[0]);
+	kengine::glState().bindBuffer(GL_ARRAY_BUFFER, m_vbo[0]);
 	glBufferStorage(GL_ARRAY_BUFFER, totalSizeInBytes, data, 0);
+	kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::BUFFER, m_vbo[0], m.getSizeInBytes(), m_name);
+
+	setVertexLayout(m);
 
 	//if (m.m_indices.attributeArray != nullptr) {
 	//	glNamedBufferStorage(vbo[2], static_cast<GLsizeiptr>(m.m_indices.getSizeInBytes()), m.m_indices.attributeArray, GL_DYNAMIC_STORAGE_BIT);
@@ -613,18 +1202,49 @@ void kengine::mesh_node::load(kengine::mesh& m, size_t size)
 	//	delete[] modelviewData;
 	//}
 
-	/*
-		Creating vertex array object (VAO)
-	*/
+	//for (GLuint location = 0; location < m.m_bitset.size(); location++)
+	//{
+	//	if (m.m_bitset[location])
+	//	{
+	//		glEnableVertexAttribArray(location);
+	//		glVertexAttribPointer(location, static_cast<GLint>(m.m_vattributes[location].count), GL_FLOAT, GL_FALSE, static_cast<GLsizei>(m.m_interleavedStride * sizeof(float)), (const GLvoid*)m.m_interleavedOffsets[location]);
+	//		countArray = static_cast<GLsizei>(m.m_vattributes[location].getSize());
+	//	}
+	//}
+
+	//if (hasModelMatrix)
+	//{
+	//	// map index for model matrix
+	//	glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
 
-	glGenVertexArrays(1, &m_vao);
-	glBindVertexArray(m_vao);
+	//	for (unsigned int i = 0; i < 4; i++)
+	//	{
+	//		glVertexAttribPointer(3UL + i, 4, GL_FLOAT, GL_FALSE, static_cast<GLsizeiptr>(16 * sizeof(GLfloat)), (const GLvoid*)((sizeof(GLfloat) * 4 * i)));
+	//		glEnableVertexAttribArray(3UL + i);
+	//		glVertexAttribDivisor(3UL + i, 1);
+	//	}
+	//}
+}
 
+void kengine::mesh_node::attach(GLuint buffer, kengine::mesh& m)
+{
+	clear();
+	m_vbo[0] = buffer;
+	kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::BUFFER, buffer, m.getSizeInBytes(), m_name);
+	setVertexLayout(m);
+}
+
+void kengine::mesh_node::setVertexLayout(kengine::mesh& m)
+{
 	/*
-		shader plumbing
+		Vertex layout
 
 		Note:
-			Note that the "type" parameter for glVertexAttribPointer will be converted to floating-point by OpenGL in order to load it into floating-point vertex attributes.
+			The vertex array object is not created per mesh anymore. The layout is registered in the
+			kengine::vertex_format_registry and all meshes with the same layout share one VAO. The buffer
+			is attached to the binding point 0 by glBindVertexBuffer at draw time.
+
+			Note that the "type" parameter for glVertexArrayAttribFormat will be converted to floating-point by OpenGL in order to load it into floating-point vertex attributes.
 			The way this conversion is performed is controlled by the normalize parameter.
 			When normalize is GL_FALSE, integer data is simply typecast into floating-point format before being passed to the vertex shader.
 			When normalize is GL_TRUE, the data is normalized before being passed to the vertex shader.
@@ -640,71 +1260,104 @@ void kengine::mesh_node::load(kengine::mesh& m, size_t size)
 		Mapping the vertex data stored in m_vbo[0] to the vertex attributes declared in vertex shader
 	*/
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_vbo[0]);
+	kengine::vertex_format format;
 	size_t offset = 0;
 	m_count = static_cast<GLsizei>(m.m_vattributesMap[0].getSize());
 
 	for (auto it : m.m_vattributesMap) {
-		auto location = it.first;
-
-		glEnableVertexAttribArray(static_cast<GLuint>(location));
-
-		glVertexAttribPointer(
-			static_cast<GLuint>(location),
+		format.addAttribute(
+			static_cast<GLuint>(it.first),
 			static_cast<GLint>(it.second.count),
 			GL_FLOAT,
 			GL_FALSE,
-			static_cast<GLsizei>(m.m_interleavedStride),
-			(const GLvoid*)offset);
+			static_cast<GLuint>(offset));
 
 		offset += it.second.count * sizeof(float);
-		
 	}
 
-	//for (GLuint location = 0; location < m.m_bitset.size(); location++)
-	//{
-	//	if (m.m_bitset[location])
-	//	{
-	//		glEnableVertexAttribArray(location);
-	//		glVertexAttribPointer(location, static_cast<GLint>(m.m_vattributes[location].count), GL_FLOAT, GL_FALSE, static_cast<GLsizei>(m.m_interleavedStride * sizeof(float)), (const GLvoid*)m.m_interleavedOffsets[location]);
-	//		countArray = static_cast<GLsizei>(m.m_vattributes[location].getSize());
-	//	}
-	//}
+	// glBindVertexBuffer doesn't accept 0 as "tightly packed" like glVertexAttribPointer does
+	m_stride = static_cast<GLsizei>(offset);
+	m_format = kengine::vertexFormatRegistry().acquire(format);
 
-	//if (hasModelMatrix)
-	//{
-	//	// map index for model matrix
-	//	glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
+	// bounding box of the positions (the missing components are 0)
+	const kengine::vattrib<float>& positions = m.m_vattributesMap[0];
 
-	//	for (unsigned int i = 0; i < 4; i++)
-	//	{
-	//		glVertexAttribPointer(3UL + i, 4, GL_FLOAT, GL_FALSE, static_cast<GLsizeiptr>(16 * sizeof(GLfloat)), (const GLvoid*)((sizeof(GLfloat) * 4 * i)));
-	//		glEnableVertexAttribArray(3UL + i);
-	//		glVertexAttribDivisor(3UL + i, 1);
-	//	}
-	//}
+	for (int axis = 0; axis < 3; axis++) {
+		m_boundsMin[axis] = 0.0f;
+		m_boundsMax[axis] = 0.0f;
+	}
+
+	for (size_t vertex = 0; positions.count > 0 && vertex < positions.getSize(); vertex++) {
+		for (size_t axis = 0; axis < 3 && axis < positions.count; axis++) {
+			float value = positions.attributeArray[vertex * positions.count + axis];
+
+			if (vertex == 0 || value < m_boundsMin[axis])
+				m_boundsMin[axis] = value;
+
+			if (vertex == 0 || value > m_boundsMax[axis])
+				m_boundsMax[axis] = value;
+		}
+	}
 }
 
 void kengine::mesh_node::clear()
 {
-	glDeleteBuffers(MAX_VBO, m_vbo);
-	glDeleteVertexArrays(1, &m_vao);
+	for (int i = 0; i < MAX_VBO; i++) {
+		if (m_vbo[i]) {
+			kengine::vertexFormatRegistry().releaseBuffer(m_vbo[i]);
+			kengine::gpuMemoryTracker().release(kengine::GPU_MEMORY_CATEGORY::BUFFER, m_vbo[i]);
+			kengine::glState().releaseBuffer(m_vbo[i]);
+			glDeleteBuffers(1, &m_vbo[i]);
+			m_vbo[i] = 0;
+		}
+	}
+
+	m_format = -1;
+	m_stride = 0;
 	m_count = 0;
 
+	for (int axis = 0; axis < 3; axis++) {
+		m_boundsMin[axis] = 0.0f;
+		m_boundsMax[axis] = 0.0f;
+	}
+
 	//max_size = 0;
 	//countElement = 0;
 }
 
 void kengine::mesh_node::drawArrays() const
 {
-	glBindVertexArray(m_vao);
+	if (m_format < 0) // not loaded yet (e.g. pending upload)
+		return;
+
+	kengine::vertexFormatRegistry().bind(m_format, m_vbo[0], 0, m_stride);
 	glDrawArrays(m_mode, 0, m_count);
 }
 
+void kengine::mesh_node::drawArraysIndirect(GLuint indirectBuffer, GLintptr offset) const
+{
+	if (m_format < 0) // not loaded yet (e.g. pending upload)
+		return;
+
+	kengine::vertexFormatRegistry().bind(m_format, m_vbo[0], 0, m_stride);
+	kengine::glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+	glDrawArraysIndirect(m_mode, reinterpret_cast<const void*>(offset));
+}
+
 /*
 	Helper function to compile GLSL shader
 */
 GLuint kengine::compileShader(GLuint shaderType, std::string filename)
+{
+	std::string sourceString;
+
+	if (!shaderPreprocessor().process(filename, "", sourceString))
+		return 0;
+
+	return compileShaderSource(shaderType, sourceString);
+}
+
+GLuint kengine::compileShaderSource(GLuint shaderType, const std::string& sourceString)
 {
 	GLuint shaderObject = glCreateShader(shaderType);
 
@@ -713,75 +1366,104 @@ GLuint kengine::compileShader(GLuint shaderType, std::string filename)
 		return 0;
 	}
 
-	std::string sourceString = readFromFile(filename);
+	const GLchar* source = sourceString.c_str();
+
+	glShaderSource(shaderObject, 1, &source, nullptr);
+	glCompileShader(shaderObject);
 
-	if (sourceString[0] == '\0') {
-		K_LOG_OUTPUT_RAW("This file " << filename << " cannot be opened.")
+	if (!checkCompileStatus(shaderObject, shaderType)) {
 		glDeleteShader(shaderObject);
 		return 0;
 	}
 
-	const GLchar* source = sourceString.c_str();
-
-	glShaderSource(shaderObject, 1, &source, nullptr);
-	glCompileShader(shaderObject);
+	return shaderObject;
+}
 
+bool kengine::checkCompileStatus(GLuint shader, GLuint shaderType)
+{
 	GLint status = 0;
-	glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &status);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
 
 	if (status == GL_FALSE) {
 		std::string log = "It was not possible to compile a shader [" + getShaderType(shaderType) + "]";
 
 		GLint logLength;
-		glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &logLength);
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
 
 		if (logLength > 0) {
 			std::string infoLog(static_cast<unsigned int>(logLength), ' ');
 			GLsizei logWrittenLength;
 
-			glGetShaderInfoLog(shaderObject, logLength, &logWrittenLength, &infoLog[0]);
+			glGetShaderInfoLog(shader, logLength, &logWrittenLength, &infoLog[0]);
 			log += ": " + infoLog;
 		}
 
-		glDeleteShader(shaderObject);
 		K_LOG_OUTPUT_RAW(log);
-		return 0;
+		return false;
 	}
 
-	return shaderObject;
+	return true;
 }
 
-
-GLuint kengine::compileSPIRVShader(GLuint shaderType, const std::string& name)
+bool kengine::checkLinkStatus(GLuint program)
 {
-	GLuint shaderObject = glCreateShader(shaderType);
-
-	std::ifstream shaderBinary(name, std::ios::binary);
-	std::istreambuf_iterator<char> startIt(shaderBinary), endIt;
-	std::vector<char> buffer(startIt, endIt);
-	shaderBinary.close();
-
-	glShaderBinary(1, &shaderObject, GL_SHADER_BINARY_FORMAT_SPIR_V, buffer.data(), static_cast<GLsizei>(buffer.size()));
-	glSpecializeShader(shaderObject, "main", 0, 0, 0);
-
-	GLint status;
-	glGetShaderiv(shaderObject, GL_COMPILE_STATUS, &status);
+	GLint status = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
 
 	if (status == GL_FALSE) {
-		std::string log = "It was not possible to compile a SPIRV shader";
+		std::string log = "It was not possible to link a shader program";
 
 		GLint logLength;
-		glGetShaderiv(shaderObject, GL_INFO_LOG_LENGTH, &logLength);
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
 
 		if (logLength > 0) {
 			std::string infoLog(static_cast<unsigned int>(logLength), ' ');
 			GLsizei logWrittenLength;
-			glGetProgramInfoLog(shaderObject, logLength, &logWrittenLength, &infoLog[0]);
+			glGetProgramInfoLog(program, logLength, &logWrittenLength, &infoLog[0]);
 			log += ": " + infoLog;
 		}
 
-		glDeleteShader(shaderObject);
 		K_LOG_OUTPUT_RAW(log);
+		return false;
+	}
+
+	return true;
+}
+
+bool kengine::isExtensionSupported(const std::string& name)
+{
+	GLint numExtensions = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+
+	for (GLint i = 0; i < numExtensions; i++) {
+		const GLubyte* extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+
+		if (extension != nullptr && name == reinterpret_cast<const char*>(extension))
+			return true;
+	}
+
+	return false;
+}
+
+
+GLuint kengine::compileSPIRVShader(GLuint shaderType, const std::string& name, const specialization_constants* constants)
+{
+	return compileSPIRVShaderBinary(shaderType, readBinaryFromFile(name), constants);
+}
+
+GLuint kengine::compileSPIRVShaderBinary(GLuint shaderType, const std::string& binary, const specialization_constants* constants)
+{
+	GLuint shaderObject = glCreateShader(shaderType);
+
+	glShaderBinary(1, &shaderObject, GL_SHADER_BINARY_FORMAT_SPIR_V, binary.data(), static_cast<GLsizei>(binary.size()));
+
+	if (constants && constants->getCount() > 0)
+		glSpecializeShader(shaderObject, "main", constants->getCount(), constants->getIndices(), constants->getValues());
+	else
+		glSpecializeShader(shaderObject, "main", 0, nullptr, nullptr);
+
+	if (!checkCompileStatus(shaderObject, shaderType)) {
+		glDeleteShader(shaderObject);
 		return 0;
 	}
 
@@ -0,0 +1,346 @@
+/*
+	K-Engine GPU Culling
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <gpu_culling.hpp>
+#include <gl_state.hpp>
+#include <gpu_memory.hpp>
+#include <logger.hpp>
+
+#include <algorithm>
+
+namespace
+{
+	const GLuint COUNTER_COUNT = 3; // visible, frustum culled, occluded
+
+	/*
+		Immutable storage: a bigger buffer replaces the old one
+	*/
+	void reallocate(GLuint& buffer, GLsizeiptr size, GLbitfield flags, const std::string& owner)
+	{
+		kengine::deleteTrackedBuffer(buffer);
+
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, size, nullptr, flags);
+		kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::BUFFER, buffer, static_cast<size_t>(size), owner);
+	}
+}
+
+/*
+	kengine::gpu_culler class - member class definition
+*/
+
+kengine::gpu_culler::~gpu_culler()
+{
+	destroyTargets();
+
+	for (auto& fence : m_statsFences) {
+		if (fence != nullptr)
+			glDeleteSync(fence);
+	}
+
+	if (m_statsBuffer != 0)
+		glUnmapNamedBuffer(m_statsBuffer);
+
+	kengine::deleteTrackedBuffer(m_statsBuffer);
+	kengine::deleteTrackedBuffer(m_counterBuffer);
+	kengine::deleteTrackedBuffer(m_commandBuffer);
+	kengine::deleteTrackedBuffer(m_visibleBuffer);
+	kengine::deleteTrackedBuffer(m_instanceBuffer);
+}
+
+bool kengine::gpu_culler::init(const std::string& shaderDirectory)
+{
+	kengine::ShaderInfo cullShaders[] = {
+		{GL_COMPUTE_SHADER, shaderDirectory + "/cs_cull.comp"},
+		{GL_NONE, ""}
+	};
+
+	kengine::ShaderInfo copyDepthShaders[] = {
+		{GL_COMPUTE_SHADER, shaderDirectory + "/cs_hiz.comp", "#define HIZ_COPY_DEPTH 1\n"},
+		{GL_NONE, ""}
+	};
+
+	kengine::ShaderInfo reduceShaders[] = {
+		{GL_COMPUTE_SHADER, shaderDirectory + "/cs_hiz.comp"},
+		{GL_NONE, ""}
+	};
+
+	if (!m_cullProgram.loadShaders(cullShaders) || !m_copyDepthProgram.loadShaders(copyDepthShaders) || !m_reduceProgram.loadShaders(reduceShaders)) {
+		K_LOG_OUTPUT_RAW("gpu_culler: it was not possible to load the compute shaders from " << shaderDirectory);
+		return false;
+	}
+
+	m_previousViewProjection = m_cullProgram.getUniform<GL_FLOAT_MAT4>(K_HASH("previousViewProjection"));
+	m_frustumPlanes = m_cullProgram.getUniform<GL_FLOAT_VEC4>(K_HASH("frustumPlanes"));
+	m_instanceCount = m_cullProgram.getUniform<GL_UNSIGNED_INT>(K_HASH("instanceCount"));
+	m_hizLevelsUniform = m_cullProgram.getUniform<GL_INT>(K_HASH("hizLevels"));
+
+	reallocate(m_counterBuffer, sizeof(GLuint) * COUNTER_COUNT, GL_DYNAMIC_STORAGE_BIT, "gpu_culler");
+
+	// readback ring of the counters
+	GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	GLsizeiptr statsSize = sizeof(GLuint) * COUNTER_COUNT * STATS_LATENCY;
+
+	reallocate(m_statsBuffer, statsSize, flags, "gpu_culler");
+	m_statsData = static_cast<const GLuint*>(glMapNamedBufferRange(m_statsBuffer, 0, statsSize, flags));
+
+	return m_statsData != nullptr;
+}
+
+unsigned int kengine::gpu_culler::addDraw(const mesh_node& node, GLuint maxInstances)
+{
+	gpu_draw_command command;
+	command.count = static_cast<GLuint>(node.getVertexCount());
+	command.baseInstance = m_instanceCapacity;
+
+	m_commands.push_back(command);
+	m_drawCapacities.push_back(maxInstances);
+	m_instanceCapacity += maxInstances;
+
+	return static_cast<unsigned int>(m_commands.size() - 1);
+}
+
+bool kengine::gpu_culler::setInstances(const gpu_instance* instances, size_t count)
+{
+	std::vector<GLuint> counts(m_commands.size(), 0);
+
+	for (size_t index = 0; index < count; index++) {
+		uint32_t draw = instances[index].draw;
+
+		if (draw >= counts.size() || ++counts[draw] > m_drawCapacities[draw]) {
+			K_LOG_OUTPUT_RAW("gpu_culler: the instance " << index << " has an invalid draw or its draw is full");
+			return false;
+		}
+	}
+
+	if (count > m_instanceBufferCapacity) {
+		reallocate(m_instanceBuffer, static_cast<GLsizeiptr>(count * sizeof(gpu_instance)), GL_DYNAMIC_STORAGE_BIT, "gpu_culler");
+		m_instanceBufferCapacity = count;
+	}
+
+	if (count > 0)
+		glNamedBufferSubData(m_instanceBuffer, 0, static_cast<GLsizeiptr>(count * sizeof(gpu_instance)), instances);
+
+	m_instanceCountValue = static_cast<GLuint>(count);
+
+	return true;
+}
+
+void kengine::gpu_culler::bindInstanceAttribute(GLuint vertexArray, GLuint location, GLuint binding)
+{
+	glEnableVertexArrayAttrib(vertexArray, location);
+	glVertexArrayAttribIFormat(vertexArray, location, 1, GL_UNSIGNED_INT, 0);
+	glVertexArrayAttribBinding(vertexArray, location, binding);
+	glVertexArrayBindingDivisor(vertexArray, binding, 1);
+
+	// before the first cull there is no visible buffer yet (cull binds it)
+	if (m_visibleBuffer != 0)
+		glVertexArrayVertexBuffer(vertexArray, binding, m_visibleBuffer, 0, sizeof(GLuint));
+
+	std::pair<GLuint, GLuint> instanceBinding(vertexArray, binding);
+
+	if (std::find(m_instanceVertexArrays.begin(), m_instanceVertexArrays.end(), instanceBinding) == m_instanceVertexArrays.end())
+		m_instanceVertexArrays.push_back(instanceBinding);
+}
+
+void kengine::gpu_culler::bindVisibleBuffer()
+{
+	for (const auto& instanceBinding : m_instanceVertexArrays)
+		glVertexArrayVertexBuffer(instanceBinding.first, instanceBinding.second, m_visibleBuffer, 0, sizeof(GLuint));
+}
+
+void kengine::gpu_culler::updateHiZ(GLuint framebuffer, int width, int height, const float* viewProjection)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	if (width != m_hizWidth || height != m_hizHeight) {
+		destroyTargets();
+
+		m_hizWidth = width;
+		m_hizHeight = height;
+		m_hizLevelCount = 1;
+
+		while ((std::max(width, height) >> m_hizLevelCount) > 0)
+			m_hizLevelCount++;
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_depthTexture);
+		glTextureStorage2D(m_depthTexture, 1, GL_DEPTH24_STENCIL8, width, height);
+		glTextureParameteri(m_depthTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(m_depthTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::RENDER_TARGET, m_depthTexture, static_cast<size_t>(width) * height * 4, "gpu_culler");
+
+		glCreateFramebuffers(1, &m_depthFramebuffer);
+		glNamedFramebufferTexture(m_depthFramebuffer, GL_DEPTH_STENCIL_ATTACHMENT, m_depthTexture, 0);
+
+		size_t hizSize = 0;
+
+		for (int level = 0; level < m_hizLevelCount; level++)
+			hizSize += static_cast<size_t>(std::max(1, width >> level)) * std::max(1, height >> level) * sizeof(float);
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_hizTexture);
+		glTextureStorage2D(m_hizTexture, m_hizLevelCount, GL_R32F, width, height);
+		glTextureParameteri(m_hizTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		glTextureParameteri(m_hizTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::RENDER_TARGET, m_hizTexture, hizSize, "gpu_culler");
+	}
+
+	glBlitNamedFramebuffer(framebuffer, m_depthFramebuffer, 0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+	// level 0
+	kengine::glState().useProgram(m_copyDepthProgram.getProgramID());
+	kengine::glState().bindTexture(0, m_depthTexture);
+	glBindImageTexture(1, m_hizTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+	glDispatchCompute(static_cast<GLuint>((width + 7) / 8), static_cast<GLuint>((height + 7) / 8), 1);
+
+	// the other levels (each one reads the previous one)
+	kengine::glState().useProgram(m_reduceProgram.getProgramID());
+
+	for (int level = 1; level < m_hizLevelCount; level++) {
+		int levelWidth = std::max(1, width >> level);
+		int levelHeight = std::max(1, height >> level);
+
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		glBindImageTexture(0, m_hizTexture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+		glBindImageTexture(1, m_hizTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		glDispatchCompute(static_cast<GLuint>((levelWidth + 7) / 8), static_cast<GLuint>((levelHeight + 7) / 8), 1);
+	}
+
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+	std::copy(viewProjection, viewProjection + 16, m_hizViewProjection);
+	m_hizLevels = m_hizLevelCount;
+}
+
+void kengine::gpu_culler::cull(const float* viewProjection)
+{
+	// the draws can be added after the first cull
+	if (m_commands.size() > m_commandCapacity) {
+		reallocate(m_commandBuffer, static_cast<GLsizeiptr>(m_commands.size() * sizeof(gpu_draw_command)), GL_DYNAMIC_STORAGE_BIT, "gpu_culler");
+		m_commandCapacity = m_commands.size();
+	}
+
+	if (m_instanceCapacity > m_visibleCapacity) {
+		reallocate(m_visibleBuffer, static_cast<GLsizeiptr>(m_instanceCapacity * sizeof(GLuint)), GL_DYNAMIC_STORAGE_BIT, "gpu_culler");
+		m_visibleCapacity = m_instanceCapacity;
+
+		// the vertex arrays still source the deleted buffer
+		bindVisibleBuffer();
+	}
+
+	if (m_commands.empty())
+		return;
+
+	// instanceCount is the append counter of each command
+	glNamedBufferSubData(m_commandBuffer, 0, static_cast<GLsizeiptr>(m_commands.size() * sizeof(gpu_draw_command)), m_commands.data());
+	glClearNamedBufferData(m_counterBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+	// frustum planes (Gribb-Hartmann): row 3 +/- rows 0, 1 and 2 of the column-major matrix
+	GLfloat planes[24];
+
+	for (int plane = 0; plane < 6; plane++) {
+		int row = plane / 2;
+		float sign = (plane % 2 == 0) ? 1.0f : -1.0f;
+
+		for (int column = 0; column < 4; column++)
+			planes[plane * 4 + column] = viewProjection[column * 4 + 3] + sign * viewProjection[column * 4 + row];
+	}
+
+	GLint hizLevels = m_hizLevels;
+
+	kengine::glState().useProgram(m_cullProgram.getProgramID());
+	m_cullProgram.setUniform(m_previousViewProjection, m_hizViewProjection);
+	m_cullProgram.setUniform(m_frustumPlanes, planes, 6);
+	m_cullProgram.setUniform(m_instanceCount, &m_instanceCountValue);
+	m_cullProgram.setUniform(m_hizLevelsUniform, &hizLevels);
+
+	kengine::glState().bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_instanceBuffer);
+	kengine::glState().bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_commandBuffer);
+	kengine::glState().bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_visibleBuffer);
+	kengine::glState().bindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, m_counterBuffer);
+
+	if (m_hizLevels > 0)
+		kengine::glState().bindTexture(0, m_hizTexture);
+
+	if (m_instanceCountValue > 0)
+		glDispatchCompute((m_instanceCountValue + 63) / 64, 1, 1);
+
+	// the commands and the visible instances are read by the draws, the counters by the copy
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	readStats();
+}
+
+void kengine::gpu_culler::readStats()
+{
+	// the newest region whose copy is done
+	for (int age = STATS_LATENCY - 1; age >= 1; age--) {
+		int region = (m_statsFrame - age + STATS_LATENCY) % STATS_LATENCY;
+		GLsync& fence = m_statsFences[region];
+
+		if (fence == nullptr)
+			continue;
+
+		GLenum result = glClientWaitSync(fence, 0, 0);
+
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+			const GLuint* counters = m_statsData + region * COUNTER_COUNT;
+			m_stats.visible = counters[0];
+			m_stats.frustumCulled = counters[1];
+			m_stats.occluded = counters[2];
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	// the GPU is too far behind: the sample of this region is lost
+	GLsync& fence = m_statsFences[m_statsFrame];
+
+	if (fence != nullptr)
+		glDeleteSync(fence);
+
+	glCopyNamedBufferSubData(m_counterBuffer, m_statsBuffer, 0, static_cast<GLintptr>(sizeof(GLuint) * COUNTER_COUNT * m_statsFrame), sizeof(GLuint) * COUNTER_COUNT);
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	m_statsFrame = (m_statsFrame + 1) % STATS_LATENCY;
+}
+
+void kengine::gpu_culler::destroyTargets()
+{
+	if (m_depthFramebuffer != 0) {
+		glDeleteFramebuffers(1, &m_depthFramebuffer);
+		m_depthFramebuffer = 0;
+	}
+
+	kengine::deleteTrackedTexture(m_depthTexture, GPU_MEMORY_CATEGORY::RENDER_TARGET);
+	kengine::deleteTrackedTexture(m_hizTexture, GPU_MEMORY_CATEGORY::RENDER_TARGET);
+
+	m_hizWidth = 0;
+	m_hizHeight = 0;
+	m_hizLevelCount = 0;
+	m_hizLevels = 0;
+}
@@ -0,0 +1,298 @@
+/*
+	K-Engine GPU Memory Tracker
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <gpu_memory.hpp>
+#include <logger.hpp>
+
+#include <sstream>
+
+std::string kengine::getGPUMemoryCategoryName(GPU_MEMORY_CATEGORY category)
+{
+	switch (category) {
+	case GPU_MEMORY_CATEGORY::BUFFER:
+		return "buffer";
+	case GPU_MEMORY_CATEGORY::TEXTURE:
+		return "texture";
+	case GPU_MEMORY_CATEGORY::PROGRAM:
+		return "program";
+	case GPU_MEMORY_CATEGORY::RENDER_TARGET:
+		return "render target";
+	case GPU_MEMORY_CATEGORY::RENDERBUFFER:
+		return "renderbuffer";
+	default:
+		return "unknown";
+	}
+}
+
+/*
+	kengine::gpu_memory_tracker class - member class definition
+*/
+
+void kengine::gpu_memory_tracker::allocate(GPU_MEMORY_CATEGORY category, unsigned int id, size_t sizeInBytes, const std::string& owner)
+{
+	bool overBudget = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		allocation& entry = m_allocations[key(category, id)];
+
+		// the same GL object is reallocated (e.g. glBufferData on the same name)
+		if (entry.sizeInBytes > 0) {
+			m_usage -= entry.sizeInBytes;
+			m_categoryUsage[static_cast<int>(entry.category)] -= entry.sizeInBytes;
+			m_frameStats.releasedBytes += entry.sizeInBytes;
+
+			if ((m_ownerUsage[entry.owner] -= entry.sizeInBytes) == 0)
+				m_ownerUsage.erase(entry.owner);
+		}
+
+		entry.category = category;
+		entry.sizeInBytes = sizeInBytes;
+		entry.owner = owner;
+
+		m_usage += sizeInBytes;
+		m_categoryUsage[static_cast<int>(category)] += sizeInBytes;
+		m_ownerUsage[owner] += sizeInBytes;
+
+		if (m_usage > m_peakUsage)
+			m_peakUsage = m_usage;
+
+		m_frameStats.allocatedBytes += sizeInBytes;
+		m_frameStats.allocations++;
+
+		overBudget = m_budget > 0 && m_usage > m_budget;
+	}
+
+	// the callbacks are called without the lock because they release the allocations
+	if (overBudget)
+		evict();
+}
+
+void kengine::gpu_memory_tracker::release(GPU_MEMORY_CATEGORY category, unsigned int id)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_allocations.find(key(category, id));
+
+	if (it == m_allocations.end())
+		return;
+
+	const allocation& entry = it->second;
+
+	m_usage -= entry.sizeInBytes;
+	m_categoryUsage[static_cast<int>(entry.category)] -= entry.sizeInBytes;
+
+	auto owner = m_ownerUsage.find(entry.owner);
+	owner->second -= entry.sizeInBytes;
+
+	if (owner->second == 0)
+		m_ownerUsage.erase(owner);
+
+	m_frameStats.releasedBytes += entry.sizeInBytes;
+	m_frameStats.releases++;
+
+	m_allocations.erase(it);
+}
+
+void kengine::gpu_memory_tracker::setBudget(size_t sizeInBytes)
+{
+	bool overBudget = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_budget = sizeInBytes;
+		overBudget = m_budget > 0 && m_usage > m_budget;
+	}
+
+	if (overBudget)
+		evict();
+}
+
+size_t kengine::gpu_memory_tracker::getBudget() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_budget;
+}
+
+int kengine::gpu_memory_tracker::addEvictionCallback(eviction_callback callback)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_evictionCallbacks.push_back(std::make_pair(m_nextCallbackID, std::move(callback)));
+	return m_nextCallbackID++;
+}
+
+void kengine::gpu_memory_tracker::removeEvictionCallback(int callbackID)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for (auto it = m_evictionCallbacks.begin(); it != m_evictionCallbacks.end(); ++it) {
+		if (it->first == callbackID) {
+			m_evictionCallbacks.erase(it);
+			break;
+		}
+	}
+
+	// a callback can remove itself, so only a call on another thread is waited for
+	m_callbackDone.wait(lock, [this, callbackID]() {
+		return m_runningCallback != callbackID || m_evictingThread == std::this_thread::get_id();
+	});
+}
+
+size_t kengine::gpu_memory_tracker::getUsage() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_usage;
+}
+
+size_t kengine::gpu_memory_tracker::getUsage(GPU_MEMORY_CATEGORY category) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_categoryUsage[static_cast<int>(category)];
+}
+
+size_t kengine::gpu_memory_tracker::getOwnerUsage(const std::string& owner) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_ownerUsage.find(owner);
+	return it != m_ownerUsage.end() ? it->second : 0;
+}
+
+size_t kengine::gpu_memory_tracker::getPeakUsage() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_peakUsage;
+}
+
+size_t kengine::gpu_memory_tracker::getAllocationCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_allocations.size();
+}
+
+void kengine::gpu_memory_tracker::newFrame()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = gpu_memory_frame_stats();
+}
+
+kengine::gpu_memory_frame_stats kengine::gpu_memory_tracker::getFrameStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_lastFrameStats;
+}
+
+std::string kengine::gpu_memory_tracker::report() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::stringstream output;
+
+	output << "> GPU MEMORY USAGE: " << m_usage << " bytes (" << m_allocations.size() << " allocations)" << std::endl;
+	output << "> GPU MEMORY PEAK USAGE: " << m_peakUsage << " bytes" << std::endl;
+	output << "> GPU MEMORY BUDGET: ";
+
+	if (m_budget > 0)
+		output << m_budget << " bytes" << std::endl;
+	else
+		output << "none" << std::endl;
+
+	for (int i = 0; i < static_cast<int>(GPU_MEMORY_CATEGORY::COUNT); i++)
+		output << "- " << getGPUMemoryCategoryName(static_cast<GPU_MEMORY_CATEGORY>(i)) << ": " << m_categoryUsage[i] << " bytes" << std::endl;
+
+	// the allocations which are alive at the end of the application are leaks
+	for (const auto& owner : m_ownerUsage)
+		output << "- owner " << owner.first << ": " << owner.second << " bytes" << std::endl;
+
+	return output.str();
+}
+
+void kengine::gpu_memory_tracker::evict()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// an eviction callback may allocate memory, so this is not reentrant
+		if (m_evicting)
+			return;
+
+		m_evicting = true;
+		m_evictingThread = std::this_thread::get_id();
+	}
+
+	// the callbacks are looked up on each step (in the order of their identifiers), so a removed callback is not called
+	int previousCallback = -1;
+
+	while (true) {
+		eviction_callback callback;
+		size_t excess = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (m_budget == 0 || m_usage <= m_budget)
+				break;
+
+			auto it = m_evictionCallbacks.begin();
+
+			while (it != m_evictionCallbacks.end() && it->first <= previousCallback)
+				++it;
+
+			if (it == m_evictionCallbacks.end())
+				break;
+
+			previousCallback = it->first;
+			callback = it->second;
+			m_runningCallback = it->first;
+
+			excess = m_usage - m_budget;
+			m_frameStats.evictions++;
+		}
+
+		size_t released = callback(excess);
+		callback = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_runningCallback = -1;
+			m_frameStats.evictedBytes += released;
+		}
+
+		m_callbackDone.notify_all();
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_evicting = false;
+	m_evictingThread = std::thread::id();
+
+	if (m_budget > 0 && m_usage > m_budget)
+		K_LOG_OUTPUT_RAW("> GPU memory usage (" + std::to_string(m_usage) + " bytes) exceeds the budget (" + std::to_string(m_budget) + " bytes)");
+}
+
+kengine::gpu_memory_tracker& kengine::gpuMemoryTracker()
+{
+	static gpu_memory_tracker tracker;
+	return tracker;
+}
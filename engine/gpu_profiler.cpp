@@ -0,0 +1,261 @@
+/*
+	K-Engine GPU Profiler
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <gpu_profiler.hpp>
+#include <logger.hpp>
+
+namespace
+{
+	const GLenum statisticsTargets[] = {
+		GL_VERTICES_SUBMITTED,
+		GL_PRIMITIVES_SUBMITTED,
+		GL_VERTEX_SHADER_INVOCATIONS,
+		GL_FRAGMENT_SHADER_INVOCATIONS
+	};
+
+	uint64_t getQueryResult(GLuint query)
+	{
+		GLuint64 result = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+		return static_cast<uint64_t>(result);
+	}
+}
+
+/*
+	kengine::gpu_profiler class - member class definition
+*/
+
+bool kengine::gpu_profiler::init(int frameLatency, int maxScopes)
+{
+	finish();
+
+	if (frameLatency < 1 || maxScopes < 1)
+		return false;
+
+	m_hasStatistics = kengine::isExtensionSupported("GL_ARB_pipeline_statistics_query");
+
+	// one more frame than the latency: the frame being recorded is not read back
+	m_frames.resize(static_cast<size_t>(frameLatency) + 1);
+
+	for (frame_queries& frame : m_frames) {
+		frame.queries.resize(static_cast<size_t>(maxScopes));
+		frame.scopes.reserve(static_cast<size_t>(maxScopes));
+
+		for (scope_queries& queries : frame.queries) {
+			glGenQueries(1, &queries.begin);
+			glGenQueries(1, &queries.end);
+			glGenQueries(1, &queries.primitives);
+
+			if (m_hasStatistics)
+				glGenQueries(STATISTICS_COUNT, queries.statistics);
+		}
+	}
+
+	m_current = 0;
+	m_frame = 0;
+	m_frames[0].frame = 0;
+
+	return true;
+}
+
+void kengine::gpu_profiler::finish()
+{
+	for (frame_queries& frame : m_frames) {
+		for (scope_queries& queries : frame.queries) {
+			glDeleteQueries(1, &queries.begin);
+			glDeleteQueries(1, &queries.end);
+			glDeleteQueries(1, &queries.primitives);
+
+			if (m_hasStatistics)
+				glDeleteQueries(STATISTICS_COUNT, queries.statistics);
+		}
+	}
+
+	m_frames.clear();
+	m_openScopes.clear();
+	m_counterScope = -1;
+	m_lastFrameStats.clear();
+}
+
+void kengine::gpu_profiler::newFrame()
+{
+	if (!isEnabled())
+		return;
+
+	if (!m_openScopes.empty()) {
+		K_LOG_OUTPUT_RAW("gpu_profiler: " << m_openScopes.size() << " scope(s) still open at the end of the frame");
+
+		while (!m_openScopes.empty())
+			endScope();
+	}
+
+	m_frames[m_current].pending = !m_frames[m_current].scopes.empty();
+
+	m_current = (m_current + 1) % static_cast<int>(m_frames.size());
+	frame_queries& frame = m_frames[m_current];
+
+	// the oldest frame of the ring is reused, so it is read back (or dropped) now
+	if (frame.pending)
+		readBack(frame);
+
+	frame.scopes.clear();
+	frame.frame = ++m_frame;
+	frame.pending = false;
+}
+
+void kengine::gpu_profiler::beginScope(const char* name)
+{
+	glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+
+	if (!isEnabled())
+		return;
+
+	frame_queries& frame = m_frames[m_current];
+
+	// too many scopes: the debug group is pushed but the scope is not timed
+	if (frame.scopes.size() >= frame.queries.size()) {
+		m_openScopes.push_back(-1);
+		return;
+	}
+
+	int index = static_cast<int>(frame.scopes.size());
+	const scope_queries& queries = frame.queries[index];
+
+	scope_record record;
+	record.name = name;
+	record.depth = static_cast<unsigned int>(m_openScopes.size());
+
+	glQueryCounter(queries.begin, GL_TIMESTAMP);
+
+	if (m_counterScope == -1) {
+		glBeginQuery(GL_PRIMITIVES_GENERATED, queries.primitives);
+
+		if (m_hasStatistics) {
+			for (int counter = 0; counter < STATISTICS_COUNT; counter++)
+				glBeginQuery(statisticsTargets[counter], queries.statistics[counter]);
+		}
+
+		m_counterScope = index;
+		record.hasCounters = true;
+	}
+
+	frame.scopes.push_back(record);
+	m_openScopes.push_back(index);
+}
+
+void kengine::gpu_profiler::endScope()
+{
+	if (isEnabled() && !m_openScopes.empty()) {
+		int index = m_openScopes.back();
+		m_openScopes.pop_back();
+
+		if (index >= 0) {
+			const scope_queries& queries = m_frames[m_current].queries[index];
+
+			if (index == m_counterScope) {
+				glEndQuery(GL_PRIMITIVES_GENERATED);
+
+				if (m_hasStatistics) {
+					for (int counter = 0; counter < STATISTICS_COUNT; counter++)
+						glEndQuery(statisticsTargets[counter]);
+				}
+
+				m_counterScope = -1;
+			}
+
+			glQueryCounter(queries.end, GL_TIMESTAMP);
+		}
+	}
+
+	glPopDebugGroup();
+}
+
+void kengine::gpu_profiler::readBack(frame_queries& frame)
+{
+	// the queries complete in order, so the frame is ready if the last end timestamp is ready
+	GLuint lastQuery = 0;
+
+	for (size_t index = 0; index < frame.scopes.size(); index++) {
+		if (frame.scopes[index].depth == 0)
+			lastQuery = frame.queries[index].end;
+	}
+
+	GLuint available = GL_FALSE;
+	glGetQueryObjectuiv(lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+
+	if (available == GL_FALSE) {
+		m_droppedFrames++;
+		return;
+	}
+
+	m_lastFrameStats.resize(frame.scopes.size());
+
+	for (size_t index = 0; index < frame.scopes.size(); index++) {
+		const scope_record& scope = frame.scopes[index];
+		const scope_queries& queries = frame.queries[index];
+		gpu_pass_stats& stats = m_lastFrameStats[index];
+
+		stats = gpu_pass_stats();
+		stats.name = scope.name;
+		stats.depth = scope.depth;
+		stats.milliseconds = static_cast<double>(getQueryResult(queries.end) - getQueryResult(queries.begin)) / 1000000.0;
+		stats.hasCounters = scope.hasCounters;
+
+		if (scope.hasCounters) {
+			stats.primitivesGenerated = getQueryResult(queries.primitives);
+
+			if (m_hasStatistics) {
+				stats.verticesSubmitted = getQueryResult(queries.statistics[0]);
+				stats.primitivesSubmitted = getQueryResult(queries.statistics[1]);
+				stats.vertexShaderInvocations = getQueryResult(queries.statistics[2]);
+				stats.fragmentShaderInvocations = getQueryResult(queries.statistics[3]);
+			}
+		}
+	}
+
+	m_lastFrame = frame.frame;
+}
+
+/*
+	kengine::gpu_scope class - member class definition
+*/
+
+kengine::gpu_scope::gpu_scope(const char* name, gpu_profiler& profiler)
+	: m_profiler(profiler)
+{
+	m_profiler.beginScope(name);
+}
+
+kengine::gpu_scope::~gpu_scope()
+{
+	m_profiler.endScope();
+}
+
+kengine::gpu_profiler& kengine::gpuProfiler()
+{
+	static gpu_profiler profiler;
+	return profiler;
+}
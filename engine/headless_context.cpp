@@ -0,0 +1,405 @@
+/*
+	K-Engine Headless Rendering Context
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <headless_context.hpp>
+#include <k_version.hpp>
+#include <gpu_memory.hpp>
+#include <logger.hpp>
+
+#include <cassert>
+#include <cstring>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace
+{
+	bool hasExtension(const char* extensions, const char* name)
+	{
+		if (extensions == nullptr)
+			return false;
+
+		size_t length = std::strlen(name);
+
+		for (const char* found = std::strstr(extensions, name); found != nullptr; found = std::strstr(found + length, name)) {
+			if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0'))
+				return true;
+		}
+
+		return false;
+	}
+
+	/*
+		The GLX context flags and profile bits (see kengine::CONTEXT_FLAG) have the same values as the EGL_KHR_create_context ones
+	*/
+	EGLContext createContext(EGLDisplay display, EGLConfig config, EGLContext sharedContext, const kengine::compatibility_profile& profile)
+	{
+		EGLint attribList[9] = {
+			EGL_CONTEXT_MAJOR_VERSION_KHR, KENGINE_OPENGL_MAJOR_VERSION,
+			EGL_CONTEXT_MINOR_VERSION_KHR, KENGINE_OPENGL_MINOR_VERSION,
+			EGL_NONE
+		};
+
+		int count = 4;
+
+		if (profile.contextFlag) {
+			attribList[count++] = EGL_CONTEXT_FLAGS_KHR;
+			attribList[count++] = profile.contextFlag;
+		}
+
+		if (profile.profileMask) {
+			attribList[count++] = EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR;
+			attribList[count++] = profile.profileMask;
+		}
+
+		attribList[count] = EGL_NONE;
+
+		return eglCreateContext(display, config, sharedContext, attribList);
+	}
+}
+
+namespace kengine
+{
+	/*
+		kengine::egl_shared_rendering_context - class members definition
+
+		EGL context that shares the objects with the headless context (see kengine::upload_worker)
+	*/
+	class egl_shared_rendering_context : public rendering_context
+	{
+	public:
+		egl_shared_rendering_context(EGLDisplay display, EGLConfig config, EGLContext sharedContext, bool surfaceless)
+			: m_display{ display }, m_config{ config }, m_sharedContext{ sharedContext }, m_surfaceless{ surfaceless }
+		{
+		}
+
+		~egl_shared_rendering_context() {
+			if (m_context != EGL_NO_CONTEXT)
+				destroy();
+		}
+
+		egl_shared_rendering_context(const egl_shared_rendering_context& copy) = delete; // copy constructor
+		egl_shared_rendering_context& operator=(const egl_shared_rendering_context& copy) = delete; // copy assignment
+		egl_shared_rendering_context(egl_shared_rendering_context&& move) noexcept = delete;  // move constructor
+		egl_shared_rendering_context& operator=(egl_shared_rendering_context&&) = delete; // move assigment
+
+		int create(const compatibility_profile& profile) {
+			m_context = createContext(m_display, m_config, m_sharedContext, profile);
+
+			if (m_context == EGL_NO_CONTEXT) {
+				K_LOG_OUTPUT_RAW("It was not possible to create a shared EGL context");
+				return 0;
+			}
+
+			if (!m_surfaceless) {
+				const EGLint surfaceAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+				m_surface = eglCreatePbufferSurface(m_display, m_config, surfaceAttribs);
+			}
+
+			return 1;
+		}
+
+		int destroy() {
+			if (m_surface != EGL_NO_SURFACE)
+				eglDestroySurface(m_display, m_surface);
+
+			eglDestroyContext(m_display, m_context);
+			m_surface = EGL_NO_SURFACE;
+			m_context = EGL_NO_CONTEXT;
+			return 1;
+		}
+
+		int makeCurrent(bool enable) {
+			if (enable)
+				return eglMakeCurrent(m_display, m_surface, m_surface, m_context) ? 1 : 0;
+
+			return eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT) ? 1 : 0;
+		}
+
+		int swapBuffers() {
+			return 1;
+		}
+
+		void clearBuffers() {
+		}
+
+	private:
+		EGLDisplay m_display = EGL_NO_DISPLAY;
+		EGLConfig m_config = nullptr;
+		EGLContext m_sharedContext = EGL_NO_CONTEXT;
+		EGLContext m_context = EGL_NO_CONTEXT;
+		EGLSurface m_surface = EGL_NO_SURFACE;
+		bool m_surfaceless = true;
+	};
+}
+
+#endif
+
+/*
+	kengine::headless_rendering_context class - member class definition
+*/
+
+kengine::headless_rendering_context::headless_rendering_context(int width, int height)
+	: m_width(width), m_height(height)
+{
+}
+
+kengine::headless_rendering_context::~headless_rendering_context()
+{
+	if (m_context != nullptr)
+		destroy();
+}
+
+int kengine::headless_rendering_context::create(const compatibility_profile& profile)
+{
+#if defined(__linux__) && !defined(__ANDROID__)
+	EGLDisplay display = EGL_NO_DISPLAY;
+
+	// the surfaceless platform doesn't need any display server (e.g. CI machines and render farms)
+	if (hasExtension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), "EGL_MESA_platform_surfaceless")) {
+		PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+		if (eglGetPlatformDisplayEXT != nullptr)
+			display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+
+	if (display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+		K_LOG_OUTPUT_RAW("headless_rendering_context: it was not possible to initialize an EGL display");
+		return 0;
+	}
+
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		K_LOG_OUTPUT_RAW("headless_rendering_context: the EGL display doesn't support OpenGL");
+		return 0;
+	}
+
+	bool surfaceless = hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+
+	EGLint configAttribs[] = {
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_NONE
+	};
+
+	// the surfaceless configs don't need to support any surface type (the default type is EGL_WINDOW_BIT)
+	if (surfaceless)
+		configAttribs[3] = EGL_DONT_CARE;
+
+	EGLConfig config = nullptr;
+	EGLint configCount = 0;
+
+	if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+		K_LOG_OUTPUT_RAW("headless_rendering_context: no EGL config supports OpenGL");
+		return 0;
+	}
+
+	EGLContext context = createContext(display, config, EGL_NO_CONTEXT, profile);
+
+	if (context == EGL_NO_CONTEXT) {
+		K_LOG_OUTPUT_RAW("headless_rendering_context: it was not possible to create an OpenGL " << KENGINE_OPENGL_MAJOR_VERSION << "." << KENGINE_OPENGL_MINOR_VERSION << " context");
+		return 0;
+	}
+
+	EGLSurface surface = EGL_NO_SURFACE;
+
+	if (!surfaceless) {
+		const EGLint surfaceAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+		surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+	}
+
+	m_display = display;
+	m_config = config;
+	m_context = context;
+	m_surface = surface;
+	m_profile = profile;
+
+	if (!makeCurrent(true) || !kengine::getAllGLProcedures()) {
+		destroy();
+		return 0;
+	}
+
+	if (!createFramebuffer()) {
+		destroy();
+		return 0;
+	}
+
+	return 1;
+#else
+	(void)profile;
+	K_LOG_OUTPUT_RAW("headless_rendering_context: the headless contexts are not supported on this platform");
+	return 0;
+#endif
+}
+
+int kengine::headless_rendering_context::destroy()
+{
+#if defined(__linux__) && !defined(__ANDROID__)
+	if (m_context == nullptr)
+		return 1;
+
+	if (eglGetCurrentContext() == m_context)
+		deleteFramebuffer();
+
+	makeCurrent(false);
+
+	if (m_surface != nullptr)
+		eglDestroySurface(m_display, m_surface);
+
+	eglDestroyContext(m_display, m_context);
+
+	// the display is not terminated: it is shared by every headless context of the process
+	m_context = nullptr;
+	m_surface = nullptr;
+#endif
+	return 1;
+}
+
+int kengine::headless_rendering_context::makeCurrent(bool enable)
+{
+#if defined(__linux__) && !defined(__ANDROID__)
+	if (enable)
+		return eglMakeCurrent(m_display, m_surface, m_surface, m_context) ? 1 : 0;
+
+	return eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT) ? 1 : 0;
+#else
+	(void)enable;
+	return 0;
+#endif
+}
+
+int kengine::headless_rendering_context::swapBuffers()
+{
+	glFlush();
+	return 1;
+}
+
+void kengine::headless_rendering_context::clearBuffers()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
+
+kengine::rendering_context* kengine::headless_rendering_context::createSharedContext()
+{
+#if defined(__linux__) && !defined(__ANDROID__)
+	assert(!(m_context == nullptr));
+
+	egl_shared_rendering_context* context = new egl_shared_rendering_context(m_display, m_config, m_context, m_surface == nullptr);
+
+	if (!context->create(m_profile)) {
+		delete context;
+		return nullptr;
+	}
+
+	return context;
+#else
+	return nullptr;
+#endif
+}
+
+bool kengine::headless_rendering_context::resize(int width, int height)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	m_width = width;
+	m_height = height;
+
+	if (m_context == nullptr)
+		return true;
+
+	deleteFramebuffer();
+	return createFramebuffer();
+}
+
+bool kengine::headless_rendering_context::readPixels(std::vector<unsigned char>& pixels) const
+{
+	if (m_framebuffer == 0)
+		return false;
+
+	pixels.resize(static_cast<size_t>(m_width) * m_height * 4);
+
+	// the rows of RGBA8 pixels are always 4-byte aligned (GL_PACK_ALIGNMENT)
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+	return glGetError() == GL_NO_ERROR;
+}
+
+bool kengine::headless_rendering_context::createFramebuffer()
+{
+	glCreateRenderbuffers(1, &m_colorBuffer);
+	glNamedRenderbufferStorage(m_colorBuffer, GL_RGBA8, m_width, m_height);
+
+	glCreateRenderbuffers(1, &m_depthBuffer);
+	glNamedRenderbufferStorage(m_depthBuffer, GL_DEPTH24_STENCIL8, m_width, m_height);
+
+	glCreateFramebuffers(1, &m_framebuffer);
+	glNamedFramebufferRenderbuffer(m_framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glNamedFramebufferRenderbuffer(m_framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	if (glCheckNamedFramebufferStatus(m_framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		K_LOG_OUTPUT_RAW("headless_rendering_context: the " << m_width << "x" << m_height << " framebuffer is not complete");
+		deleteFramebuffer();
+		return false;
+	}
+
+	size_t size = static_cast<size_t>(m_width) * m_height * 4;
+	kengine::gpuMemoryTracker().allocate(GPU_MEMORY_CATEGORY::RENDERBUFFER, m_colorBuffer, size, "headless_rendering_context");
+	kengine::gpuMemoryTracker().allocate(GPU_MEMORY_CATEGORY::RENDERBUFFER, m_depthBuffer, size, "headless_rendering_context");
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_width, m_height);
+
+	return true;
+}
+
+void kengine::headless_rendering_context::deleteFramebuffer()
+{
+	if (m_framebuffer != 0) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &m_framebuffer);
+	}
+
+	if (m_colorBuffer != 0) {
+		kengine::gpuMemoryTracker().release(GPU_MEMORY_CATEGORY::RENDERBUFFER, m_colorBuffer);
+		glDeleteRenderbuffers(1, &m_colorBuffer);
+	}
+
+	if (m_depthBuffer != 0) {
+		kengine::gpuMemoryTracker().release(GPU_MEMORY_CATEGORY::RENDERBUFFER, m_depthBuffer);
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+	}
+
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+}
@@ -0,0 +1,200 @@
+/*
+	K-Engine Clustered Lighting
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_CLUSTERED_LIGHTING_HPP
+#define K_ENGINE_CLUSTERED_LIGHTING_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		World space point light (the layout of the shader storage buffer)
+	*/
+	struct point_light
+	{
+		float position[3] = { 0.0f, 0.0f, 0.0f };
+		float radius = 1.0f; // the light doesn't affect anything beyond the radius
+		float color[3] = { 1.0f, 1.0f, 1.0f };
+		float intensity = 1.0f;
+	};
+
+	/*
+		Range of a cluster in the light index list
+	*/
+	struct light_cluster
+	{
+		uint32_t offset = 0;
+		uint32_t count = 0;
+	};
+
+	struct clustered_lighting_stats
+	{
+		unsigned int lights = 0;
+		unsigned int visibleLights = 0; // lights that overlap the clustered part of the frustum
+		unsigned int activeClusters = 0; // clusters with at least one light
+		unsigned int indices = 0;
+		unsigned int overflows = 0; // lights dropped because a cluster was full
+		double binMilliseconds = 0.0;
+		double uploadMilliseconds = 0.0;
+	};
+
+	/*
+		kengine::light_clusters assigns the point lights to the clusters of the view frustum (froxels), so a
+		fragment shader only loops over the lights of its own cluster (see shaders/clustered_lighting.glsl).
+
+		The frustum is split into a grid of screen tiles and exponential depth slices. Each frame, bin() transforms
+		the lights into view space and assigns them to the clusters on the threads of kengine::threadPool() (each
+		thread owns a set of depth slices, so the lists are built without locks), then the lists are compacted
+		into a single index list. upload() copies the lights, the clusters and the indices to shader storage
+		buffers (the GL part, on the GL thread).
+
+		The matrices are column-major float[16] (the layout of glUniformMatrix4fv) and the projection must be a
+		perspective projection (the OpenGL convention, looking down -Z).
+
+		Usage per frame:
+
+			clusters.bin(view, lights, count);
+			clusters.upload();
+			clusters.bind();
+	*/
+	class light_clusters
+	{
+	public:
+		/*
+			Default bindings of the shader storage blocks (see shaders/clustered_lighting.glsl)
+		*/
+		static constexpr GLuint LIGHT_BINDING = 4;
+		static constexpr GLuint CLUSTER_BINDING = 5;
+		static constexpr GLuint INDEX_BINDING = 6;
+
+		/*
+			The layout of the beginning of the cluster buffer (followed by the light_cluster array)
+		*/
+		struct grid_header
+		{
+			uint32_t size[4] = { 0, 0, 0, 0 }; // x, y, z, lights per cluster
+			float params[4] = { 0.0f, 0.0f, 0.0f, 0.0f }; // 1 / viewport width, 1 / viewport height, depth slice scale, depth slice bias
+		};
+
+		explicit light_clusters(unsigned int tilesX = 16, unsigned int tilesY = 9, unsigned int slices = 24, unsigned int maxLightsPerCluster = 256);
+		~light_clusters();
+
+		light_clusters(const light_clusters& copy) = delete; // copy constructor
+		light_clusters(light_clusters&& move) noexcept = delete; // move constructor
+		light_clusters& operator=(const light_clusters& copy) = delete; // copy assignment
+		light_clusters& operator=(light_clusters&&) = delete; // move assigment
+
+		/*
+			The clusters are rebuilt when the projection, the planes or the viewport change
+		*/
+		void setProjection(const float* projection, float nearPlane, float farPlane, int viewportWidth, int viewportHeight);
+
+		/*
+			The lights are copied (the buffer of the caller can be reused after the call)
+		*/
+		void bin(const float* view, const point_light* lights, size_t count);
+
+		/*
+			It must be called with a current rendering context
+		*/
+		void upload();
+		void bind(GLuint lightBinding = LIGHT_BINDING, GLuint clusterBinding = CLUSTER_BINDING, GLuint indexBinding = INDEX_BINDING) const;
+
+		unsigned int getClusterIndex(unsigned int x, unsigned int y, unsigned int slice) const { return (slice * m_tilesY + y) * m_tilesX + x; }
+		unsigned int getClusterCount() const { return m_tilesX * m_tilesY * m_slices; }
+
+		/*
+			Depth slice of a view space depth (the distance along -Z)
+		*/
+		unsigned int getSlice(float depth) const;
+
+		const light_cluster& getCluster(unsigned int index) const { return m_clusters[index]; }
+		const uint32_t* getIndices() const { return m_indices.data(); }
+
+		/*
+			View space bounds of a cluster (min x, y, z, max x, y, z)
+		*/
+		const float* getClusterBounds(unsigned int index) const { return &m_bounds[static_cast<size_t>(index) * 6]; }
+
+		const grid_header& getHeader() const { return m_header; }
+		GLuint getLightBuffer() const { return m_lightBuffer; }
+		GLuint getClusterBuffer() const { return m_clusterBuffer; }
+		GLuint getIndexBuffer() const { return m_indexBuffer; }
+
+		const clustered_lighting_stats& getFrameStats() const { return m_stats; }
+
+	private:
+		/*
+			View space sphere of a light and the range of clusters that it can touch
+		*/
+		struct light_range
+		{
+			float center[3];
+			float radius;
+			unsigned int min[3];
+			unsigned int max[3];
+			bool visible;
+		};
+
+		void buildBounds();
+		void computeRange(const point_light& light, const float* view, light_range& range) const;
+		unsigned int binSlice(unsigned int slice); // it returns the number of dropped lights
+
+		unsigned int m_tilesX = 0;
+		unsigned int m_tilesY = 0;
+		unsigned int m_slices = 0;
+		unsigned int m_maxLightsPerCluster = 0;
+
+		float m_projection[16];
+		float m_near = 0.1f;
+		float m_far = 100.0f;
+		std::vector<float> m_bounds; // per cluster
+		grid_header m_header;
+
+		std::vector<point_light> m_lights;
+		std::vector<light_range> m_ranges;
+		std::vector<unsigned int> m_sliceOverflows;
+		std::vector<uint32_t> m_clusterLights; // maxLightsPerCluster slots per cluster
+		std::vector<light_cluster> m_clusters;
+		std::vector<uint32_t> m_indices;
+
+		GLuint m_lightBuffer = 0;
+		GLuint m_clusterBuffer = 0;
+		GLuint m_indexBuffer = 0;
+		GLsizeiptr m_lightCapacity = 0;
+		GLsizeiptr m_clusterCapacity = 0;
+		GLsizeiptr m_indexCapacity = 0;
+
+		clustered_lighting_stats m_stats;
+	};
+}
+
+#endif
@@ -0,0 +1,198 @@
+/*
+	K-Engine Command Buffer
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_COMMAND_BUFFER_HPP
+#define K_ENGINE_COMMAND_BUFFER_HPP
+
+#include <gl_wrapper.hpp>
+#include <gl_state.hpp>
+#include <render_queue.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace kengine
+{
+	enum class COMMAND_TYPE : uint16_t
+	{
+		USE_PROGRAM,
+		BIND_BUFFER_RANGE,
+		BIND_TEXTURE,
+		BIND_SAMPLER,
+		APPLY_STATE,
+		DRAW_NODE,
+		DRAW_ARRAYS
+	};
+
+	/*
+		The commands are POD structs stored after their header in the linear memory of the buffer
+	*/
+	struct command_header
+	{
+		COMMAND_TYPE type;
+		uint16_t size; // header included (multiple of 8 bytes)
+	};
+
+	struct use_program_command
+	{
+		GLuint program;
+	};
+
+	struct bind_buffer_range_command
+	{
+		GLenum target;
+		GLuint index;
+		GLuint buffer;
+		GLintptr offset;
+		GLsizeiptr size;
+	};
+
+	struct bind_texture_command
+	{
+		GLuint unit;
+		GLuint texture;
+	};
+
+	struct bind_sampler_command
+	{
+		GLuint unit;
+		GLuint sampler;
+	};
+
+	struct apply_state_command
+	{
+		const pipeline_state* state; // it must be alive until the replay
+	};
+
+	struct draw_node_command
+	{
+		const mesh_node* node; // it must be alive until the replay
+	};
+
+	struct draw_arrays_command
+	{
+		GLenum mode;
+		int vertexFormat; // identifier from kengine::vertex_format_registry
+		GLuint buffer;
+		GLintptr offset;
+		GLsizei stride;
+		GLint first;
+		GLsizei count;
+	};
+
+	/*
+		kengine::command_buffer records the rendering commands without a rendering context.
+
+		The buffers are recorded in parallel (one per worker, e.g. one per view or per scene chunk) and replayed
+		in order on the GL thread by execute(). Recording doesn't call OpenGL, so it can run on any thread.
+		The memory is kept by reset(), so a buffer doesn't allocate after the first frames.
+	*/
+	class command_buffer
+	{
+	public:
+		explicit command_buffer(size_t capacity = 64 * 1024) { m_data.reserve(capacity); }
+		~command_buffer() {}
+
+		command_buffer(const command_buffer& copy) = delete; // copy constructor
+		command_buffer(command_buffer&& move) noexcept = default; // move constructor
+		command_buffer& operator=(const command_buffer& copy) = delete; // copy assignment
+		command_buffer& operator=(command_buffer&&) = default; // move assigment
+
+		void reset();
+
+		void useProgram(GLuint program);
+		void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+		void bindTexture(GLuint unit, GLuint texture);
+		void bindSampler(GLuint unit, GLuint sampler);
+		void applyState(const pipeline_state& state);
+		void drawNode(const mesh_node& node);
+		void drawArrays(GLenum mode, int vertexFormat, GLuint buffer, GLintptr offset, GLsizei stride, GLint first, GLsizei count);
+
+		/*
+			Replay the commands on the GL thread (through the state cache, so the redundant calls are elided)
+		*/
+		void execute() const;
+
+		size_t getSize() const { return m_data.size(); }
+		size_t getCommandCount() const { return m_count; }
+		bool empty() const { return m_count == 0; }
+
+	private:
+		template <typename T>
+		void push(COMMAND_TYPE type, const T& command) {
+			static_assert(std::is_trivially_copyable<T>::value, "the commands must be POD");
+
+			const size_t headerSize = (sizeof(command_header) + 7) & ~size_t(7);
+			const size_t size = (headerSize + sizeof(T) + 7) & ~size_t(7);
+			size_t offset = m_data.size();
+			m_data.resize(offset + size);
+
+			command_header header = { type, static_cast<uint16_t>(size) };
+			std::memcpy(&m_data[offset], &header, sizeof(header));
+			std::memcpy(&m_data[offset + headerSize], &command, sizeof(T));
+			m_count++;
+		}
+
+		std::vector<unsigned char> m_data;
+		size_t m_count = 0;
+	};
+
+	/*
+		Replay the buffers in order (e.g. the buffers recorded by the workers of a parallelFor)
+	*/
+	void executeCommandBuffers(const command_buffer* buffers, size_t count);
+
+	/*
+		Render queue submitter that records the sorted packets into a command buffer (see render_queue::submit)
+	*/
+	struct command_buffer_submitter
+	{
+		command_buffer* buffer = nullptr;
+		std::function<void(command_buffer&, uint32_t)> recordMaterial;
+		std::function<void(command_buffer&, const render_packet&)> beforeDraw; // e.g. the per-object uniform block
+
+		void setProgram(GLuint program) { buffer->useProgram(program); }
+
+		void setMaterial(uint32_t material) {
+			if (recordMaterial)
+				recordMaterial(*buffer, material);
+		}
+
+		void draw(const render_packet& packet) {
+			if (beforeDraw)
+				beforeDraw(*buffer, packet);
+
+			if (packet.node)
+				buffer->drawNode(*packet.node);
+		}
+	};
+}
+
+#endif
@@ -32,6 +32,8 @@
 
 namespace kengine
 {
+	class render_thread;
+
 	/*
 		k-engine runtime states
 	*/
@@ -63,11 +65,18 @@ namespace kengine
 		void resumeMainLoop();
 
 		void setEventsCallback(events_callback* eventsCallback);
+
+		/*
+			Optional pipelined mode: the frame packet is opened before update and published after it, so the
+			render thread draws the frame N while update simulates the frame N + 1 (nullptr disables it)
+		*/
+		void setRenderThread(render_thread* renderThread);
 		// void setFrameRate(unsigned int framesPerSecond);
 
 	private:
 		K_RUNTIME_STATE mainLoopState = K_RUNTIME_STATE::STOPPED;
 		events_callback* userEventsCallback = nullptr;
+		render_thread* m_renderThread = nullptr;
 	};
 
 	/*
@@ -0,0 +1,193 @@
+/*
+	K-Engine Dynamic Resolution
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_DYNAMIC_RESOLUTION_HPP
+#define K_ENGINE_DYNAMIC_RESOLUTION_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace kengine
+{
+	struct dynamic_resolution_settings
+	{
+		float minScale = 0.5f; // bounds of the scale of each axis
+		float maxScale = 1.0f;
+		double targetMilliseconds = 16.6; // frame budget
+		double upperThreshold = 0.95; // the scale goes down above this fraction of the budget
+		double lowerThreshold = 0.75; // and up below this fraction (hysteresis band between them)
+		unsigned int downFrames = 3; // consecutive frames over the band before a decrease
+		unsigned int upFrames = 30; // consecutive frames under the band before an increase
+		unsigned int cooldownFrames = 8; // frames ignored after a change (the GPU times are measured a few frames late)
+		float maxStepUp = 0.05f; // the scale goes up gently, so it doesn't overshoot
+		float minStep = 0.01f; // smaller changes are not worth a new resolution
+		double smoothing = 0.2; // weight of the new frame time in the moving average
+	};
+
+	/*
+		Scaling decision (the result is the first frame time measured after the cooldown, negative until then)
+	*/
+	struct resolution_change
+	{
+		uint64_t frame = 0;
+		float fromScale = 1.0f;
+		float toScale = 1.0f;
+		double cpuMilliseconds = 0.0;
+		double gpuMilliseconds = 0.0; // moving average that triggered the change
+		double resultMilliseconds = -1.0;
+	};
+
+	struct resolution_controller_stats
+	{
+		uint64_t frames = 0;
+		unsigned int increases = 0;
+		unsigned int decreases = 0;
+		unsigned int cpuBoundFrames = 0; // over the budget because of the CPU (the scale is not decreased)
+	};
+
+	/*
+		kengine::resolution_controller chooses the render scale from the measured frame times (no GL calls).
+
+		The GPU time drives the decision, because the resolution only changes the GPU cost: the scale goes down
+		when the moving average stays over the band and up when it stays under it, towards the middle of the
+		band (the GPU time is assumed proportional to the number of pixels). A frame that is over the budget only
+		because of the CPU doesn't lower the resolution. Without a GPU time (negative), the CPU frame time is used.
+	*/
+	class resolution_controller
+	{
+	public:
+		explicit resolution_controller(const dynamic_resolution_settings& settings = dynamic_resolution_settings());
+
+		void setSettings(const dynamic_resolution_settings& settings);
+		const dynamic_resolution_settings& getSettings() const { return m_settings; }
+
+		/*
+			Called once per frame. It returns true if the scale changed.
+		*/
+		bool update(double cpuMilliseconds, double gpuMilliseconds);
+
+		float getScale() const { return m_scale; }
+		void setScale(float scale);
+
+		const std::vector<resolution_change>& getChanges() const { return m_changes; }
+		const resolution_controller_stats& getStats() const { return m_stats; }
+
+	private:
+		bool change(float scale, double cpuMilliseconds);
+
+		dynamic_resolution_settings m_settings;
+		float m_scale = 1.0f;
+		double m_average = -1.0; // negative: no sample since the last change
+		unsigned int m_overFrames = 0;
+		unsigned int m_underFrames = 0;
+		unsigned int m_cooldown = 0;
+
+		std::vector<resolution_change> m_changes;
+		resolution_controller_stats m_stats;
+	};
+
+	/*
+		kengine::dynamic_resolution renders the scene into an offscreen target whose resolution follows a
+		kengine::resolution_controller, then upscales it into the output framebuffer (the window backbuffer by
+		default) with a blit.
+
+		The target is allocated once for the maximum scale and the scene is rendered into its bottom left
+		corner, so a new scale only changes the viewport (a new maximum scale needs a new resize). The pass between begin and end is a scope of the GPU
+		profiler and its time is the GPU feedback of the controller (the CPU frame time is used if the profiler
+		is not initialized).
+
+		Usage per frame (with a current rendering context):
+
+			renderingSystem.newFrame();
+			resolution.update(cpuMilliseconds);
+			resolution.begin();
+			... scene ...
+			resolution.end();
+			... GUI at the output resolution ...
+	*/
+	class dynamic_resolution
+	{
+	public:
+		explicit dynamic_resolution(const dynamic_resolution_settings& settings = dynamic_resolution_settings());
+		~dynamic_resolution();
+
+		dynamic_resolution(const dynamic_resolution& copy) = delete; // copy constructor
+		dynamic_resolution(dynamic_resolution&& move) noexcept = delete; // move constructor
+		dynamic_resolution& operator=(const dynamic_resolution& copy) = delete; // copy assignment
+		dynamic_resolution& operator=(dynamic_resolution&&) = delete; // move assigment
+
+		/*
+			Size of the output (e.g. the window), called again when the window is resized
+		*/
+		bool resize(int outputWidth, int outputHeight, GLenum colorFormat = GL_RGBA8);
+
+		/*
+			It reads the GPU time of the last frame read back by the GPU profiler (call it after rendering_system::newFrame)
+		*/
+		bool update(double cpuMilliseconds);
+
+		void begin();
+		void end(GLuint outputFramebuffer = 0, GLenum filter = GL_LINEAR);
+
+		int getRenderWidth() const;
+		int getRenderHeight() const;
+		int getOutputWidth() const { return m_outputWidth; }
+		int getOutputHeight() const { return m_outputHeight; }
+
+		GLuint getFramebuffer() const { return m_framebuffer; }
+		GLuint getColorTexture() const { return m_colorTexture; }
+		GLuint getDepthTexture() const { return m_depthTexture; }
+
+		resolution_controller& getController() { return m_controller; }
+		const resolution_controller& getController() const { return m_controller; }
+
+		/*
+			Name of the GPU profiler scope of the scaled pass
+		*/
+		static const char* const SCOPE_NAME;
+
+	private:
+		void destroyTarget();
+
+		resolution_controller m_controller;
+		uint64_t m_lastGPUFrame = 0;
+
+		int m_outputWidth = 0;
+		int m_outputHeight = 0;
+		int m_renderWidth = 0; // of the current frame (between begin and end)
+		int m_renderHeight = 0;
+		int m_targetWidth = 0; // the maximum scale and a border of one texel
+		int m_targetHeight = 0;
+
+		GLuint m_framebuffer = 0;
+		GLuint m_colorTexture = 0;
+		GLuint m_depthTexture = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,338 @@
+/*
+	K-Engine GL Capture
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_GL_CAPTURE_HPP
+#define K_ENGINE_GL_CAPTURE_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		Calls stored in the trace (the values are a part of the file format, new calls are appended)
+	*/
+	enum class GL_CALL : uint16_t
+	{
+		FRAME = 0, // frame marker (see gl_capture::newFrame)
+		MAPPED_DATA, // content of a persistently mapped range written by the CPU
+
+		CREATE_BUFFERS,
+		GEN_BUFFERS,
+		DELETE_BUFFERS,
+		BIND_BUFFER,
+		NAMED_BUFFER_STORAGE,
+		BUFFER_STORAGE,
+		NAMED_BUFFER_SUB_DATA,
+		MAP_NAMED_BUFFER_RANGE,
+		UNMAP_NAMED_BUFFER,
+		BIND_BUFFER_BASE,
+		BIND_BUFFER_RANGE,
+
+		CREATE_VERTEX_ARRAYS,
+		DELETE_VERTEX_ARRAYS,
+		BIND_VERTEX_ARRAY,
+		ENABLE_VERTEX_ARRAY_ATTRIB,
+		VERTEX_ARRAY_ATTRIB_FORMAT,
+		VERTEX_ARRAY_ATTRIB_BINDING,
+		VERTEX_ARRAY_VERTEX_BUFFER,
+		BIND_VERTEX_BUFFER,
+		ENABLE_VERTEX_ATTRIB_ARRAY,
+		VERTEX_ATTRIB_POINTER,
+
+		CREATE_SHADER,
+		SHADER_SOURCE,
+		COMPILE_SHADER,
+		SHADER_BINARY,
+		SPECIALIZE_SHADER,
+		DELETE_SHADER,
+		CREATE_PROGRAM,
+		ATTACH_SHADER,
+		DETACH_SHADER,
+		PROGRAM_PARAMETERI,
+		LINK_PROGRAM,
+		PROGRAM_BINARY,
+		DELETE_PROGRAM,
+		USE_PROGRAM,
+		CREATE_SHADER_PROGRAMV,
+		CREATE_PROGRAM_PIPELINES,
+		DELETE_PROGRAM_PIPELINES,
+		USE_PROGRAM_STAGES,
+		BIND_PROGRAM_PIPELINE,
+		UNIFORM_MATRIX_4FV,
+
+		BIND_TEXTURE_UNIT,
+		BIND_SAMPLER,
+		BLEND_FUNC_SEPARATE,
+		BLEND_EQUATION_SEPARATE,
+
+		CREATE_FRAMEBUFFERS,
+		DELETE_FRAMEBUFFERS,
+		BIND_FRAMEBUFFER,
+		CREATE_RENDERBUFFERS,
+		DELETE_RENDERBUFFERS,
+		NAMED_RENDERBUFFER_STORAGE,
+		NAMED_FRAMEBUFFER_RENDERBUFFER,
+
+		FENCE_SYNC,
+		CLIENT_WAIT_SYNC,
+		DELETE_SYNC,
+
+		CLEAR,
+		CLEAR_COLOR,
+		DRAW_ARRAYS,
+		ENABLE,
+		DISABLE,
+		VIEWPORT,
+		POLYGON_MODE,
+		DEPTH_FUNC,
+		DEPTH_MASK,
+		CULL_FACE,
+		FRONT_FACE,
+		LINE_WIDTH,
+		POINT_SIZE,
+
+		NAMED_BUFFER_DATA,
+		BUFFER_DATA,
+		BUFFER_SUB_DATA,
+		CLEAR_NAMED_BUFFER_DATA,
+		CLEAR_BUFFER_DATA,
+		COPY_NAMED_BUFFER_SUB_DATA,
+		COPY_BUFFER_SUB_DATA,
+		MAP_NAMED_BUFFER,
+		MAP_BUFFER,
+		MAP_BUFFER_RANGE,
+		UNMAP_BUFFER,
+		FLUSH_MAPPED_NAMED_BUFFER_RANGE,
+		FLUSH_MAPPED_BUFFER_RANGE,
+		INVALIDATE_BUFFER_DATA,
+		INVALIDATE_BUFFER_SUB_DATA,
+		CLEAR_BUFFERFV,
+
+		GEN_VERTEX_ARRAYS,
+		DISABLE_VERTEX_ARRAY_ATTRIB,
+		DISABLE_VERTEX_ATTRIB_ARRAY,
+		VERTEX_ATTRIB_I_POINTER,
+		VERTEX_ATTRIB_L_POINTER,
+		VERTEX_ARRAY_VERTEX_BUFFERS,
+		VERTEX_ATTRIB_FORMAT,
+		VERTEX_ATTRIB_BINDING,
+		BIND_ATTRIB_LOCATION,
+		DRAW_ARRAYS_INSTANCED_BASE_INSTANCE,
+		PRIMITIVE_RESTART_INDEX,
+
+		PROGRAM_UNIFORM_3F,
+		ACTIVE_SHADER_PROGRAM,
+		UNIFORM_1FV,
+		UNIFORM_2FV,
+		UNIFORM_3FV,
+		UNIFORM_4FV,
+		UNIFORM_1IV,
+		UNIFORM_2IV,
+		UNIFORM_3IV,
+		UNIFORM_4IV,
+		UNIFORM_1UIV,
+		UNIFORM_2UIV,
+		UNIFORM_3UIV,
+		UNIFORM_4UIV,
+		UNIFORM_1DV,
+		UNIFORM_2DV,
+		UNIFORM_3DV,
+		UNIFORM_4DV,
+		UNIFORM_MATRIX_2FV,
+		UNIFORM_MATRIX_3FV,
+		UNIFORM_MATRIX_2X3FV,
+		UNIFORM_MATRIX_3X2FV,
+		UNIFORM_MATRIX_2X4FV,
+		UNIFORM_MATRIX_4X2FV,
+		UNIFORM_MATRIX_3X4FV,
+		UNIFORM_MATRIX_4X3FV,
+		UNIFORM_MATRIX_2DV,
+		UNIFORM_MATRIX_3DV,
+		UNIFORM_MATRIX_4DV,
+		UNIFORM_MATRIX_2X3DV,
+		UNIFORM_MATRIX_3X2DV,
+		UNIFORM_MATRIX_2X4DV,
+		UNIFORM_MATRIX_4X2DV,
+		UNIFORM_MATRIX_3X4DV,
+		UNIFORM_MATRIX_4X3DV,
+
+		CREATE_TEXTURES,
+		TEXTURE_STORAGE_2D,
+		TEXTURE_PARAMETERI,
+		BIND_IMAGE_TEXTURE,
+		NAMED_FRAMEBUFFER_TEXTURE,
+		BLIT_NAMED_FRAMEBUFFER,
+		NAMED_FRAMEBUFFER_DRAW_BUFFERS,
+		VERTEX_ARRAY_ATTRIB_I_FORMAT,
+		VERTEX_ARRAY_BINDING_DIVISOR,
+		DISPATCH_COMPUTE,
+		MEMORY_BARRIER,
+		DRAW_ARRAYS_INDIRECT,
+		MULTI_DRAW_ARRAYS_INDIRECT,
+		TEXTURE_STORAGE_3D,
+		TEXTURE_SUB_IMAGE_3D,
+		GENERATE_TEXTURE_MIPMAP,
+		DELETE_TEXTURES,
+
+		TEXTURE_SUB_IMAGE_2D,
+		COPY_IMAGE_SUB_DATA,
+		CREATE_SAMPLERS,
+		DELETE_SAMPLERS,
+		SAMPLER_PARAMETERI,
+		SAMPLER_PARAMETERF,
+		PIXEL_STOREI,
+
+		COUNT
+	};
+
+	const char* getGLCallName(GL_CALL call);
+
+	/*
+		Header of the trace file (a sequence of records follows it)
+	*/
+	struct gl_trace_header
+	{
+		char magic[4] = { 'K', 'G', 'L', 'T' };
+		uint32_t version = 1;
+	};
+
+	/*
+		Header of a record: the arguments and the payloads (buffer data, shader sources, etc) follow it
+	*/
+	struct gl_trace_record
+	{
+		uint16_t call = 0;
+		uint16_t reserved = 0;
+		uint32_t size = 0; // size of the arguments in bytes
+	};
+
+	struct gl_capture_stats
+	{
+		uint64_t calls = 0;
+		uint64_t bytes = 0;
+		unsigned int frames = 0;
+	};
+
+	/*
+		kengine::gl_capture records the GL calls issued by the engine into a compact binary trace, so a slow
+		scene can be replayed (and timed) without the application and its assets (see kengine::gl_replay).
+
+		The capture replaces the loaded function pointers (and the OpenGL 1.x pointers of gl_wrapper.hpp) by
+		recording functions that call the driver and then write the call, its arguments and its payloads.
+		The content of the persistently mapped ranges is recorded when the range is bound.
+
+		The objects created before the capture are not in the trace, so the capture should start before the
+		resources are loaded: the environment variables KENGINE_GL_CAPTURE (trace filename) and
+		KENGINE_GL_CAPTURE_FRAMES (default 60) start it as soon as the GL functions are loaded.
+
+		Notes:
+			- the calls of the GUI (it has its own GL loader) are not recorded
+			- the calls that only read the state or the objects are not recorded: glGet* (e.g. glGetProgramiv,
+			  glGetUniformLocation, glGetProgramBinary, glGetNamedBufferSubData), glIsBuffer, glIsVertexArray,
+			  glValidateProgramPipeline, glCheckNamedFramebufferStatus, glGetError, glReadPixels, glFlush and glFinish
+			- the timer queries (glGenQueries, glDeleteQueries, glBeginQuery, glEndQuery, glQueryCounter) are not
+			  recorded, their results are only read by the application (see kengine::gpu_profiler)
+			- the debug output (glDebugMessageCallback, glDebugMessageControl, glPushDebugGroup, glPopDebugGroup) and
+			  glMaxShaderCompilerThreadsKHR (a hint of the compiler) are not recorded
+			- the content written in a mapped range is recorded when the range is flushed (glFlushMapped*BufferRange
+			  or the unmap), except the persistent ranges (see above)
+			- the program binaries (see kengine::program_cache) are only valid on the driver of the capture
+			- the uniform locations are assumed to be the same on the replay
+	*/
+	class gl_capture
+	{
+	public:
+		gl_capture() {}
+		~gl_capture();
+
+		gl_capture(const gl_capture& copy) = delete; // copy constructor
+		gl_capture(gl_capture&& move) noexcept = delete; // move constructor
+		gl_capture& operator=(const gl_capture& copy) = delete; // copy assignment
+		gl_capture& operator=(gl_capture&&) = delete; // move assigment
+
+		/*
+			The capture stops by itself after "frameCount" frames (0 means until stop is called)
+		*/
+		bool start(const std::string& filename, unsigned int frameCount = 0);
+		void stop();
+		bool isCapturing() const { return m_file != nullptr; }
+
+		/*
+			Called by kengine::getAllGLProcedures: it installs the recording functions (again)
+		*/
+		void attach();
+
+		/*
+			Frame marker (called by rendering_system::newFrame)
+		*/
+		void newFrame();
+
+		gl_capture_stats getStats() const;
+
+		/*
+			Used by the recording functions
+		*/
+		void write(GL_CALL call, const std::vector<unsigned char>& arguments);
+		void mapRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access, void* data);
+		void unmapRange(GLuint buffer);
+		void writeMappedRange(GLuint buffer, GLintptr offset, GLsizeiptr size);
+		void flushMappedRange(GLuint buffer, GLintptr offset, GLsizeiptr length);
+
+	private:
+		void install();
+		void uninstall();
+
+		struct mapped_range
+		{
+			GLintptr offset = 0;
+			GLsizeiptr length = 0;
+			GLbitfield access = 0;
+			unsigned char* data = nullptr;
+		};
+
+		mutable std::mutex m_mutex; // the upload worker issues GL calls on its own thread
+		FILE* m_file = nullptr;
+		bool m_installed = false;
+		bool m_environmentChecked = false;
+		unsigned int m_frameCount = 0;
+		std::unordered_map<GLuint, mapped_range> m_mappedRanges;
+		gl_capture_stats m_stats;
+	};
+
+	/*
+		Global GL capture
+	*/
+	gl_capture& glCapture();
+}
+
+#endif
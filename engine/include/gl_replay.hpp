@@ -0,0 +1,127 @@
+/*
+	K-Engine GL Replay
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_GL_REPLAY_HPP
+#define K_ENGINE_GL_REPLAY_HPP
+
+#include <gl_capture.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace kengine
+{
+	struct gl_replay_call_stats
+	{
+		uint64_t calls = 0;
+		double milliseconds = 0.0; // CPU time of the calls (driver overhead)
+	};
+
+	struct gl_replay_frame_stats
+	{
+		uint64_t calls = 0;
+		double submitMilliseconds = 0.0; // CPU time to issue the calls
+		double milliseconds = 0.0; // until glFinish returns
+	};
+
+	/*
+		kengine::gl_replay executes a trace recorded by kengine::gl_capture on the current context.
+
+		The object names of the trace are mapped to the names created by the replay. The names that are not
+		created by the trace are mapped to 0, except the framebuffers that are mapped to the default framebuffer
+		of the replay (e.g. the framebuffer of a kengine::headless_rendering_context).
+
+		The calls before the first frame marker (the loading) are executed by replaySetup and each frame is
+		timed by replayFrame. The frames can be replayed again if they don't create objects.
+	*/
+	class gl_replay
+	{
+	public:
+		gl_replay() {}
+		~gl_replay() {}
+
+		gl_replay(const gl_replay& copy) = delete; // copy constructor
+		gl_replay(gl_replay&& move) noexcept = delete; // move constructor
+		gl_replay& operator=(const gl_replay& copy) = delete; // copy assignment
+		gl_replay& operator=(gl_replay&&) = delete; // move assigment
+
+		bool load(const std::string& filename);
+
+		void setDefaultFramebuffer(GLuint framebuffer) { m_defaultFramebuffer = framebuffer; }
+
+		bool replaySetup();
+		bool replayFrame(size_t frame, gl_replay_frame_stats* stats = nullptr);
+
+		size_t getFrameCount() const { return m_frames.size(); }
+
+		/*
+			Accumulated by every replayed call (indexed by kengine::GL_CALL)
+		*/
+		const std::vector<gl_replay_call_stats>& getCallStats() const { return m_callStats; }
+
+	private:
+		enum NAMESPACE
+		{
+			BUFFER = 0,
+			VERTEX_ARRAY,
+			PROGRAM, // the shaders and the programs share the names
+			PIPELINE,
+			FRAMEBUFFER,
+			RENDERBUFFER,
+			TEXTURE,
+			SAMPLER,
+			NAMESPACE_COUNT
+		};
+
+		struct mapped_range
+		{
+			unsigned char* data = nullptr;
+			int64_t offset = 0;
+		};
+
+		bool execute(size_t begin, size_t end, uint64_t* calls);
+		bool executeCall(GL_CALL call, const unsigned char* arguments, size_t size);
+
+		GLuint getName(NAMESPACE space, GLuint name) const;
+		void createNames(NAMESPACE space, GLsizei count, const GLuint* traceNames, const GLuint* names);
+		void deleteNames(NAMESPACE space, GLsizei count, const GLuint* traceNames, std::vector<GLuint>& names);
+
+		std::vector<unsigned char> m_trace;
+		size_t m_setupEnd = 0; // offset of the first frame marker
+		std::vector<size_t> m_frames; // offsets of the frame markers
+
+		std::unordered_map<GLuint, GLuint> m_names[NAMESPACE_COUNT];
+		std::unordered_map<uint64_t, GLsync> m_syncs;
+		std::unordered_map<GLuint, mapped_range> m_mappedRanges; // by trace name
+		GLuint m_defaultFramebuffer = 0;
+
+		std::vector<gl_replay_call_stats> m_callStats;
+	};
+}
+
+#endif
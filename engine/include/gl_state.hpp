@@ -0,0 +1,235 @@
+/*
+	K-Engine GL State
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_GL_STATE_HPP
+#define K_ENGINE_GL_STATE_HPP
+
+#include <gl_wrapper.hpp>
+#include <gpu_memory.hpp>
+
+#include <cstdint>
+#include <thread>
+
+namespace kengine
+{
+	/*
+		Fixed function state of a draw (the default values are the OpenGL defaults)
+	*/
+	struct pipeline_state_desc
+	{
+		bool blend = false;
+		GLenum blendSrcRGB = GL_ONE;
+		GLenum blendDstRGB = GL_ZERO;
+		GLenum blendSrcAlpha = GL_ONE;
+		GLenum blendDstAlpha = GL_ZERO;
+		GLenum blendEquationRGB = GL_FUNC_ADD;
+		GLenum blendEquationAlpha = GL_FUNC_ADD;
+
+		bool depthTest = false;
+		bool depthWrite = true;
+		GLenum depthFunc = GL_LESS;
+
+		bool cull = false;
+		GLenum cullFace = GL_BACK;
+		GLenum frontFace = GL_CCW;
+
+		GLenum polygonMode = GL_FILL;
+	};
+
+	/*
+		kengine::pipeline_state is an immutable block of fixed function state (created once, e.g. at loading time)
+		that is applied by gl_state_cache::apply. Only the differences from the current state are sent to the driver.
+	*/
+	class pipeline_state
+	{
+	public:
+		pipeline_state() : m_hash{ computeHash(m_desc) } {}
+		explicit pipeline_state(const pipeline_state_desc& desc) : m_desc{ desc }, m_hash{ computeHash(desc) } {}
+
+		const pipeline_state_desc& getDesc() const { return m_desc; }
+		uint64_t getHash() const { return m_hash; }
+
+	private:
+		static uint64_t computeHash(const pipeline_state_desc& desc);
+
+		pipeline_state_desc m_desc;
+		uint64_t m_hash;
+	};
+
+	/*
+		Counters of the state cache (see gl_state_cache::newFrame)
+	*/
+	struct gl_state_stats
+	{
+		unsigned int issued = 0; // calls sent to the driver
+		unsigned int elided = 0; // redundant calls that were skipped
+	};
+
+	/*
+		kengine::gl_state_cache is a shadow copy of the bound objects and of the fixed function state of the main
+		rendering context. A call is only sent to the driver if it changes the state.
+
+		The state is per context: the other contexts (e.g. the upload worker) must call OpenGL directly. If a third
+		party code (e.g. the GUI) changes the state, invalidate() must be called after it.
+		The methods return true if the call was issued.
+	*/
+	class gl_state_cache
+	{
+	public:
+		static constexpr GLuint MAX_TEXTURE_UNITS = 32;
+		static constexpr GLuint MAX_BUFFER_BINDINGS = 16;
+
+		gl_state_cache() { invalidate(); }
+		~gl_state_cache() {}
+
+		gl_state_cache(const gl_state_cache& copy) = delete; // copy constructor
+		gl_state_cache(gl_state_cache&& move) noexcept = delete; // move constructor
+		gl_state_cache& operator=(const gl_state_cache& copy) = delete; // copy assignment
+		gl_state_cache& operator=(gl_state_cache&&) = delete; // move assigment
+
+		bool useProgram(GLuint program);
+
+		/*
+			A program in use overrides the bound pipeline: the pipeline is only used after useProgram(0)
+		*/
+		bool bindProgramPipeline(GLuint pipeline);
+
+		bool bindVertexArray(GLuint vao);
+		bool bindBuffer(GLenum target, GLuint buffer);
+
+		/*
+			Indexed binding points of GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER and GL_ATOMIC_COUNTER_BUFFER
+		*/
+		bool bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+		bool bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+		bool bindTexture(GLuint unit, GLuint texture);
+		bool bindSampler(GLuint unit, GLuint sampler);
+
+		/*
+			Apply the differences between the current state and the state block
+		*/
+		void apply(const pipeline_state& state);
+
+		bool setPolygonMode(GLenum mode);
+
+		/*
+			Forget the shadow state (the next calls are always issued). The calling thread becomes the thread of
+			the cache (rendering_system::init calls it on the thread of the main context).
+		*/
+		void invalidate();
+
+		bool isOwnerThread() const { return std::this_thread::get_id() == m_thread; }
+
+		/*
+			Must be called when an object is deleted because its name can be reused by a new object. The calls
+			from the other threads (e.g. an object deleted by the upload worker) are ignored: the objects of the
+			other contexts are never bound through the cache.
+		*/
+		void releaseBuffer(GLuint buffer);
+		void releaseTexture(GLuint texture);
+		void releaseSampler(GLuint sampler);
+		void releaseVertexArray(GLuint vao);
+		void releaseProgram(GLuint program);
+		void releaseProgramPipeline(GLuint pipeline);
+
+		/*
+			Store the counters of the last frame and reset the counters of the current frame
+		*/
+		void newFrame();
+
+		const gl_state_stats& getFrameStats() const { return m_lastFrameStats; }
+
+	private:
+		enum PIPELINE_FIELD
+		{
+			BLEND = 1 << 0,
+			BLEND_FUNC = 1 << 1,
+			BLEND_EQUATION = 1 << 2,
+			DEPTH_TEST = 1 << 3,
+			DEPTH_WRITE = 1 << 4,
+			DEPTH_FUNC = 1 << 5,
+			CULL = 1 << 6,
+			CULL_FACE = 1 << 7,
+			FRONT_FACE = 1 << 8,
+			POLYGON_MODE = 1 << 9
+		};
+
+		struct buffer_range
+		{
+			GLuint buffer;
+			GLintptr offset;
+			GLsizeiptr size;
+		};
+
+		bool changed(bool different) {
+			if (different)
+				m_frameStats.issued++;
+			else
+				m_frameStats.elided++;
+
+			return different;
+		}
+
+		bool changed(unsigned int field, bool different) {
+			return changed(!(m_validFields & field) || different);
+		}
+
+		static constexpr int BUFFER_TARGET_COUNT = 11;
+
+		static int getBufferTargetIndex(GLenum target);
+		static int getIndexedTargetIndex(GLenum target);
+
+		GLuint m_program;
+		GLuint m_programPipeline;
+		GLuint m_vao;
+		GLuint m_buffers[BUFFER_TARGET_COUNT];
+		buffer_range m_indexedBuffers[3][MAX_BUFFER_BINDINGS];
+		GLuint m_textures[MAX_TEXTURE_UNITS];
+		GLuint m_samplers[MAX_TEXTURE_UNITS];
+
+		pipeline_state_desc m_pipeline;
+		unsigned int m_validFields = 0; // PIPELINE_FIELD bits of the known fixed function state
+		std::thread::id m_thread;
+
+		gl_state_stats m_frameStats;
+		gl_state_stats m_lastFrameStats;
+	};
+
+	/*
+		Global state cache of the main rendering context
+	*/
+	gl_state_cache& glState();
+
+	/*
+		Release the object from the GPU memory tracker and from the state cache, delete it and reset its name to 0
+		(nothing is done for the name 0)
+	*/
+	void deleteTrackedBuffer(GLuint& buffer);
+	void deleteTrackedTexture(GLuint& texture, GPU_MEMORY_CATEGORY category);
+}
+
+#endif
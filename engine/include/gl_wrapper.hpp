@@ -28,6 +28,7 @@
 
 #include <k_math.hpp>
 #include <mesh.hpp>
+#include <k_hash.hpp>
 
 // #if defined() allows to use #elif
 #if defined(_WIN32)
@@ -45,8 +46,12 @@
 #include <GL/glxext.h>
 #endif
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 /*
 	References:
@@ -68,6 +73,7 @@ extern PFNGLCOPYNAMEDBUFFERSUBDATAPROC glCopyNamedBufferSubData; // OpenGL 4.5
 extern PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData; // OpenGL 3.1
 extern PFNGLGETNAMEDBUFFERSUBDATAPROC glGetNamedBufferSubData; // OpenGL 4.5
 extern PFNGLGETBUFFERSUBDATAPROC glGetBufferSubData; // OpenGL 2.0
+extern PFNGLGETNAMEDBUFFERPARAMETERI64VPROC glGetNamedBufferParameteri64v; // OpenGL 4.5
 extern PFNGLMAPNAMEDBUFFERPROC glMapNamedBuffer; // OpenGL 4.5
 extern PFNGLMAPBUFFERPROC glMapBuffer; // OpenGL 2.0
 extern PFNGLUNMAPNAMEDBUFFERPROC glUnmapNamedBuffer; // OpenGL 4.5
@@ -95,12 +101,47 @@ extern PFNGLENABLEVERTEXARRAYATTRIBPROC glEnableVertexArrayAttrib; // OpenGL 4.5
 extern PFNGLDISABLEVERTEXARRAYATTRIBPROC glDisableVertexArrayAttrib; // OpenGL 4.5
 extern PFNGLVERTEXARRAYATTRIBFORMATPROC glVertexArrayAttribFormat; // OpenGL 4.5
 extern PFNGLVERTEXARRAYVERTEXBUFFERSPROC glVertexArrayVertexBuffers; // OpenGL 4.5
+extern PFNGLVERTEXARRAYVERTEXBUFFERPROC glVertexArrayVertexBuffer; // OpenGL 4.5
+extern PFNGLVERTEXARRAYATTRIBBINDINGPROC glVertexArrayAttribBinding; // OpenGL 4.5
 extern PFNGLBINDVERTEXBUFFERPROC glBindVertexBuffer; // OpenGL 4.3
-extern PFNGLVERTEXATTRIBFORMATPROC glVertexAtttribFormat; // OpenGL 4.3
+extern PFNGLVERTEXATTRIBFORMATPROC glVertexAttribFormat; // OpenGL 4.3
 extern PFNGLVERTEXATTRIBBINDINGPROC glVertexAttribBinding; // OpenGL 4.3
 extern PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation; // OpenGL 2.0
 extern PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC glDrawArraysInstancedBaseInstance; // OpenGL 4.2
 extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv; // OpenGL 2.0
+extern PFNGLUNIFORM1FVPROC glUniform1fv; // OpenGL 2.0
+extern PFNGLUNIFORM2FVPROC glUniform2fv; // OpenGL 2.0
+extern PFNGLUNIFORM3FVPROC glUniform3fv; // OpenGL 2.0
+extern PFNGLUNIFORM4FVPROC glUniform4fv; // OpenGL 2.0
+extern PFNGLUNIFORM1IVPROC glUniform1iv; // OpenGL 2.0
+extern PFNGLUNIFORM2IVPROC glUniform2iv; // OpenGL 2.0
+extern PFNGLUNIFORM3IVPROC glUniform3iv; // OpenGL 2.0
+extern PFNGLUNIFORM4IVPROC glUniform4iv; // OpenGL 2.0
+extern PFNGLUNIFORM1UIVPROC glUniform1uiv; // OpenGL 3.0
+extern PFNGLUNIFORM2UIVPROC glUniform2uiv; // OpenGL 3.0
+extern PFNGLUNIFORM3UIVPROC glUniform3uiv; // OpenGL 3.0
+extern PFNGLUNIFORM4UIVPROC glUniform4uiv; // OpenGL 3.0
+extern PFNGLUNIFORM1DVPROC glUniform1dv; // OpenGL 4.0
+extern PFNGLUNIFORM2DVPROC glUniform2dv; // OpenGL 4.0
+extern PFNGLUNIFORM3DVPROC glUniform3dv; // OpenGL 4.0
+extern PFNGLUNIFORM4DVPROC glUniform4dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX2FVPROC glUniformMatrix2fv; // OpenGL 2.0
+extern PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv; // OpenGL 2.0
+extern PFNGLUNIFORMMATRIX2X3FVPROC glUniformMatrix2x3fv; // OpenGL 2.1
+extern PFNGLUNIFORMMATRIX3X2FVPROC glUniformMatrix3x2fv; // OpenGL 2.1
+extern PFNGLUNIFORMMATRIX2X4FVPROC glUniformMatrix2x4fv; // OpenGL 2.1
+extern PFNGLUNIFORMMATRIX4X2FVPROC glUniformMatrix4x2fv; // OpenGL 2.1
+extern PFNGLUNIFORMMATRIX3X4FVPROC glUniformMatrix3x4fv; // OpenGL 2.1
+extern PFNGLUNIFORMMATRIX4X3FVPROC glUniformMatrix4x3fv; // OpenGL 2.1
+extern PFNGLUNIFORMMATRIX2DVPROC glUniformMatrix2dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX3DVPROC glUniformMatrix3dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX4DVPROC glUniformMatrix4dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX2X3DVPROC glUniformMatrix2x3dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX3X2DVPROC glUniformMatrix3x2dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX2X4DVPROC glUniformMatrix2x4dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX4X2DVPROC glUniformMatrix4x2dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX3X4DVPROC glUniformMatrix3x4dv; // OpenGL 4.0
+extern PFNGLUNIFORMMATRIX4X3DVPROC glUniformMatrix4x3dv; // OpenGL 4.0
 extern PFNGLGETSTRINGIPROC glGetStringi; // OpenGL 3.0
 extern PFNGLCREATESHADERPROC glCreateShader; // OpenGL 2.0
 extern PFNGLDELETESHADERPROC glDeleteShader; // OpenGL 2.0
@@ -123,6 +164,7 @@ extern PFNGLSPECIALIZESHADERPROC glSpecializeShader; // OpenGL 4.1
 extern PFNGLGETPROGRAMINTERFACEIVPROC glGetProgramInterfaceiv; //OpenGL 4.3
 extern PFNGLGETPROGRAMRESOURCEIVPROC glGetProgramResourceiv; // OpenGL 4.3
 extern PFNGLGETPROGRAMRESOURCENAMEPROC glGetProgramResourceName; // OpenGL 4.3
+extern PFNGLGETPROGRAMRESOURCEINDEXPROC glGetProgramResourceIndex; // OpenGL 4.3
 extern PFNGLGETACTIVEATTRIBPROC glGetActiveAttrib; // OpenGL 2.0
 extern PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation; // OpenGL 2.0
 extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation; // OpenGL 2.0
@@ -133,11 +175,19 @@ extern PFNGLGETACTIVEUNIFORMBLOCKIVPROC glGetActiveUniformBlockiv; // OpenGL 3.1
 extern PFNGLGETUNIFORMINDICESPROC glGetUniformIndices; // OpenGL 3.1
 extern PFNGLGETACTIVEUNIFORMSIVPROC glGetActiveUniformsiv; // OpenGL 3.1
 extern PFNGLBINDBUFFERBASEPROC glBindBufferBase; // OpenGL 3.0
+extern PFNGLBINDBUFFERRANGEPROC glBindBufferRange; // OpenGL 3.0
+extern PFNGLBINDTEXTUREUNITPROC glBindTextureUnit; // OpenGL 4.5
+extern PFNGLBINDSAMPLERPROC glBindSampler; // OpenGL 3.3
+extern PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate; // OpenGL 1.4
+extern PFNGLBLENDEQUATIONSEPARATEPROC glBlendEquationSeparate; // OpenGL 2.0
 extern PFNGLCREATESHADERPROGRAMVPROC glCreateShaderProgramv; // OpenGL 4.1
 extern PFNGLCREATEPROGRAMPIPELINESPROC glCreateProgramPipelines; // OpenGL 4.5
 extern PFNGLDELETEPROGRAMPIPELINESPROC glDeleteProgramPipelines; // OpenGL 4.5
 extern PFNGLUSEPROGRAMSTAGESPROC glUseProgramStages; // OpenGL 4.1
 extern PFNGLBINDPROGRAMPIPELINEPROC glBindProgramPipeline; // OpenGL 4.1
+extern PFNGLVALIDATEPROGRAMPIPELINEPROC glValidateProgramPipeline; // OpenGL 4.1
+extern PFNGLGETPROGRAMPIPELINEIVPROC glGetProgramPipelineiv; // OpenGL 4.1
+extern PFNGLGETPROGRAMPIPELINEINFOLOGPROC glGetProgramPipelineInfoLog; // OpenGL 4.1
 extern PFNGLPROGRAMUNIFORM3FPROC glProgramUniform3f; // OpenGL 4.1
 extern PFNGLACTIVESHADERPROGRAMPROC glActiveShaderProgram; // OpenGL 4.1
 extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri;
@@ -145,8 +195,90 @@ extern PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback; // OpenGL 4.3
 extern PFNGLDEBUGMESSAGECONTROLPROC glDebugMessageControl; // OpenGL 4.3
 extern PFNGLPUSHDEBUGGROUPPROC glPushDebugGroup; // OpenGL 4.3
 extern PFNGLPOPDEBUGGROUPPROC glPopDebugGroup; // OpenGL 4.3
+extern PFNGLGENQUERIESPROC glGenQueries; // OpenGL 1.5
+extern PFNGLDELETEQUERIESPROC glDeleteQueries; // OpenGL 1.5
+extern PFNGLBEGINQUERYPROC glBeginQuery; // OpenGL 1.5
+extern PFNGLENDQUERYPROC glEndQuery; // OpenGL 1.5
+extern PFNGLGETQUERYOBJECTUIVPROC glGetQueryObjectuiv; // OpenGL 1.5
+extern PFNGLQUERYCOUNTERPROC glQueryCounter; // OpenGL 3.3
+extern PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v; // OpenGL 3.3
+extern PFNGLCREATEFRAMEBUFFERSPROC glCreateFramebuffers; // OpenGL 4.5
+extern PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers; // OpenGL 3.0
+extern PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer; // OpenGL 3.0
+extern PFNGLCREATERENDERBUFFERSPROC glCreateRenderbuffers; // OpenGL 4.5
+extern PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffers; // OpenGL 3.0
+extern PFNGLNAMEDRENDERBUFFERSTORAGEPROC glNamedRenderbufferStorage; // OpenGL 4.5
+extern PFNGLNAMEDFRAMEBUFFERRENDERBUFFERPROC glNamedFramebufferRenderbuffer; // OpenGL 4.5
+extern PFNGLCHECKNAMEDFRAMEBUFFERSTATUSPROC glCheckNamedFramebufferStatus; // OpenGL 4.5
+extern PFNGLDISPATCHCOMPUTEPROC glDispatchCompute; // OpenGL 4.3
+extern PFNGLMEMORYBARRIERPROC glMemoryBarrier; // OpenGL 4.2
+extern PFNGLDRAWARRAYSINDIRECTPROC glDrawArraysIndirect; // OpenGL 4.0
+extern PFNGLMULTIDRAWARRAYSINDIRECTPROC glMultiDrawArraysIndirect; // OpenGL 4.3
+extern PFNGLBINDIMAGETEXTUREPROC glBindImageTexture; // OpenGL 4.2
+extern PFNGLCREATETEXTURESPROC glCreateTextures; // OpenGL 4.5
+extern PFNGLTEXTURESTORAGE2DPROC glTextureStorage2D; // OpenGL 4.5
+extern PFNGLTEXTUREPARAMETERIPROC glTextureParameteri; // OpenGL 4.5
+extern PFNGLNAMEDFRAMEBUFFERTEXTUREPROC glNamedFramebufferTexture; // OpenGL 4.5
+extern PFNGLBLITNAMEDFRAMEBUFFERPROC glBlitNamedFramebuffer; // OpenGL 4.5
+extern PFNGLVERTEXARRAYATTRIBIFORMATPROC glVertexArrayAttribIFormat; // OpenGL 4.5
+extern PFNGLVERTEXARRAYBINDINGDIVISORPROC glVertexArrayBindingDivisor; // OpenGL 4.5
+extern PFNGLNAMEDFRAMEBUFFERDRAWBUFFERSPROC glNamedFramebufferDrawBuffers; // OpenGL 4.5
+extern PFNGLCREATESAMPLERSPROC glCreateSamplers; // OpenGL 4.5
+extern PFNGLDELETESAMPLERSPROC glDeleteSamplers; // OpenGL 3.3
+extern PFNGLSAMPLERPARAMETERIPROC glSamplerParameteri; // OpenGL 3.3
+extern PFNGLSAMPLERPARAMETERFPROC glSamplerParameterf; // OpenGL 3.3
+extern PFNGLCOPYIMAGESUBDATAPROC glCopyImageSubData; // OpenGL 4.3
+extern PFNGLTEXTURESUBIMAGE2DPROC glTextureSubImage2D; // OpenGL 4.5
+extern PFNGLGETTEXTUREIMAGEPROC glGetTextureImage; // OpenGL 4.5
+extern PFNGLTEXTURESTORAGE3DPROC glTextureStorage3D; // OpenGL 4.5
+extern PFNGLTEXTURESUBIMAGE3DPROC glTextureSubImage3D; // OpenGL 4.5
+extern PFNGLGENERATETEXTUREMIPMAPPROC glGenerateTextureMipmap; // OpenGL 4.5
+extern PFNGLFENCESYNCPROC glFenceSync; // OpenGL 3.2
+extern PFNGLCLIENTWAITSYNCPROC glClientWaitSync; // OpenGL 3.2
+extern PFNGLDELETESYNCPROC glDeleteSync; // OpenGL 3.2
+extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR; // GL_KHR_parallel_shader_compile (optional)
 extern PFNGLPRIMITIVERESTARTINDEXPROC glPrimitiveRestartIndex; // OpenGL 3.1
 
+/*
+	The OpenGL 1.x functions issued by the engine are called through pointers as well, so kengine::gl_capture
+	can record them. The pointers are initialized with the functions of the system library.
+*/
+#ifndef __ANDROID__
+extern decltype(&glClear) kglClear;
+extern decltype(&glClearColor) kglClearColor;
+extern decltype(&glDrawArrays) kglDrawArrays;
+extern decltype(&glEnable) kglEnable;
+extern decltype(&glDisable) kglDisable;
+extern decltype(&glViewport) kglViewport;
+extern decltype(&glPolygonMode) kglPolygonMode;
+extern decltype(&glDepthFunc) kglDepthFunc;
+extern decltype(&glDepthMask) kglDepthMask;
+extern decltype(&glCullFace) kglCullFace;
+extern decltype(&glFrontFace) kglFrontFace;
+extern decltype(&glLineWidth) kglLineWidth;
+extern decltype(&glPointSize) kglPointSize;
+extern decltype(&glDeleteTextures) kglDeleteTextures;
+extern decltype(&glPixelStorei) kglPixelStorei;
+
+#ifndef K_ENGINE_GL_NO_REDIRECT
+#define glClear kglClear
+#define glClearColor kglClearColor
+#define glDrawArrays kglDrawArrays
+#define glEnable kglEnable
+#define glDisable kglDisable
+#define glViewport kglViewport
+#define glPolygonMode kglPolygonMode
+#define glDepthFunc kglDepthFunc
+#define glDepthMask kglDepthMask
+#define glCullFace kglCullFace
+#define glFrontFace kglFrontFace
+#define glLineWidth kglLineWidth
+#define glPointSize kglPointSize
+#define glDeleteTextures kglDeleteTextures
+#define glPixelStorei kglPixelStorei
+#endif
+#endif
+
 namespace kengine {
 	enum CONTEXT_FLAG {
 #if defined(_WIN32)
@@ -193,6 +325,31 @@ namespace kengine {
 	*/
 	bool getAllGLProcedures();
 
+	/*
+		Values of the specialization constants of a SPIR-V module (layout (constant_id = N) const ...).
+
+		The values are stored as their 32-bit patterns and sorted by id, so the key doesn't depend on the order of the calls to set().
+		A constant that is not declared by the module is an error of glSpecializeShader, so each stage has its own set.
+	*/
+	class specialization_constants
+	{
+	public:
+		void set(GLuint id, GLuint value);
+		void set(GLuint id, GLint value);
+		void set(GLuint id, GLfloat value);
+		void set(GLuint id, bool value) { set(id, static_cast<GLuint>(value ? 1 : 0)); }
+
+		GLuint getCount() const { return static_cast<GLuint>(m_indices.size()); }
+		const GLuint* getIndices() const { return m_indices.data(); }
+		const GLuint* getValues() const { return m_values.data(); }
+
+		uint64_t getKey() const;
+
+	private:
+		std::vector<GLuint> m_indices;
+		std::vector<GLuint> m_values;
+	};
+
 	/*
 		This struct is used to pass a list of GLSL shaders that can be compiled.
 
@@ -209,8 +366,133 @@ namespace kengine {
 	{
 		GLuint type;
 		std::string filename;
+		std::string defines; // injected after the #version directive by the shader preprocessor (e.g. "#define SKINNING 1\n")
+		specialization_constants constants; // only used by the SPIR-V modules
+	};
+
+	/*
+		Reflection of an active uniform variable
+	*/
+	struct uniform_info
+	{
+		GLint location = -1;
+		GLenum type = GL_NONE;
+		GLint size = 0; // number of array elements (1 if it is not an array)
+	};
+
+	/*
+		Open addressing hash table (linear probing) of the uniform variables keyed by the hashed names.
+		It is built once after the link, so the lookups never allocate memory.
+	*/
+	class uniform_table
+	{
+	public:
+		void clear();
+
+		/*
+			It returns false if another name has the same hash
+		*/
+		bool insert(uint32_t hash, const uniform_info& info);
+		const uniform_info* find(uint32_t hash) const;
+
+		size_t size() const { return m_count; }
+		void getEntries(std::vector<std::pair<uint32_t, uniform_info>>& entries) const;
+
+	private:
+		struct slot
+		{
+			uint32_t hash = 0;
+			bool used = false;
+			uniform_info info;
+		};
+
+		void rehash(size_t capacity);
+
+		std::vector<slot> m_slots; // the capacity is a power of two
+		size_t m_count = 0;
+	};
+
+	/*
+		The uniform traits map a GLSL type to the glUniform* function (the program must be in use)
+
+		Note: the opaque types (samplers, images and atomic counters) are set as GL_INT
+	*/
+	template <GLenum Type>
+	struct uniform_traits;
+
+#define K_UNIFORM_TRAITS(glType, valueType, function) \
+	template <> \
+	struct uniform_traits<glType> { \
+		typedef valueType value_type; \
+		static void set(GLint location, GLsizei count, const valueType* value) { function(location, count, value); } \
+	};
+
+#define K_UNIFORM_MATRIX_TRAITS(glType, valueType, function) \
+	template <> \
+	struct uniform_traits<glType> { \
+		typedef valueType value_type; \
+		static void set(GLint location, GLsizei count, const valueType* value) { function(location, count, GL_FALSE, value); } \
+	};
+
+	K_UNIFORM_TRAITS(GL_FLOAT, GLfloat, glUniform1fv)
+	K_UNIFORM_TRAITS(GL_FLOAT_VEC2, GLfloat, glUniform2fv)
+	K_UNIFORM_TRAITS(GL_FLOAT_VEC3, GLfloat, glUniform3fv)
+	K_UNIFORM_TRAITS(GL_FLOAT_VEC4, GLfloat, glUniform4fv)
+	K_UNIFORM_TRAITS(GL_DOUBLE, GLdouble, glUniform1dv)
+	K_UNIFORM_TRAITS(GL_DOUBLE_VEC2, GLdouble, glUniform2dv)
+	K_UNIFORM_TRAITS(GL_DOUBLE_VEC3, GLdouble, glUniform3dv)
+	K_UNIFORM_TRAITS(GL_DOUBLE_VEC4, GLdouble, glUniform4dv)
+	K_UNIFORM_TRAITS(GL_INT, GLint, glUniform1iv)
+	K_UNIFORM_TRAITS(GL_INT_VEC2, GLint, glUniform2iv)
+	K_UNIFORM_TRAITS(GL_INT_VEC3, GLint, glUniform3iv)
+	K_UNIFORM_TRAITS(GL_INT_VEC4, GLint, glUniform4iv)
+	K_UNIFORM_TRAITS(GL_UNSIGNED_INT, GLuint, glUniform1uiv)
+	K_UNIFORM_TRAITS(GL_UNSIGNED_INT_VEC2, GLuint, glUniform2uiv)
+	K_UNIFORM_TRAITS(GL_UNSIGNED_INT_VEC3, GLuint, glUniform3uiv)
+	K_UNIFORM_TRAITS(GL_UNSIGNED_INT_VEC4, GLuint, glUniform4uiv)
+	K_UNIFORM_TRAITS(GL_BOOL, GLint, glUniform1iv)
+	K_UNIFORM_TRAITS(GL_BOOL_VEC2, GLint, glUniform2iv)
+	K_UNIFORM_TRAITS(GL_BOOL_VEC3, GLint, glUniform3iv)
+	K_UNIFORM_TRAITS(GL_BOOL_VEC4, GLint, glUniform4iv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT2, GLfloat, glUniformMatrix2fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT3, GLfloat, glUniformMatrix3fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT4, GLfloat, glUniformMatrix4fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT2x3, GLfloat, glUniformMatrix2x3fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT3x2, GLfloat, glUniformMatrix3x2fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT2x4, GLfloat, glUniformMatrix2x4fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT4x2, GLfloat, glUniformMatrix4x2fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT3x4, GLfloat, glUniformMatrix3x4fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_FLOAT_MAT4x3, GLfloat, glUniformMatrix4x3fv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT2, GLdouble, glUniformMatrix2dv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT3, GLdouble, glUniformMatrix3dv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT4, GLdouble, glUniformMatrix4dv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT2x3, GLdouble, glUniformMatrix2x3dv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT3x2, GLdouble, glUniformMatrix3x2dv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT2x4, GLdouble, glUniformMatrix2x4dv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT4x2, GLdouble, glUniformMatrix4x2dv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT3x4, GLdouble, glUniformMatrix3x4dv)
+	K_UNIFORM_MATRIX_TRAITS(GL_DOUBLE_MAT4x3, GLdouble, glUniformMatrix4x3dv)
+
+#undef K_UNIFORM_TRAITS
+#undef K_UNIFORM_MATRIX_TRAITS
+
+	/*
+		Typed handle of a uniform variable (see GLSLprogram::getUniform)
+	*/
+	template <GLenum Type>
+	struct uniform
+	{
+		GLint location = -1; // the location -1 is silently ignored by glUniform*
+		GLint size = 0;
+
+		bool isValid() const { return location >= 0; }
 	};
 
+	/*
+		It returns true if a value of the "handleType" can be assigned to a uniform variable of the "type"
+	*/
+	bool isUniformTypeCompatible(GLenum type, GLenum handleType);
+
 	/*
 		This class represents a GLSL program
 	*/
@@ -226,12 +508,20 @@ namespace kengine {
 		GLSLprogram& operator=(GLSLprogram&&) = delete; // move assigment
 
 		bool loadShaders(const kengine::ShaderInfo* shaders);
+
+		/*
+			Load the SPIR-V modules stored alongside the GLSL files (filename + ".spv", e.g. "vs_example.vert.spv") and
+			specialize each stage with its constants. It returns false if GL_ARB_gl_spirv is not supported or if a
+			module is missing, so the caller can fall back to loadShaders.
+		*/
+		bool loadSPIRVShaders(const kengine::ShaderInfo* shaders);
+
 		void useProgram();
 
 		void saveBinary(const std::string& name);
 		void loadBinary(const std::string& name);
 
-		void setUniform(std::string name, bool transpose, GLfloat* value);
+		void setUniform(const std::string& name, bool transpose, GLfloat* value);
 
 		/*
 			(!) for perfomance: it doesn't use std::unordered_map and is inline
@@ -240,10 +530,41 @@ namespace kengine {
 			glUniformMatrix4fv(location, 1, transpose, value);
 		}
 
-		GLint getLocation(std::string name) {
-			return uniformMap[name];
+		/*
+			It returns -1 if the program doesn't have an active uniform variable with this name
+		*/
+		GLint getLocation(const std::string& name) const;
+
+		/*
+			Resolve a typed uniform handle once (e.g. after loading the shaders). The name is hashed by K_HASH:
+
+				kengine::uniform<GL_FLOAT_MAT4> model = program.getUniform<GL_FLOAT_MAT4>(K_HASH("model"));
+
+			The handle is invalid if the name is not found or if the type doesn't match.
+		*/
+		template <GLenum Type>
+		uniform<Type> getUniform(uint32_t nameHash) const {
+			uniform<Type> handle;
+			uniform_info info;
+
+			if (resolveUniform(nameHash, Type, info)) {
+				handle.location = info.location;
+				handle.size = info.size;
+			}
+
+			return handle;
+		}
+
+		/*
+			No allocation and no lookup: it is a direct call to glUniform* (the program must be in use)
+		*/
+		template <GLenum Type>
+		void setUniform(const uniform<Type>& handle, const typename uniform_traits<Type>::value_type* value, GLsizei count = 1) const {
+			uniform_traits<Type>::set(handle.location, count, value);
 		}
 
+		const uniform_table& getUniforms() const { return uniforms; }
+
 		GLuint getProgramID() const { return programID; }
 
 		void print() const;
@@ -259,13 +580,26 @@ namespace kengine {
 		// the parameter size specifies the number of array elements. this should be 1 if the targeted uniform variable is not an array
 		// void setUniform(std::string name, GLsizei size, float* data);
 	private:
+		friend class shader_batch;
+		friend class upload_worker;
+
+		/*
+			Replace the program object (the previous one is deleted)
+		*/
+		void setProgram(GLuint program, const std::string& owner);
+		bool loadCachedProgram(const GLuint* types, const std::string* sources, int count, const std::string& owner, uint64_t& key);
+		bool linkShaders(GLuint* shaders, const std::string& owner, uint64_t key);
+		void reflectUniforms();
+		bool resolveUniform(uint32_t nameHash, GLenum type, uniform_info& info) const;
+
 		GLuint programID = 0;
 		GLenum binaryFormat = 0;
-		std::unordered_map<std::string, GLint> uniformMap; // std::map vs std::unordered_map
+		uniform_table uniforms; // active uniform variables keyed by kengine::fnv1a(name)
 	};
 
 	/*
-		This class encapsulate the vertex buffer object and vertex array object
+		This class encapsulate the vertex buffer object. The vertex array object is shared by all
+		meshes with the same vertex layout (see kengine::vertex_format_registry).
 	*/
 	class mesh_node {
 		static constexpr int MAX_VBO = 1;
@@ -283,15 +617,55 @@ namespace kengine {
 			Create new buffer objects for the mesh m. This method will destroy all previous loaded objects.
 		*/
 		void load(mesh& m, size_t size = 1); // no DSA commands
+
+		/*
+			Take the ownership of a vertex buffer already filled with the interleaved data of the mesh m
+			(e.g. created by the upload worker in a shared context). This method will destroy all previous loaded objects.
+		*/
+		void attach(GLuint buffer, mesh& m);
+
 		void clear();
 		void drawArrays() const;
 		void setMode(GLenum mode) { m_mode = mode; }
 
+		/*
+			Draw with a DrawArraysIndirectCommand stored in a buffer (e.g. written on the GPU by kengine::gpu_culler)
+		*/
+		void drawArraysIndirect(GLuint indirectBuffer, GLintptr offset) const;
+
+		int getVertexFormat() const { return m_format; }
+		GLsizei getVertexCount() const { return m_count; }
+		bool isLoaded() const { return m_format >= 0; }
+
+		/*
+			Bounding box of the positions (location 0) in object space (e.g. for kengine::occlusion_culler)
+		*/
+		const float* getBoundsMin() const { return m_boundsMin; }
+		const float* getBoundsMax() const { return m_boundsMax; }
+
+		/*
+			Name of the owner of the GPU memory (see kengine::gpu_memory_tracker)
+		*/
+		void setName(const std::string& name) { m_name = name; }
+		const std::string& getName() const { return m_name; }
+
+		/*
+			It expires when the node is deleted (e.g. the completion of an asynchronous upload checks it)
+		*/
+		std::weak_ptr<bool> getToken() const { return m_token; }
+
 	private:
+		void setVertexLayout(mesh& m);
+
 		GLuint m_vbo[MAX_VBO] = { 0 };
-		GLuint m_vao = 0;
+		int m_format = -1; // vertex format identifier from kengine::vertex_format_registry
+		GLsizei m_stride = 0;
 		GLsizei m_count = 0;
 		GLenum m_mode = GL_TRIANGLES;
+		float m_boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+		float m_boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+		std::string m_name = "mesh_node";
+		std::shared_ptr<bool> m_token = std::make_shared<bool>(true);
 
 		//GLsizei countElement = 0;
 		//size_t max_size = 1;
@@ -302,11 +676,25 @@ namespace kengine {
 		Helper function to compile GLSL shader
 	*/
 	GLuint compileShader(GLuint shaderType, std::string filename);
+	GLuint compileShaderSource(GLuint shaderType, const std::string& source);
+
+	/*
+		Helper functions to check the compile and the link status (the info log is printed on failure)
+	*/
+	bool checkCompileStatus(GLuint shader, GLuint shaderType);
+	bool checkLinkStatus(GLuint program);
+
+	/*
+		The extension functions can be loaded even if the driver doesn't support them (e.g. glXGetProcAddress),
+		so the extension must be checked before calling them
+	*/
+	bool isExtensionSupported(const std::string& name);
 
 	/*
 		Helper function to compile SPIR-V shader
 	*/
-	GLuint compileSPIRVShader(GLuint shaderType, const std::string& name);
+	GLuint compileSPIRVShader(GLuint shaderType, const std::string& name, const specialization_constants* constants = nullptr);
+	GLuint compileSPIRVShaderBinary(GLuint shaderType, const std::string& binary, const specialization_constants* constants = nullptr);
 
 	std::string getShaderType(GLuint shader_type);
 	std::string getGLSLType(GLint type);
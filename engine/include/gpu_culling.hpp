@@ -0,0 +1,193 @@
+/*
+	K-Engine GPU Culling
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_GPU_CULLING_HPP
+#define K_ENGINE_GPU_CULLING_HPP
+
+#include <gl_wrapper.hpp>
+#include <k_constants.hpp>
+#include <k_hash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		World space bounding box of an instance (the layout of the shader storage buffer)
+	*/
+	struct gpu_instance
+	{
+		float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+		uint32_t draw = 0; // index returned by gpu_culler::addDraw
+		float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+		uint32_t reserved = 0;
+	};
+
+	/*
+		DrawArraysIndirectCommand
+	*/
+	struct gpu_draw_command
+	{
+		GLuint count = 0;
+		GLuint instanceCount = 0;
+		GLuint first = 0;
+		GLuint baseInstance = 0;
+	};
+
+	/*
+		Atomic counters of a culling pass (read back without stall, a few frames later)
+	*/
+	struct gpu_culling_stats
+	{
+		unsigned int visible = 0;
+		unsigned int frustumCulled = 0;
+		unsigned int occluded = 0;
+	};
+
+	/*
+		kengine::gpu_culler is the GPU alternative of kengine::occlusion_culler.
+
+		A compute shader (shaders/cs_cull.comp) tests every instance against the frustum and against a Hi-Z
+		pyramid built from the depth of the previous frame (shaders/cs_hiz.comp), then appends the visible
+		instances to the instance range of their draw command. The commands are consumed by glDrawArraysIndirect
+		(see mesh_node::drawArraysIndirect), so the CPU cost doesn't depend on the number of instances and the
+		results are never read back (only the counters, a few frames later, without waiting).
+
+		The vertex shader receives the index of the instance from an instanced attribute (see
+		bindInstanceAttribute): the baseInstance of the command selects the range of the draw.
+
+		It requires OpenGL 4.3 and it must be created and deleted with a current rendering context.
+	*/
+	class gpu_culler
+	{
+	public:
+		static constexpr int STATS_LATENCY = 3;
+
+		gpu_culler() {}
+		~gpu_culler();
+
+		gpu_culler(const gpu_culler& copy) = delete; // copy constructor
+		gpu_culler(gpu_culler&& move) noexcept = delete; // move constructor
+		gpu_culler& operator=(const gpu_culler& copy) = delete; // copy assignment
+		gpu_culler& operator=(gpu_culler&&) = delete; // move assigment
+
+		bool init(const std::string& shaderDirectory = KENGINE_SHADER_PATH_STR + "/shaders");
+
+		/*
+			Draw command of a mesh. It returns the index of the draw (see gpu_instance::draw).
+		*/
+		unsigned int addDraw(const mesh_node& node, GLuint maxInstances);
+
+		/*
+			Upload the instances (only when they change). It returns false if a draw receives more instances than its maximum.
+		*/
+		bool setInstances(const gpu_instance* instances, size_t count);
+
+		/*
+			Copy the depth of the framebuffer (GL_DEPTH24_STENCIL8, the format of the blit destination) and build
+			the Hi-Z pyramid used by the next cull. The matrix is the view projection used to render the depth.
+		*/
+		void updateHiZ(GLuint framebuffer, int width, int height, const float* viewProjection);
+		void resetHiZ() { m_hizLevels = 0; }
+
+		/*
+			Reset the commands and run the culling pass (the matrix is column-major)
+		*/
+		void cull(const float* viewProjection);
+
+		void draw(unsigned int drawIndex, const mesh_node& node) const {
+			node.drawArraysIndirect(m_commandBuffer, static_cast<GLintptr>(drawIndex * sizeof(gpu_draw_command)));
+		}
+
+		/*
+			Source the attribute "location" (uint) of the vertex array from the visible instances (divisor 1).
+
+			The culler remembers the vertex array: the visible buffer is bound again when cull reallocates it (e.g. a
+			draw is added after the first cull), so the vertex array must live as long as the culler. The vertex
+			arrays of kengine::vertex_format_registry are shared by every mesh of a vertex format, so the attribute
+			is added to all of them: "location" must not be used by the other shaders drawing that format.
+		*/
+		void bindInstanceAttribute(GLuint vertexArray, GLuint location, GLuint binding = 1);
+
+		GLuint getCommandBuffer() const { return m_commandBuffer; }
+		GLuint getVisibleBuffer() const { return m_visibleBuffer; }
+		GLuint getInstanceBuffer() const { return m_instanceBuffer; }
+		GLuint getHiZTexture() const { return m_hizTexture; }
+		int getHiZLevels() const { return m_hizLevels; }
+
+		const gpu_culling_stats& getFrameStats() const { return m_stats; }
+
+	private:
+		void destroyTargets();
+		void readStats();
+		void bindVisibleBuffer();
+
+		GLSLprogram m_cullProgram;
+		GLSLprogram m_copyDepthProgram;
+		GLSLprogram m_reduceProgram;
+		uniform<GL_FLOAT_MAT4> m_previousViewProjection;
+		uniform<GL_FLOAT_VEC4> m_frustumPlanes;
+		uniform<GL_UNSIGNED_INT> m_instanceCount;
+		uniform<GL_INT> m_hizLevelsUniform;
+
+		std::vector<gpu_draw_command> m_commands; // instanceCount is 0 (reset of each cull)
+		std::vector<GLuint> m_drawCapacities;
+		GLuint m_instanceCapacity = 0; // sum of the maximum instances of the draws
+
+		GLuint m_commandBuffer = 0;
+		GLuint m_visibleBuffer = 0;
+		GLuint m_instanceBuffer = 0;
+		GLuint m_counterBuffer = 0;
+		GLuint m_visibleCapacity = 0;
+		size_t m_instanceBufferCapacity = 0;
+		size_t m_commandCapacity = 0;
+		GLuint m_instanceCountValue = 0;
+		std::vector<std::pair<GLuint, GLuint>> m_instanceVertexArrays; // vertex array and binding (see bindInstanceAttribute)
+
+		// depth copy and Hi-Z pyramid
+		GLuint m_depthTexture = 0;
+		GLuint m_depthFramebuffer = 0;
+		GLuint m_hizTexture = 0;
+		int m_hizWidth = 0;
+		int m_hizHeight = 0;
+		int m_hizLevelCount = 0; // levels of the texture
+		int m_hizLevels = 0; // 0 until the first updateHiZ
+		float m_hizViewProjection[16] = { 0.0f };
+
+		// the counters are copied to a persistently mapped ring and read when their fence is signaled
+		GLuint m_statsBuffer = 0;
+		const GLuint* m_statsData = nullptr;
+		GLsync m_statsFences[STATS_LATENCY] = { nullptr };
+		int m_statsFrame = 0;
+		gpu_culling_stats m_stats;
+	};
+}
+
+#endif
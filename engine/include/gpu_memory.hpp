@@ -0,0 +1,168 @@
+/*
+	K-Engine GPU Memory Tracker
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_GPU_MEMORY_HPP
+#define K_ENGINE_GPU_MEMORY_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		Categories of the GPU allocations
+	*/
+	enum class GPU_MEMORY_CATEGORY
+	{
+		BUFFER = 0,
+		TEXTURE,
+		PROGRAM,
+		RENDER_TARGET, // textures rendered to
+		RENDERBUFFER, // the renderbuffers have their own names (they can be equal to the names of the textures)
+		COUNT
+	};
+
+	std::string getGPUMemoryCategoryName(GPU_MEMORY_CATEGORY category);
+
+	/*
+		Allocation churn of one frame (see gpu_memory_tracker::newFrame)
+	*/
+	struct gpu_memory_frame_stats
+	{
+		size_t allocatedBytes = 0;
+		size_t releasedBytes = 0;
+		unsigned int allocations = 0;
+		unsigned int releases = 0;
+		unsigned int evictions = 0; // number of eviction callback calls
+		size_t evictedBytes = 0; // bytes released by the eviction callbacks (their return values)
+	};
+
+	/*
+		kengine::gpu_memory_tracker keeps the accounting of every GL allocation made by the engine.
+
+		The allocations are identified by category and GL object name. The sizes are the sizes requested
+		by the engine (the driver may allocate more). If the usage exceeds the budget, the eviction
+		callbacks are called in the order they were registered until the usage is back under the budget.
+
+		This class is thread-safe (the upload worker allocates on its own thread).
+	*/
+	class gpu_memory_tracker
+	{
+	public:
+		/*
+			Eviction callback: it receives the number of bytes that must be released and returns
+			the number of bytes that it has released (by calling gpu_memory_tracker::release).
+			It is called without the lock on the thread that allocates over the budget (e.g. the upload worker).
+		*/
+		typedef std::function<size_t(size_t)> eviction_callback;
+
+		gpu_memory_tracker() {}
+		~gpu_memory_tracker() {}
+
+		gpu_memory_tracker(const gpu_memory_tracker& copy) = delete; // copy constructor
+		gpu_memory_tracker(gpu_memory_tracker&& move) noexcept = delete; // move constructor
+		gpu_memory_tracker& operator=(const gpu_memory_tracker& copy) = delete; // copy assignment
+		gpu_memory_tracker& operator=(gpu_memory_tracker&&) = delete; // move assigment
+
+		void allocate(GPU_MEMORY_CATEGORY category, unsigned int id, size_t sizeInBytes, const std::string& owner);
+		void release(GPU_MEMORY_CATEGORY category, unsigned int id);
+
+		/*
+			Budget in bytes (0 means no budget)
+		*/
+		void setBudget(size_t sizeInBytes);
+		size_t getBudget() const;
+
+		int addEvictionCallback(eviction_callback callback);
+
+		/*
+			It waits for the callback if another thread is running it, so the owner of the callback can be
+			destroyed after it returns
+		*/
+		void removeEvictionCallback(int callbackID);
+
+		size_t getUsage() const;
+		size_t getUsage(GPU_MEMORY_CATEGORY category) const;
+		size_t getOwnerUsage(const std::string& owner) const;
+		size_t getPeakUsage() const;
+		size_t getAllocationCount() const;
+
+		/*
+			Store the churn of the last frame and reset the counters of the current frame
+		*/
+		void newFrame();
+		gpu_memory_frame_stats getFrameStats() const;
+
+		/*
+			Text report used by the profiling output (usage by category and owner, peak and live allocations)
+		*/
+		std::string report() const;
+
+	private:
+		struct allocation
+		{
+			GPU_MEMORY_CATEGORY category = GPU_MEMORY_CATEGORY::BUFFER;
+			size_t sizeInBytes = 0;
+			std::string owner;
+		};
+
+		static uint64_t key(GPU_MEMORY_CATEGORY category, unsigned int id) {
+			return (static_cast<uint64_t>(category) << 32) | id;
+		}
+
+		void evict();
+
+		mutable std::mutex m_mutex;
+		std::unordered_map<uint64_t, allocation> m_allocations;
+		std::map<std::string, size_t> m_ownerUsage;
+		size_t m_categoryUsage[static_cast<int>(GPU_MEMORY_CATEGORY::COUNT)] = { 0 };
+		size_t m_usage = 0;
+		size_t m_peakUsage = 0;
+		size_t m_budget = 0;
+		bool m_evicting = false;
+		std::thread::id m_evictingThread;
+		int m_runningCallback = -1; // identifier of the callback being called
+		std::condition_variable m_callbackDone;
+		std::vector<std::pair<int, eviction_callback>> m_evictionCallbacks;
+		int m_nextCallbackID = 0;
+		gpu_memory_frame_stats m_frameStats;
+		gpu_memory_frame_stats m_lastFrameStats;
+	};
+
+	/*
+		Global GPU memory tracker of the current rendering context
+	*/
+	gpu_memory_tracker& gpuMemoryTracker();
+}
+
+#endif
@@ -0,0 +1,168 @@
+/*
+	K-Engine GPU Profiler
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_GPU_PROFILER_HPP
+#define K_ENGINE_GPU_PROFILER_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		GPU time and counters of a profiled scope (a pass)
+	*/
+	struct gpu_pass_stats
+	{
+		std::string name;
+		unsigned int depth = 0; // nesting level of the scope
+		double milliseconds = 0.0;
+		bool hasCounters = false; // the counters are only collected by the outermost scope (the queries can't be nested)
+		uint64_t primitivesGenerated = 0;
+		uint64_t verticesSubmitted = 0; // pipeline statistics (GL_ARB_pipeline_statistics_query)
+		uint64_t primitivesSubmitted = 0;
+		uint64_t vertexShaderInvocations = 0;
+		uint64_t fragmentShaderInvocations = 0;
+	};
+
+	/*
+		kengine::gpu_profiler measures the GPU time of the scopes with GL_TIMESTAMP queries.
+
+		The queries of a frame are kept in a ring of "frameLatency" frames and read back when the ring wraps
+		(frameLatency frames later), so the CPU never waits for the GPU. If the results are not available yet,
+		the frame is dropped. Each scope also records GL_PRIMITIVES_GENERATED and, if supported, the pipeline
+		statistics of the outermost scope.
+
+		It must be initialized and finished with a current rendering context. Before init (or if the timer
+		queries fail), the scopes only push the debug groups.
+	*/
+	class gpu_profiler
+	{
+	public:
+		gpu_profiler() {}
+		~gpu_profiler() {}
+
+		gpu_profiler(const gpu_profiler& copy) = delete; // copy constructor
+		gpu_profiler(gpu_profiler&& move) noexcept = delete; // move constructor
+		gpu_profiler& operator=(const gpu_profiler& copy) = delete; // copy assignment
+		gpu_profiler& operator=(gpu_profiler&&) = delete; // move assigment
+
+		bool init(int frameLatency = 3, int maxScopes = 64);
+		void finish();
+		bool isEnabled() const { return !m_frames.empty(); }
+
+		/*
+			Called once per frame (see rendering_system::newFrame): the oldest frame of the ring is read back
+		*/
+		void newFrame();
+
+		void beginScope(const char* name);
+		void endScope();
+
+		/*
+			Passes of the last frame read back (in the order of beginScope)
+		*/
+		const std::vector<gpu_pass_stats>& getFrameStats() const { return m_lastFrameStats; }
+		uint64_t getLastFrameNumber() const { return m_lastFrame; }
+		unsigned int getDroppedFrames() const { return m_droppedFrames; }
+
+	private:
+		enum
+		{
+			STATISTICS_COUNT = 4
+		};
+
+		struct scope_queries
+		{
+			GLuint begin = 0;
+			GLuint end = 0;
+			GLuint primitives = 0;
+			GLuint statistics[STATISTICS_COUNT] = {};
+		};
+
+		struct scope_record
+		{
+			const char* name = nullptr; // string literals (the scope names must outlive the frame latency)
+			unsigned int depth = 0;
+			bool hasCounters = false;
+		};
+
+		struct frame_queries
+		{
+			std::vector<scope_queries> queries;
+			std::vector<scope_record> scopes;
+			uint64_t frame = 0;
+			bool pending = false;
+		};
+
+		void readBack(frame_queries& frame);
+
+		std::vector<frame_queries> m_frames;
+		int m_current = 0;
+		uint64_t m_frame = 0;
+		bool m_hasStatistics = false;
+
+		std::vector<int> m_openScopes; // indices into the scopes of the current frame
+		int m_counterScope = -1; // scope that owns the counter queries
+
+		std::vector<gpu_pass_stats> m_lastFrameStats;
+		uint64_t m_lastFrame = 0;
+		unsigned int m_droppedFrames = 0;
+	};
+
+	/*
+		Global GPU profiler used by kengine::gpu_scope
+	*/
+	gpu_profiler& gpuProfiler();
+
+	/*
+		RAII scope: a debug group (visible in RenderDoc, apitrace, etc) and a timed pass of the GPU profiler
+
+			{
+				kengine::gpu_scope scope("shadows");
+				...
+			}
+	*/
+	class gpu_scope
+	{
+	public:
+		explicit gpu_scope(const char* name, gpu_profiler& profiler = gpuProfiler());
+		~gpu_scope();
+
+		gpu_scope(const gpu_scope& copy) = delete; // copy constructor
+		gpu_scope(gpu_scope&& move) noexcept = delete; // move constructor
+		gpu_scope& operator=(const gpu_scope& copy) = delete; // copy assignment
+		gpu_scope& operator=(gpu_scope&&) = delete; // move assigment
+
+	private:
+		gpu_profiler& m_profiler;
+	};
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+	K-Engine Headless Rendering Context
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_HEADLESS_CONTEXT_HPP
+#define K_ENGINE_HEADLESS_CONTEXT_HPP
+
+#include <os_api_wrapper.hpp>
+#include <gl_wrapper.hpp>
+
+#include <vector>
+
+namespace kengine
+{
+	/*
+		kengine::headless_rendering_context is a rendering context without window and without display.
+
+		The context is created by EGL (the Mesa surfaceless platform if available, otherwise the default display
+		with a pbuffer) and it renders into a framebuffer object of a configurable size, so the rendering and
+		performance tests can run on machines without display or GPU (e.g. Mesa llvmpipe):
+
+			kengine::headless_rendering_context* context = new kengine::headless_rendering_context(256, 256);
+			kengine::rendering_system renderingSystem(context); // the rendering system owns the context
+
+		The framebuffer is bound by create, resize and clearBuffers. swapBuffers only flushes the commands.
+
+		Note: only Linux is supported (create fails on the other platforms).
+	*/
+	class headless_rendering_context : public rendering_context
+	{
+	public:
+		explicit headless_rendering_context(int width = 640, int height = 480);
+		~headless_rendering_context();
+
+		headless_rendering_context(const headless_rendering_context& copy) = delete; // copy constructor
+		headless_rendering_context& operator=(const headless_rendering_context& copy) = delete; // copy assignment
+		headless_rendering_context(headless_rendering_context&& move) noexcept = delete;  // move constructor
+		headless_rendering_context& operator=(headless_rendering_context&&) = delete; // move assigment
+
+		int create(const compatibility_profile& profile);
+		int destroy();
+		int makeCurrent(bool enable);
+		int swapBuffers();
+		void clearBuffers();
+
+		rendering_context* createSharedContext();
+
+		/*
+			Recreate the framebuffer attachments (the content is lost)
+		*/
+		bool resize(int width, int height);
+
+		int getWidth() const { return m_width; }
+		int getHeight() const { return m_height; }
+		GLuint getFramebuffer() const { return m_framebuffer; }
+
+		/*
+			Read back the color attachment (RGBA8, width * height * 4 bytes, the first row is the bottom one)
+		*/
+		bool readPixels(std::vector<unsigned char>& pixels) const;
+
+	private:
+		bool createFramebuffer();
+		void deleteFramebuffer();
+
+		int m_width = 640;
+		int m_height = 480;
+
+		// EGL handles (EGLDisplay, EGLConfig, EGLContext and EGLSurface), the EGL headers stay in the .cpp file
+		void* m_display = nullptr;
+		void* m_config = nullptr;
+		void* m_context = nullptr;
+		void* m_surface = nullptr; // 1x1 pbuffer if the surfaceless contexts are not supported
+		compatibility_profile m_profile;
+
+		GLuint m_framebuffer = 0;
+		GLuint m_colorBuffer = 0;
+		GLuint m_depthBuffer = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+	K-Engine hash header
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_HASH_HPP
+#define K_ENGINE_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/*
+	Hash of a string literal computed by the compiler (e.g. K_HASH("projection"))
+*/
+#define K_HASH(str) (std::integral_constant<uint32_t, kengine::fnv1a(str)>::value)
+
+namespace kengine
+{
+	/*
+		32-bit FNV-1a (a single return statement, so it is a valid C++11 constexpr function)
+	*/
+	constexpr uint32_t fnv1a(const char* str, uint32_t hash = 2166136261u)
+	{
+		return *str == '\0' ? hash : fnv1a(str + 1, (hash ^ static_cast<uint32_t>(static_cast<unsigned char>(*str))) * 16777619u);
+	}
+
+	/*
+		64-bit FNV-1a of a memory block (the hash of the previous block can be passed to combine them)
+	*/
+	inline uint64_t fnv1a64(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+		for (size_t index = 0; index < size; index++) {
+			hash ^= bytes[index];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+}
+
+#endif
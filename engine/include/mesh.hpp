@@ -206,6 +206,14 @@ namespace kengine {
 			Remove the vertex attribute data
 		*/
 		void removeVertexAttribute(size_t location);
+
+		/*
+			Return the vertex attribute data at the location (nullptr if there is none)
+		*/
+		const vattrib<float>* getVertexAttribute(size_t location) const {
+			auto it = m_vattributesMap.find(location);
+			return it != m_vattributesMap.end() ? &it->second : nullptr;
+		}
 		
 		void clear();
 
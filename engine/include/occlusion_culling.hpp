@@ -0,0 +1,167 @@
+/*
+	K-Engine Occlusion Culling
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_OCCLUSION_CULLING_HPP
+#define K_ENGINE_OCCLUSION_CULLING_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kengine
+{
+	struct occlusion_culling_stats
+	{
+		unsigned int occluders = 0;
+		unsigned int triangles = 0; // occluder triangles rasterized (after the near plane clipping)
+		unsigned int tested = 0;
+		unsigned int occluded = 0;
+		unsigned int outside = 0; // the box is outside the viewport or beyond the far plane
+		double rasterizeMilliseconds = 0.0;
+		double testMilliseconds = 0.0;
+	};
+
+	/*
+		kengine::occlusion_culler rejects the objects that are hidden by the occluders (walls, floors, big props)
+		before they are submitted.
+
+		The occluders are rasterized by the CPU into a low resolution depth buffer (8 pixels at a time with AVX,
+		SSE2 or a scalar fallback, see KENGINE_AVX) on the threads of kengine::threadPool(): each thread owns a
+		row of 8x8 tiles and writes the farthest depth of each tile into the hierarchical level. A bounding box is
+		occluded if its nearest depth is behind every pixel that it covers: the tiles are tested first and the
+		pixels only when the tile is not conclusive.
+
+		The matrices are column-major float[16] (the layout of glUniformMatrix4fv) and the depth is the window
+		depth [0, 1] of the OpenGL convention. The occluders must be conservative (inside the visible geometry),
+		otherwise visible objects can be culled.
+
+		Usage per frame:
+
+			culler.newFrame(viewProjection);
+			culler.addOccluder(...);
+			culler.rasterize();
+			culler.testNode(node, model) or culler.testAABBs(...)
+	*/
+	class occlusion_culler
+	{
+	public:
+		static constexpr int TILE_SIZE = 8;
+
+		/*
+			The size is rounded up to a multiple of the tile size
+		*/
+		explicit occlusion_culler(int width = 320, int height = 192);
+		~occlusion_culler() {}
+
+		occlusion_culler(const occlusion_culler& copy) = delete; // copy constructor
+		occlusion_culler(occlusion_culler&& move) noexcept = delete; // move constructor
+		occlusion_culler& operator=(const occlusion_culler& copy) = delete; // copy assignment
+		occlusion_culler& operator=(occlusion_culler&&) = delete; // move assigment
+
+		void resize(int width, int height);
+
+		/*
+			It removes the occluders of the previous frame and starts new frame statistics
+		*/
+		void newFrame(const float* viewProjection);
+
+		/*
+			Triangle list of "vertexCount" positions (x, y, z at the beginning of each "stride" floats).
+			The positions are referenced, not copied: they must be valid until rasterize returns.
+		*/
+		void addOccluder(const float* positions, size_t vertexCount, size_t stride = 3, const float* model = nullptr);
+
+		void rasterize();
+
+		/*
+			It returns false if the box is occluded (or outside the viewport). The box is in object space if
+			the model matrix is not nullptr.
+		*/
+		bool testAABB(const float* boundsMin, const float* boundsMax, const float* model = nullptr);
+		bool testNode(const mesh_node& node, const float* model = nullptr) { return testAABB(node.getBoundsMin(), node.getBoundsMax(), model); }
+
+		/*
+			Test "count" boxes (min x, y, z, max x, y, z) on the thread pool. The models are optional (nullptr or
+			one matrix per box) and visible receives 1 for each box that must be drawn.
+		*/
+		void testAABBs(size_t count, const float* bounds, const float* const* models, uint8_t* visible);
+
+		int getWidth() const { return m_width; }
+		int getHeight() const { return m_height; }
+
+		/*
+			Depth of the pixel (1.0 where there is no occluder)
+		*/
+		float getDepth(int x, int y) const { return m_depth[static_cast<size_t>(y) * m_width + x]; }
+		float getTileDepth(int tileX, int tileY) const { return m_tileDepth[static_cast<size_t>(tileY) * m_tilesX + tileX]; }
+
+		const occlusion_culling_stats& getFrameStats() const { return m_stats; }
+
+	private:
+		enum class RESULT
+		{
+			VISIBLE,
+			OCCLUDED,
+			OUTSIDE
+		};
+
+		struct occluder
+		{
+			const float* positions = nullptr;
+			size_t vertexCount = 0;
+			size_t stride = 3;
+			float matrix[16]; // view projection * model
+		};
+
+		/*
+			Window coordinates of a triangle: x, y, depth of each vertex
+		*/
+		struct screen_triangle
+		{
+			float vertices[9];
+		};
+
+		void transformOccluder(const occluder& current, std::vector<screen_triangle>& triangles) const;
+		void rasterizeTiles(int tileY, const std::vector<screen_triangle>& triangles);
+		RESULT test(const float* boundsMin, const float* boundsMax, const float* model) const;
+
+		int m_width = 0;
+		int m_height = 0;
+		int m_tilesX = 0;
+		int m_tilesY = 0;
+		std::vector<float> m_depth; // row-major
+		std::vector<float> m_tileDepth; // farthest depth of each tile
+
+		float m_viewProjection[16];
+		std::vector<occluder> m_occluders;
+		std::vector<std::vector<screen_triangle>> m_triangles; // per thread of the pool
+		occlusion_culling_stats m_stats;
+	};
+}
+
+#endif
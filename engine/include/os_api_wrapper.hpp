@@ -106,6 +106,13 @@ namespace kengine
 		virtual int swapBuffers() = 0;
 		virtual void clearBuffers() = 0;
 
+		/*
+			Create a new context that shares the objects (buffers, textures, programs and sync objects) with this one.
+			The new context has no drawable and it is meant to be made current on another thread (e.g. upload worker).
+			Returns nullptr if the platform doesn't support it.
+		*/
+		virtual rendering_context* createSharedContext() { return nullptr; }
+
 		void setRenderingContextInfo(int major, int minor) { info.major = major; info.minor = minor; }
 
 	private:
@@ -151,6 +158,11 @@ namespace kengine
 	*/
 	int64_t getHighResolutionTimerFrequency();
 
+	/*
+		Get the absolute path of a file without the symbolic links and the "." and ".." components. It returns the filename itself if the file doesn't exist.
+	*/
+	std::string getCanonicalPath(const std::string& filename);
+
 	/*
 		Creating a debug console
 	*/
@@ -28,10 +28,27 @@
 
 #include <timer.hpp>
 #include <vector>
+#include <string>
 #include <cstdint>
+#include <cstddef>
 
 namespace kengine
 {
+	class resolution_controller; // forward declaration
+
+	/*
+		GPU time of a pass accumulated over the profile (see kengine::gpu_profiler)
+	*/
+	struct gpu_pass_profile
+	{
+		std::string name;
+		unsigned int depth = 0;
+		unsigned int frames = 0;
+		double totalMilliseconds = 0.0;
+		double maxMilliseconds = 0.0;
+		uint64_t totalPrimitives = 0;
+	};
+
 	class profile
 	{
 	public:
@@ -42,6 +59,11 @@ namespace kengine
 		void update(int64_t frameTime);
 		void save() const;
 
+		/*
+			The scale and the scaling decisions of the dynamic resolution are logged (nullptr stops it)
+		*/
+		void setResolutionController(const resolution_controller* controller) { resolutionController = controller; }
+
 	private:
 		kengine::timer timer;
 		std::vector<int> framesPerSecond;
@@ -52,6 +74,19 @@ namespace kengine
 		int minFramesPerSecond;
 		int frameCounter;
 		int64_t totalFrameTime;
+		size_t maxGPUAllocatedBytes; // GPU memory churn (see kengine::gpu_memory_tracker)
+		size_t maxGPUReleasedBytes;
+		unsigned int gpuEvictions;
+		size_t gpuEvictedBytes;
+		uint64_t glCallsIssued; // redundant state calls (see kengine::gl_state_cache)
+		uint64_t glCallsElided;
+		unsigned int maxGLCallsIssued;
+		std::vector<gpu_pass_profile> gpuPasses; // per-pass GPU time breakdown
+		uint64_t lastGPUFrame;
+		const resolution_controller* resolutionController; // see kengine::dynamic_resolution
+		double totalResolutionScale;
+		float minResolutionScale;
+		unsigned int resolutionFrames;
 		bool isProfilingEnd;
 	};
 }
@@ -0,0 +1,108 @@
+/*
+	K-Engine Program Cache
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_PROGRAM_CACHE_HPP
+#define K_ENGINE_PROGRAM_CACHE_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		Counters of the program cache
+	*/
+	struct program_cache_stats
+	{
+		unsigned int hits = 0;
+		unsigned int misses = 0;
+		unsigned int rejections = 0; // binaries rejected by the driver (e.g. after a driver update)
+	};
+
+	/*
+		kengine::program_cache stores the linked program binaries on disk (one file per program).
+
+		The key is a hash of the type and the final source of every stage (so the injected defines are a part
+		of it) and of the GL_VENDOR, GL_RENDERER and GL_VERSION strings. Each file stores the binary format,
+		the binary and the uniform reflection, so a hit skips the compilation, the link and the queries of
+		the program resources.
+
+		The cache is disabled until a directory is set.
+	*/
+	class program_cache
+	{
+	public:
+		program_cache() {}
+		~program_cache() {}
+
+		program_cache(const program_cache& copy) = delete; // copy constructor
+		program_cache(program_cache&& move) noexcept = delete; // move constructor
+		program_cache& operator=(const program_cache& copy) = delete; // copy assignment
+		program_cache& operator=(program_cache&&) = delete; // move assigment
+
+		/*
+			Set the cache directory (it is created if it doesn't exist). An empty string disables the cache.
+		*/
+		bool setDirectory(const std::string& directory);
+		const std::string& getDirectory() const { return m_directory; }
+		bool isEnabled() const { return !m_directory.empty(); }
+
+		/*
+			It must be called with a current rendering context (the driver strings are a part of the key)
+		*/
+		uint64_t makeKey(const GLuint* types, const std::string* sources, int count);
+
+		/*
+			Create a program from the cached binary. It returns 0 on a miss or if the driver rejects the binary.
+		*/
+		GLuint load(uint64_t key, GLenum& binaryFormat, uniform_table& uniforms);
+
+		/*
+			Store the binary of a linked program (it must be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+		*/
+		bool save(uint64_t key, GLuint program, const uniform_table& uniforms);
+
+		program_cache_stats getStats() const;
+
+	private:
+		std::string getFilename(uint64_t key) const;
+
+		mutable std::mutex m_mutex; // the programs can be loaded by the upload worker
+		std::string m_directory;
+		std::string m_driver; // GL_VENDOR, GL_RENDERER and GL_VERSION
+		program_cache_stats m_stats;
+	};
+
+	/*
+		Global program cache used by GLSLprogram::loadShaders
+	*/
+	program_cache& programCache();
+}
+
+#endif
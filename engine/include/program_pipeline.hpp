@@ -0,0 +1,113 @@
+/*
+	K-Engine Program Pipeline
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_PROGRAM_PIPELINE_HPP
+#define K_ENGINE_PROGRAM_PIPELINE_HPP
+
+#include <gl_wrapper.hpp>
+#include <shader_preprocessor.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		Single stage program created by glCreateShaderProgramv (GL_PROGRAM_SEPARABLE)
+	*/
+	struct separable_program
+	{
+		GLuint program = 0;
+		GLenum type = GL_NONE;
+		GLbitfield stageBit = 0;
+		std::string filename;
+
+		bool isValid() const { return program != 0; }
+	};
+
+	struct program_pipeline_stats
+	{
+		unsigned int stageLinks = 0;
+		unsigned int pipelines = 0;
+		unsigned int pipelineBinds = 0; // issued binds
+	};
+
+	/*
+		kengine::program_pipeline_cache combines separable stages into program pipeline objects.
+
+		Each stage variant (file + defines) is compiled and linked once, and the pipelines are created on demand
+		for the combinations that are really drawn. With M vertex and N fragment variants, M + N programs are
+		linked instead of M * N monolithic programs (a pipeline object only binds the stages, it doesn't link).
+
+		The stages that write gl_Position must redeclare the gl_PerVertex block and the interfaces between the
+		stages should use explicit locations (they are matched by location, not by name).
+		It must be created and deleted with a current rendering context.
+	*/
+	class program_pipeline_cache
+	{
+	public:
+		program_pipeline_cache() {}
+		~program_pipeline_cache();
+
+		program_pipeline_cache(const program_pipeline_cache& copy) = delete; // copy constructor
+		program_pipeline_cache(program_pipeline_cache&& move) noexcept = delete; // move constructor
+		program_pipeline_cache& operator=(const program_pipeline_cache& copy) = delete; // copy assignment
+		program_pipeline_cache& operator=(program_pipeline_cache&&) = delete; // move assigment
+
+		/*
+			It returns an invalid stage if the source cannot be compiled or linked (the failure is cached too)
+		*/
+		const separable_program& getStage(GLenum type, const std::string& filename, const shader_define_set& defines = shader_define_set());
+
+		/*
+			It returns 0 if a stage is invalid. A pipeline that fails the validation is only logged and still returned
+			(the validation depends on the state bound when it is created, not on the state of the draw)
+		*/
+		GLuint getPipeline(const separable_program& vertex, const separable_program& fragment);
+		GLuint getPipeline(const separable_program* const* stages, int count);
+
+		/*
+			A program in use overrides the bound pipeline, so the program is unbound too. The pipeline is bound
+			through the state cache (pipelineBinds counts the binds that were not redundant)
+		*/
+		void bind(GLuint pipeline);
+
+		size_t getStageCount() const { return m_stages.size(); }
+		size_t getPipelineCount() const { return m_pipelines.size(); }
+		const program_pipeline_stats& getStats() const { return m_stats; }
+
+		void clear();
+
+	private:
+		std::map<uint64_t, separable_program> m_stages; // hash of the type, the file and the defines -> stage
+		std::map<std::vector<GLuint>, GLuint> m_pipelines; // programs of the stages -> pipeline
+		program_pipeline_stats m_stats;
+	};
+}
+
+#endif
@@ -0,0 +1,305 @@
+/*
+	K-Engine Render Graph
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_RENDER_GRAPH_HPP
+#define K_ENGINE_RENDER_GRAPH_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace kengine
+{
+	enum class RENDER_RESOURCE_TYPE
+	{
+		TEXTURE,
+		BUFFER
+	};
+
+	struct render_texture_desc
+	{
+		int width = 0;
+		int height = 0;
+		GLenum format = GL_RGBA8; // sized internal format (the depth formats are attached as depth or depth stencil)
+	};
+
+	/*
+		Handle of a resource of the graph (valid until render_graph::reset)
+	*/
+	typedef uint32_t render_resource;
+
+	class render_graph; // forward declaration
+
+	/*
+		Declarations of a pass (see render_graph::addPass)
+	*/
+	class render_pass_builder
+	{
+	public:
+		/*
+			A pass that reads and writes the same resource (e.g. blending into the color) declares both
+		*/
+		void read(render_resource resource);
+		void write(render_resource resource);
+
+		/*
+			The pass is never culled, even if no other pass uses its results (e.g. a readback)
+		*/
+		void setSideEffect();
+
+	private:
+		friend class render_graph;
+
+		render_pass_builder(render_graph& graph, unsigned int pass) : m_graph(graph), m_pass(pass) {}
+
+		render_graph& m_graph;
+		unsigned int m_pass;
+	};
+
+	/*
+		The GL objects of a pass while it is executed
+	*/
+	class render_pass_context
+	{
+	public:
+		GLuint getTexture(render_resource resource) const;
+		GLuint getBuffer(render_resource resource) const;
+
+		/*
+			Framebuffer of the textures written by the pass (already bound with the viewport of the attachments).
+			It is 0 if the pass doesn't write any texture (e.g. a compute pass).
+		*/
+		GLuint getFramebuffer() const { return m_framebuffer; }
+		int getWidth() const { return m_width; }
+		int getHeight() const { return m_height; }
+
+	private:
+		friend class render_graph;
+
+		explicit render_pass_context(const render_graph& graph) : m_graph(graph) {}
+
+		const render_graph& m_graph;
+		GLuint m_framebuffer = 0;
+		int m_width = 0;
+		int m_height = 0;
+	};
+
+	struct render_graph_stats
+	{
+		unsigned int passes = 0;
+		unsigned int culledPasses = 0;
+		unsigned int transientResources = 0; // used by the passes that are not culled
+		unsigned int physicalTextures = 0; // after the aliasing
+		unsigned int physicalBuffers = 0;
+		size_t transientBytes = 0; // one object per transient resource
+		size_t physicalBytes = 0; // after the aliasing
+	};
+
+	/*
+		kengine::render_graph describes a frame as passes that declare the resources they read and write.
+
+		compile() only works on the declarations (no GL calls, so it can be tested without a context):
+			- the passes are ordered by their dependencies: a pass that reads a resource runs after the last pass
+			  declared before it that writes the resource, and before the next one (write after read), so the
+			  passes must be declared in the order of the frame (the independent passes can be reordered)
+			- the passes whose results are never used are culled: the roots are the passes that write an
+			  imported resource (e.g. the backbuffer) or that have a side effect
+			- the lifetime of each transient resource is the range of the passes that use it
+			- the transient resources whose lifetimes don't overlap share a physical object: the textures of the
+			  same size and format, the buffers of any size (the biggest one is allocated)
+
+		execute() takes the physical objects from a pool that survives reset(), so a stable frame allocates
+		nothing (the objects unused for a few frames are released). Each pass gets a cached framebuffer with
+		the textures it writes and is executed inside a kengine::gpu_scope.
+
+		The names of the passes and the resources must be string literals (see kengine::gpu_scope).
+
+		Usage per frame:
+
+			graph.reset();
+			render_resource backbuffer = graph.importBackbuffer("backbuffer", width, height);
+			render_resource color = graph.createTexture("color", desc);
+			graph.addPass("scene", [&](render_pass_builder& builder) { builder.write(color); }, drawScene);
+			graph.addPass("post", [&](render_pass_builder& builder) { builder.read(color); builder.write(backbuffer); }, drawPost);
+			graph.compile();
+			graph.execute();
+	*/
+	class render_graph
+	{
+	public:
+		typedef std::function<void(render_pass_builder& builder)> setup_callback;
+		typedef std::function<void(const render_pass_context& context)> execute_callback;
+
+		static constexpr render_resource INVALID_RESOURCE = 0xFFFFFFFFu;
+
+		/*
+			The physical objects unused for "poolLifetime" frames are released
+		*/
+		explicit render_graph(unsigned int poolLifetime = 3) : m_poolLifetime(poolLifetime) {}
+		~render_graph();
+
+		render_graph(const render_graph& copy) = delete; // copy constructor
+		render_graph(render_graph&& move) noexcept = delete; // move constructor
+		render_graph& operator=(const render_graph& copy) = delete; // copy assignment
+		render_graph& operator=(render_graph&&) = delete; // move assigment
+
+		/*
+			Transient resources (the graph owns them)
+		*/
+		render_resource createTexture(const char* name, const render_texture_desc& desc);
+		render_resource createBuffer(const char* name, GLsizeiptr size);
+
+		/*
+			Imported resources (owned by the caller). A pass that writes them is never culled.
+		*/
+		render_resource importTexture(const char* name, GLuint texture, const render_texture_desc& desc);
+		render_resource importBuffer(const char* name, GLuint buffer, GLsizeiptr size);
+		render_resource importBackbuffer(const char* name, int width, int height, GLuint framebuffer = 0);
+
+		/*
+			The setup is called immediately and the execution is called by execute()
+		*/
+		unsigned int addPass(const char* name, const setup_callback& setup, const execute_callback& execute);
+
+		/*
+			It returns false if the graph is invalid (an invalid handle or incompatible attachments)
+		*/
+		bool compile();
+
+		/*
+			It must be called after compile, with a current rendering context
+		*/
+		void execute();
+
+		/*
+			Remove the passes and the resources (the pool of physical objects is kept)
+		*/
+		void reset();
+
+		/*
+			Release the pool (with a current rendering context)
+		*/
+		void releasePool();
+
+		/*
+			Results of compile
+		*/
+		const std::vector<unsigned int>& getExecutionOrder() const { return m_order; }
+		bool isPassCulled(unsigned int pass) const { return m_passes[pass].culled; }
+		unsigned int getPassCount() const { return static_cast<unsigned int>(m_passes.size()); }
+
+		/*
+			Index of the physical object of a transient resource (-1 if it is imported or not used)
+		*/
+		int getPhysicalIndex(render_resource resource) const { return m_resources[resource].physical; }
+
+		/*
+			Positions in the execution order of the first and the last pass that use the resource
+		*/
+		unsigned int getFirstUse(render_resource resource) const { return m_resources[resource].firstUse; }
+		unsigned int getLastUse(render_resource resource) const { return m_resources[resource].lastUse; }
+
+		const render_graph_stats& getStats() const { return m_stats; }
+		size_t getPoolSize() const { return m_pool.size(); }
+
+	private:
+		friend class render_pass_builder;
+		friend class render_pass_context;
+
+		struct resource
+		{
+			const char* name = nullptr;
+			RENDER_RESOURCE_TYPE type = RENDER_RESOURCE_TYPE::TEXTURE;
+			render_texture_desc texture;
+			GLsizeiptr size = 0;
+			bool imported = false;
+			bool backbuffer = false;
+			GLuint object = 0; // the imported object or the framebuffer of the backbuffer
+			int physical = -1;
+			unsigned int firstUse = 0;
+			unsigned int lastUse = 0;
+			bool used = false;
+		};
+
+		struct pass
+		{
+			const char* name = nullptr;
+			execute_callback execute;
+			std::vector<render_resource> reads;
+			std::vector<render_resource> writes;
+			bool sideEffect = false;
+			bool culled = true;
+		};
+
+		struct physical_resource
+		{
+			RENDER_RESOURCE_TYPE type = RENDER_RESOURCE_TYPE::TEXTURE;
+			render_texture_desc texture;
+			GLsizeiptr size = 0;
+			unsigned int lastUse = 0;
+			GLuint object = 0; // set by execute
+		};
+
+		struct pooled_object
+		{
+			RENDER_RESOURCE_TYPE type = RENDER_RESOURCE_TYPE::TEXTURE;
+			render_texture_desc texture;
+			GLsizeiptr size = 0;
+			GLuint object = 0;
+			uint64_t lastFrame = 0;
+		};
+
+		render_resource addResource(const resource& current);
+		bool isValid(render_resource handle) const { return handle < m_resources.size(); }
+		void cullAndSort();
+		void computeLifetimes();
+		void alias();
+		void acquireObjects();
+		GLuint getFramebuffer(const std::vector<GLuint>& colors, GLuint depth, GLenum depthAttachment);
+		void releaseObject(const pooled_object& object);
+		GLuint getObject(render_resource handle) const;
+
+		std::vector<resource> m_resources;
+		std::vector<pass> m_passes;
+		bool m_valid = true; // false if a declaration was invalid
+
+		std::vector<unsigned int> m_order;
+		std::vector<physical_resource> m_physical;
+		render_graph_stats m_stats;
+		bool m_compiled = false;
+
+		unsigned int m_poolLifetime = 3;
+		uint64_t m_frame = 0;
+		std::vector<pooled_object> m_pool;
+		std::map<std::vector<GLuint>, GLuint> m_framebuffers; // attachments (colors, then depth) -> framebuffer
+	};
+}
+
+#endif
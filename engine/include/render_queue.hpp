@@ -0,0 +1,175 @@
+/*
+	K-Engine Render Queue
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_RENDER_QUEUE_HPP
+#define K_ENGINE_RENDER_QUEUE_HPP
+
+#include <gl_wrapper.hpp>
+#include <gl_state.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		Draw packet of the render queue (the state is referenced, not copied)
+	*/
+	struct render_packet
+	{
+		GLuint program = 0;
+		uint32_t material = 0;
+		const mesh_node* node = nullptr;
+		const void* userData = nullptr; // e.g. the per-object uniform data used by the submitter
+	};
+
+	struct render_queue_stats
+	{
+		size_t packets = 0;
+		unsigned int programChanges = 0;
+		unsigned int materialChanges = 0;
+		unsigned int sortPasses = 0; // the radix passes of the bytes that are the same in all keys are skipped
+	};
+
+	/*
+		kengine::render_queue collects the draw packets of a frame, sorts them by a 64-bit key (LSD radix sort)
+		and submits them in the order that minimizes the state changes.
+
+		Key layout (from the most significant bit):
+
+			opaque:       layer (4) | pass (4) | 0 | program (10) | material (12) | vertex format (6) | depth (27)
+			translucent:  layer (4) | pass (4) | 1 | inverted depth (27) | program (10) | material (12) | vertex format (6)
+
+		The opaque packets are grouped by state and drawn front-to-back inside each group (early depth test),
+		the translucent packets are drawn back-to-front after the opaque packets of the same pass. The program,
+		material and vertex format fields are sort identifiers masked to their widths (a collision only costs a
+		state change, the submitter compares the real values).
+	*/
+	class render_queue
+	{
+	public:
+		static constexpr int LAYER_BITS = 4;
+		static constexpr int PASS_BITS = 4;
+		static constexpr int PROGRAM_BITS = 10;
+		static constexpr int MATERIAL_BITS = 12;
+		static constexpr int VERTEX_FORMAT_BITS = 6;
+		static constexpr int DEPTH_BITS = 27;
+
+		render_queue() {}
+		~render_queue() {}
+
+		render_queue(const render_queue& copy) = delete; // copy constructor
+		render_queue(render_queue&& move) noexcept = delete; // move constructor
+		render_queue& operator=(const render_queue& copy) = delete; // copy assignment
+		render_queue& operator=(render_queue&&) = delete; // move assigment
+
+		/*
+			The depth is the normalized view distance [0, 1] (it is clamped)
+		*/
+		static uint64_t makeKey(unsigned int layer, unsigned int pass, bool translucent, unsigned int program, unsigned int material, unsigned int vertexFormat, float depth);
+
+		/*
+			The memory is kept between the frames, so the queue doesn't allocate after the first frames
+		*/
+		void clear();
+		void reserve(size_t count);
+		void push(uint64_t key, const render_packet& packet);
+
+		void sort();
+
+		size_t size() const { return m_packets.size(); }
+
+		/*
+			Packets in the sorted order (after sort)
+		*/
+		const render_packet& getPacket(size_t index) const { return m_packets[m_order[index]]; }
+		uint64_t getKey(size_t index) const { return m_keys[index]; }
+
+		/*
+			The submitter receives the state changes and the draws in the sorted order:
+
+				void setProgram(GLuint program);
+				void setMaterial(uint32_t material);
+				void draw(const render_packet& packet);
+		*/
+		template <typename Submitter>
+		void submit(Submitter& submitter) {
+			for (size_t index = 0; index < m_order.size(); index++) {
+				const render_packet& packet = m_packets[m_order[index]];
+
+				if (index == 0 || packet.program != m_packets[m_order[index - 1]].program) {
+					submitter.setProgram(packet.program);
+					m_stats.programChanges++;
+				}
+
+				if (index == 0 || packet.material != m_packets[m_order[index - 1]].material) {
+					submitter.setMaterial(packet.material);
+					m_stats.materialChanges++;
+				}
+
+				submitter.draw(packet);
+			}
+		}
+
+		const render_queue_stats& getStats() const { return m_stats; }
+
+	private:
+		std::vector<uint64_t> m_keys; // sorted by sort()
+		std::vector<uint32_t> m_order; // packet index of each sorted key
+		std::vector<render_packet> m_packets;
+		std::vector<uint64_t> m_tempKeys;
+		std::vector<uint32_t> m_tempOrder;
+		render_queue_stats m_stats;
+	};
+
+	/*
+		OpenGL submitter of the render queue (the material binding and the per-object state are set by the application)
+	*/
+	struct gl_render_submitter
+	{
+		std::function<void(uint32_t)> bindMaterial;
+		std::function<void(const render_packet&)> beforeDraw;
+
+		void setProgram(GLuint program) { kengine::glState().useProgram(program); }
+
+		void setMaterial(uint32_t material) {
+			if (bindMaterial)
+				bindMaterial(material);
+		}
+
+		void draw(const render_packet& packet) {
+			if (beforeDraw)
+				beforeDraw(packet);
+
+			if (packet.node)
+				packet.node->drawArrays();
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,144 @@
+/*
+	K-Engine Render Thread
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_RENDER_THREAD_HPP
+#define K_ENGINE_RENDER_THREAD_HPP
+
+#include <rendering_system.hpp>
+#include <command_buffer.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		Everything the render thread needs to draw a frame. It is written by the simulation and it is immutable
+		after render_thread::endFrame (the render thread only reads it).
+	*/
+	struct frame_packet
+	{
+		uint64_t frame = 0;
+		int64_t frameTime = 0;
+		std::vector<command_buffer> commandBuffers; // replayed in order
+
+		/*
+			The command buffers are kept (only reset), so the packets don't allocate after the first frames
+		*/
+		void reset();
+	};
+
+	struct render_thread_stats
+	{
+		uint64_t frames = 0;
+		uint64_t simulationStalls = 0; // endFrame waited for the render thread (the GPU side is the bottleneck)
+		uint64_t renderStalls = 0; // the render thread waited for a packet (the simulation is the bottleneck)
+		int64_t lastRenderTime = 0; // high resolution counter
+	};
+
+	/*
+		kengine::render_thread is the optional pipelined mode of the main loop. The render thread owns the
+		rendering context and draws the frame N while the main thread simulates the frame N + 1.
+
+		There are two frame packets: the main thread writes one while the render thread reads the other.
+		endFrame blocks until the previous packet is drawn, so the render thread is never more than one
+		frame behind (bounded latency). The sync points are:
+
+			- endFrame: the packet is published (it must not be changed after it)
+			- sync: waits until every published packet and task is done (e.g. before the resources are deleted)
+			- stop: the rendering context is current on the main thread again
+
+		While the render thread runs, the main thread must not call OpenGL: the GL work (e.g. resource creation)
+		is sent by enqueue and runs on the render thread before the next frame.
+		The state cache (kengine::glState) belongs to the render thread between start and stop, and to the main
+		thread again after stop, so the objects are deleted on the render thread (e.g. by an enqueued task).
+	*/
+	class render_thread
+	{
+	public:
+		/*
+			"render" is called on the render thread after the command buffers of the packet (e.g. to draw the GUI)
+		*/
+		explicit render_thread(rendering_system* renderingSystem, std::function<void(const frame_packet&)> render = nullptr);
+		~render_thread();
+
+		render_thread(const render_thread& copy) = delete; // copy constructor
+		render_thread(render_thread&& move) noexcept = delete; // move constructor
+		render_thread& operator=(const render_thread& copy) = delete; // copy assignment
+		render_thread& operator=(render_thread&&) = delete; // move assigment
+
+		/*
+			The rendering context is released by the main thread and made current on the render thread
+		*/
+		bool start();
+		void stop();
+		bool isRunning() const { return m_thread.joinable(); }
+
+		/*
+			Packet of the next frame (main thread only)
+		*/
+		frame_packet& beginFrame(int64_t frameTime);
+		void endFrame();
+
+		void sync();
+
+		/*
+			Run a GL task on the render thread before the next frame (or immediately if the thread is not running)
+		*/
+		void enqueue(std::function<void()> task);
+
+		render_thread_stats getStats() const;
+
+	private:
+		void run();
+		void runTasks();
+
+		rendering_system* m_renderingSystem = nullptr;
+		std::function<void(const frame_packet&)> m_render;
+
+		frame_packet m_packets[2];
+		int m_writeIndex = 0;
+		int m_published = -1; // packet waiting for the render thread
+		int m_rendering = -1; // packet being drawn
+		bool m_runningTasks = false;
+		uint64_t m_frame = 0;
+
+		std::thread m_thread;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_running = false;
+		bool m_contextReady = false;
+		bool m_contextFailed = false;
+		std::vector<std::function<void()>> m_tasks;
+		render_thread_stats m_stats;
+	};
+}
+
+#endif
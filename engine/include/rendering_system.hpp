@@ -23,6 +23,9 @@
 	SOFTWARE.
 */
 
+#ifndef K_ENGINE_RENDERING_SYSTEM_HPP
+#define K_ENGINE_RENDERING_SYSTEM_HPP
+
 #include <gl_wrapper.hpp>
 
 namespace kengine
@@ -48,6 +51,11 @@ namespace kengine
 	{
 	public:
 		explicit rendering_system(window* win);
+
+		/*
+			The rendering system takes the ownership of the context (e.g. kengine::headless_rendering_context)
+		*/
+		explicit rendering_system(rendering_context* context);
 		~rendering_system();
 
 		rendering_system(const rendering_system& copy) = delete; // copy constructor
@@ -60,10 +68,29 @@ namespace kengine
 		void swapBuffers();
 		void clearBuffers();
 
+		/*
+			Make the rendering context current (or release it) on the calling thread (see kengine::render_thread)
+		*/
+		int makeCurrent(bool enable);
+
+		/*
+			Called once per frame before rendering: it resets the per-frame counters of the GPU
+			resource managers (kengine::vertex_format_registry and kengine::gpu_memory_tracker)
+			and reads back the GPU timers of an old frame (kengine::gpu_profiler)
+		*/
+		void newFrame();
+
+		/*
+			Create a context that shares the objects with the rendering context (see kengine::upload_worker)
+		*/
+		rendering_context* createSharedContext();
+
 		std::string info(bool extension);
 
 	private:
 		RENDERING_TYPE m_type = RENDERING_TYPE::OPENGL;
 		rendering_context* m_context = nullptr;
 	};
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*
+	K-Engine Shader Batch
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_SHADER_BATCH_HPP
+#define K_ENGINE_SHADER_BATCH_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		kengine::shader_batch compiles and links many programs without serializing the driver's compiler.
+
+		add() issues the compilation and the link of all stages at once and never queries the status. With
+		GL_KHR_parallel_shader_compile the driver compiles on its own threads and update() polls
+		GL_COMPLETION_STATUS_KHR, so it never blocks. Without the extension the status query waits for the
+		compiler, so update() finishes at most "maxBlockingPerUpdate" programs per call.
+
+		The program object of a GLSLprogram is replaced only when the new one is linked successfully,
+		so a failed (re)compilation keeps the previous program.
+	*/
+	class shader_batch
+	{
+	public:
+		shader_batch();
+		~shader_batch();
+
+		shader_batch(const shader_batch& copy) = delete; // copy constructor
+		shader_batch(shader_batch&& move) noexcept = delete; // move constructor
+		shader_batch& operator=(const shader_batch& copy) = delete; // copy assignment
+		shader_batch& operator=(shader_batch&&) = delete; // move assigment
+
+		/*
+			The program must live until the completion callback is called
+		*/
+		void add(GLSLprogram& program, const ShaderInfo* shaders, std::function<void(bool)> completion = nullptr);
+
+		/*
+			Discard the pending programs of "program" (e.g. before it is destroyed). Their completion callbacks
+			are not called. It returns the number of discarded programs.
+		*/
+		int cancel(const GLSLprogram& program);
+
+		/*
+			Called once per frame. It returns the number of programs that were completed.
+		*/
+		int update(int maxBlockingPerUpdate = 4);
+
+		/*
+			Wait for all programs (e.g. behind a loading screen)
+		*/
+		void finish();
+
+		size_t getPendingCount() const { return m_pending.size(); }
+		bool isParallel() const { return m_parallel; }
+
+	private:
+		struct pending_program
+		{
+			GLSLprogram* program = nullptr;
+			std::string owner;
+			GLuint handle = 0;
+			GLuint shaders[6] = { 0 };
+			GLuint types[6] = { 0 };
+			uint64_t key = 0;
+			bool cached = false; // the program was created from the program cache
+			GLenum binaryFormat = 0;
+			uniform_table uniforms; // reflection from the program cache
+			std::function<void(bool)> completion;
+		};
+
+		void complete(pending_program& pending);
+		static void discard(pending_program& pending);
+
+		std::vector<pending_program> m_pending;
+		bool m_parallel = false;
+	};
+}
+
+#endif
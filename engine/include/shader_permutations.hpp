@@ -0,0 +1,94 @@
+/*
+	K-Engine Shader Permutations
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_SHADER_PERMUTATIONS_HPP
+#define K_ENGINE_SHADER_PERMUTATIONS_HPP
+
+#include <gl_wrapper.hpp>
+#include <shader_preprocessor.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace kengine
+{
+	class shader_watcher;
+
+	/*
+		kengine::shader_permutations holds the variants of a program (the same stages with different define sets).
+
+		A permutation is compiled on its first use, so only the variants that are really drawn are paid for.
+		The programs are deduplicated by the hash of the preprocessed sources: define sets that produce the
+		same sources (e.g. defines that are not used by the stages) share a program. With the offline SPIR-V
+		modules the variants are selected by specialization constants instead of defines.
+
+		It must be used with a current rendering context.
+	*/
+	class shader_permutations
+	{
+	public:
+		/*
+			The stages are terminated by GL_NONE (their defines are ignored)
+		*/
+		explicit shader_permutations(const ShaderInfo* shaders);
+		~shader_permutations();
+
+		shader_permutations(const shader_permutations& copy) = delete; // copy constructor
+		shader_permutations(shader_permutations&& move) noexcept = delete; // move constructor
+		shader_permutations& operator=(const shader_permutations& copy) = delete; // copy assignment
+		shader_permutations& operator=(shader_permutations&&) = delete; // move assigment
+
+		/*
+			It returns nullptr if the permutation doesn't link (it is not compiled again until its files change)
+		*/
+		GLSLprogram* get(const shader_define_set& defines);
+
+		/*
+			SPIR-V permutation: the constants of each stage in the order of the stages (a missing entry is an empty set).
+			It returns nullptr if the modules cannot be loaded (see GLSLprogram::loadSPIRVShaders).
+		*/
+		GLSLprogram* getSpecialized(const std::vector<specialization_constants>& constants);
+
+		/*
+			The new programs are watched for hot reload (the watcher must outlive the permutations)
+		*/
+		void setWatcher(shader_watcher* watcher) { m_watcher = watcher; }
+
+		size_t getPermutationCount() const { return m_permutations.size(); }
+		size_t getProgramCount() const { return m_programs.size() + m_specializations.size(); }
+
+	private:
+		std::vector<ShaderInfo> m_shaders; // terminated by GL_NONE
+		std::map<uint64_t, GLSLprogram*> m_permutations; // define set key -> program
+		std::map<uint64_t, std::unique_ptr<GLSLprogram>> m_programs; // hash of the preprocessed sources -> program
+		std::map<uint64_t, std::unique_ptr<GLSLprogram>> m_specializations; // hash of the constants of all stages -> program
+		shader_watcher* m_watcher = nullptr;
+	};
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+	K-Engine Shader Preprocessor
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_SHADER_PREPROCESSOR_HPP
+#define K_ENGINE_SHADER_PREPROCESSOR_HPP
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		kengine::shader_define_set is the set of defines of a shader permutation.
+
+		The defines are sorted by name, so the key and the generated source don't depend on the order of the calls to set().
+	*/
+	class shader_define_set
+	{
+	public:
+		shader_define_set& set(const std::string& name, const std::string& value = "1");
+		void remove(const std::string& name);
+
+		bool empty() const { return m_defines.empty(); }
+		size_t size() const { return m_defines.size(); }
+
+		/*
+			Deterministic 64-bit key of the permutation (the empty set is always 0)
+		*/
+		uint64_t getKey() const;
+
+		/*
+			One "#define NAME VALUE" line per define
+		*/
+		std::string toString() const;
+
+	private:
+		std::map<std::string, std::string> m_defines;
+	};
+
+	/*
+		kengine::shader_preprocessor prepares the GLSL source before it is sent to the driver:
+
+			- #include "file" (or <file>) is replaced by the file, searched relative to the including file and then in the include directories
+			- each file is included only once per stage, so the include guards are not needed (and cycles are not possible)
+			- the defines are injected after the #version directive
+			- #line directives keep the line numbers of the driver logs (the source string number is the index in the dependency list)
+
+		The includes are resolved before the conditional directives, so a file included inside an #ifdef block
+		is always a dependency. The files are read once and kept in a source cache until they are invalidated
+		(e.g. by the shader watcher).
+	*/
+	class shader_preprocessor
+	{
+	public:
+		shader_preprocessor() {}
+		~shader_preprocessor() {}
+
+		shader_preprocessor(const shader_preprocessor& copy) = delete; // copy constructor
+		shader_preprocessor(shader_preprocessor&& move) noexcept = delete; // move constructor
+		shader_preprocessor& operator=(const shader_preprocessor& copy) = delete; // copy assignment
+		shader_preprocessor& operator=(shader_preprocessor&&) = delete; // move assigment
+
+		void addIncludeDirectory(const std::string& directory);
+
+		/*
+			The dependencies are the canonical paths of the file (first) and of all included files.
+			It returns false (and logs the error) if a file cannot be opened.
+		*/
+		bool process(const std::string& filename, const std::string& defines, std::string& output, std::vector<std::string>* dependencies = nullptr);
+
+		/*
+			Remove a file from the source cache (it is read again by the next process call)
+		*/
+		void invalidate(const std::string& filename);
+		void clear();
+
+		size_t getCachedFileCount() const;
+
+	private:
+		bool getSource(const std::string& path, std::string& source);
+		std::string resolveInclude(const std::string& name, const std::string& includingPath) const;
+		bool expand(size_t fileIndex, const std::string& defines, std::vector<std::string>& files, std::string& output);
+
+		mutable std::mutex m_mutex; // the shaders can be loaded by the upload worker
+		std::vector<std::string> m_includeDirectories;
+		std::map<std::string, std::string> m_sources; // canonical path -> source
+	};
+
+	/*
+		Global shader preprocessor used by GLSLprogram::loadShaders and kengine::shader_batch
+	*/
+	shader_preprocessor& shaderPreprocessor();
+}
+
+#endif
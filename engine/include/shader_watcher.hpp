@@ -0,0 +1,109 @@
+/*
+	K-Engine Shader Watcher
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_SHADER_WATCHER_HPP
+#define K_ENGINE_SHADER_WATCHER_HPP
+
+#include <gl_wrapper.hpp>
+#include <shader_batch.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		kengine::shader_watcher reloads the programs when their source files change (hot reload).
+
+		A background thread waits for the file events (inotify on Linux) and update(), called by the main
+		thread at the beginning of the frame, recompiles the changed programs with a kengine::shader_batch.
+		The new program replaces the old one at a frame boundary and only if the link succeeds, so a
+		broken shader never stops the rendering. The latency between the file event and the swap is logged.
+
+		It must be created with a current rendering context.
+
+		Note: the file events are not supported on the other platforms yet (the watcher does nothing).
+	*/
+	class shader_watcher
+	{
+	public:
+		shader_watcher();
+		~shader_watcher();
+
+		shader_watcher(const shader_watcher& copy) = delete; // copy constructor
+		shader_watcher(shader_watcher&& move) noexcept = delete; // move constructor
+		shader_watcher& operator=(const shader_watcher& copy) = delete; // copy assignment
+		shader_watcher& operator=(shader_watcher&&) = delete; // move assigment
+
+		/*
+			The callback is called after each reload (e.g. to bind the new program and to resolve the uniform handles again)
+		*/
+		void watch(GLSLprogram& program, const ShaderInfo* shaders, std::function<void(bool)> reloaded = nullptr);
+
+		/*
+			The reloads of the program that are still compiling are discarded, so the program can be destroyed after it
+		*/
+		void unwatch(GLSLprogram& program);
+
+		/*
+			Files that the program depends on besides its stages and their includes
+		*/
+		void addDependency(GLSLprogram& program, const std::string& filename);
+
+		void update();
+
+		bool isEnabled() const { return m_fd >= 0; }
+
+	private:
+		struct watched_program
+		{
+			GLSLprogram* program = nullptr;
+			std::vector<ShaderInfo> shaders; // terminated by GL_NONE
+			std::vector<std::string> files; // canonical paths of the stages and the dependencies
+			std::function<void(bool)> reloaded;
+		};
+
+		void run();
+		void addIncludes(watched_program& watched);
+		void addFile(watched_program& watched, const std::string& filename);
+
+		std::vector<watched_program> m_programs;
+		std::map<int, std::string> m_directories; // watch descriptor -> canonical directory
+		shader_batch m_batch;
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		bool m_running = false;
+		int m_fd = -1;
+		std::map<std::string, int64_t> m_changed; // canonical path -> time of the last event (high resolution counter)
+	};
+}
+
+#endif
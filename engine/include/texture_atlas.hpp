@@ -0,0 +1,209 @@
+/*
+	K-Engine Texture Atlas
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_TEXTURE_ATLAS_HPP
+#define K_ENGINE_TEXTURE_ATLAS_HPP
+
+#include <gl_wrapper.hpp>
+#include <mesh.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kengine
+{
+	struct atlas_rect
+	{
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+	};
+
+	/*
+		kengine::skyline_packer packs rectangles into a fixed area with the skyline bottom-left heuristic.
+
+		The skyline is the top edge of the packed rectangles: a new rectangle is placed on the segment where
+		its top is the lowest (the narrowest segment on a tie). It doesn't depend on OpenGL, so the offline
+		tools can use it too.
+	*/
+	class skyline_packer
+	{
+	public:
+		skyline_packer(int width = 0, int height = 0) { reset(width, height); }
+
+		void reset(int width, int height);
+
+		/*
+			It returns false if the rectangle doesn't fit
+		*/
+		bool insert(int width, int height, atlas_rect& rect);
+
+		int getWidth() const { return m_width; }
+		int getHeight() const { return m_height; }
+
+		/*
+			Packed area over the total area
+		*/
+		float getOccupancy() const;
+
+	private:
+		struct skyline_node
+		{
+			int x;
+			int y;
+			int width;
+		};
+
+		bool fit(size_t index, int width, int height, int& y) const;
+
+		std::vector<skyline_node> m_skyline; // sorted by x, without gaps
+		int m_width = 0;
+		int m_height = 0;
+		size_t m_usedArea = 0;
+	};
+
+	/*
+		Texture coordinates of an image in its texture array: uv * scale + offset, in the layer "layer"
+	*/
+	struct atlas_region
+	{
+		int group = -1;
+		int layer = 0;
+		float offset[2] = { 0.0f, 0.0f };
+		float scale[2] = { 1.0f, 1.0f };
+	};
+
+	struct texture_array_stats
+	{
+		unsigned int groups = 0;
+		unsigned int layers = 0;
+		unsigned int images = 0;
+		size_t residentBytes = 0;
+		float occupancy = 0.0f; // packed area over the area of the layers
+	};
+
+	typedef uint32_t atlas_image;
+
+	/*
+		kengine::texture_array_atlas groups the images of the same format into GL_TEXTURE_2D_ARRAY textures.
+
+		The images are packed into the layers by a skyline packer, with a border of "padding" texels that
+		repeats the edges of each image (so the bilinear filter doesn't bleed the neighbours). The mip chain
+		stops at the level where the border is one texel wide, and the images are aligned to it. An image of
+		the size of the layer takes a whole layer without border, so its texture coordinates can repeat.
+		The coordinates of the other images must stay in [0, 1].
+
+		All the images of a group are drawn with one bind: the meshes get the region of their image at load
+		time (see remapTexCoords) and the shader samples a sampler2DArray with (u, v, layer). The images that
+		are added after build are packed into the free space of the layers (new layers are appended).
+
+		It must be used with a current rendering context.
+	*/
+	class texture_array_atlas
+	{
+	public:
+		static constexpr atlas_image INVALID_IMAGE = 0xFFFFFFFFu;
+
+		explicit texture_array_atlas(int layerSize = 1024, int padding = 4);
+		~texture_array_atlas();
+
+		texture_array_atlas(const texture_array_atlas& copy) = delete; // copy constructor
+		texture_array_atlas(texture_array_atlas&& move) noexcept = delete; // move constructor
+		texture_array_atlas& operator=(const texture_array_atlas& copy) = delete; // copy assignment
+		texture_array_atlas& operator=(texture_array_atlas&&) = delete; // move assigment
+
+		/*
+			The pixels are tightly packed RGBA8 rows. The image is uploaded by the next build.
+		*/
+		atlas_image add(const std::string& name, int width, int height, std::vector<unsigned char> pixels, GLenum format = GL_RGBA8);
+
+		/*
+			Pack and upload the images added since the last build (it returns false if an image doesn't fit in a layer)
+		*/
+		bool build();
+
+		/*
+			Valid after the build of the image
+		*/
+		const atlas_region& getRegion(atlas_image image) const { return m_images[image].region; }
+
+		int getGroupCount() const { return static_cast<int>(m_groups.size()); }
+		GLuint getTexture(int group) const { return m_groups[group].texture; }
+		GLenum getFormat(int group) const { return m_groups[group].format; }
+		int getLayerCount(int group) const { return static_cast<int>(m_groups[group].layers.size()); }
+		int getAllocatedLayers(int group) const { return m_groups[group].allocatedLayers; }
+		int getLevelCount() const { return m_levels; }
+		int getLayerSize() const { return m_layerSize; }
+
+		bool bind(GLuint unit, int group) const;
+
+		texture_array_stats getStats() const;
+
+	private:
+		struct atlas_entry
+		{
+			std::string name;
+			int width = 0;
+			int height = 0;
+			GLenum format = GL_RGBA8;
+			std::vector<unsigned char> pixels; // released by the build
+			atlas_region region;
+			bool built = false;
+		};
+
+		struct atlas_group
+		{
+			GLenum format = GL_RGBA8;
+			GLuint texture = 0;
+			std::vector<skyline_packer> layers;
+			int allocatedLayers = 0; // layers of the texture storage
+		};
+
+		int findGroup(GLenum format);
+		bool place(atlas_group& group, int width, int height, atlas_rect& rect, int& layer);
+		void grow(atlas_group& group);
+		void upload(const atlas_group& group, const atlas_entry& entry, const atlas_rect& rect, int layer, int padding);
+
+		std::vector<atlas_entry> m_images;
+		std::vector<atlas_group> m_groups;
+		int m_layerSize = 1024;
+		int m_padding = 4;
+		int m_levels = 1;
+		int m_alignment = 1;
+	};
+
+	/*
+		Map the texture coordinates of the mesh (at the location "location") to the region of its image. With
+		"layerComponent", the coordinates get a third component with the layer (vec3 in the vertex shader).
+		It must be called at load time, before the mesh is uploaded.
+	*/
+	bool remapTexCoords(mesh& m, const atlas_region& region, size_t location = 2, bool layerComponent = true);
+}
+
+#endif
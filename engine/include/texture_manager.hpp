@@ -0,0 +1,220 @@
+/*
+	K-Engine Texture Manager
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_TEXTURE_MANAGER_HPP
+#define K_ENGINE_TEXTURE_MANAGER_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace kengine
+{
+	class upload_worker; // forward declaration
+
+	/*
+		The loaded levels are tightly packed rows of "pixelFormat" and "pixelType" (compressed formats are not supported)
+	*/
+	struct texture_desc
+	{
+		int width = 0;
+		int height = 0;
+		int levels = 0; // 0: the full mip chain
+		GLenum format = GL_RGBA8;
+		GLenum pixelFormat = GL_RGBA;
+		GLenum pixelType = GL_UNSIGNED_BYTE;
+		int bytesPerPixel = 4; // of the loaded levels and of the storage
+	};
+
+	struct sampler_desc
+	{
+		GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR;
+		GLenum magFilter = GL_LINEAR;
+		GLenum wrapS = GL_REPEAT;
+		GLenum wrapT = GL_REPEAT;
+		float maxAnisotropy = 1.0f; // ignored without GL_ARB_texture_filter_anisotropic
+
+		bool operator<(const sampler_desc& other) const;
+	};
+
+	struct texture_manager_stats
+	{
+		size_t residentBytes = 0;
+		unsigned int pendingUploads = 0; // textures waiting for more levels (queued or in flight)
+		unsigned int evictions = 0; // evicted levels (since the creation of the manager)
+		unsigned int uploads = 0; // loaded levels (since the creation of the manager)
+		size_t frameUploadBytes = 0; // bytes scheduled by the last update
+		unsigned int textures = 0;
+		unsigned int samplers = 0;
+	};
+
+	typedef uint32_t texture_handle;
+
+	/*
+		kengine::texture_manager owns the textures and streams their mip levels under a memory budget.
+
+		The storage is immutable (glTextureStorage2D) and only holds the resident levels: the first level of
+		the texture object is the most detailed resident level, so a new level (or an eviction) allocates a new
+		texture and copies the resident levels into it with glCopyImageSubData. The texture coordinates don't
+		change, but the GL name does (see getTexture and bind).
+
+		The low levels (the tail, up to "tailSize" pixels) are loaded first and never evicted. The other levels
+		are loaded one at a time, from the textures that are the most magnified on the screen (the screen size
+		over the size of the resident level), while the resident bytes stay under the budget. Over the budget,
+		the levels that are more detailed than the screen needs are evicted first, then the levels of the least
+		magnified textures. The tracker budget (see gpu_memory_tracker::setBudget) evicts levels too.
+
+		The levels are loaded by the level loaders: on the thread of the upload worker if one is set, otherwise
+		in update. The manager must be used on the main thread, with a current rendering context.
+	*/
+	class texture_manager
+	{
+	public:
+		/*
+			It fills the pixels of a level (see texture_desc) and returns false if the level can't be loaded.
+			It is called on the thread of the upload worker (one call at a time for a texture).
+		*/
+		typedef std::function<bool(int level, std::vector<unsigned char>& pixels)> level_loader;
+
+		static constexpr texture_handle INVALID_TEXTURE = 0xFFFFFFFFu;
+
+		explicit texture_manager(size_t budget = 256 * 1024 * 1024, int tailSize = 64);
+		~texture_manager();
+
+		texture_manager(const texture_manager& copy) = delete; // copy constructor
+		texture_manager(texture_manager&& move) noexcept = delete; // move constructor
+		texture_manager& operator=(const texture_manager& copy) = delete; // copy assignment
+		texture_manager& operator=(texture_manager&&) = delete; // move assigment
+
+		void setUploadWorker(upload_worker* worker) { m_worker = worker; }
+
+		void setBudget(size_t bytes) { m_budget = bytes; }
+		size_t getBudget() const { return m_budget; }
+
+		/*
+			Bytes of levels scheduled per update (at least one level is scheduled)
+		*/
+		void setFrameUploadBudget(size_t bytes) { m_frameUploadBudget = bytes; }
+
+		/*
+			The tail is scheduled by the next update
+		*/
+		texture_handle create(const std::string& name, const texture_desc& desc, level_loader loader);
+		void destroy(texture_handle handle);
+
+		/*
+			Size of the texture on the screen in pixels (e.g. the longest side of the projected bounds), 0 if it
+			is not visible. It chooses the most detailed level that the texture needs.
+		*/
+		void setScreenSize(texture_handle handle, float pixels);
+
+		/*
+			Called once per frame: evictions and new uploads
+		*/
+		void update();
+
+		/*
+			Bind the texture and the sampler (it returns false if no level is resident yet)
+		*/
+		bool bind(GLuint unit, texture_handle handle, const sampler_desc& sampler = sampler_desc());
+
+		/*
+			Sampler object of the description (created on the first use)
+		*/
+		GLuint getSampler(const sampler_desc& desc);
+
+		GLuint getTexture(texture_handle handle) const { return m_textures[handle].texture; }
+		int getLevelCount(texture_handle handle) const { return m_textures[handle].desc.levels; }
+
+		/*
+			Most detailed resident level (the level count if nothing is resident)
+		*/
+		int getResidentLevel(texture_handle handle) const { return m_textures[handle].residentLevel; }
+		int getWantedLevel(texture_handle handle) const { return m_textures[handle].wantedLevel; }
+		int getTailLevel(texture_handle handle) const { return m_textures[handle].tailLevel; }
+
+		const texture_manager_stats& getStats() const { return m_stats; }
+
+	private:
+		struct texture_entry
+		{
+			std::string name;
+			texture_desc desc;
+			level_loader loader;
+			GLuint texture = 0;
+			int residentLevel = 0;
+			int tailLevel = 0;
+			int wantedLevel = 0;
+			float screenSize = 0.0f;
+			size_t residentBytes = 0;
+			bool busy = false; // a job is in flight
+			bool failed = false; // a level couldn't be loaded (no new attempt)
+			bool alive = false;
+		};
+
+		size_t getBytes(const texture_desc& desc, int firstLevel) const;
+		float getPriority(const texture_entry& entry) const;
+		void schedule(texture_handle handle, int level);
+		void finishJob(texture_handle handle, GLuint texture, int level, size_t extraBytes);
+		void replace(texture_entry& entry, GLuint texture, int level);
+		size_t evict(size_t bytes, float maxPriority);
+
+		std::vector<texture_entry> m_textures;
+		std::vector<texture_handle> m_freeHandles;
+		std::map<sampler_desc, GLuint> m_samplers;
+		upload_worker* m_worker = nullptr;
+
+		size_t m_budget = 0;
+		size_t m_frameUploadBudget = 4 * 1024 * 1024;
+		int m_tailSize = 64;
+		size_t m_residentBytes = 0;
+		size_t m_pendingBytes = 0; // levels being loaded
+		unsigned int m_inFlight = 0;
+		bool m_evicting = false;
+
+		int m_evictionCallback = -1;
+		std::thread::id m_mainThread;
+		std::atomic<size_t> m_deferredEviction{ 0 }; // requested by the tracker on another thread
+		std::shared_ptr<bool> m_token; // the jobs completed after the destruction of the manager only delete their texture
+
+		texture_manager_stats m_stats;
+	};
+
+	/*
+		Level loader of an RGBA8 image in memory: the levels are box filtered from the image once
+	*/
+	texture_manager::level_loader mipChainLoader(int width, int height, std::vector<unsigned char> pixels);
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+	K-Engine Thread Pool
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef K_ENGINE_THREAD_POOL_HPP
+#define K_ENGINE_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		kengine::thread_pool runs data parallel loops on a fixed set of worker threads.
+
+		The calling thread takes part in the loop and parallelFor returns after all chunks are done, so the
+		data of the caller can be used by the body without synchronization. A parallelFor called by a worker
+		(nested loop) or while another loop is running on the pool runs on the calling thread only.
+		The pool never touches the rendering context: the GL calls must stay on the GL thread.
+	*/
+	class thread_pool
+	{
+	public:
+		/*
+			The body receives the range [begin, end) and the index of the thread (0 is the calling thread)
+		*/
+		typedef std::function<void(size_t begin, size_t end, unsigned int thread)> loop_body;
+
+		/*
+			0 uses one worker less than the number of hardware threads (the calling thread is the last one)
+		*/
+		explicit thread_pool(unsigned int workerCount = 0);
+		~thread_pool();
+
+		thread_pool(const thread_pool& copy) = delete; // copy constructor
+		thread_pool(thread_pool&& move) noexcept = delete; // move constructor
+		thread_pool& operator=(const thread_pool& copy) = delete; // copy assignment
+		thread_pool& operator=(thread_pool&&) = delete; // move assigment
+
+		/*
+			Split [0, count) into chunks of "grain" elements (0 chooses a chunk per thread)
+		*/
+		void parallelFor(size_t count, const loop_body& body, size_t grain = 0);
+
+		/*
+			Number of threads that run a loop (the workers and the calling thread)
+		*/
+		unsigned int getThreadCount() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+	private:
+		struct loop
+		{
+			const loop_body* body = nullptr;
+			size_t count = 0;
+			size_t grain = 1;
+			size_t chunks = 0;
+			std::atomic<size_t> nextChunk{ 0 };
+			std::atomic<size_t> doneChunks{ 0 };
+		};
+
+		void run(unsigned int thread);
+		void runChunks(loop& current, unsigned int thread);
+
+		std::vector<std::thread> m_workers;
+		std::mutex m_mutex;
+		std::mutex m_loopMutex; // one loop at a time
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		loop* m_loop = nullptr;
+		unsigned int m_activeWorkers = 0; // workers that hold a pointer to the current loop
+		unsigned int m_generation = 0;
+		bool m_running = true;
+	};
+
+	/*
+		Global thread pool of the engine (created on the first use)
+	*/
+	thread_pool& threadPool();
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*
+	K-Engine Uniform Block
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_UNIFORM_BLOCK_HPP
+#define K_ENGINE_UNIFORM_BLOCK_HPP
+
+#include <gl_wrapper.hpp>
+#include <k_hash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+	Compare the offset of a member of a C++ block struct with the offset reflected from the program:
+
+		K_VALIDATE_BLOCK_MEMBER(cameraLayout, camera_block, projection);
+*/
+#define K_VALIDATE_BLOCK_MEMBER(layout, type, member) (layout).validateMember(K_HASH(#member), offsetof(type, member), #member)
+
+namespace kengine
+{
+	/*
+		Uniform blocks use the std140 layout and shader storage blocks use the std430 layout
+	*/
+	enum class BUFFER_BLOCK_TYPE
+	{
+		UNIFORM,
+		SHADER_STORAGE
+	};
+
+	struct buffer_block_member
+	{
+		std::string name; // without the block prefix and without the "[0]" suffix
+		uint32_t hash = 0; // kengine::fnv1a(name)
+		GLint offset = 0;
+		GLenum type = GL_NONE;
+		GLint arraySize = 1; // 0 for the unsized array of a shader storage block
+		GLint arrayStride = 0;
+		GLint matrixStride = 0;
+	};
+
+	/*
+		kengine::buffer_block_layout is the layout of a uniform or shader storage block reflected from a linked program
+	*/
+	class buffer_block_layout
+	{
+	public:
+		bool reflect(GLuint program, const std::string& blockName, BUFFER_BLOCK_TYPE type = BUFFER_BLOCK_TYPE::UNIFORM);
+
+		const std::string& getName() const { return m_name; }
+		GLint getDataSize() const { return m_dataSize; }
+		GLint getBinding() const { return m_binding; }
+
+		size_t getMemberCount() const { return m_members.size(); }
+		const buffer_block_member& getMember(size_t index) const { return m_members[index]; }
+		const buffer_block_member* findMember(uint32_t hash) const;
+
+		/*
+			It returns false (and logs the mismatch) if the C++ offset is not the reflected offset
+		*/
+		bool validateMember(uint32_t hash, size_t offset, const char* name) const;
+		bool validateSize(size_t size) const;
+
+		/*
+			C++ struct that matches the reflected layout (explicit padding included)
+		*/
+		std::string generateStruct(const std::string& structName) const;
+
+	private:
+		std::string m_name;
+		GLint m_dataSize = 0;
+		GLint m_binding = 0;
+		std::vector<buffer_block_member> m_members; // sorted by offset
+	};
+
+	/*
+		Region of the uniform ring buffer
+	*/
+	struct ring_allocation
+	{
+		GLuint buffer = 0;
+		GLintptr offset = 0;
+		GLsizeiptr size = 0;
+		void* data = nullptr;
+
+		bool isValid() const { return data != nullptr; }
+	};
+
+	struct uniform_ring_stats
+	{
+		GLsizeiptr usedBytes = 0;
+		unsigned int allocations = 0;
+		unsigned int stalls = 0; // the frame region was still in use by the GPU
+		unsigned int overflows = 0;
+	};
+
+	/*
+		kengine::uniform_ring_buffer is a persistently mapped buffer split into one region per frame in flight.
+
+		The block data is written directly into the mapped memory and bound by glBindBufferRange. A fence
+		protects each region, so the CPU only waits if it is more than "frameCount" frames ahead of the GPU.
+		It must be created and deleted with a current rendering context.
+	*/
+	class uniform_ring_buffer
+	{
+	public:
+		explicit uniform_ring_buffer(GLsizeiptr frameSize = 256 * 1024, int frameCount = 3);
+		~uniform_ring_buffer();
+
+		uniform_ring_buffer(const uniform_ring_buffer& copy) = delete; // copy constructor
+		uniform_ring_buffer(uniform_ring_buffer&& move) noexcept = delete; // move constructor
+		uniform_ring_buffer& operator=(const uniform_ring_buffer& copy) = delete; // copy assignment
+		uniform_ring_buffer& operator=(uniform_ring_buffer&&) = delete; // move assigment
+
+		/*
+			beginFrame waits for the region of the frame (if needed) and endFrame protects it with a fence
+		*/
+		void beginFrame();
+		void endFrame();
+
+		/*
+			The offset is aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. The allocation is invalid if the region is full.
+		*/
+		ring_allocation allocate(GLsizeiptr size);
+
+		template <typename T>
+		ring_allocation write(const T& block) {
+			ring_allocation allocation = allocate(static_cast<GLsizeiptr>(sizeof(T)));
+
+			if (allocation.isValid())
+				std::memcpy(allocation.data, &block, sizeof(T));
+
+			return allocation;
+		}
+
+		void bind(GLuint binding, const ring_allocation& allocation, GLenum target = GL_UNIFORM_BUFFER) const;
+
+		const uniform_ring_stats& getFrameStats() const { return m_lastFrameStats; }
+		GLuint getBuffer() const { return m_buffer; }
+
+	private:
+		GLuint m_buffer = 0;
+		unsigned char* m_data = nullptr;
+		GLsizeiptr m_frameSize = 0;
+		GLsizeiptr m_alignment = 256;
+		GLintptr m_head = 0;
+		GLintptr m_end = 0;
+		int m_frame = 0;
+		std::vector<GLsync> m_fences;
+		uniform_ring_stats m_frameStats;
+		uniform_ring_stats m_lastFrameStats;
+	};
+}
+
+#endif
@@ -0,0 +1,132 @@
+/*
+	K-Engine Upload Worker
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_UPLOAD_WORKER_HPP
+#define K_ENGINE_UPLOAD_WORKER_HPP
+
+#include <os_api_wrapper.hpp>
+#include <gl_wrapper.hpp>
+#include <mesh.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		kengine::upload_worker loads GPU resources on a background thread.
+
+		The worker owns a rendering context that shares the objects with the main context
+		(see rendering_context::createSharedContext). Each job runs on the worker thread and
+		is followed by a fence. The completion callback runs on the main thread (in update)
+		once the fence is signaled, so the main loop never waits for the uploads.
+
+		The byte budget is enforced on the main thread: update() releases to the worker at most
+		"frameBudget" bytes of queued jobs per frame (at least one job is always released).
+
+		If there is no shared context, the released jobs run synchronously in update().
+	*/
+	class upload_worker
+	{
+	public:
+		/*
+			The upload worker takes the ownership of the shared context (it can be nullptr)
+		*/
+		explicit upload_worker(rendering_context* sharedContext, size_t frameBudget = 4 * 1024 * 1024);
+		~upload_worker();
+
+		upload_worker(const upload_worker& copy) = delete; // copy constructor
+		upload_worker(upload_worker&& move) noexcept = delete; // move constructor
+		upload_worker& operator=(const upload_worker& copy) = delete; // copy assignment
+		upload_worker& operator=(upload_worker&&) = delete; // move assigment
+
+		/*
+			Queue a generic job. "work" runs on the worker thread with the shared context current and
+			"completion" runs on the main thread after the GPU has consumed the commands issued by "work".
+			If the worker is finished after "work" but before "completion", "cancel" runs on the main thread
+			instead (e.g. to delete the objects created by "work").
+		*/
+		void submit(size_t sizeInBytes, std::function<void()> work, std::function<void()> completion, std::function<void()> cancel = nullptr);
+
+		/*
+			Upload the interleaved vertex data of the mesh. The node is attached to the buffer on completion
+			(the buffer is deleted instead if the node was deleted before).
+		*/
+		void uploadMesh(mesh_node& node, mesh&& m, std::function<void()> completion = nullptr);
+
+		/*
+			Compile and link the shaders into a new program object on the worker thread. The program of the caller
+			is replaced on the main thread by the completion (it is kept if the link fails), so the caller's
+			program must live until the completion callback is called.
+		*/
+		void loadShaders(GLSLprogram& program, const ShaderInfo* shaders, std::function<void(bool)> completion = nullptr);
+
+		/*
+			Called once per frame on the main thread. It never blocks.
+		*/
+		void update();
+
+		/*
+			Stop the worker thread. It must be called while the main context is still current.
+		*/
+		void finish();
+
+		void setFrameBudget(size_t bytes) { m_frameBudget = bytes; }
+		size_t getFrameBudget() const { return m_frameBudget; }
+		size_t getPendingJobs() const;
+		bool isAsynchronous() const { return m_context != nullptr; }
+
+	private:
+		struct upload_job
+		{
+			size_t sizeInBytes = 0;
+			std::function<void()> work;
+			std::function<void()> completion;
+			std::function<void()> cancel;
+			GLsync fence = nullptr;
+		};
+
+		void run();
+
+		rendering_context* m_context = nullptr;
+		std::thread m_thread;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_running = false;
+		size_t m_frameBudget = 0;
+
+		std::deque<upload_job> m_queued; // main thread only
+		std::deque<upload_job> m_released; // main thread -> worker thread
+		std::vector<upload_job> m_inFlight; // worker thread -> main thread
+		size_t m_releasedCount = 0; // released jobs not completed yet
+	};
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+	K-Engine Vertex Format
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_VERTEX_FORMAT_HPP
+#define K_ENGINE_VERTEX_FORMAT_HPP
+
+#include <gl_wrapper.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace kengine
+{
+	/*
+		Describes how one vertex attribute is fetched from the vertex buffer binding point
+	*/
+	struct vertex_attrib_format
+	{
+		GLuint location = 0;
+		GLint size = 0; // number of components (1, 2, 3 or 4)
+		GLenum type = GL_FLOAT;
+		GLboolean normalized = GL_FALSE;
+		GLuint relativeOffset = 0; // offset in bytes from the beginning of the vertex
+	};
+
+	/*
+		This class represents a vertex layout (the VAO format state without any buffer)
+
+		Note: the stride is not a part of the format. It is a vertex buffer binding state
+		and it is set by glBindVertexBuffer at draw time.
+	*/
+	class vertex_format
+	{
+	public:
+		static const int MAX_ATTRIBUTES = 16; // this value can be obtained by GL_MAX_VERTEX_ATTRIBS
+
+		void addAttribute(GLuint location, GLint size, GLenum type, GLboolean normalized, GLuint relativeOffset);
+		void clear() { m_count = 0; }
+
+		int getAttributeCount() const { return m_count; }
+		const vertex_attrib_format& getAttribute(int index) const { return m_attributes[index]; }
+
+		uint64_t hash() const;
+		bool operator==(const vertex_format& format) const;
+		bool operator!=(const vertex_format& format) const { return !(*this == format); }
+
+	private:
+		vertex_attrib_format m_attributes[MAX_ATTRIBUTES];
+		int m_count = 0;
+	};
+
+	/*
+		Counters of the vertex format registry (see vertex_format_registry::newFrame)
+	*/
+	struct vertex_format_stats
+	{
+		unsigned int binds = 0; // number of bind requests (one per draw call)
+		unsigned int formatSwitches = 0; // glBindVertexArray calls
+		unsigned int bufferSwitches = 0; // glBindVertexBuffer calls
+	};
+
+	/*
+		kengine::vertex_format_registry keeps one VAO per distinct vertex layout.
+
+		Meshes sharing the same layout share the same VAO and only the vertex buffer is swapped
+		at draw time (binding point 0). Consecutive draws with the same layout never touch the VAO state.
+	*/
+	class vertex_format_registry
+	{
+	public:
+		vertex_format_registry() {}
+		~vertex_format_registry() {}
+
+		vertex_format_registry(const vertex_format_registry& copy) = delete; // copy constructor
+		vertex_format_registry(vertex_format_registry&& move) noexcept = delete; // move constructor
+		vertex_format_registry& operator=(const vertex_format_registry& copy) = delete; // copy assignment
+		vertex_format_registry& operator=(vertex_format_registry&&) = delete; // move assigment
+
+		/*
+			Return the identifier of the format (the VAO is created on the first use)
+		*/
+		int acquire(const vertex_format& format);
+
+		/*
+			Bind the VAO of the format and attach the buffer to the binding point 0 (only if they have changed)
+		*/
+		void bind(int formatID, GLuint buffer, GLintptr offset, GLsizei stride);
+
+		/*
+			Must be called when a buffer is deleted because the VAOs which are not bound keep the reference to it
+		*/
+		void releaseBuffer(GLuint buffer);
+
+		/*
+			Forget the cached binding state (e.g. when a third party code changes the bound VAO)
+		*/
+		void invalidate();
+
+		/*
+			Delete all VAOs. It must be called while the rendering context is still current.
+		*/
+		void clear();
+
+		/*
+			Store the counters of the last frame and reset the counters of the current frame
+		*/
+		void newFrame();
+
+		const vertex_format_stats& getFrameStats() const { return m_lastFrameStats; }
+		GLuint getVertexArray(int formatID) const { return m_formats[static_cast<size_t>(formatID)].vao; }
+		size_t getFormatCount() const { return m_formats.size(); }
+
+	private:
+		struct format_entry
+		{
+			vertex_format format;
+			uint64_t hash = 0;
+			GLuint vao = 0;
+			GLuint buffer = 0; // buffer attached to the binding point 0 of this VAO
+			GLintptr offset = 0;
+			GLsizei stride = 0;
+		};
+
+		std::vector<format_entry> m_formats; // the bound VAO is tracked by kengine::gl_state_cache
+		vertex_format_stats m_frameStats;
+		vertex_format_stats m_lastFrameStats;
+	};
+
+	/*
+		Global vertex format registry of the current rendering context
+	*/
+	vertex_format_registry& vertexFormatRegistry();
+}
+
+#endif
@@ -34,6 +34,8 @@
 #include <iostream>
 // linux headers
 #include <time.h>
+#include <climits>
+#include <cstdlib>
 
 
 /*
@@ -74,6 +76,8 @@ namespace kengine
 	{
 	public:
 		xlib_global_app_manager() {
+			// the display connection is also used by the worker threads (e.g. shared GLX contexts)
+			XInitThreads();
 			m_display = XOpenDisplay(nullptr);
 
 			if (m_display == nullptr)
@@ -311,6 +315,76 @@ namespace kengine
 	}
 
 
+	/*
+		kengine::xlib_shared_rendering_context - class members definition
+
+		GLX context that shares the objects with the main context. It is made current without
+		any drawable (allowed for OpenGL 3.0+ contexts by GLX_ARB_create_context).
+	*/
+	class xlib_shared_rendering_context : public rendering_context
+	{
+	public:
+		xlib_shared_rendering_context(GLXFBConfig config, GLXContext sharedContext)
+			: framebufferConfig{ config }, hSharedRC{ sharedContext }
+		{
+		}
+
+		~xlib_shared_rendering_context() {
+			if (hRC != nullptr)
+				destroy();
+		}
+
+		xlib_shared_rendering_context(const xlib_shared_rendering_context& copy) = delete; // copy constructor
+		xlib_shared_rendering_context& operator=(const xlib_shared_rendering_context& copy) = delete; // copy assignment
+		xlib_shared_rendering_context(xlib_shared_rendering_context&& move) noexcept = delete;  // move constructor
+		xlib_shared_rendering_context& operator=(xlib_shared_rendering_context&&) = delete; // move assigment
+
+		int create(const compatibility_profile& profile) {
+			int attribList[] = {
+			   GLX_CONTEXT_MAJOR_VERSION_ARB, KENGINE_OPENGL_MAJOR_VERSION,
+			   GLX_CONTEXT_MINOR_VERSION_ARB, KENGINE_OPENGL_MINOR_VERSION,
+			   GLX_CONTEXT_FLAGS_ARB, profile.contextFlag,
+			   GLX_CONTEXT_PROFILE_MASK_ARB, profile.profileMask,
+			   None
+			};
+
+			hRC = glXCreateContextAttribsARB(globalAppManager->m_display, framebufferConfig, hSharedRC, true, attribList);
+			XSync(globalAppManager->m_display, False);
+
+			if (hRC == nullptr) {
+				globalUserEventsCallback->debugMessage("It was not possible to create a shared GLX context");
+				return 0;
+			}
+
+			return 1;
+		}
+
+		int destroy() {
+			glXDestroyContext(globalAppManager->m_display, hRC);
+			hRC = nullptr;
+			return 1;
+		}
+
+		int makeCurrent(bool enable) {
+			if (enable)
+				return glXMakeContextCurrent(globalAppManager->m_display, None, None, hRC) ? 1 : 0;
+
+			return glXMakeContextCurrent(globalAppManager->m_display, None, None, NULL) ? 1 : 0;
+		}
+
+		int swapBuffers() {
+			return 1;
+		}
+
+		void clearBuffers() {
+		}
+
+	private:
+		GLXFBConfig framebufferConfig;
+		GLXContext hSharedRC = nullptr;
+		GLXContext hRC = nullptr;
+	};
+
 	/*
 		kengine::xlib_rendering_context - class members definition
 	*/
@@ -370,6 +444,7 @@ namespace kengine
 			};
 
 			hRC = glXCreateContextAttribsARB(globalAppManager->m_display, xlib_win->framebufferConfig, 0, true, attribList);
+			contextProfile = profile;
 			XSync(globalAppManager->m_display, False);
 
 			makeCurrent(true);
@@ -406,9 +481,21 @@ namespace kengine
 			glClear(GL_COLOR_BUFFER_BIT);
 		}
 
+		rendering_context* createSharedContext() {
+			xlib_shared_rendering_context* context = new xlib_shared_rendering_context(xlib_win->framebufferConfig, hRC);
+
+			if (!context->create(contextProfile)) {
+				delete context;
+				return nullptr;
+			}
+
+			return context;
+		}
+
 	private:
 		xlib_window* xlib_win = nullptr; // avoid dynamic casts in the methods
 		GLXContext hRC;
+		compatibility_profile contextProfile;
 	};
 
 	rendering_context* renderingContextInstance(window* win)
@@ -432,6 +519,16 @@ int64_t kengine::getHighResolutionTimerFrequency()
 	return t.tv_nsec * LINUX_TIME_RESOLUTION;
 }
 
+std::string kengine::getCanonicalPath(const std::string& filename)
+{
+	char path[PATH_MAX];
+
+	if (realpath(filename.c_str(), path) == nullptr)
+		return filename;
+
+	return path;
+}
+
 
 int kengine::createDebugConsole()
 {
@@ -65,14 +65,24 @@ void kengine::mesh::setVertexAttribute(vattrib<float>& vertexAttribute, size_t l
 	m_vattributesMap[location] = vertexAttribute;
 	m_size += vertexAttribute.getSize() * vertexAttribute.count;
 	m_sizeInBytes += vertexAttribute.getSizeInBytes();
+
+	// the interleaved data is built again with the new attribute
+	m_interleavedData.clear();
+	m_interleavedStride = 0;
 }
 
 /*
 	Remove the vertex attribute data
 */
 void kengine::mesh::removeVertexAttribute(size_t location) {
-	if (m_vattributesMap.find(location) != m_vattributesMap.end()) {
-		m_vattributesMap.erase(location);
+	auto it = m_vattributesMap.find(location);
+
+	if (it != m_vattributesMap.end()) {
+		m_size -= it->second.getSize() * it->second.count;
+		m_sizeInBytes -= it->second.getSizeInBytes();
+		m_vattributesMap.erase(it);
+		m_interleavedData.clear();
+		m_interleavedStride = 0;
 	}
 }
 
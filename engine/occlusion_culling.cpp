@@ -0,0 +1,514 @@
+/*
+	K-Engine Occlusion Culling
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <occlusion_culling.hpp>
+#include <os_api_wrapper.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define K_OCCLUSION_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define K_OCCLUSION_SSE2
+#endif
+
+namespace
+{
+	/*
+		8 floats processed together: one AVX register, two SSE2 registers or a plain array.
+		The masks are the results of the comparisons (all bits set in the AVX and SSE2 versions, 1.0f in the scalar version).
+	*/
+	struct float8
+	{
+#if defined(K_OCCLUSION_AVX)
+		__m256 v;
+#elif defined(K_OCCLUSION_SSE2)
+		__m128 lo;
+		__m128 hi;
+#else
+		float v[8];
+#endif
+	};
+
+#if defined(K_OCCLUSION_AVX)
+	inline float8 splat(float value) { float8 r; r.v = _mm256_set1_ps(value); return r; }
+	inline float8 lanes() { float8 r; r.v = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); return r; }
+	inline float8 load(const float* data) { float8 r; r.v = _mm256_loadu_ps(data); return r; }
+	inline void store(float* data, const float8& a) { _mm256_storeu_ps(data, a.v); }
+	inline float8 operator+(const float8& a, const float8& b) { float8 r; r.v = _mm256_add_ps(a.v, b.v); return r; }
+	inline float8 operator*(const float8& a, const float8& b) { float8 r; r.v = _mm256_mul_ps(a.v, b.v); return r; }
+	inline float8 min(const float8& a, const float8& b) { float8 r; r.v = _mm256_min_ps(a.v, b.v); return r; }
+	inline float8 max(const float8& a, const float8& b) { float8 r; r.v = _mm256_max_ps(a.v, b.v); return r; }
+	inline float8 greaterEqual(const float8& a, const float8& b) { float8 r; r.v = _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); return r; }
+	inline float8 both(const float8& a, const float8& b) { float8 r; r.v = _mm256_and_ps(a.v, b.v); return r; }
+	inline float8 select(const float8& mask, const float8& a, const float8& b) { float8 r; r.v = _mm256_blendv_ps(b.v, a.v, mask.v); return r; }
+	inline int bits(const float8& mask) { return _mm256_movemask_ps(mask.v); }
+#elif defined(K_OCCLUSION_SSE2)
+	inline float8 splat(float value) { float8 r; r.lo = r.hi = _mm_set1_ps(value); return r; }
+	inline float8 lanes() { float8 r; r.lo = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); r.hi = _mm_setr_ps(4.0f, 5.0f, 6.0f, 7.0f); return r; }
+	inline float8 load(const float* data) { float8 r; r.lo = _mm_loadu_ps(data); r.hi = _mm_loadu_ps(data + 4); return r; }
+	inline void store(float* data, const float8& a) { _mm_storeu_ps(data, a.lo); _mm_storeu_ps(data + 4, a.hi); }
+	inline float8 operator+(const float8& a, const float8& b) { float8 r; r.lo = _mm_add_ps(a.lo, b.lo); r.hi = _mm_add_ps(a.hi, b.hi); return r; }
+	inline float8 operator*(const float8& a, const float8& b) { float8 r; r.lo = _mm_mul_ps(a.lo, b.lo); r.hi = _mm_mul_ps(a.hi, b.hi); return r; }
+	inline float8 min(const float8& a, const float8& b) { float8 r; r.lo = _mm_min_ps(a.lo, b.lo); r.hi = _mm_min_ps(a.hi, b.hi); return r; }
+	inline float8 max(const float8& a, const float8& b) { float8 r; r.lo = _mm_max_ps(a.lo, b.lo); r.hi = _mm_max_ps(a.hi, b.hi); return r; }
+	inline float8 greaterEqual(const float8& a, const float8& b) { float8 r; r.lo = _mm_cmpge_ps(a.lo, b.lo); r.hi = _mm_cmpge_ps(a.hi, b.hi); return r; }
+	inline float8 both(const float8& a, const float8& b) { float8 r; r.lo = _mm_and_ps(a.lo, b.lo); r.hi = _mm_and_ps(a.hi, b.hi); return r; }
+
+	inline float8 select(const float8& mask, const float8& a, const float8& b) {
+		float8 r;
+		r.lo = _mm_or_ps(_mm_and_ps(mask.lo, a.lo), _mm_andnot_ps(mask.lo, b.lo));
+		r.hi = _mm_or_ps(_mm_and_ps(mask.hi, a.hi), _mm_andnot_ps(mask.hi, b.hi));
+		return r;
+	}
+
+	inline int bits(const float8& mask) { return _mm_movemask_ps(mask.lo) | (_mm_movemask_ps(mask.hi) << 4); }
+#else
+	inline float8 splat(float value) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = value; return r; }
+	inline float8 lanes() { float8 r; for (int i = 0; i < 8; i++) r.v[i] = static_cast<float>(i); return r; }
+	inline float8 load(const float* data) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = data[i]; return r; }
+	inline void store(float* data, const float8& a) { for (int i = 0; i < 8; i++) data[i] = a.v[i]; }
+	inline float8 operator+(const float8& a, const float8& b) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = a.v[i] + b.v[i]; return r; }
+	inline float8 operator*(const float8& a, const float8& b) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = a.v[i] * b.v[i]; return r; }
+	inline float8 min(const float8& a, const float8& b) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = std::min(a.v[i], b.v[i]); return r; }
+	inline float8 max(const float8& a, const float8& b) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = std::max(a.v[i], b.v[i]); return r; }
+	inline float8 greaterEqual(const float8& a, const float8& b) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = a.v[i] >= b.v[i] ? 1.0f : 0.0f; return r; }
+	inline float8 both(const float8& a, const float8& b) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = a.v[i] * b.v[i]; return r; }
+	inline float8 select(const float8& mask, const float8& a, const float8& b) { float8 r; for (int i = 0; i < 8; i++) r.v[i] = mask.v[i] != 0.0f ? a.v[i] : b.v[i]; return r; }
+	inline int bits(const float8& mask) { int r = 0; for (int i = 0; i < 8; i++) r |= (mask.v[i] != 0.0f ? 1 : 0) << i; return r; }
+#endif
+
+	/*
+		The upper halves of the AVX registers are cleared when a SIMD function returns: the SSE code of the
+		other translation units (compiled without AVX) would pay a transition penalty otherwise
+	*/
+	struct simd_scope
+	{
+		~simd_scope() {
+#if defined(K_OCCLUSION_AVX)
+			_mm256_zeroupper();
+#endif
+		}
+	};
+
+	inline float horizontalMax(const float8& a)
+	{
+		float values[8];
+		store(values, a);
+		return std::max(std::max(std::max(values[0], values[1]), std::max(values[2], values[3])), std::max(std::max(values[4], values[5]), std::max(values[6], values[7])));
+	}
+
+	/*
+		result = a * b (column-major)
+	*/
+	void multiply(const float* a, const float* b, float* result)
+	{
+		for (int column = 0; column < 4; column++) {
+			for (int row = 0; row < 4; row++) {
+				result[column * 4 + row] =
+					a[row] * b[column * 4] +
+					a[4 + row] * b[column * 4 + 1] +
+					a[8 + row] * b[column * 4 + 2] +
+					a[12 + row] * b[column * 4 + 3];
+			}
+		}
+	}
+
+	inline void transform(const float* matrix, float x, float y, float z, float* clip)
+	{
+		for (int row = 0; row < 4; row++)
+			clip[row] = matrix[row] * x + matrix[4 + row] * y + matrix[8 + row] * z + matrix[12 + row];
+	}
+
+	const float MIN_W = 1e-5f;
+}
+
+/*
+	kengine::occlusion_culler class - member class definition
+*/
+
+kengine::occlusion_culler::occlusion_culler(int width, int height)
+{
+	for (int index = 0; index < 16; index++)
+		m_viewProjection[index] = (index % 5 == 0) ? 1.0f : 0.0f;
+
+	resize(width, height);
+}
+
+void kengine::occlusion_culler::resize(int width, int height)
+{
+	m_tilesX = std::max(1, (width + TILE_SIZE - 1) / TILE_SIZE);
+	m_tilesY = std::max(1, (height + TILE_SIZE - 1) / TILE_SIZE);
+	m_width = m_tilesX * TILE_SIZE;
+	m_height = m_tilesY * TILE_SIZE;
+
+	m_depth.assign(static_cast<size_t>(m_width) * m_height, 1.0f);
+	m_tileDepth.assign(static_cast<size_t>(m_tilesX) * m_tilesY, 1.0f);
+}
+
+void kengine::occlusion_culler::newFrame(const float* viewProjection)
+{
+	std::copy(viewProjection, viewProjection + 16, m_viewProjection);
+	m_occluders.clear();
+	m_stats = occlusion_culling_stats();
+}
+
+void kengine::occlusion_culler::addOccluder(const float* positions, size_t vertexCount, size_t stride, const float* model)
+{
+	occluder current;
+	current.positions = positions;
+	current.vertexCount = vertexCount;
+	current.stride = stride;
+
+	if (model != nullptr)
+		multiply(m_viewProjection, model, current.matrix);
+	else
+		std::copy(m_viewProjection, m_viewProjection + 16, current.matrix);
+
+	m_occluders.push_back(current);
+}
+
+void kengine::occlusion_culler::rasterize()
+{
+	int64_t startTime = kengine::getHighResolutionTimerCounter();
+	kengine::thread_pool& pool = kengine::threadPool();
+
+	m_triangles.resize(pool.getThreadCount());
+
+	for (auto& triangles : m_triangles)
+		triangles.clear();
+
+	// the triangles are transformed and clipped into one list per thread
+	pool.parallelFor(m_occluders.size(), [this](size_t begin, size_t end, unsigned int thread) {
+		for (size_t index = begin; index < end; index++)
+			transformOccluder(m_occluders[index], m_triangles[thread]);
+	}, 1);
+
+	size_t triangleCount = 0;
+
+	for (const auto& triangles : m_triangles)
+		triangleCount += triangles.size();
+
+	// each row of tiles is owned by one thread, so the depth buffer is written without synchronization
+	pool.parallelFor(static_cast<size_t>(m_tilesY), [this](size_t begin, size_t end, unsigned int) {
+		for (size_t tileY = begin; tileY < end; tileY++) {
+			auto rowBegin = m_depth.begin() + static_cast<std::ptrdiff_t>(tileY * TILE_SIZE * m_width);
+			std::fill(rowBegin, rowBegin + TILE_SIZE * m_width, 1.0f);
+
+			for (const auto& triangles : m_triangles)
+				rasterizeTiles(static_cast<int>(tileY), triangles);
+		}
+	}, 1);
+
+	// the tile depths are computed after all triangles of the row
+	pool.parallelFor(static_cast<size_t>(m_tilesY), [this](size_t begin, size_t end, unsigned int) {
+		for (size_t tileY = begin; tileY < end; tileY++) {
+			simd_scope scope;
+
+			for (int tileX = 0; tileX < m_tilesX; tileX++) {
+				const float* depth = &m_depth[tileY * TILE_SIZE * m_width + static_cast<size_t>(tileX) * TILE_SIZE];
+				float8 farthest = load(depth);
+
+				for (int row = 1; row < TILE_SIZE; row++)
+					farthest = max(farthest, load(depth + static_cast<size_t>(row) * m_width));
+
+				m_tileDepth[tileY * m_tilesX + tileX] = horizontalMax(farthest);
+			}
+		}
+	}, 1);
+
+	m_stats.occluders = static_cast<unsigned int>(m_occluders.size());
+	m_stats.triangles = static_cast<unsigned int>(triangleCount);
+	m_stats.rasterizeMilliseconds = static_cast<double>(kengine::getHighResolutionTimerCounter() - startTime) * 1000.0 / static_cast<double>(kengine::getHighResolutionTimerFrequency());
+}
+
+void kengine::occlusion_culler::transformOccluder(const occluder& current, std::vector<screen_triangle>& triangles) const
+{
+	const float width = static_cast<float>(m_width);
+	const float height = static_cast<float>(m_height);
+
+	for (size_t first = 0; first + 3 <= current.vertexCount; first += 3) {
+		float clip[3][4];
+
+		for (int vertex = 0; vertex < 3; vertex++) {
+			const float* position = current.positions + (first + vertex) * current.stride;
+			transform(current.matrix, position[0], position[1], position[2], clip[vertex]);
+		}
+
+		// clipping against the near plane (z >= -w): the result is a polygon of 0, 3 or 4 vertices
+		float polygon[4][4];
+		int count = 0;
+
+		for (int vertex = 0; vertex < 3; vertex++) {
+			const float* a = clip[vertex];
+			const float* b = clip[(vertex + 1) % 3];
+			float distanceA = a[2] + a[3];
+			float distanceB = b[2] + b[3];
+
+			if (distanceA >= 0.0f)
+				std::copy(a, a + 4, polygon[count++]);
+
+			if ((distanceA >= 0.0f) != (distanceB >= 0.0f)) {
+				float t = distanceA / (distanceA - distanceB);
+
+				for (int component = 0; component < 4; component++)
+					polygon[count][component] = a[component] + (b[component] - a[component]) * t;
+
+				count++;
+			}
+		}
+
+		if (count < 3)
+			continue;
+
+		// window coordinates
+		float window[4][3];
+		bool valid = true;
+
+		for (int vertex = 0; vertex < count; vertex++) {
+			float w = polygon[vertex][3];
+
+			if (w < MIN_W) {
+				valid = false;
+				break;
+			}
+
+			window[vertex][0] = (polygon[vertex][0] / w * 0.5f + 0.5f) * width;
+			window[vertex][1] = (polygon[vertex][1] / w * 0.5f + 0.5f) * height;
+			window[vertex][2] = polygon[vertex][2] / w * 0.5f + 0.5f;
+		}
+
+		if (!valid)
+			continue;
+
+		for (int vertex = 1; vertex + 1 < count; vertex++) {
+			screen_triangle triangle;
+			std::copy(window[0], window[0] + 3, triangle.vertices);
+			std::copy(window[vertex], window[vertex] + 3, triangle.vertices + 3);
+			std::copy(window[vertex + 1], window[vertex + 1] + 3, triangle.vertices + 6);
+
+			float minX = std::min(std::min(triangle.vertices[0], triangle.vertices[3]), triangle.vertices[6]);
+			float maxX = std::max(std::max(triangle.vertices[0], triangle.vertices[3]), triangle.vertices[6]);
+			float minY = std::min(std::min(triangle.vertices[1], triangle.vertices[4]), triangle.vertices[7]);
+			float maxY = std::max(std::max(triangle.vertices[1], triangle.vertices[4]), triangle.vertices[7]);
+
+			if (maxX >= 0.0f && minX <= width && maxY >= 0.0f && minY <= height)
+				triangles.push_back(triangle);
+		}
+	}
+}
+
+void kengine::occlusion_culler::rasterizeTiles(int tileY, const std::vector<screen_triangle>& triangles)
+{
+	simd_scope scope;
+	const int rowBegin = tileY * TILE_SIZE;
+	const int rowEnd = rowBegin + TILE_SIZE;
+	const float8 laneOffsets = lanes();
+	const float8 zero = splat(0.0f);
+
+	for (const screen_triangle& triangle : triangles) {
+		const float* v = triangle.vertices;
+
+		int minY = std::max(rowBegin, static_cast<int>(std::floor(std::min(std::min(v[1], v[4]), v[7]))));
+		int maxY = std::min(rowEnd - 1, static_cast<int>(std::ceil(std::max(std::max(v[1], v[4]), v[7]))));
+
+		if (minY > maxY)
+			continue;
+
+		int minX = std::max(0, static_cast<int>(std::floor(std::min(std::min(v[0], v[3]), v[6]))));
+		int maxX = std::min(m_width - 1, static_cast<int>(std::ceil(std::max(std::max(v[0], v[3]), v[6]))));
+
+		if (minX > maxX)
+			continue;
+
+		// edge functions (A * x + B * y + C), positive inside for both windings
+		float area = (v[3] - v[0]) * (v[7] - v[1]) - (v[4] - v[1]) * (v[6] - v[0]);
+
+		if (std::fabs(area) < 1e-8f)
+			continue;
+
+		float sign = area > 0.0f ? 1.0f : -1.0f;
+		float edgeA[3], edgeB[3], edgeC[3];
+
+		for (int edge = 0; edge < 3; edge++) {
+			const float* a = v + edge * 3;
+			const float* b = v + ((edge + 1) % 3) * 3;
+			edgeA[edge] = (a[1] - b[1]) * sign;
+			edgeB[edge] = (b[0] - a[0]) * sign;
+			edgeC[edge] = -(edgeA[edge] * a[0] + edgeB[edge] * a[1]);
+		}
+
+		// depth plane: the edge opposite to each vertex weights it
+		float inverseArea = 1.0f / std::fabs(area);
+		float depthA = (edgeA[1] * v[2] + edgeA[2] * v[5] + edgeA[0] * v[8]) * inverseArea;
+		float depthB = (edgeB[1] * v[2] + edgeB[2] * v[5] + edgeB[0] * v[8]) * inverseArea;
+		float depthC = (edgeC[1] * v[2] + edgeC[2] * v[5] + edgeC[0] * v[8]) * inverseArea;
+
+		const float8 a0 = splat(edgeA[0]), a1 = splat(edgeA[1]), a2 = splat(edgeA[2]);
+		const float8 dzdx = splat(depthA);
+		const int startX = minX & ~(TILE_SIZE - 1);
+
+		for (int y = minY; y <= maxY; y++) {
+			float centerY = static_cast<float>(y) + 0.5f;
+			const float8 row0 = splat(edgeB[0] * centerY + edgeC[0]);
+			const float8 row1 = splat(edgeB[1] * centerY + edgeC[1]);
+			const float8 row2 = splat(edgeB[2] * centerY + edgeC[2]);
+			const float8 rowDepth = splat(depthB * centerY + depthC);
+			float* depth = &m_depth[static_cast<size_t>(y) * m_width];
+
+			for (int x = startX; x <= maxX; x += TILE_SIZE) {
+				float8 centerX = splat(static_cast<float>(x) + 0.5f) + laneOffsets;
+				float8 inside = both(both(greaterEqual(a0 * centerX + row0, zero), greaterEqual(a1 * centerX + row1, zero)), greaterEqual(a2 * centerX + row2, zero));
+
+				if (bits(inside) == 0)
+					continue;
+
+				float8 current = load(depth + x);
+				float8 triangleDepth = dzdx * centerX + rowDepth;
+				store(depth + x, select(inside, min(current, triangleDepth), current));
+			}
+		}
+	}
+}
+
+kengine::occlusion_culler::RESULT kengine::occlusion_culler::test(const float* boundsMin, const float* boundsMax, const float* model) const
+{
+	simd_scope scope;
+	float matrix[16];
+
+	if (model != nullptr)
+		multiply(m_viewProjection, model, matrix);
+	else
+		std::copy(m_viewProjection, m_viewProjection + 16, matrix);
+
+	float minX = 1.0f, maxX = -1.0f, minY = 1.0f, maxY = -1.0f, minDepth = 1.0f;
+
+	for (int corner = 0; corner < 8; corner++) {
+		float clip[4];
+		transform(matrix,
+			(corner & 1) ? boundsMax[0] : boundsMin[0],
+			(corner & 2) ? boundsMax[1] : boundsMin[1],
+			(corner & 4) ? boundsMax[2] : boundsMin[2],
+			clip);
+
+		// the box crosses the plane of the camera
+		if (clip[3] < MIN_W)
+			return RESULT::VISIBLE;
+
+		float x = clip[0] / clip[3];
+		float y = clip[1] / clip[3];
+		float depth = clip[2] / clip[3] * 0.5f + 0.5f;
+
+		minX = corner == 0 ? x : std::min(minX, x);
+		maxX = corner == 0 ? x : std::max(maxX, x);
+		minY = corner == 0 ? y : std::min(minY, y);
+		maxY = corner == 0 ? y : std::max(maxY, y);
+		minDepth = corner == 0 ? depth : std::min(minDepth, depth);
+	}
+
+	if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f || minDepth > 1.0f)
+		return RESULT::OUTSIDE;
+
+	// pixels touched by the box
+	int pixelMinX = std::max(0, static_cast<int>(std::floor((minX * 0.5f + 0.5f) * m_width)));
+	int pixelMaxX = std::min(m_width - 1, static_cast<int>(std::floor((maxX * 0.5f + 0.5f) * m_width)));
+	int pixelMinY = std::max(0, static_cast<int>(std::floor((minY * 0.5f + 0.5f) * m_height)));
+	int pixelMaxY = std::min(m_height - 1, static_cast<int>(std::floor((maxY * 0.5f + 0.5f) * m_height)));
+
+	const float8 boxDepth = splat(minDepth);
+	const float8 laneOffsets = lanes();
+	const float8 firstPixel = splat(static_cast<float>(pixelMinX));
+	const float8 lastPixel = splat(static_cast<float>(pixelMaxX));
+
+	for (int tileY = pixelMinY / TILE_SIZE; tileY <= pixelMaxY / TILE_SIZE; tileY++) {
+		for (int tileX = pixelMinX / TILE_SIZE; tileX <= pixelMaxX / TILE_SIZE; tileX++) {
+			// the whole tile is in front of the box
+			if (minDepth > m_tileDepth[static_cast<size_t>(tileY) * m_tilesX + tileX])
+				continue;
+
+			float8 pixelX = splat(static_cast<float>(tileX * TILE_SIZE)) + laneOffsets;
+			float8 columns = both(greaterEqual(pixelX, firstPixel), greaterEqual(lastPixel, pixelX));
+			int rowBegin = std::max(pixelMinY, tileY * TILE_SIZE);
+			int rowEnd = std::min(pixelMaxY, tileY * TILE_SIZE + TILE_SIZE - 1);
+
+			for (int y = rowBegin; y <= rowEnd; y++) {
+				float8 depth = load(&m_depth[static_cast<size_t>(y) * m_width + static_cast<size_t>(tileX) * TILE_SIZE]);
+
+				if (bits(both(greaterEqual(depth, boxDepth), columns)) != 0)
+					return RESULT::VISIBLE;
+			}
+		}
+	}
+
+	return RESULT::OCCLUDED;
+}
+
+bool kengine::occlusion_culler::testAABB(const float* boundsMin, const float* boundsMax, const float* model)
+{
+	RESULT result = test(boundsMin, boundsMax, model);
+
+	m_stats.tested++;
+
+	if (result == RESULT::OCCLUDED)
+		m_stats.occluded++;
+	else if (result == RESULT::OUTSIDE)
+		m_stats.outside++;
+
+	return result == RESULT::VISIBLE;
+}
+
+void kengine::occlusion_culler::testAABBs(size_t count, const float* bounds, const float* const* models, uint8_t* visible)
+{
+	int64_t startTime = kengine::getHighResolutionTimerCounter();
+	std::atomic<unsigned int> occluded{ 0 };
+	std::atomic<unsigned int> outside{ 0 };
+
+	kengine::threadPool().parallelFor(count, [&](size_t begin, size_t end, unsigned int) {
+		unsigned int chunkOccluded = 0;
+		unsigned int chunkOutside = 0;
+
+		for (size_t index = begin; index < end; index++) {
+			RESULT result = test(bounds + index * 6, bounds + index * 6 + 3, models != nullptr ? models[index] : nullptr);
+
+			visible[index] = result == RESULT::VISIBLE ? 1 : 0;
+			chunkOccluded += result == RESULT::OCCLUDED ? 1 : 0;
+			chunkOutside += result == RESULT::OUTSIDE ? 1 : 0;
+		}
+
+		occluded += chunkOccluded;
+		outside += chunkOutside;
+	}, 256);
+
+	m_stats.tested += static_cast<unsigned int>(count);
+	m_stats.occluded += occluded;
+	m_stats.outside += outside;
+	m_stats.testMilliseconds += static_cast<double>(kengine::getHighResolutionTimerCounter() - startTime) * 1000.0 / static_cast<double>(kengine::getHighResolutionTimerFrequency());
+}
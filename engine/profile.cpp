@@ -25,6 +25,10 @@
 
 #include <profile.hpp>
 #include <os_api_wrapper.hpp>
+#include <gpu_memory.hpp>
+#include <gl_state.hpp>
+#include <gpu_profiler.hpp>
+#include <dynamic_resolution.hpp>
 
 #include <iostream>
 #include <fstream>
@@ -42,6 +46,19 @@ kengine::profile::profile()
 	minFramesPerSecond{ 0 },
 	frameCounter{ 0 },
 	totalFrameTime{ 0 },
+	maxGPUAllocatedBytes{ 0 },
+	maxGPUReleasedBytes{ 0 },
+	gpuEvictions{ 0 },
+	gpuEvictedBytes{ 0 },
+	glCallsIssued{ 0 },
+	glCallsElided{ 0 },
+	maxGLCallsIssued{ 0 },
+	gpuPasses{},
+	lastGPUFrame{ 0 },
+	resolutionController{ nullptr },
+	totalResolutionScale{ 0.0 },
+	minResolutionScale{ 0.0f },
+	resolutionFrames{ 0 },
 	isProfilingEnd{ false }
 {
 }
@@ -56,6 +73,18 @@ void kengine::profile::init()
 	minFramesPerSecond = 0;
 	frameCounter = 0;
 	totalFrameTime = 0;
+	maxGPUAllocatedBytes = 0;
+	maxGPUReleasedBytes = 0;
+	gpuEvictions = 0;
+	gpuEvictedBytes = 0;
+	glCallsIssued = 0;
+	glCallsElided = 0;
+	maxGLCallsIssued = 0;
+	gpuPasses.clear();
+	lastGPUFrame = kengine::gpuProfiler().getLastFrameNumber();
+	totalResolutionScale = 0.0;
+	minResolutionScale = 0.0f;
+	resolutionFrames = 0;
 	isProfilingEnd = false;
 	timer.start();
 }
@@ -80,6 +109,64 @@ void kengine::profile::update(int64_t frameTime)
 	if (!minFrameTime || frameTime < minFrameTime)
 		minFrameTime = frameTime;
 
+	kengine::gpu_memory_frame_stats gpuStats = kengine::gpuMemoryTracker().getFrameStats();
+
+	if (gpuStats.allocatedBytes > maxGPUAllocatedBytes)
+		maxGPUAllocatedBytes = gpuStats.allocatedBytes;
+
+	if (gpuStats.releasedBytes > maxGPUReleasedBytes)
+		maxGPUReleasedBytes = gpuStats.releasedBytes;
+
+	gpuEvictions += gpuStats.evictions;
+	gpuEvictedBytes += gpuStats.evictedBytes;
+
+	kengine::gl_state_stats stateStats = kengine::glState().getFrameStats();
+	glCallsIssued += stateStats.issued;
+	glCallsElided += stateStats.elided;
+
+	if (stateStats.issued > maxGLCallsIssued)
+		maxGLCallsIssued = stateStats.issued;
+
+	// the GPU timers are read back a few frames later (each read back frame is accumulated once)
+	if (kengine::gpuProfiler().getLastFrameNumber() != lastGPUFrame)
+	{
+		lastGPUFrame = kengine::gpuProfiler().getLastFrameNumber();
+
+		for (const kengine::gpu_pass_stats& pass : kengine::gpuProfiler().getFrameStats())
+		{
+			size_t index = 0;
+
+			while (index < gpuPasses.size() && (gpuPasses[index].name != pass.name || gpuPasses[index].depth != pass.depth))
+				index++;
+
+			if (index == gpuPasses.size())
+			{
+				gpuPasses.push_back(kengine::gpu_pass_profile());
+				gpuPasses.back().name = pass.name;
+				gpuPasses.back().depth = pass.depth;
+			}
+
+			kengine::gpu_pass_profile& total = gpuPasses[index];
+			total.frames++;
+			total.totalMilliseconds += pass.milliseconds;
+			total.totalPrimitives += pass.primitivesGenerated;
+
+			if (pass.milliseconds > total.maxMilliseconds)
+				total.maxMilliseconds = pass.milliseconds;
+		}
+	}
+
+	if (resolutionController)
+	{
+		float scale = resolutionController->getScale();
+		totalResolutionScale += scale;
+
+		if (!resolutionFrames || scale < minResolutionScale)
+			minResolutionScale = scale;
+
+		resolutionFrames++;
+	}
+
 	if (timer.doneAndRestart())
 	{
 		framesPerSecond.push_back(frameCounter);
@@ -116,6 +203,45 @@ void kengine::profile::save() const
 	logFile << "> MIN FRAMETIME: " << minFrameTime << "\n" << std::endl;
 	logFile << "> MAX FRAMES PER SECOND: " << maxFramesPerSecond << std::endl;
 	logFile << "> MIN FRAMES PER SECOND: " << minFramesPerSecond << "\n" << std::endl;
+	logFile << "> MAX GPU BYTES ALLOCATED PER FRAME: " << maxGPUAllocatedBytes << std::endl;
+	logFile << "> MAX GPU BYTES RELEASED PER FRAME: " << maxGPUReleasedBytes << std::endl;
+	logFile << "> GPU EVICTIONS: " << gpuEvictions << " (" << gpuEvictedBytes << " bytes)" << std::endl;
+	logFile << kengine::gpuMemoryTracker().report() << std::endl;
+	logFile << "> GL STATE CALLS ISSUED: " << glCallsIssued << std::endl;
+	logFile << "> GL STATE CALLS ELIDED: " << glCallsElided << std::endl;
+	logFile << "> MAX GL STATE CALLS ISSUED PER FRAME: " << maxGLCallsIssued << "\n" << std::endl;
+
+	if (!gpuPasses.empty())
+	{
+		logFile << "> GPU PASSES (MEAN MS / MAX MS / MEAN PRIMITIVES):" << std::endl;
+
+		for (const auto& pass : gpuPasses)
+		{
+			logFile << std::string(2 * (pass.depth + 1), ' ') << "- " << pass.name << ": " <<
+				pass.totalMilliseconds / pass.frames << " / " << pass.maxMilliseconds << " / " <<
+				pass.totalPrimitives / pass.frames << std::endl;
+		}
+
+		logFile << "> GPU DROPPED FRAMES: " << kengine::gpuProfiler().getDroppedFrames() << "\n" << std::endl;
+	}
+
+	if (resolutionController && resolutionFrames)
+	{
+		const kengine::resolution_controller_stats& stats = resolutionController->getStats();
+
+		logFile << "> DYNAMIC RESOLUTION MEAN SCALE: " << totalResolutionScale / resolutionFrames << std::endl;
+		logFile << "> DYNAMIC RESOLUTION MIN SCALE: " << minResolutionScale << std::endl;
+		logFile << "> DYNAMIC RESOLUTION CPU BOUND FRAMES: " << stats.cpuBoundFrames << std::endl;
+		logFile << "> DYNAMIC RESOLUTION CHANGES (FRAME: SCALE -> SCALE, MS BEFORE -> MS AFTER):" << std::endl;
+
+		for (const auto& change : resolutionController->getChanges())
+		{
+			logFile << "  - " << change.frame << ": " << change.fromScale << " -> " << change.toScale << ", " <<
+				change.gpuMilliseconds << " -> " << change.resultMilliseconds << std::endl;
+		}
+
+		logFile << std::endl;
+	}
 	
 	for (auto fps : framesPerSecond)
 	{
@@ -0,0 +1,268 @@
+/*
+	K-Engine Program Cache
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <program_cache.hpp>
+#include <k_hash.hpp>
+#include <logger.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+	const uint32_t PROGRAM_CACHE_MAGIC = 0x4B505247; // "KPRG"
+	const uint32_t PROGRAM_CACHE_VERSION = 2;
+
+	template <typename T>
+	void writeValue(std::ofstream& file, const T& value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool readValue(std::ifstream& file, T& value)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	bool makeDirectory(const std::string& directory)
+	{
+#if defined(_WIN32)
+		return _mkdir(directory.c_str()) == 0 || errno == EEXIST;
+#else
+		return mkdir(directory.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+	}
+}
+
+/*
+	kengine::program_cache class - member class definition
+*/
+
+bool kengine::program_cache::setDirectory(const std::string& directory)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!directory.empty() && !makeDirectory(directory)) {
+		K_LOG_OUTPUT_RAW("> program cache: it was not possible to create the directory " << directory);
+		m_directory.clear();
+		return false;
+	}
+
+	m_directory = directory;
+	return true;
+}
+
+uint64_t kengine::program_cache::makeKey(const GLuint* types, const std::string* sources, int count)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_driver.empty()) {
+		const GLubyte* strings[] = { glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION) };
+
+		for (auto s : strings) {
+			if (s != nullptr)
+				m_driver += reinterpret_cast<const char*>(s);
+
+			m_driver += '\n';
+		}
+	}
+
+	uint64_t hash = kengine::fnv1a64(&PROGRAM_CACHE_VERSION, sizeof(PROGRAM_CACHE_VERSION));
+	hash = kengine::fnv1a64(m_driver.data(), m_driver.size(), hash);
+
+	for (int i = 0; i < count; i++) {
+		// the size is hashed too, so the concatenation of the stages is not ambiguous
+		uint64_t size = sources[i].size();
+		hash = kengine::fnv1a64(&types[i], sizeof(GLuint), hash);
+		hash = kengine::fnv1a64(&size, sizeof(size), hash);
+		hash = kengine::fnv1a64(sources[i].data(), sources[i].size(), hash);
+	}
+
+	return hash;
+}
+
+GLuint kengine::program_cache::load(uint64_t key, GLenum& binaryFormat, uniform_table& uniforms)
+{
+	std::string filename;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_directory.empty())
+			return 0;
+
+		filename = getFilename(key);
+	}
+
+	std::ifstream file(filename, std::ios::binary);
+	bool valid = static_cast<bool>(file);
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint64_t fileKey = 0;
+	uint32_t format = 0;
+	uint32_t uniformCount = 0;
+
+	valid = valid && readValue(file, magic) && readValue(file, version) && readValue(file, fileKey);
+	valid = valid && magic == PROGRAM_CACHE_MAGIC && version == PROGRAM_CACHE_VERSION && fileKey == key;
+	valid = valid && readValue(file, format) && readValue(file, uniformCount);
+
+	uniform_table reflection;
+
+	for (uint32_t i = 0; valid && i < uniformCount; i++) {
+		uint32_t hash = 0;
+		uint32_t type = 0;
+		uniform_info info;
+
+		valid = readValue(file, hash) && readValue(file, info.location) && readValue(file, type) && readValue(file, info.size);
+		info.type = type;
+
+		if (valid)
+			reflection.insert(hash, info);
+	}
+
+	uint32_t binaryLength = 0;
+	valid = valid && readValue(file, binaryLength) && binaryLength > 0;
+
+	std::vector<char> binary(valid ? binaryLength : 0);
+	valid = valid && file.read(binary.data(), binaryLength);
+	file.close();
+
+	if (!valid) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stats.misses++;
+		return 0;
+	}
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binaryLength));
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+	if (status == GL_FALSE) {
+		// the caller compiles the program again and refreshes the file
+		glDeleteProgram(program);
+		std::remove(filename.c_str());
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stats.rejections++;
+		K_LOG_OUTPUT_RAW("> program cache: the driver rejected the binary " << filename);
+		return 0;
+	}
+
+	binaryFormat = format;
+	uniforms = reflection;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.hits++;
+	return program;
+}
+
+bool kengine::program_cache::save(uint64_t key, GLuint program, const uniform_table& uniforms)
+{
+	std::string filename;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_directory.empty())
+			return false;
+
+		filename = getFilename(key);
+	}
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+		return false;
+
+	std::vector<char> binary(static_cast<size_t>(length));
+	GLenum format = 0;
+	glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+	// the file is written under a temporary name, so a crash never leaves a truncated entry
+	std::string temporary = filename + ".tmp";
+	std::ofstream file(temporary, std::ios::binary);
+
+	if (!file)
+		return false;
+
+	writeValue(file, PROGRAM_CACHE_MAGIC);
+	writeValue(file, PROGRAM_CACHE_VERSION);
+	writeValue(file, key);
+	writeValue(file, static_cast<uint32_t>(format));
+	// the uniform names are stored as hashes (the names are never used after the link)
+	std::vector<std::pair<uint32_t, uniform_info>> entries;
+	uniforms.getEntries(entries);
+	writeValue(file, static_cast<uint32_t>(entries.size()));
+
+	for (const auto& entry : entries) {
+		writeValue(file, entry.first);
+		writeValue(file, entry.second.location);
+		writeValue(file, static_cast<uint32_t>(entry.second.type));
+		writeValue(file, entry.second.size);
+	}
+
+	writeValue(file, static_cast<uint32_t>(length));
+	file.write(binary.data(), length);
+	file.close();
+
+	if (!file) {
+		std::remove(temporary.c_str());
+		return false;
+	}
+
+	std::remove(filename.c_str()); // std::rename doesn't replace an existing file on Windows
+	return std::rename(temporary.c_str(), filename.c_str()) == 0;
+}
+
+kengine::program_cache_stats kengine::program_cache::getStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+std::string kengine::program_cache::getFilename(uint64_t key) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+	return m_directory + "/" + name;
+}
+
+kengine::program_cache& kengine::programCache()
+{
+	static program_cache cache;
+	return cache;
+}
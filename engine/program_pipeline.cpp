@@ -0,0 +1,185 @@
+/*
+	K-Engine Program Pipeline
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <program_pipeline.hpp>
+#include <gpu_memory.hpp>
+#include <gl_state.hpp>
+#include <k_hash.hpp>
+#include <logger.hpp>
+
+namespace
+{
+	GLbitfield getStageBit(GLenum type)
+	{
+		switch (type) {
+		case GL_VERTEX_SHADER:
+			return GL_VERTEX_SHADER_BIT;
+		case GL_TESS_CONTROL_SHADER:
+			return GL_TESS_CONTROL_SHADER_BIT;
+		case GL_TESS_EVALUATION_SHADER:
+			return GL_TESS_EVALUATION_SHADER_BIT;
+		case GL_GEOMETRY_SHADER:
+			return GL_GEOMETRY_SHADER_BIT;
+		case GL_FRAGMENT_SHADER:
+			return GL_FRAGMENT_SHADER_BIT;
+		case GL_COMPUTE_SHADER:
+			return GL_COMPUTE_SHADER_BIT;
+		default:
+			return 0;
+		}
+	}
+}
+
+/*
+	kengine::program_pipeline_cache class - member class definition
+*/
+
+kengine::program_pipeline_cache::~program_pipeline_cache()
+{
+	clear();
+}
+
+const kengine::separable_program& kengine::program_pipeline_cache::getStage(GLenum type, const std::string& filename, const shader_define_set& defines)
+{
+	uint64_t definesKey = defines.getKey();
+	uint64_t key = kengine::fnv1a64(&type, sizeof(type));
+	key = kengine::fnv1a64(filename.data(), filename.size(), key);
+	key = kengine::fnv1a64(&definesKey, sizeof(definesKey), key);
+
+	auto it = m_stages.find(key);
+
+	if (it != m_stages.end())
+		return it->second;
+
+	separable_program stage;
+	stage.type = type;
+	stage.stageBit = getStageBit(type);
+	stage.filename = filename;
+
+	std::string source;
+
+	if (shaderPreprocessor().process(filename, defines.toString(), source)) {
+		// the compilation log is appended to the program log
+		const char* sourcePointer = source.c_str();
+		GLuint program = glCreateShaderProgramv(type, 1, &sourcePointer);
+		m_stats.stageLinks++;
+
+		if (program && checkLinkStatus(program)) {
+			GLint length = 0;
+			glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+			kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::PROGRAM, program, static_cast<size_t>(length), filename);
+
+			stage.program = program;
+		}
+		else if (program) {
+			glDeleteProgram(program);
+		}
+	}
+
+	return m_stages.insert(std::make_pair(key, stage)).first->second;
+}
+
+GLuint kengine::program_pipeline_cache::getPipeline(const separable_program& vertex, const separable_program& fragment)
+{
+	const separable_program* stages[] = { &vertex, &fragment };
+	return getPipeline(stages, 2);
+}
+
+GLuint kengine::program_pipeline_cache::getPipeline(const separable_program* const* stages, int count)
+{
+	std::vector<GLuint> programs;
+
+	for (int index = 0; index < count; index++) {
+		if (!stages[index]->isValid())
+			return 0;
+
+		programs.push_back(stages[index]->program);
+	}
+
+	auto it = m_pipelines.find(programs);
+
+	if (it != m_pipelines.end())
+		return it->second;
+
+	GLuint pipeline = 0;
+	glCreateProgramPipelines(1, &pipeline);
+
+	for (int index = 0; index < count; index++)
+		glUseProgramStages(pipeline, stages[index]->stageBit, stages[index]->program);
+
+	// the validation depends on the current state too, so a failure is only reported
+	glValidateProgramPipeline(pipeline);
+
+	GLint status = 0;
+	glGetProgramPipelineiv(pipeline, GL_VALIDATE_STATUS, &status);
+
+	if (status == GL_FALSE) {
+		std::string log = "> program pipeline: the pipeline of " + stages[0]->filename + " is not valid";
+
+		GLint logLength = 0;
+		glGetProgramPipelineiv(pipeline, GL_INFO_LOG_LENGTH, &logLength);
+
+		if (logLength > 0) {
+			std::string infoLog(static_cast<unsigned int>(logLength), ' ');
+			GLsizei logWrittenLength;
+
+			glGetProgramPipelineInfoLog(pipeline, logLength, &logWrittenLength, &infoLog[0]);
+			log += ": " + infoLog;
+		}
+
+		K_LOG_OUTPUT_RAW(log);
+	}
+
+	m_stats.pipelines++;
+	m_pipelines[programs] = pipeline;
+	return pipeline;
+}
+
+void kengine::program_pipeline_cache::bind(GLuint pipeline)
+{
+	kengine::glState().useProgram(0);
+
+	if (kengine::glState().bindProgramPipeline(pipeline))
+		m_stats.pipelineBinds++;
+}
+
+void kengine::program_pipeline_cache::clear()
+{
+	for (auto& pipeline : m_pipelines) {
+		kengine::glState().releaseProgramPipeline(pipeline.second);
+		glDeleteProgramPipelines(1, &pipeline.second);
+	}
+
+	for (auto& stage : m_stages) {
+		if (stage.second.program) {
+			kengine::gpuMemoryTracker().release(kengine::GPU_MEMORY_CATEGORY::PROGRAM, stage.second.program);
+			glDeleteProgram(stage.second.program);
+		}
+	}
+
+	m_pipelines.clear();
+	m_stages.clear();
+}
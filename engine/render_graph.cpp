@@ -0,0 +1,683 @@
+/*
+	K-Engine Render Graph
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <render_graph.hpp>
+#include <gl_state.hpp>
+#include <gpu_memory.hpp>
+#include <gpu_profiler.hpp>
+#include <logger.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace
+{
+	bool isDepthFormat(GLenum format)
+	{
+		return format == GL_DEPTH_COMPONENT16 || format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32 ||
+			format == GL_DEPTH_COMPONENT32F || format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+	}
+
+	size_t bytesPerPixel(GLenum format)
+	{
+		switch (format) {
+		case GL_R8:
+			return 1;
+		case GL_RG8:
+		case GL_R16F:
+		case GL_DEPTH_COMPONENT16:
+			return 2;
+		case GL_RGBA16F:
+		case GL_RG32F:
+		case GL_DEPTH32F_STENCIL8:
+			return 8;
+		case GL_RGBA32F:
+			return 16;
+		default:
+			return 4; // RGBA8, RGB10_A2, R11F_G11F_B10F, RG16F, R32F, DEPTH24_STENCIL8, etc
+		}
+	}
+
+	bool sameTexture(const kengine::render_texture_desc& first, const kengine::render_texture_desc& second)
+	{
+		return first.width == second.width && first.height == second.height && first.format == second.format;
+	}
+}
+
+/*
+	kengine::render_pass_builder class - member class definition
+*/
+
+void kengine::render_pass_builder::read(render_resource resource)
+{
+	if (!m_graph.isValid(resource)) {
+		K_LOG_OUTPUT_RAW("render_graph: the pass " << m_graph.m_passes[m_pass].name << " reads an invalid resource");
+		m_graph.m_valid = false;
+		return;
+	}
+
+	std::vector<render_resource>& reads = m_graph.m_passes[m_pass].reads;
+
+	if (std::find(reads.begin(), reads.end(), resource) == reads.end())
+		reads.push_back(resource);
+}
+
+void kengine::render_pass_builder::write(render_resource resource)
+{
+	if (!m_graph.isValid(resource)) {
+		K_LOG_OUTPUT_RAW("render_graph: the pass " << m_graph.m_passes[m_pass].name << " writes an invalid resource");
+		m_graph.m_valid = false;
+		return;
+	}
+
+	std::vector<render_resource>& writes = m_graph.m_passes[m_pass].writes;
+
+	if (std::find(writes.begin(), writes.end(), resource) == writes.end())
+		writes.push_back(resource);
+}
+
+void kengine::render_pass_builder::setSideEffect()
+{
+	m_graph.m_passes[m_pass].sideEffect = true;
+}
+
+/*
+	kengine::render_pass_context class - member class definition
+*/
+
+GLuint kengine::render_pass_context::getTexture(render_resource resource) const
+{
+	if (!m_graph.isValid(resource) || m_graph.m_resources[resource].type != RENDER_RESOURCE_TYPE::TEXTURE)
+		return 0;
+
+	return m_graph.getObject(resource);
+}
+
+GLuint kengine::render_pass_context::getBuffer(render_resource resource) const
+{
+	if (!m_graph.isValid(resource) || m_graph.m_resources[resource].type != RENDER_RESOURCE_TYPE::BUFFER)
+		return 0;
+
+	return m_graph.getObject(resource);
+}
+
+/*
+	kengine::render_graph class - member class definition
+*/
+
+kengine::render_graph::~render_graph()
+{
+	releasePool();
+}
+
+kengine::render_resource kengine::render_graph::addResource(const resource& current)
+{
+	m_resources.push_back(current);
+	m_compiled = false;
+
+	return static_cast<render_resource>(m_resources.size() - 1);
+}
+
+kengine::render_resource kengine::render_graph::createTexture(const char* name, const render_texture_desc& desc)
+{
+	if (desc.width <= 0 || desc.height <= 0) {
+		K_LOG_OUTPUT_RAW("render_graph: the texture " << name << " has an invalid size");
+		m_valid = false;
+	}
+
+	resource current;
+	current.name = name;
+	current.texture = desc;
+
+	return addResource(current);
+}
+
+kengine::render_resource kengine::render_graph::createBuffer(const char* name, GLsizeiptr size)
+{
+	if (size <= 0) {
+		K_LOG_OUTPUT_RAW("render_graph: the buffer " << name << " has an invalid size");
+		m_valid = false;
+	}
+
+	resource current;
+	current.name = name;
+	current.type = RENDER_RESOURCE_TYPE::BUFFER;
+	current.size = size;
+
+	return addResource(current);
+}
+
+kengine::render_resource kengine::render_graph::importTexture(const char* name, GLuint texture, const render_texture_desc& desc)
+{
+	resource current;
+	current.name = name;
+	current.texture = desc;
+	current.imported = true;
+	current.object = texture;
+
+	return addResource(current);
+}
+
+kengine::render_resource kengine::render_graph::importBuffer(const char* name, GLuint buffer, GLsizeiptr size)
+{
+	resource current;
+	current.name = name;
+	current.type = RENDER_RESOURCE_TYPE::BUFFER;
+	current.size = size;
+	current.imported = true;
+	current.object = buffer;
+
+	return addResource(current);
+}
+
+kengine::render_resource kengine::render_graph::importBackbuffer(const char* name, int width, int height, GLuint framebuffer)
+{
+	resource current;
+	current.name = name;
+	current.texture.width = width;
+	current.texture.height = height;
+	current.imported = true;
+	current.backbuffer = true;
+	current.object = framebuffer;
+
+	return addResource(current);
+}
+
+unsigned int kengine::render_graph::addPass(const char* name, const setup_callback& setup, const execute_callback& execute)
+{
+	pass current;
+	current.name = name;
+	current.execute = execute;
+	m_passes.push_back(current);
+	m_compiled = false;
+
+	unsigned int index = static_cast<unsigned int>(m_passes.size() - 1);
+	render_pass_builder builder(*this, index);
+
+	if (setup)
+		setup(builder);
+
+	return index;
+}
+
+void kengine::render_graph::reset()
+{
+	m_resources.clear();
+	m_passes.clear();
+	m_order.clear();
+	m_physical.clear();
+	m_stats = render_graph_stats();
+	m_valid = true;
+	m_compiled = false;
+}
+
+bool kengine::render_graph::compile()
+{
+	m_compiled = false;
+	m_order.clear();
+	m_physical.clear();
+	m_stats = render_graph_stats();
+
+	for (auto& current : m_resources) {
+		current.physical = -1;
+		current.used = false;
+		current.firstUse = 0;
+		current.lastUse = 0;
+	}
+
+	if (!m_valid)
+		return false;
+
+	// the textures written by a pass are the attachments of its framebuffer
+	for (const auto& current : m_passes) {
+		int width = 0;
+		int height = 0;
+		unsigned int depthCount = 0;
+		unsigned int textureCount = 0;
+		bool backbuffer = false;
+
+		for (render_resource handle : current.writes) {
+			const resource& written = m_resources[handle];
+
+			if (written.type != RENDER_RESOURCE_TYPE::TEXTURE)
+				continue;
+
+			if (textureCount++ == 0) {
+				width = written.texture.width;
+				height = written.texture.height;
+			}
+
+			depthCount += isDepthFormat(written.texture.format) && !written.backbuffer ? 1 : 0;
+			backbuffer = backbuffer || written.backbuffer;
+
+			if (written.texture.width != width || written.texture.height != height || depthCount > 1 || (backbuffer && textureCount > 1)) {
+				K_LOG_OUTPUT_RAW("render_graph: the attachments of the pass " << current.name << " are incompatible (" << written.name << ")");
+				return false;
+			}
+		}
+	}
+
+	cullAndSort();
+	computeLifetimes();
+	alias();
+
+	m_stats.passes = static_cast<unsigned int>(m_passes.size());
+	m_stats.culledPasses = static_cast<unsigned int>(m_passes.size() - m_order.size());
+	m_compiled = true;
+
+	return true;
+}
+
+void kengine::render_graph::cullAndSort()
+{
+	const size_t passCount = m_passes.size();
+	std::vector<std::vector<unsigned int>> dependencies(passCount); // the passes whose results are used (culling)
+	std::vector<std::vector<unsigned int>> predecessors(passCount); // the dependencies and the write after read edges (order)
+	std::vector<std::vector<unsigned int>> successors(passCount);
+
+	auto addEdge = [&](unsigned int from, unsigned int to, bool dependency) {
+		successors[from].push_back(to);
+		predecessors[to].push_back(from);
+
+		if (dependency)
+			dependencies[to].push_back(from);
+	};
+
+	// a reader follows the last writer declared before it and the next writer follows the readers (write after
+	// read), so it doesn't overwrite the content they read
+	for (render_resource handle = 0; handle < m_resources.size(); handle++) {
+		bool written = false;
+		unsigned int writer = 0;
+		std::vector<unsigned int> readers;
+
+		for (unsigned int index = 0; index < passCount; index++) {
+			const pass& current = m_passes[index];
+			bool writes = std::find(current.writes.begin(), current.writes.end(), handle) != current.writes.end();
+			bool reads = std::find(current.reads.begin(), current.reads.end(), handle) != current.reads.end();
+
+			if (!writes && !reads)
+				continue;
+
+			if (written)
+				addEdge(writer, index, true);
+
+			if (writes) {
+				for (unsigned int reader : readers)
+					addEdge(reader, index, false);
+
+				readers.clear();
+				written = true;
+				writer = index;
+			}
+			else {
+				readers.push_back(index);
+			}
+		}
+	}
+
+	// culling: only the passes that a root depends on are kept
+	std::vector<unsigned int> stack;
+
+	for (unsigned int index = 0; index < passCount; index++) {
+		pass& current = m_passes[index];
+		current.culled = true;
+
+		bool root = current.sideEffect;
+
+		for (render_resource handle : current.writes)
+			root = root || m_resources[handle].imported;
+
+		if (root)
+			stack.push_back(index);
+	}
+
+	while (!stack.empty()) {
+		unsigned int index = stack.back();
+		stack.pop_back();
+
+		if (!m_passes[index].culled)
+			continue;
+
+		m_passes[index].culled = false;
+
+		for (unsigned int dependency : dependencies[index])
+			stack.push_back(dependency);
+	}
+
+	// topological order (the ties are broken by the order of declaration). The edges go from a pass to a pass
+	// declared after it, so there is no cycle.
+	std::vector<unsigned int> inDegree(passCount, 0);
+	std::priority_queue<unsigned int, std::vector<unsigned int>, std::greater<unsigned int>> ready;
+
+	for (unsigned int index = 0; index < passCount; index++) {
+		if (m_passes[index].culled)
+			continue;
+
+		// a culled reader doesn't delay the next writer
+		for (unsigned int predecessor : predecessors[index])
+			inDegree[index] += m_passes[predecessor].culled ? 0 : 1;
+
+		if (inDegree[index] == 0)
+			ready.push(index);
+	}
+
+	while (!ready.empty()) {
+		unsigned int index = ready.top();
+		ready.pop();
+		m_order.push_back(index);
+
+		for (unsigned int successor : successors[index]) {
+			if (!m_passes[successor].culled && --inDegree[successor] == 0)
+				ready.push(successor);
+		}
+	}
+}
+
+void kengine::render_graph::computeLifetimes()
+{
+	for (unsigned int position = 0; position < m_order.size(); position++) {
+		const pass& current = m_passes[m_order[position]];
+
+		for (int access = 0; access < 2; access++) {
+			for (render_resource handle : (access == 0 ? current.reads : current.writes)) {
+				resource& used = m_resources[handle];
+
+				if (!used.used) {
+					used.used = true;
+					used.firstUse = position;
+
+					// the content of a transient resource is undefined before its first write
+					if (!used.imported && std::find(current.writes.begin(), current.writes.end(), handle) == current.writes.end()) {
+						K_LOG_OUTPUT_RAW("render_graph: the pass " << current.name << " reads " << used.name << " before it is written");
+					}
+				}
+
+				used.lastUse = position;
+			}
+		}
+	}
+}
+
+void kengine::render_graph::alias()
+{
+	std::vector<render_resource> transients;
+
+	for (render_resource handle = 0; handle < m_resources.size(); handle++) {
+		if (m_resources[handle].used && !m_resources[handle].imported)
+			transients.push_back(handle);
+	}
+
+	std::stable_sort(transients.begin(), transients.end(), [this](render_resource first, render_resource second) {
+		return m_resources[first].firstUse < m_resources[second].firstUse;
+	});
+
+	// a physical object is reused once the last pass of its previous resource has run
+	for (render_resource handle : transients) {
+		resource& current = m_resources[handle];
+		size_t index = 0;
+
+		for (; index < m_physical.size(); index++) {
+			const physical_resource& physical = m_physical[index];
+
+			if (physical.type != current.type || physical.lastUse >= current.firstUse)
+				continue;
+
+			if (current.type == RENDER_RESOURCE_TYPE::BUFFER || sameTexture(physical.texture, current.texture))
+				break;
+		}
+
+		if (index == m_physical.size()) {
+			physical_resource physical;
+			physical.type = current.type;
+			physical.texture = current.texture;
+			m_physical.push_back(physical);
+		}
+
+		physical_resource& physical = m_physical[index];
+		physical.lastUse = current.lastUse;
+		physical.size = std::max(physical.size, current.size);
+		current.physical = static_cast<int>(index);
+
+		m_stats.transientResources++;
+		m_stats.transientBytes += current.type == RENDER_RESOURCE_TYPE::BUFFER ? static_cast<size_t>(current.size) :
+			static_cast<size_t>(current.texture.width) * current.texture.height * bytesPerPixel(current.texture.format);
+	}
+
+	for (const auto& physical : m_physical) {
+		if (physical.type == RENDER_RESOURCE_TYPE::BUFFER) {
+			m_stats.physicalBuffers++;
+			m_stats.physicalBytes += static_cast<size_t>(physical.size);
+		}
+		else {
+			m_stats.physicalTextures++;
+			m_stats.physicalBytes += static_cast<size_t>(physical.texture.width) * physical.texture.height * bytesPerPixel(physical.texture.format);
+		}
+	}
+}
+
+void kengine::render_graph::acquireObjects()
+{
+	for (auto& physical : m_physical) {
+		physical.object = 0;
+
+		for (auto& pooled : m_pool) {
+			if (pooled.lastFrame == m_frame || pooled.type != physical.type)
+				continue;
+
+			bool compatible = physical.type == RENDER_RESOURCE_TYPE::BUFFER ? pooled.size >= physical.size : sameTexture(pooled.texture, physical.texture);
+
+			if (compatible) {
+				pooled.lastFrame = m_frame;
+				physical.object = pooled.object;
+				break;
+			}
+		}
+
+		if (physical.object != 0)
+			continue;
+
+		pooled_object pooled;
+		pooled.type = physical.type;
+		pooled.texture = physical.texture;
+		pooled.size = physical.size;
+		pooled.lastFrame = m_frame;
+
+		if (physical.type == RENDER_RESOURCE_TYPE::BUFFER) {
+			glCreateBuffers(1, &pooled.object);
+			glNamedBufferStorage(pooled.object, physical.size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+			kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::BUFFER, pooled.object, static_cast<size_t>(physical.size), "render_graph");
+		}
+		else {
+			const render_texture_desc& desc = physical.texture;
+
+			glCreateTextures(GL_TEXTURE_2D, 1, &pooled.object);
+			glTextureStorage2D(pooled.object, 1, desc.format, desc.width, desc.height);
+			glTextureParameteri(pooled.object, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(pooled.object, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(pooled.object, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(pooled.object, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::RENDER_TARGET, pooled.object, static_cast<size_t>(desc.width) * desc.height * bytesPerPixel(desc.format), "render_graph");
+		}
+
+		physical.object = pooled.object;
+		m_pool.push_back(pooled);
+	}
+}
+
+GLuint kengine::render_graph::getObject(render_resource handle) const
+{
+	const resource& current = m_resources[handle];
+
+	if (current.imported)
+		return current.object;
+
+	return current.physical >= 0 ? m_physical[static_cast<size_t>(current.physical)].object : 0;
+}
+
+GLuint kengine::render_graph::getFramebuffer(const std::vector<GLuint>& colors, GLuint depth, GLenum depthAttachment)
+{
+	std::vector<GLuint> key = colors;
+	key.push_back(depth);
+
+	auto found = m_framebuffers.find(key);
+
+	if (found != m_framebuffers.end())
+		return found->second;
+
+	GLuint framebuffer = 0;
+	std::vector<GLenum> drawBuffers;
+
+	glCreateFramebuffers(1, &framebuffer);
+
+	for (size_t index = 0; index < colors.size(); index++) {
+		glNamedFramebufferTexture(framebuffer, static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + index), colors[index], 0);
+		drawBuffers.push_back(static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + index));
+	}
+
+	if (drawBuffers.empty())
+		drawBuffers.push_back(GL_NONE);
+
+	glNamedFramebufferDrawBuffers(framebuffer, static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+
+	if (depth != 0)
+		glNamedFramebufferTexture(framebuffer, depthAttachment, depth, 0);
+
+	if (glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		K_LOG_OUTPUT_RAW("render_graph: incomplete framebuffer (" << colors.size() << " color attachments)");
+	}
+
+	m_framebuffers[key] = framebuffer;
+
+	return framebuffer;
+}
+
+void kengine::render_graph::execute()
+{
+	if (!m_compiled) {
+		K_LOG_OUTPUT_RAW("render_graph: execute without a successful compile");
+		return;
+	}
+
+	m_frame++;
+	acquireObjects();
+
+	for (unsigned int index : m_order) {
+		const pass& current = m_passes[index];
+		render_pass_context context(*this);
+		std::vector<GLuint> colors;
+		GLuint depth = 0;
+		GLenum depthAttachment = GL_DEPTH_ATTACHMENT;
+		bool hasTarget = false;
+		bool backbuffer = false;
+
+		for (render_resource handle : current.writes) {
+			const resource& written = m_resources[handle];
+
+			if (written.type != RENDER_RESOURCE_TYPE::TEXTURE)
+				continue;
+
+			hasTarget = true;
+			context.m_width = written.texture.width;
+			context.m_height = written.texture.height;
+
+			if (written.backbuffer) {
+				backbuffer = true;
+				context.m_framebuffer = written.object;
+			}
+			else if (isDepthFormat(written.texture.format)) {
+				depth = getObject(handle);
+				depthAttachment = (written.texture.format == GL_DEPTH24_STENCIL8 || written.texture.format == GL_DEPTH32F_STENCIL8) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+			}
+			else {
+				colors.push_back(getObject(handle));
+			}
+		}
+
+		if (hasTarget) {
+			if (!backbuffer)
+				context.m_framebuffer = getFramebuffer(colors, depth, depthAttachment);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, context.m_framebuffer);
+			glViewport(0, 0, context.m_width, context.m_height);
+		}
+
+		kengine::gpu_scope scope(current.name);
+
+		if (current.execute)
+			current.execute(context);
+	}
+
+	// the objects that were not used for a few frames are released
+	for (size_t index = 0; index < m_pool.size();) {
+		if (m_frame - m_pool[index].lastFrame >= m_poolLifetime) {
+			releaseObject(m_pool[index]);
+			m_pool.erase(m_pool.begin() + static_cast<std::ptrdiff_t>(index));
+		}
+		else {
+			index++;
+		}
+	}
+}
+
+void kengine::render_graph::releaseObject(const pooled_object& object)
+{
+	if (object.type == RENDER_RESOURCE_TYPE::BUFFER) {
+		GLuint buffer = object.object;
+		kengine::deleteTrackedBuffer(buffer);
+		return;
+	}
+
+	GLuint texture = object.object;
+
+	// the framebuffers of the texture are not valid anymore
+	for (auto framebuffer = m_framebuffers.begin(); framebuffer != m_framebuffers.end();) {
+		if (std::find(framebuffer->first.begin(), framebuffer->first.end(), texture) != framebuffer->first.end()) {
+			glDeleteFramebuffers(1, &framebuffer->second);
+			framebuffer = m_framebuffers.erase(framebuffer);
+		}
+		else {
+			++framebuffer;
+		}
+	}
+
+	kengine::deleteTrackedTexture(texture, GPU_MEMORY_CATEGORY::RENDER_TARGET);
+}
+
+void kengine::render_graph::releasePool()
+{
+	for (const auto& object : m_pool)
+		releaseObject(object);
+
+	for (auto& framebuffer : m_framebuffers)
+		glDeleteFramebuffers(1, &framebuffer.second);
+
+	m_pool.clear();
+	m_framebuffers.clear();
+
+	for (auto& physical : m_physical)
+		physical.object = 0;
+}
@@ -0,0 +1,142 @@
+/*
+	K-Engine Render Queue
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <render_queue.hpp>
+
+#include <cstring>
+
+namespace
+{
+	inline uint64_t field(unsigned int value, int bits)
+	{
+		return static_cast<uint64_t>(value) & ((uint64_t(1) << bits) - 1);
+	}
+}
+
+/*
+	kengine::render_queue class - member class definition
+*/
+
+uint64_t kengine::render_queue::makeKey(unsigned int layer, unsigned int pass, bool translucent, unsigned int program, unsigned int material, unsigned int vertexFormat, float depth)
+{
+	const uint64_t maxDepth = (uint64_t(1) << DEPTH_BITS) - 1;
+
+	if (!(depth > 0.0f)) // NaN too
+		depth = 0.0f;
+	else if (depth > 1.0f)
+		depth = 1.0f;
+
+	uint64_t quantizedDepth = static_cast<uint64_t>(static_cast<double>(depth) * static_cast<double>(maxDepth));
+
+	uint64_t key = field(layer, LAYER_BITS);
+	key = (key << PASS_BITS) | field(pass, PASS_BITS);
+	key = (key << 1) | (translucent ? 1 : 0);
+
+	uint64_t state = field(program, PROGRAM_BITS);
+	state = (state << MATERIAL_BITS) | field(material, MATERIAL_BITS);
+	state = (state << VERTEX_FORMAT_BITS) | field(vertexFormat, VERTEX_FORMAT_BITS);
+
+	const int stateBits = PROGRAM_BITS + MATERIAL_BITS + VERTEX_FORMAT_BITS;
+
+	if (translucent)
+		return (((key << DEPTH_BITS) | (maxDepth - quantizedDepth)) << stateBits) | state;
+
+	return (((key << stateBits) | state) << DEPTH_BITS) | quantizedDepth;
+}
+
+void kengine::render_queue::clear()
+{
+	m_keys.clear();
+	m_order.clear();
+	m_packets.clear();
+	m_stats = render_queue_stats();
+}
+
+void kengine::render_queue::reserve(size_t count)
+{
+	m_keys.reserve(count);
+	m_order.reserve(count);
+	m_packets.reserve(count);
+	m_tempKeys.reserve(count);
+	m_tempOrder.reserve(count);
+}
+
+void kengine::render_queue::push(uint64_t key, const render_packet& packet)
+{
+	m_order.push_back(static_cast<uint32_t>(m_packets.size()));
+	m_keys.push_back(key);
+	m_packets.push_back(packet);
+}
+
+void kengine::render_queue::sort()
+{
+	const size_t count = m_keys.size();
+	m_stats.packets = count;
+
+	if (count < 2)
+		return;
+
+	// the histograms of all bytes are built by a single pass over the keys
+	uint32_t histograms[8][256];
+	std::memset(histograms, 0, sizeof(histograms));
+
+	for (size_t index = 0; index < count; index++) {
+		uint64_t key = m_keys[index];
+
+		for (int byte = 0; byte < 8; byte++)
+			histograms[byte][(key >> (byte * 8)) & 0xFF]++;
+	}
+
+	m_tempKeys.resize(count);
+	m_tempOrder.resize(count);
+
+	for (int byte = 0; byte < 8; byte++) {
+		uint32_t* histogram = histograms[byte];
+
+		// every key has the same value in this byte
+		if (histogram[(m_keys[0] >> (byte * 8)) & 0xFF] == count)
+			continue;
+
+		uint32_t offset = 0;
+
+		for (int bucket = 0; bucket < 256; bucket++) {
+			uint32_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		// the scatter is stable, so the order of the previous passes is kept
+		for (size_t index = 0; index < count; index++) {
+			uint32_t destination = histogram[(m_keys[index] >> (byte * 8)) & 0xFF]++;
+			m_tempKeys[destination] = m_keys[index];
+			m_tempOrder[destination] = m_order[index];
+		}
+
+		m_keys.swap(m_tempKeys);
+		m_order.swap(m_tempOrder);
+		m_stats.sortPasses++;
+	}
+}
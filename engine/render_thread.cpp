@@ -0,0 +1,289 @@
+/*
+	K-Engine Render Thread
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <render_thread.hpp>
+#include <gl_state.hpp>
+#include <vertex_format.hpp>
+#include <os_api_wrapper.hpp>
+#include <logger.hpp>
+
+/*
+	kengine::frame_packet struct - member definition
+*/
+
+void kengine::frame_packet::reset()
+{
+	frame = 0;
+	frameTime = 0;
+
+	for (command_buffer& buffer : commandBuffers)
+		buffer.reset();
+}
+
+/*
+	kengine::render_thread class - member class definition
+*/
+
+kengine::render_thread::render_thread(rendering_system* renderingSystem, std::function<void(const frame_packet&)> render)
+	: m_renderingSystem(renderingSystem), m_render(std::move(render))
+{
+}
+
+kengine::render_thread::~render_thread()
+{
+	stop();
+}
+
+bool kengine::render_thread::start()
+{
+	if (m_thread.joinable())
+		return true;
+
+	// a context can only be current on one thread
+	m_renderingSystem->makeCurrent(false);
+
+	m_running = true;
+	m_contextReady = false;
+	m_contextFailed = false;
+	m_published = -1;
+	m_rendering = -1;
+	m_runningTasks = false;
+	m_thread = std::thread(&render_thread::run, this);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_condition.wait(lock, [this] { return m_contextReady || m_contextFailed; });
+
+	if (m_contextFailed) {
+		lock.unlock();
+		m_thread.join();
+		m_renderingSystem->makeCurrent(true);
+		K_LOG_OUTPUT_RAW("render_thread: the rendering context could not be made current on the render thread");
+		return false;
+	}
+
+	return true;
+}
+
+void kengine::render_thread::stop()
+{
+	if (!m_thread.joinable())
+		return;
+
+	sync();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+
+	m_condition.notify_all();
+	m_thread.join();
+
+	m_renderingSystem->makeCurrent(true);
+
+	// the state cache belongs to the main thread again
+	kengine::glState().invalidate();
+	kengine::vertexFormatRegistry().invalidate();
+}
+
+kengine::frame_packet& kengine::render_thread::beginFrame(int64_t frameTime)
+{
+	frame_packet& packet = m_packets[m_writeIndex];
+
+	packet.reset();
+	packet.frame = m_frame;
+	packet.frameTime = frameTime;
+
+	return packet;
+}
+
+void kengine::render_thread::endFrame()
+{
+	m_frame++;
+
+	if (!m_thread.joinable()) {
+		// not running: the frame is drawn on the calling thread
+		runTasks();
+		m_renderingSystem->newFrame();
+		m_renderingSystem->clearBuffers();
+		executeCommandBuffers(m_packets[m_writeIndex].commandBuffers.data(), m_packets[m_writeIndex].commandBuffers.size());
+
+		if (m_render)
+			m_render(m_packets[m_writeIndex]);
+
+		m_renderingSystem->swapBuffers();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		// the render thread is still drawing the previous packet (at most one frame of latency)
+		if (m_published != -1) {
+			m_stats.simulationStalls++;
+			m_condition.wait(lock, [this] { return m_published == -1; });
+		}
+
+		m_published = m_writeIndex;
+		m_writeIndex = 1 - m_writeIndex;
+
+		// the new write packet may be the one that is being drawn
+		if (m_rendering == m_writeIndex) {
+			m_stats.simulationStalls++;
+			m_condition.wait(lock, [this] { return m_rendering != m_writeIndex; });
+		}
+	}
+
+	m_condition.notify_all();
+}
+
+void kengine::render_thread::sync()
+{
+	if (!m_thread.joinable()) {
+		runTasks();
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_condition.wait(lock, [this] { return m_published == -1 && m_rendering == -1 && !m_runningTasks && m_tasks.empty(); });
+}
+
+void kengine::render_thread::enqueue(std::function<void()> task)
+{
+	if (!m_thread.joinable()) {
+		task();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+
+	m_condition.notify_all();
+}
+
+kengine::render_thread_stats kengine::render_thread::getStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void kengine::render_thread::run()
+{
+	int made = m_renderingSystem->makeCurrent(true);
+
+	// the state cache belongs to the thread of the context (the objects deleted here are released from it)
+	if (made) {
+		kengine::glState().invalidate();
+		kengine::vertexFormatRegistry().invalidate();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (made)
+			m_contextReady = true;
+		else
+			m_contextFailed = true;
+	}
+
+	m_condition.notify_all();
+
+	if (!made)
+		return;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (true) {
+		if (m_published == -1 && m_tasks.empty() && m_running) {
+			m_stats.renderStalls++;
+			m_condition.wait(lock, [this] { return m_published != -1 || !m_tasks.empty() || !m_running; });
+		}
+
+		if (!m_tasks.empty()) {
+			std::vector<std::function<void()>> tasks;
+			tasks.swap(m_tasks);
+
+			m_runningTasks = true;
+			lock.unlock();
+
+			for (std::function<void()>& task : tasks)
+				task();
+
+			lock.lock();
+			m_runningTasks = false;
+			m_condition.notify_all();
+		}
+
+		if (m_published != -1) {
+			const frame_packet& packet = m_packets[m_published];
+
+			// the packet is released before the swap, so the simulation of the next frame is not blocked by the vsync
+			m_rendering = m_published;
+			m_published = -1;
+			lock.unlock();
+			m_condition.notify_all();
+
+			int64_t startTime = getHighResolutionTimerCounter();
+
+			m_renderingSystem->newFrame();
+			m_renderingSystem->clearBuffers();
+			executeCommandBuffers(packet.commandBuffers.data(), packet.commandBuffers.size());
+
+			if (m_render)
+				m_render(packet);
+
+			m_renderingSystem->swapBuffers();
+
+			lock.lock();
+			m_rendering = -1;
+			m_stats.frames++;
+			m_stats.lastRenderTime = getHighResolutionTimerCounter() - startTime;
+			m_condition.notify_all();
+			continue;
+		}
+
+		if (!m_running && m_tasks.empty())
+			break;
+	}
+
+	lock.unlock();
+	m_renderingSystem->makeCurrent(false);
+}
+
+void kengine::render_thread::runTasks()
+{
+	std::vector<std::function<void()>> tasks;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		tasks.swap(m_tasks);
+	}
+
+	for (std::function<void()>& task : tasks)
+		task();
+}
@@ -25,6 +25,11 @@
 
 #include <rendering_system.hpp>
 #include <os_api_wrapper.hpp>
+#include <vertex_format.hpp>
+#include <gpu_memory.hpp>
+#include <gl_state.hpp>
+#include <gpu_profiler.hpp>
+#include <gl_capture.hpp>
 
 #include <cassert>
 #include <sstream>
@@ -38,6 +43,11 @@ kengine::rendering_system::rendering_system(window* win)
 	m_context = kengine::renderingContextInstance(win);
 }
 
+kengine::rendering_system::rendering_system(rendering_context* context)
+	: m_context(context)
+{
+}
+
 kengine::rendering_system::~rendering_system()
 {
 	delete m_context;
@@ -46,7 +56,12 @@ kengine::rendering_system::~rendering_system()
 int kengine::rendering_system::init(RENDERING_TYPE renderingType, const compatibility_profile& profile)
 {
 	m_type = renderingType;
-	m_context->create(profile);
+
+	if (!m_context->create(profile))
+		return 0;
+
+	// the state cache belongs to the thread of the main context
+	kengine::glState().invalidate();
 	
 //#if defined(__ANDROID__)
 //	context->create();
@@ -58,6 +73,10 @@ int kengine::rendering_system::init(RENDERING_TYPE renderingType, const compatib
 
 void kengine::rendering_system::finish()
 {
+	// the shared VAOs must be deleted while the context is still alive
+	kengine::vertexFormatRegistry().clear();
+	kengine::gpuProfiler().finish();
+
 	//context->makeCurrent(false);
 	delete m_context;
 	m_context = nullptr;
@@ -75,6 +94,27 @@ void kengine::rendering_system::clearBuffers()
 	m_context->clearBuffers();
 }
 
+void kengine::rendering_system::newFrame()
+{
+	kengine::vertexFormatRegistry().newFrame();
+	kengine::gpuMemoryTracker().newFrame();
+	kengine::glState().newFrame();
+	kengine::gpuProfiler().newFrame();
+	kengine::glCapture().newFrame();
+}
+
+int kengine::rendering_system::makeCurrent(bool enable)
+{
+	assert(!(m_context == nullptr)); // remove branching code in the release version
+	return m_context->makeCurrent(enable);
+}
+
+kengine::rendering_context* kengine::rendering_system::createSharedContext()
+{
+	assert(!(m_context == nullptr)); // remove branching code in the release version
+	return m_context->createSharedContext();
+}
+
 std::string kengine::rendering_system::info(bool extension)
 {
 	assert(!(m_context == nullptr)); // remove branching code in the release version
@@ -0,0 +1,212 @@
+/*
+	K-Engine Shader Batch
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <shader_batch.hpp>
+#include <program_cache.hpp>
+#include <shader_preprocessor.hpp>
+#include <logger.hpp>
+
+/*
+	kengine::shader_batch class - member class definition
+*/
+
+kengine::shader_batch::shader_batch()
+{
+	bool khr = isExtensionSupported("GL_KHR_parallel_shader_compile");
+	m_parallel = khr || isExtensionSupported("GL_ARB_parallel_shader_compile");
+
+	// 0xFFFFFFFF means the maximum number of threads supported by the implementation
+	if (khr && glMaxShaderCompilerThreadsKHR != nullptr)
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+}
+
+kengine::shader_batch::~shader_batch()
+{
+	// the programs which were not completed are discarded (the previous programs are kept)
+	for (auto& pending : m_pending)
+		discard(pending);
+}
+
+void kengine::shader_batch::add(GLSLprogram& program, const ShaderInfo* shaders, std::function<void(bool)> completion)
+{
+	pending_program pending;
+	pending.program = &program;
+	pending.owner = shaders[0].filename;
+	pending.completion = std::move(completion);
+
+	std::string sources[6];
+	int count = 0;
+
+	for (; count < 6 && shaders[count].type != GL_NONE; count++) {
+		pending.types[count] = shaders[count].type;
+		shaderPreprocessor().process(shaders[count].filename, shaders[count].defines, sources[count]);
+	}
+
+	kengine::program_cache& cache = kengine::programCache();
+
+	if (cache.isEnabled()) {
+		pending.key = cache.makeKey(pending.types, sources, count);
+		pending.handle = cache.load(pending.key, pending.binaryFormat, pending.uniforms);
+
+		if (pending.handle) {
+			pending.cached = true;
+			m_pending.push_back(std::move(pending));
+			return;
+		}
+	}
+
+	// the status is not queried here, so the driver can compile all stages of all programs concurrently
+	for (int index = 0; index < count; index++) {
+		if (sources[index].empty())
+			continue;
+
+		const GLchar* source = sources[index].c_str();
+		pending.shaders[index] = glCreateShader(pending.types[index]);
+		glShaderSource(pending.shaders[index], 1, &source, nullptr);
+		glCompileShader(pending.shaders[index]);
+	}
+
+	pending.handle = glCreateProgram();
+
+	for (int index = 0; index < 6; index++) {
+		if (pending.shaders[index])
+			glAttachShader(pending.handle, pending.shaders[index]);
+	}
+
+	if (cache.isEnabled())
+		glProgramParameteri(pending.handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	glLinkProgram(pending.handle);
+	m_pending.push_back(std::move(pending));
+}
+
+int kengine::shader_batch::cancel(const GLSLprogram& program)
+{
+	int cancelled = 0;
+	size_t index = 0;
+
+	while (index < m_pending.size()) {
+		if (m_pending[index].program != &program) {
+			index++;
+			continue;
+		}
+
+		discard(m_pending[index]);
+		m_pending.erase(m_pending.begin() + static_cast<std::ptrdiff_t>(index));
+		cancelled++;
+	}
+
+	return cancelled;
+}
+
+int kengine::shader_batch::update(int maxBlockingPerUpdate)
+{
+	int completed = 0;
+	int blocking = 0;
+	size_t index = 0;
+
+	while (index < m_pending.size()) {
+		pending_program& pending = m_pending[index];
+
+		if (!pending.cached) {
+			if (m_parallel) {
+				GLint done = GL_FALSE;
+				glGetProgramiv(pending.handle, GL_COMPLETION_STATUS_KHR, &done);
+
+				if (done == GL_FALSE) {
+					index++;
+					continue;
+				}
+			} else if (blocking++ >= maxBlockingPerUpdate) {
+				break;
+			}
+		}
+
+		pending_program finished = std::move(pending);
+		m_pending.erase(m_pending.begin() + static_cast<std::ptrdiff_t>(index));
+		complete(finished);
+		completed++;
+	}
+
+	return completed;
+}
+
+void kengine::shader_batch::finish()
+{
+	while (!m_pending.empty()) {
+		pending_program finished = std::move(m_pending.front());
+		m_pending.erase(m_pending.begin());
+		complete(finished);
+	}
+}
+
+void kengine::shader_batch::complete(pending_program& pending)
+{
+	bool linked = true;
+
+	if (pending.cached) {
+		pending.program->setProgram(pending.handle, pending.owner);
+		pending.program->binaryFormat = pending.binaryFormat;
+		pending.program->uniforms = pending.uniforms;
+	} else {
+		// the compile logs are printed only when the link fails
+		linked = checkLinkStatus(pending.handle);
+
+		for (int i = 0; i < 6; i++) {
+			if (pending.shaders[i]) {
+				if (!linked)
+					checkCompileStatus(pending.shaders[i], pending.types[i]);
+
+				glDetachShader(pending.handle, pending.shaders[i]);
+				glDeleteShader(pending.shaders[i]);
+			}
+		}
+
+		if (linked) {
+			pending.program->setProgram(pending.handle, pending.owner);
+			pending.program->reflectUniforms();
+
+			kengine::program_cache& cache = kengine::programCache();
+
+			if (cache.isEnabled())
+				cache.save(pending.key, pending.handle, pending.program->uniforms);
+		} else {
+			glDeleteProgram(pending.handle);
+		}
+	}
+
+	if (pending.completion)
+		pending.completion(linked);
+}
+
+void kengine::shader_batch::discard(pending_program& pending)
+{
+	for (int i = 0; i < 6; i++) {
+		if (pending.shaders[i])
+			glDeleteShader(pending.shaders[i]);
+	}
+
+	glDeleteProgram(pending.handle);
+}
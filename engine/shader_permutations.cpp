@@ -0,0 +1,122 @@
+/*
+	K-Engine Shader Permutations
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <shader_permutations.hpp>
+#include <shader_watcher.hpp>
+#include <k_hash.hpp>
+#include <logger.hpp>
+
+/*
+	kengine::shader_permutations class - member class definition
+*/
+
+kengine::shader_permutations::shader_permutations(const ShaderInfo* shaders)
+{
+	for (int index = 0; shaders[index].type != GL_NONE; index++) {
+		ShaderInfo shader = { shaders[index].type, shaders[index].filename };
+		m_shaders.push_back(shader);
+	}
+
+	ShaderInfo end = { GL_NONE, "" };
+	m_shaders.push_back(end);
+}
+
+kengine::shader_permutations::~shader_permutations()
+{
+	if (m_watcher) {
+		for (auto& program : m_programs)
+			m_watcher->unwatch(*program.second);
+	}
+}
+
+kengine::GLSLprogram* kengine::shader_permutations::get(const shader_define_set& defines)
+{
+	uint64_t key = defines.getKey();
+	auto it = m_permutations.find(key);
+
+	if (it == m_permutations.end()) {
+		std::vector<ShaderInfo> shaders = m_shaders;
+		std::string defineLines = defines.toString();
+		uint64_t hash = kengine::fnv1a64(nullptr, 0);
+
+		for (auto& shader : shaders) {
+			if (shader.type == GL_NONE)
+				break;
+
+			std::string source;
+			shader.defines = defineLines;
+			shaderPreprocessor().process(shader.filename, shader.defines, source);
+
+			hash = kengine::fnv1a64(&shader.type, sizeof(shader.type), hash);
+			hash = kengine::fnv1a64(source.data(), source.size(), hash);
+		}
+
+		auto program = m_programs.find(hash);
+
+		if (program == m_programs.end()) {
+			std::unique_ptr<GLSLprogram> newProgram(new GLSLprogram());
+
+			if (!newProgram->loadShaders(shaders.data()))
+				K_LOG_OUTPUT_RAW("> shader permutations: it was not possible to link " << m_shaders[0].filename << " with the defines:\n" << defineLines);
+
+			// a broken permutation is watched too, so it is fixed by the next edit
+			if (m_watcher)
+				m_watcher->watch(*newProgram, shaders.data());
+
+			program = m_programs.insert(std::make_pair(hash, std::move(newProgram))).first;
+		}
+
+		it = m_permutations.insert(std::make_pair(key, program->second.get())).first;
+	}
+
+	return it->second->getProgramID() ? it->second : nullptr;
+}
+
+kengine::GLSLprogram* kengine::shader_permutations::getSpecialized(const std::vector<specialization_constants>& constants)
+{
+	uint64_t key = kengine::fnv1a64(nullptr, 0);
+
+	for (size_t index = 0; index + 1 < m_shaders.size(); index++) {
+		uint64_t stageKey = index < constants.size() ? constants[index].getKey() : 0;
+		key = kengine::fnv1a64(&stageKey, sizeof(stageKey), key);
+	}
+
+	auto it = m_specializations.find(key);
+
+	if (it == m_specializations.end()) {
+		std::vector<ShaderInfo> shaders = m_shaders;
+
+		for (size_t index = 0; index < constants.size() && shaders[index].type != GL_NONE; index++)
+			shaders[index].constants = constants[index];
+
+		std::unique_ptr<GLSLprogram> program(new GLSLprogram());
+		program->loadSPIRVShaders(shaders.data());
+
+		it = m_specializations.insert(std::make_pair(key, std::move(program))).first;
+	}
+
+	return it->second->getProgramID() ? it->second.get() : nullptr;
+}
@@ -0,0 +1,309 @@
+/*
+	K-Engine Shader Preprocessor
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <shader_preprocessor.hpp>
+#include <os_api_wrapper.hpp>
+#include <k_hash.hpp>
+#include <logger.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	/*
+		It returns true if the line is the directive "#name" (the spaces before and after '#' are allowed)
+	*/
+	bool isDirective(const std::string& line, const char* name, std::string& argument)
+	{
+		size_t position = line.find_first_not_of(" \t");
+
+		if (position == std::string::npos || line[position] != '#')
+			return false;
+
+		position = line.find_first_not_of(" \t", position + 1);
+
+		if (position == std::string::npos || line.compare(position, std::char_traits<char>::length(name), name) != 0)
+			return false;
+
+		position += std::char_traits<char>::length(name);
+
+		if (position < line.size() && line[position] != ' ' && line[position] != '\t' && line[position] != '"' && line[position] != '<' && line[position] != '\r')
+			return false;
+
+		argument = line.substr(position);
+		return true;
+	}
+
+	/*
+		"file" or <file>
+	*/
+	std::string getIncludeName(const std::string& argument)
+	{
+		size_t begin = argument.find_first_of("\"<");
+
+		if (begin == std::string::npos)
+			return "";
+
+		size_t end = argument.find(argument[begin] == '"' ? '"' : '>', begin + 1);
+
+		if (end == std::string::npos)
+			return "";
+
+		return argument.substr(begin + 1, end - begin - 1);
+	}
+
+	std::string getDirectory(const std::string& path)
+	{
+		size_t separator = path.find_last_of("/\\");
+		return separator == std::string::npos ? "." : path.substr(0, separator);
+	}
+
+	bool fileExists(const std::string& path)
+	{
+		std::ifstream filestream(path, std::ios::in | std::ios::binary);
+		return static_cast<bool>(filestream);
+	}
+}
+
+/*
+	kengine::shader_define_set class - member class definition
+*/
+
+kengine::shader_define_set& kengine::shader_define_set::set(const std::string& name, const std::string& value)
+{
+	m_defines[name] = value;
+	return *this;
+}
+
+void kengine::shader_define_set::remove(const std::string& name)
+{
+	m_defines.erase(name);
+}
+
+uint64_t kengine::shader_define_set::getKey() const
+{
+	if (m_defines.empty())
+		return 0;
+
+	uint64_t key = kengine::fnv1a64(nullptr, 0);
+
+	// the separators avoid collisions like {"AB", "C"} and {"A", "BC"}
+	for (const auto& define : m_defines) {
+		key = kengine::fnv1a64(define.first.data(), define.first.size(), key);
+		key = kengine::fnv1a64("=", 1, key);
+		key = kengine::fnv1a64(define.second.data(), define.second.size(), key);
+		key = kengine::fnv1a64(";", 1, key);
+	}
+
+	return key;
+}
+
+std::string kengine::shader_define_set::toString() const
+{
+	std::string defines;
+
+	for (const auto& define : m_defines)
+		defines += "#define " + define.first + " " + define.second + "\n";
+
+	return defines;
+}
+
+/*
+	kengine::shader_preprocessor class - member class definition
+*/
+
+void kengine::shader_preprocessor::addIncludeDirectory(const std::string& directory)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_includeDirectories.push_back(directory);
+}
+
+bool kengine::shader_preprocessor::process(const std::string& filename, const std::string& defines, std::string& output, std::vector<std::string>* dependencies)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<std::string> files(1, kengine::getCanonicalPath(filename));
+	output.clear();
+
+	bool ret = expand(0, defines, files, output);
+
+	if (!ret)
+		output.clear();
+
+	if (dependencies)
+		*dependencies = files;
+
+	return ret;
+}
+
+void kengine::shader_preprocessor::invalidate(const std::string& filename)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_sources.erase(kengine::getCanonicalPath(filename));
+}
+
+void kengine::shader_preprocessor::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_sources.clear();
+}
+
+size_t kengine::shader_preprocessor::getCachedFileCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_sources.size();
+}
+
+bool kengine::shader_preprocessor::getSource(const std::string& path, std::string& source)
+{
+	auto it = m_sources.find(path);
+
+	if (it != m_sources.end()) {
+		source = it->second;
+		return true;
+	}
+
+	std::ifstream filestream(path, std::ios::in | std::ios::binary);
+
+	if (!filestream)
+		return false;
+
+	std::ostringstream stream;
+	stream << filestream.rdbuf();
+
+	source = stream.str();
+	m_sources[path] = source;
+	return true;
+}
+
+std::string kengine::shader_preprocessor::resolveInclude(const std::string& name, const std::string& includingPath) const
+{
+	std::string path = getDirectory(includingPath) + "/" + name;
+
+	if (m_sources.count(kengine::getCanonicalPath(path)) || fileExists(path))
+		return kengine::getCanonicalPath(path);
+
+	for (const auto& directory : m_includeDirectories) {
+		path = directory + "/" + name;
+
+		if (fileExists(path))
+			return kengine::getCanonicalPath(path);
+	}
+
+	return "";
+}
+
+bool kengine::shader_preprocessor::expand(size_t fileIndex, const std::string& defines, std::vector<std::string>& files, std::string& output)
+{
+	std::string source;
+
+	if (!getSource(files[fileIndex], source)) {
+		K_LOG_OUTPUT_RAW("This file " << files[fileIndex] << " cannot be opened.");
+		return false;
+	}
+
+	std::string argument;
+	bool root = (fileIndex == 0);
+	bool injected = !root || defines.empty();
+
+	// without #version the defines are the first lines
+	if (!injected && source.find("#version") == std::string::npos) {
+		output += defines;
+		output += "#line 1 0\n";
+		injected = true;
+	}
+
+	size_t begin = 0;
+	int lineNumber = 0;
+
+	while (begin < source.size()) {
+		size_t end = source.find('\n', begin);
+
+		if (end == std::string::npos)
+			end = source.size();
+
+		std::string line = source.substr(begin, end - begin);
+		begin = end + 1;
+		lineNumber++;
+
+		if (isDirective(line, "include", argument)) {
+			std::string name = getIncludeName(argument);
+			std::string path = name.empty() ? "" : resolveInclude(name, files[fileIndex]);
+
+			if (path.empty()) {
+				K_LOG_OUTPUT_RAW("> shader preprocessor: " << files[fileIndex] << "(" << lineNumber << "): cannot include" << argument);
+				return false;
+			}
+
+			if (std::find(files.begin(), files.end(), path) == files.end()) {
+				files.push_back(path);
+				size_t includeIndex = files.size() - 1;
+
+				output += "#line 1 " + std::to_string(includeIndex) + "\n";
+
+				if (!expand(includeIndex, defines, files, output))
+					return false;
+
+				output += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+			}
+			else {
+				output += "\n"; // already included
+			}
+
+			continue;
+		}
+
+		if (isDirective(line, "version", argument)) {
+			// the included files can be complete shaders, but only the version of the stage is valid
+			if (!root) {
+				output += "\n";
+				continue;
+			}
+
+			output += line + "\n";
+
+			if (!injected) {
+				output += defines;
+				output += "#line " + std::to_string(lineNumber + 1) + " 0\n";
+				injected = true;
+			}
+
+			continue;
+		}
+
+		output += line + "\n";
+	}
+
+	return true;
+}
+
+kengine::shader_preprocessor& kengine::shaderPreprocessor()
+{
+	static shader_preprocessor preprocessor;
+	return preprocessor;
+}
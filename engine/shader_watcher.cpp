@@ -0,0 +1,265 @@
+/*
+	K-Engine Shader Watcher
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <shader_watcher.hpp>
+#include <os_api_wrapper.hpp>
+#include <shader_preprocessor.hpp>
+#include <logger.hpp>
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// the editors usually write a file with several events, so the reload waits for them
+	const int64_t DEBOUNCE_TIME_IN_MS = 50;
+
+	std::string getDirectory(const std::string& path)
+	{
+		size_t separator = path.find_last_of("/\\");
+		return separator == std::string::npos ? "." : path.substr(0, separator);
+	}
+}
+
+/*
+	kengine::shader_watcher class - member class definition
+*/
+
+kengine::shader_watcher::shader_watcher()
+{
+#if defined(__linux__)
+	m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (m_fd < 0) {
+		K_LOG_OUTPUT_RAW("> shader watcher: inotify is not available, the shaders will not be reloaded");
+		return;
+	}
+
+	m_running = true;
+	m_thread = std::thread(&shader_watcher::run, this);
+#else
+	K_LOG_OUTPUT_RAW("> shader watcher: the file events are not supported on this platform");
+#endif
+}
+
+kengine::shader_watcher::~shader_watcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+
+	if (m_thread.joinable())
+		m_thread.join();
+
+#if defined(__linux__)
+	if (m_fd >= 0)
+		close(m_fd);
+#endif
+}
+
+void kengine::shader_watcher::watch(GLSLprogram& program, const ShaderInfo* shaders, std::function<void(bool)> reloaded)
+{
+	unwatch(program);
+
+	watched_program watched;
+	watched.program = &program;
+	watched.reloaded = std::move(reloaded);
+
+	for (int index = 0; shaders[index].type != GL_NONE; index++) {
+		watched.shaders.push_back(shaders[index]);
+		addFile(watched, shaders[index].filename);
+	}
+
+	ShaderInfo end = { GL_NONE, "" };
+	watched.shaders.push_back(end);
+	addIncludes(watched);
+
+	m_programs.push_back(std::move(watched));
+}
+
+void kengine::shader_watcher::unwatch(GLSLprogram& program)
+{
+	// a queued reload must not complete on a program that is going to be destroyed
+	m_batch.cancel(program);
+
+	m_programs.erase(std::remove_if(m_programs.begin(), m_programs.end(), [&program](const watched_program& watched) {
+		return watched.program == &program;
+	}), m_programs.end());
+}
+
+void kengine::shader_watcher::addDependency(GLSLprogram& program, const std::string& filename)
+{
+	for (auto& watched : m_programs) {
+		if (watched.program == &program)
+			addFile(watched, filename);
+	}
+}
+
+void kengine::shader_watcher::addIncludes(watched_program& watched)
+{
+	std::string source;
+	std::vector<std::string> dependencies;
+
+	for (const auto& shader : watched.shaders) {
+		if (shader.type == GL_NONE)
+			break;
+
+		shaderPreprocessor().process(shader.filename, shader.defines, source, &dependencies);
+
+		for (const auto& dependency : dependencies)
+			addFile(watched, dependency);
+	}
+}
+
+void kengine::shader_watcher::addFile(watched_program& watched, const std::string& filename)
+{
+	std::string path = kengine::getCanonicalPath(filename);
+
+	if (std::find(watched.files.begin(), watched.files.end(), path) == watched.files.end())
+		watched.files.push_back(path);
+
+#if defined(__linux__)
+	if (m_fd < 0)
+		return;
+
+	// the directory is watched because many editors replace the file (rename) instead of writing it
+	std::string directory = getDirectory(path);
+	int wd = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+	if (wd < 0) {
+		K_LOG_OUTPUT_RAW("> shader watcher: it was not possible to watch " << directory);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_directories[wd] = directory;
+#endif
+}
+
+void kengine::shader_watcher::update()
+{
+	int64_t now = kengine::getHighResolutionTimerCounter();
+	int64_t frequency = kengine::getHighResolutionTimerFrequency();
+	std::map<std::string, int64_t> changed;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (auto it = m_changed.begin(); it != m_changed.end();) {
+			if ((now - it->second) * 1000 / frequency >= DEBOUNCE_TIME_IN_MS) {
+				changed.insert(*it);
+				it = m_changed.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	// the cached sources of the changed files are stale
+	for (const auto& file : changed)
+		shaderPreprocessor().invalidate(file.first);
+
+	for (auto& watched : m_programs) {
+		int64_t eventTime = 0;
+
+		for (const auto& file : watched.files) {
+			auto it = changed.find(file);
+
+			if (it != changed.end())
+				eventTime = std::max(eventTime, it->second);
+		}
+
+		if (eventTime == 0)
+			continue;
+
+		// the edit can add an include
+		addIncludes(watched);
+
+		std::string name = watched.shaders[0].filename;
+		std::function<void(bool)> reloaded = watched.reloaded;
+
+		// the old program keeps rendering until the new one is linked
+		m_batch.add(*watched.program, watched.shaders.data(), [eventTime, frequency, name, reloaded](bool linked) {
+			int64_t latency = (kengine::getHighResolutionTimerCounter() - eventTime) * 1000 / frequency;
+
+			if (linked) {
+				K_LOG_OUTPUT_RAW("> shader watcher: " << name << " reloaded in " << latency << " ms");
+			} else {
+				K_LOG_OUTPUT_RAW("> shader watcher: " << name << " failed to reload (the previous program is kept)");
+			}
+
+			if (reloaded)
+				reloaded(linked);
+		});
+	}
+
+	m_batch.update();
+}
+
+void kengine::shader_watcher::run()
+{
+#if defined(__linux__)
+	alignas(inotify_event) char buffer[4096];
+
+	while (true) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (!m_running)
+				break;
+		}
+
+		pollfd descriptor = { m_fd, POLLIN, 0 };
+
+		// the timeout is the time to notice the end of the watcher
+		if (poll(&descriptor, 1, 100) <= 0)
+			continue;
+
+		ssize_t length = read(m_fd, buffer, sizeof(buffer));
+
+		if (length <= 0)
+			continue;
+
+		int64_t now = kengine::getHighResolutionTimerCounter();
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (char* pointer = buffer; pointer < buffer + length; ) {
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(pointer);
+			auto directory = m_directories.find(event->wd);
+
+			if (event->len > 0 && directory != m_directories.end())
+				m_changed[directory->second + "/" + event->name] = now;
+
+			pointer += sizeof(inotify_event) + event->len;
+		}
+	}
+#endif
+}
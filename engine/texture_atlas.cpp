@@ -0,0 +1,452 @@
+/*
+	K-Engine Texture Atlas
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <texture_atlas.hpp>
+#include <gl_state.hpp>
+#include <gpu_memory.hpp>
+#include <logger.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	const std::string ATLAS_OWNER = "texture_atlas";
+	const int BYTES_PER_TEXEL = 4;
+
+	int alignUp(int value, int alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	size_t layerBytes(int layerSize, int levels)
+	{
+		size_t bytes = 0;
+
+		for (int level = 0; level < levels; level++) {
+			size_t size = static_cast<size_t>(std::max(1, layerSize >> level));
+			bytes += size * size * BYTES_PER_TEXEL;
+		}
+
+		return bytes;
+	}
+}
+
+/*
+	kengine::skyline_packer class - member class definition
+*/
+
+void kengine::skyline_packer::reset(int width, int height)
+{
+	m_width = std::max(width, 0);
+	m_height = std::max(height, 0);
+	m_usedArea = 0;
+	m_skyline.clear();
+
+	if (m_width > 0)
+		m_skyline.push_back({ 0, 0, m_width });
+}
+
+bool kengine::skyline_packer::insert(int width, int height, atlas_rect& rect)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	int bestTop = std::numeric_limits<int>::max();
+	int bestWidth = std::numeric_limits<int>::max();
+	size_t bestIndex = m_skyline.size();
+	int bestY = 0;
+
+	for (size_t index = 0; index < m_skyline.size(); index++) {
+		int y = 0;
+
+		if (!fit(index, width, height, y))
+			continue;
+
+		// the lowest top, then the narrowest segment (less wasted area under the rectangle)
+		if (y + height < bestTop || (y + height == bestTop && m_skyline[index].width < bestWidth)) {
+			bestTop = y + height;
+			bestWidth = m_skyline[index].width;
+			bestIndex = index;
+			bestY = y;
+		}
+	}
+
+	if (bestIndex == m_skyline.size())
+		return false;
+
+	rect.x = m_skyline[bestIndex].x;
+	rect.y = bestY;
+	rect.width = width;
+	rect.height = height;
+
+	skyline_node node = { rect.x, rect.y + height, width };
+	m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(bestIndex), node);
+
+	// the segments under the new one are shortened or removed
+	for (size_t index = bestIndex + 1; index < m_skyline.size();) {
+		const skyline_node& previous = m_skyline[index - 1];
+		int overlap = previous.x + previous.width - m_skyline[index].x;
+
+		if (overlap <= 0)
+			break;
+
+		m_skyline[index].x += overlap;
+		m_skyline[index].width -= overlap;
+
+		if (m_skyline[index].width > 0)
+			break;
+
+		m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(index));
+	}
+
+	// the neighbours at the same height are merged
+	for (size_t index = 0; index + 1 < m_skyline.size();) {
+		if (m_skyline[index].y == m_skyline[index + 1].y) {
+			m_skyline[index].width += m_skyline[index + 1].width;
+			m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(index + 1));
+		}
+		else {
+			index++;
+		}
+	}
+
+	m_usedArea += static_cast<size_t>(width) * static_cast<size_t>(height);
+
+	return true;
+}
+
+float kengine::skyline_packer::getOccupancy() const
+{
+	if (m_width == 0 || m_height == 0)
+		return 0.0f;
+
+	return static_cast<float>(static_cast<double>(m_usedArea) / (static_cast<double>(m_width) * static_cast<double>(m_height)));
+}
+
+/*
+	The rectangle rests on the highest segment under it
+*/
+bool kengine::skyline_packer::fit(size_t index, int width, int height, int& y) const
+{
+	if (m_skyline[index].x + width > m_width)
+		return false;
+
+	int remaining = width;
+	y = m_skyline[index].y;
+
+	for (size_t node = index; remaining > 0; node++) {
+		y = std::max(y, m_skyline[node].y);
+
+		if (y + height > m_height)
+			return false;
+
+		remaining -= m_skyline[node].width;
+	}
+
+	return true;
+}
+
+/*
+	kengine::texture_array_atlas class - member class definition
+*/
+
+kengine::texture_array_atlas::texture_array_atlas(int layerSize, int padding)
+	: m_layerSize(std::max(layerSize, 1)), m_padding(std::max(padding, 0))
+{
+	// a border of 2^n texels keeps the level n free of bleeding (if the images are aligned to 2^n)
+	while ((2 << (m_levels - 1)) <= m_padding && (m_layerSize >> m_levels) > 0)
+		m_levels++;
+
+	m_alignment = 1 << (m_levels - 1);
+	m_padding = alignUp(m_padding, m_alignment);
+}
+
+kengine::texture_array_atlas::~texture_array_atlas()
+{
+	for (auto& group : m_groups)
+		kengine::deleteTrackedTexture(group.texture, GPU_MEMORY_CATEGORY::TEXTURE);
+}
+
+kengine::atlas_image kengine::texture_array_atlas::add(const std::string& name, int width, int height, std::vector<unsigned char> pixels, GLenum format)
+{
+	if (width <= 0 || height <= 0 || pixels.size() < static_cast<size_t>(width) * static_cast<size_t>(height) * BYTES_PER_TEXEL) {
+		K_LOG_OUTPUT_RAW("texture_array_atlas: invalid image \"" + name + "\"");
+		return INVALID_IMAGE;
+	}
+
+	atlas_entry entry;
+	entry.name = name;
+	entry.width = width;
+	entry.height = height;
+	entry.format = format;
+	entry.pixels = std::move(pixels);
+	m_images.push_back(std::move(entry));
+
+	return static_cast<atlas_image>(m_images.size() - 1);
+}
+
+bool kengine::texture_array_atlas::build()
+{
+	struct placement
+	{
+		size_t image;
+		int group;
+		int layer;
+		int padding;
+		atlas_rect rect;
+	};
+
+	std::vector<size_t> pending;
+
+	for (size_t index = 0; index < m_images.size(); index++) {
+		if (!m_images[index].built)
+			pending.push_back(index);
+	}
+
+	// the tallest images first (the skyline stays flat)
+	std::stable_sort(pending.begin(), pending.end(), [this](size_t a, size_t b) {
+		return m_images[a].height > m_images[b].height;
+	});
+
+	std::vector<placement> placements;
+	bool result = true;
+
+	for (size_t index : pending) {
+		atlas_entry& entry = m_images[index];
+		placement placed;
+		placed.image = index;
+		placed.group = findGroup(entry.format);
+
+		// an image of the size of the layer takes a whole layer (no border, its coordinates can repeat)
+		bool wholeLayer = entry.width == m_layerSize && entry.height == m_layerSize;
+		placed.padding = wholeLayer ? 0 : m_padding;
+
+		int width = wholeLayer ? m_layerSize : alignUp(entry.width + 2 * m_padding, m_alignment);
+		int height = wholeLayer ? m_layerSize : alignUp(entry.height + 2 * m_padding, m_alignment);
+
+		if (!place(m_groups[placed.group], width, height, placed.rect, placed.layer)) {
+			K_LOG_OUTPUT_RAW("texture_array_atlas: the image \"" + entry.name + "\" doesn't fit in a layer");
+			entry.built = true;
+			entry.pixels.clear();
+			result = false;
+			continue;
+		}
+
+		placements.push_back(placed);
+	}
+
+	if (placements.empty())
+		return result;
+
+	for (auto& group : m_groups)
+		grow(group);
+
+	glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	std::vector<bool> modified(m_groups.size(), false);
+
+	for (const auto& placed : placements) {
+		atlas_entry& entry = m_images[placed.image];
+		upload(m_groups[placed.group], entry, placed.rect, placed.layer, placed.padding);
+
+		float size = static_cast<float>(m_layerSize);
+		entry.region.group = placed.group;
+		entry.region.layer = placed.layer;
+		entry.region.offset[0] = static_cast<float>(placed.rect.x + placed.padding) / size;
+		entry.region.offset[1] = static_cast<float>(placed.rect.y + placed.padding) / size;
+		entry.region.scale[0] = static_cast<float>(entry.width) / size;
+		entry.region.scale[1] = static_cast<float>(entry.height) / size;
+		entry.built = true;
+		entry.pixels.clear();
+		entry.pixels.shrink_to_fit();
+
+		modified[static_cast<size_t>(placed.group)] = true;
+	}
+
+	for (size_t group = 0; group < m_groups.size(); group++) {
+		if (modified[group] && m_levels > 1)
+			glGenerateTextureMipmap(m_groups[group].texture);
+	}
+
+	return result;
+}
+
+bool kengine::texture_array_atlas::bind(GLuint unit, int group) const
+{
+	if (group < 0 || group >= getGroupCount() || m_groups[group].texture == 0)
+		return false;
+
+	glState().bindTexture(unit, m_groups[group].texture);
+
+	return true;
+}
+
+kengine::texture_array_stats kengine::texture_array_atlas::getStats() const
+{
+	texture_array_stats stats;
+	stats.groups = static_cast<unsigned int>(m_groups.size());
+	double usedArea = 0.0;
+
+	for (const auto& group : m_groups) {
+		stats.layers += static_cast<unsigned int>(group.layers.size());
+		stats.residentBytes += layerBytes(m_layerSize, m_levels) * static_cast<size_t>(group.allocatedLayers);
+
+		for (const auto& layer : group.layers)
+			usedArea += layer.getOccupancy();
+	}
+
+	for (const auto& entry : m_images) {
+		if (entry.built && entry.region.group >= 0)
+			stats.images++;
+	}
+
+	if (stats.layers > 0)
+		stats.occupancy = static_cast<float>(usedArea / static_cast<double>(stats.layers));
+
+	return stats;
+}
+
+int kengine::texture_array_atlas::findGroup(GLenum format)
+{
+	for (size_t group = 0; group < m_groups.size(); group++) {
+		if (m_groups[group].format == format)
+			return static_cast<int>(group);
+	}
+
+	atlas_group group;
+	group.format = format;
+	m_groups.push_back(std::move(group));
+
+	return static_cast<int>(m_groups.size() - 1);
+}
+
+bool kengine::texture_array_atlas::place(atlas_group& group, int width, int height, atlas_rect& rect, int& layer)
+{
+	if (width > m_layerSize || height > m_layerSize)
+		return false;
+
+	for (size_t index = 0; index < group.layers.size(); index++) {
+		if (group.layers[index].insert(width, height, rect)) {
+			layer = static_cast<int>(index);
+			return true;
+		}
+	}
+
+	group.layers.push_back(skyline_packer(m_layerSize, m_layerSize));
+	layer = static_cast<int>(group.layers.size() - 1);
+
+	return group.layers.back().insert(width, height, rect);
+}
+
+/*
+	The storage is immutable: new layers need a new texture, the previous layers are copied into it
+*/
+void kengine::texture_array_atlas::grow(atlas_group& group)
+{
+	int layers = static_cast<int>(group.layers.size());
+
+	if (layers <= group.allocatedLayers)
+		return;
+
+	// the capacity doubles, so the layers are not copied on every build
+	int capacity = std::max(layers, group.allocatedLayers * 2);
+
+	GLuint texture = 0;
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture);
+	glTextureStorage3D(texture, m_levels, group.format, m_layerSize, m_layerSize, capacity);
+
+	if (group.texture != 0) {
+		for (int level = 0; level < m_levels; level++) {
+			int size = std::max(1, m_layerSize >> level);
+			glCopyImageSubData(group.texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+				texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, size, size, group.allocatedLayers);
+		}
+
+		kengine::deleteTrackedTexture(group.texture, GPU_MEMORY_CATEGORY::TEXTURE);
+	}
+
+	group.texture = texture;
+	group.allocatedLayers = capacity;
+
+	gpuMemoryTracker().allocate(GPU_MEMORY_CATEGORY::TEXTURE, texture, layerBytes(m_layerSize, m_levels) * static_cast<size_t>(capacity), ATLAS_OWNER);
+}
+
+/*
+	The border repeats the edge texels of the image
+*/
+void kengine::texture_array_atlas::upload(const atlas_group& group, const atlas_entry& entry, const atlas_rect& rect, int layer, int padding)
+{
+	int width = entry.width + 2 * padding;
+	int height = entry.height + 2 * padding;
+	std::vector<unsigned char> padded(static_cast<size_t>(width) * static_cast<size_t>(height) * BYTES_PER_TEXEL);
+
+	for (int y = 0; y < height; y++) {
+		int sourceY = std::min(std::max(y - padding, 0), entry.height - 1);
+
+		for (int x = 0; x < width; x++) {
+			int sourceX = std::min(std::max(x - padding, 0), entry.width - 1);
+			const unsigned char* source = &entry.pixels[(static_cast<size_t>(sourceY) * static_cast<size_t>(entry.width) + static_cast<size_t>(sourceX)) * BYTES_PER_TEXEL];
+			std::copy(source, source + BYTES_PER_TEXEL, &padded[(static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)) * BYTES_PER_TEXEL]);
+		}
+	}
+
+	glTextureSubImage3D(group.texture, 0, rect.x, rect.y, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+}
+
+/*
+	kengine::remapTexCoords
+*/
+
+bool kengine::remapTexCoords(mesh& m, const atlas_region& region, size_t location, bool layerComponent)
+{
+	const vattrib<float>* texCoords = m.getVertexAttribute(location);
+
+	if (texCoords == nullptr || texCoords->count < 2) {
+		K_LOG_OUTPUT_RAW("remapTexCoords: the mesh has no texture coordinates at the location " + std::to_string(location));
+		return false;
+	}
+
+	size_t vertices = texCoords->getSize();
+	size_t count = layerComponent ? 3 : 2;
+	std::vector<float> remapped(vertices * count);
+
+	for (size_t vertex = 0; vertex < vertices; vertex++) {
+		const float* uv = &texCoords->attributeArray[vertex * texCoords->count];
+		float* target = &remapped[vertex * count];
+
+		target[0] = uv[0] * region.scale[0] + region.offset[0];
+		target[1] = uv[1] * region.scale[1] + region.offset[1];
+
+		if (layerComponent)
+			target[2] = static_cast<float>(region.layer);
+	}
+
+	vattrib<float> attribute(remapped.data(), remapped.size(), count);
+	m.setVertexAttribute(attribute, location);
+
+	return true;
+}
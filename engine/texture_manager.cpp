@@ -0,0 +1,569 @@
+/*
+	K-Engine Texture Manager
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <texture_manager.hpp>
+#include <gl_state.hpp>
+#include <gpu_memory.hpp>
+#include <logger.hpp>
+#include <upload_worker.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+namespace
+{
+	const std::string TEXTURE_OWNER = "texture_manager";
+
+	int levelSize(int size, int level)
+	{
+		return std::max(1, size >> level);
+	}
+
+	int fullChainLevels(int width, int height)
+	{
+		int levels = 1;
+
+		while ((std::max(width, height) >> levels) > 0)
+			levels++;
+
+		return levels;
+	}
+
+	/*
+		Storage of the levels [firstLevel, levels): the level 0 of the texture is "firstLevel"
+	*/
+	GLuint createStorage(const kengine::texture_desc& desc, int firstLevel)
+	{
+		GLuint texture = 0;
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureStorage2D(texture, desc.levels - firstLevel, desc.format, levelSize(desc.width, firstLevel), levelSize(desc.height, firstLevel));
+		glTextureParameteri(texture, GL_TEXTURE_MAX_LEVEL, desc.levels - firstLevel - 1);
+
+		return texture;
+	}
+
+	void copyLevels(const kengine::texture_desc& desc, GLuint source, int sourceFirst, GLuint destination, int destinationFirst, int firstLevel)
+	{
+		for (int level = firstLevel; level < desc.levels; level++) {
+			glCopyImageSubData(source, GL_TEXTURE_2D, level - sourceFirst, 0, 0, 0,
+				destination, GL_TEXTURE_2D, level - destinationFirst, 0, 0, 0,
+				levelSize(desc.width, level), levelSize(desc.height, level), 1);
+		}
+	}
+}
+
+bool kengine::sampler_desc::operator<(const sampler_desc& other) const
+{
+	return std::tie(minFilter, magFilter, wrapS, wrapT, maxAnisotropy) < std::tie(other.minFilter, other.magFilter, other.wrapS, other.wrapT, other.maxAnisotropy);
+}
+
+/*
+	kengine::texture_manager class - member class definition
+*/
+
+kengine::texture_manager::texture_manager(size_t budget, int tailSize)
+	: m_budget(budget), m_tailSize(std::max(tailSize, 1)), m_mainThread(std::this_thread::get_id()), m_token(std::make_shared<bool>(true))
+{
+	m_evictionCallback = gpuMemoryTracker().addEvictionCallback([this](size_t bytes) -> size_t {
+		// the upload worker can allocate on its own thread: the levels are evicted by the next update
+		if (std::this_thread::get_id() != m_mainThread) {
+			m_deferredEviction += bytes;
+			return 0;
+		}
+
+		return evict(bytes, std::numeric_limits<float>::max());
+	});
+}
+
+kengine::texture_manager::~texture_manager()
+{
+	gpuMemoryTracker().removeEvictionCallback(m_evictionCallback);
+	m_token.reset();
+
+	for (auto& entry : m_textures)
+		kengine::deleteTrackedTexture(entry.texture, GPU_MEMORY_CATEGORY::TEXTURE);
+
+	for (auto& sampler : m_samplers) {
+		glState().releaseSampler(sampler.second);
+		glDeleteSamplers(1, &sampler.second);
+	}
+}
+
+kengine::texture_handle kengine::texture_manager::create(const std::string& name, const texture_desc& desc, level_loader loader)
+{
+	if (desc.width <= 0 || desc.height <= 0 || desc.bytesPerPixel <= 0 || !loader) {
+		K_LOG_OUTPUT_RAW("texture_manager: invalid texture \"" + name + "\"");
+		return INVALID_TEXTURE;
+	}
+
+	texture_handle handle;
+
+	if (!m_freeHandles.empty()) {
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+	}
+	else {
+		handle = static_cast<texture_handle>(m_textures.size());
+		m_textures.emplace_back();
+	}
+
+	texture_entry& entry = m_textures[handle];
+	entry = texture_entry();
+	entry.name = name;
+	entry.desc = desc;
+	entry.loader = std::move(loader);
+
+	int fullChain = fullChainLevels(desc.width, desc.height);
+	entry.desc.levels = desc.levels > 0 ? std::min(desc.levels, fullChain) : fullChain;
+
+	// the tail is the most detailed level that fits in "tailSize"
+	entry.tailLevel = 0;
+
+	while (entry.tailLevel < entry.desc.levels - 1 && std::max(levelSize(desc.width, entry.tailLevel), levelSize(desc.height, entry.tailLevel)) > m_tailSize)
+		entry.tailLevel++;
+
+	entry.residentLevel = entry.desc.levels;
+	entry.wantedLevel = entry.tailLevel;
+	entry.alive = true;
+
+	return handle;
+}
+
+void kengine::texture_manager::destroy(texture_handle handle)
+{
+	if (handle >= m_textures.size() || !m_textures[handle].alive)
+		return;
+
+	texture_entry& entry = m_textures[handle];
+
+	m_residentBytes -= entry.residentBytes;
+	m_stats.residentBytes = m_residentBytes;
+	kengine::deleteTrackedTexture(entry.texture, GPU_MEMORY_CATEGORY::TEXTURE);
+
+	entry.alive = false;
+	entry.residentBytes = 0;
+	entry.loader = nullptr;
+
+	// the handle is reused after the completion of the job in flight
+	if (!entry.busy)
+		m_freeHandles.push_back(handle);
+}
+
+void kengine::texture_manager::setScreenSize(texture_handle handle, float pixels)
+{
+	texture_entry& entry = m_textures[handle];
+	entry.screenSize = std::max(pixels, 0.0f);
+
+	// the level whose size matches the size on the screen
+	int size = std::max(entry.desc.width, entry.desc.height);
+	int level = entry.tailLevel;
+
+	if (entry.screenSize >= static_cast<float>(size))
+		level = 0;
+	else if (entry.screenSize > 0.0f)
+		level = static_cast<int>(std::floor(std::log2(static_cast<float>(size) / entry.screenSize)));
+
+	entry.wantedLevel = std::min(std::max(level, 0), entry.tailLevel);
+}
+
+void kengine::texture_manager::update()
+{
+	size_t deferred = m_deferredEviction.exchange(0);
+
+	if (deferred > 0)
+		evict(deferred, std::numeric_limits<float>::max());
+
+	if (m_residentBytes > m_budget)
+		evict(m_residentBytes - m_budget, std::numeric_limits<float>::max());
+
+	/*
+		one level per texture, from the most magnified textures (the tails first)
+	*/
+
+	std::vector<std::pair<float, texture_handle>> candidates;
+
+	for (texture_handle handle = 0; handle < m_textures.size(); handle++) {
+		const texture_entry& entry = m_textures[handle];
+
+		if (!entry.alive || entry.busy || entry.failed || entry.residentLevel <= entry.wantedLevel)
+			continue;
+
+		float priority = entry.texture == 0 ? std::numeric_limits<float>::max() : getPriority(entry);
+		candidates.push_back(std::make_pair(priority, handle));
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end(), [](const std::pair<float, texture_handle>& a, const std::pair<float, texture_handle>& b) {
+		return a.first > b.first;
+	});
+
+	size_t frameBytes = 0;
+
+	for (const auto& candidate : candidates) {
+		const texture_entry& entry = m_textures[candidate.second];
+
+		// an eviction can change the resident level of the candidates
+		if (entry.busy || entry.residentLevel <= entry.wantedLevel)
+			continue;
+
+		bool tail = entry.texture == 0;
+		int level = tail ? entry.tailLevel : entry.residentLevel - 1;
+		size_t bytes = getBytes(entry.desc, level) - entry.residentBytes;
+
+		if (frameBytes > 0 && frameBytes + bytes > m_frameUploadBudget)
+			break;
+
+		/*
+			the tails are always resident, the other levels make room by evicting less magnified textures: a victim
+			loses a level only if it stays less magnified than the candidate after the swap (no ping-pong)
+		*/
+		if (!tail && m_residentBytes + m_pendingBytes + bytes > m_budget) {
+			size_t needed = m_residentBytes + m_pendingBytes + bytes - m_budget;
+
+			if (evict(needed, candidate.first * 0.25f) < needed)
+				continue;
+		}
+
+		frameBytes += bytes;
+		schedule(candidate.second, level);
+	}
+
+	m_stats.frameUploadBytes = frameBytes;
+	m_stats.pendingUploads = 0;
+	m_stats.textures = 0;
+
+	for (const auto& entry : m_textures) {
+		if (!entry.alive)
+			continue;
+
+		m_stats.textures++;
+
+		if (entry.busy || (!entry.failed && entry.residentLevel > entry.wantedLevel))
+			m_stats.pendingUploads++;
+	}
+
+	m_stats.residentBytes = m_residentBytes;
+}
+
+bool kengine::texture_manager::bind(GLuint unit, texture_handle handle, const sampler_desc& sampler)
+{
+	GLuint texture = m_textures[handle].texture;
+
+	if (texture == 0)
+		return false;
+
+	glState().bindTexture(unit, texture);
+	glState().bindSampler(unit, getSampler(sampler));
+
+	return true;
+}
+
+GLuint kengine::texture_manager::getSampler(const sampler_desc& desc)
+{
+	auto it = m_samplers.find(desc);
+
+	if (it != m_samplers.end())
+		return it->second;
+
+	GLuint sampler = 0;
+	glCreateSamplers(1, &sampler);
+	glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(desc.minFilter));
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(desc.magFilter));
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, static_cast<GLint>(desc.wrapS));
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, static_cast<GLint>(desc.wrapT));
+
+	if (desc.maxAnisotropy > 1.0f && (isExtensionSupported("GL_ARB_texture_filter_anisotropic") || isExtensionSupported("GL_EXT_texture_filter_anisotropic")))
+		glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, desc.maxAnisotropy);
+
+	m_samplers[desc] = sampler;
+	m_stats.samplers = static_cast<unsigned int>(m_samplers.size());
+
+	return sampler;
+}
+
+size_t kengine::texture_manager::getBytes(const texture_desc& desc, int firstLevel) const
+{
+	size_t bytes = 0;
+
+	for (int level = firstLevel; level < desc.levels; level++)
+		bytes += static_cast<size_t>(levelSize(desc.width, level)) * static_cast<size_t>(levelSize(desc.height, level)) * static_cast<size_t>(desc.bytesPerPixel);
+
+	return bytes;
+}
+
+float kengine::texture_manager::getPriority(const texture_entry& entry) const
+{
+	// screen pixels per texel of the most detailed resident level
+	int size = std::max(levelSize(entry.desc.width, entry.residentLevel), levelSize(entry.desc.height, entry.residentLevel));
+	return entry.screenSize / static_cast<float>(size);
+}
+
+void kengine::texture_manager::schedule(texture_handle handle, int level)
+{
+	texture_entry& entry = m_textures[handle];
+
+	struct level_job
+	{
+		GLuint texture = 0;
+		bool loaded = false;
+	};
+
+	std::shared_ptr<level_job> job = std::make_shared<level_job>();
+	texture_desc desc = entry.desc;
+	level_loader loader = entry.loader;
+	GLuint source = entry.texture;
+	int sourceFirst = entry.residentLevel;
+	size_t bytes = getBytes(desc, level) - entry.residentBytes;
+	std::thread::id mainThread = m_mainThread;
+
+	entry.busy = true;
+	m_pendingBytes += bytes;
+	m_inFlight++;
+
+	// the loader runs on the thread of the upload worker (if any)
+	auto work = [job, desc, loader, source, sourceFirst, level, mainThread]() {
+		std::vector<std::vector<unsigned char>> levels(static_cast<size_t>(sourceFirst - level));
+
+		for (int index = level; index < sourceFirst; index++) {
+			std::vector<unsigned char>& pixels = levels[static_cast<size_t>(index - level)];
+			size_t expected = static_cast<size_t>(levelSize(desc.width, index)) * static_cast<size_t>(levelSize(desc.height, index)) * static_cast<size_t>(desc.bytesPerPixel);
+
+			if (!loader(index, pixels) || pixels.size() < expected)
+				return;
+		}
+
+		if (std::this_thread::get_id() == mainThread)
+			glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		job->texture = createStorage(desc, level);
+
+		if (source != 0)
+			copyLevels(desc, source, sourceFirst, job->texture, level, sourceFirst);
+
+		for (int index = level; index < sourceFirst; index++) {
+			glTextureSubImage2D(job->texture, index - level, 0, 0, levelSize(desc.width, index), levelSize(desc.height, index),
+				desc.pixelFormat, desc.pixelType, levels[static_cast<size_t>(index - level)].data());
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		job->loaded = true;
+	};
+
+	std::weak_ptr<bool> token = m_token;
+
+	auto completion = [this, token, job, handle, level, bytes]() {
+		// the manager was deleted: the texture of the job is not tracked yet
+		if (token.expired()) {
+			if (job->texture != 0)
+				glDeleteTextures(1, &job->texture);
+
+			return;
+		}
+
+		finishJob(handle, job->loaded ? job->texture : 0, level, bytes);
+	};
+
+	// the texture of a job discarded by upload_worker::finish is not tracked yet
+	auto cancel = [job]() {
+		if (job->texture != 0)
+			glDeleteTextures(1, &job->texture);
+	};
+
+	if (m_worker != nullptr) {
+		m_worker->submit(bytes, work, completion, cancel);
+		return;
+	}
+
+	work();
+	completion();
+}
+
+void kengine::texture_manager::finishJob(texture_handle handle, GLuint texture, int level, size_t extraBytes)
+{
+	texture_entry& entry = m_textures[handle];
+
+	entry.busy = false;
+	m_pendingBytes -= extraBytes;
+	m_inFlight--;
+
+	if (!entry.alive) {
+		if (texture != 0)
+			glDeleteTextures(1, &texture);
+
+		m_freeHandles.push_back(handle);
+		return;
+	}
+
+	if (texture == 0) {
+		K_LOG_OUTPUT_RAW("texture_manager: the level " + std::to_string(level) + " of \"" + entry.name + "\" can't be loaded");
+		entry.failed = true;
+		return;
+	}
+
+	m_stats.uploads += static_cast<unsigned int>(entry.residentLevel - level);
+	replace(entry, texture, level);
+}
+
+void kengine::texture_manager::replace(texture_entry& entry, GLuint texture, int level)
+{
+	kengine::deleteTrackedTexture(entry.texture, GPU_MEMORY_CATEGORY::TEXTURE);
+	m_residentBytes -= entry.residentBytes;
+
+	entry.texture = texture;
+	entry.residentLevel = level;
+	entry.residentBytes = getBytes(entry.desc, level);
+	m_residentBytes += entry.residentBytes;
+	m_stats.residentBytes = m_residentBytes;
+
+	// the entry is consistent: the allocation can call the eviction callback
+	gpuMemoryTracker().allocate(GPU_MEMORY_CATEGORY::TEXTURE, texture, entry.residentBytes, TEXTURE_OWNER);
+}
+
+size_t kengine::texture_manager::evict(size_t bytes, float maxPriority)
+{
+	if (m_evicting)
+		return 0;
+
+	m_evicting = true;
+	size_t released = 0;
+
+	auto shrink = [this, &released](texture_entry& entry, int level) {
+		GLuint texture = createStorage(entry.desc, level);
+		copyLevels(entry.desc, entry.texture, entry.residentLevel, texture, level, level);
+
+		size_t before = entry.residentBytes;
+		m_stats.evictions += static_cast<unsigned int>(level - entry.residentLevel);
+		replace(entry, texture, level);
+		released += before - entry.residentBytes;
+	};
+
+	auto isEvictable = [](const texture_entry& entry) {
+		return entry.alive && !entry.busy && entry.texture != 0 && entry.residentLevel < entry.tailLevel;
+	};
+
+	/*
+		the levels that are more detailed than the screen needs (least magnified textures first)
+	*/
+
+	std::vector<std::pair<float, texture_handle>> excess;
+
+	for (texture_handle handle = 0; handle < m_textures.size(); handle++) {
+		const texture_entry& entry = m_textures[handle];
+
+		if (isEvictable(entry) && entry.residentLevel < entry.wantedLevel)
+			excess.push_back(std::make_pair(getPriority(entry), handle));
+	}
+
+	std::sort(excess.begin(), excess.end());
+
+	for (size_t index = 0; index < excess.size() && released < bytes; index++) {
+		texture_entry& entry = m_textures[excess[index].second];
+		shrink(entry, entry.wantedLevel);
+	}
+
+	/*
+		one level at a time from the least magnified textures (the tails stay resident)
+	*/
+
+	while (released < bytes) {
+		texture_entry* victim = nullptr;
+		float victimPriority = maxPriority;
+
+		for (auto& entry : m_textures) {
+			if (!isEvictable(entry))
+				continue;
+
+			float priority = getPriority(entry);
+
+			if (priority < victimPriority) {
+				victim = &entry;
+				victimPriority = priority;
+			}
+		}
+
+		if (victim == nullptr)
+			break;
+
+		shrink(*victim, victim->residentLevel + 1);
+	}
+
+	m_evicting = false;
+
+	return released;
+}
+
+/*
+	kengine::mipChainLoader
+*/
+
+kengine::texture_manager::level_loader kengine::mipChainLoader(int width, int height, std::vector<unsigned char> pixels)
+{
+	std::shared_ptr<std::vector<std::vector<unsigned char>>> chain = std::make_shared<std::vector<std::vector<unsigned char>>>();
+	chain->push_back(std::move(pixels));
+
+	int levelWidth = width;
+	int levelHeight = height;
+
+	// 2x2 box filter (the last row or column of an odd level is clamped)
+	while (levelWidth > 1 || levelHeight > 1) {
+		int nextWidth = std::max(1, levelWidth / 2);
+		int nextHeight = std::max(1, levelHeight / 2);
+		const std::vector<unsigned char>& source = chain->back();
+		std::vector<unsigned char> level(static_cast<size_t>(nextWidth) * static_cast<size_t>(nextHeight) * 4);
+
+		for (int y = 0; y < nextHeight; y++) {
+			int y0 = std::min(y * 2, levelHeight - 1);
+			int y1 = std::min(y * 2 + 1, levelHeight - 1);
+
+			for (int x = 0; x < nextWidth; x++) {
+				int x0 = std::min(x * 2, levelWidth - 1);
+				int x1 = std::min(x * 2 + 1, levelWidth - 1);
+
+				for (int channel = 0; channel < 4; channel++) {
+					unsigned int sum = source[(static_cast<size_t>(y0) * levelWidth + x0) * 4 + channel] + source[(static_cast<size_t>(y0) * levelWidth + x1) * 4 + channel]
+						+ source[(static_cast<size_t>(y1) * levelWidth + x0) * 4 + channel] + source[(static_cast<size_t>(y1) * levelWidth + x1) * 4 + channel];
+
+					level[(static_cast<size_t>(y) * nextWidth + x) * 4 + channel] = static_cast<unsigned char>((sum + 2) / 4);
+				}
+			}
+		}
+
+		chain->push_back(std::move(level));
+		levelWidth = nextWidth;
+		levelHeight = nextHeight;
+	}
+
+	return [chain](int level, std::vector<unsigned char>& levelPixels) {
+		if (level < 0 || static_cast<size_t>(level) >= chain->size())
+			return false;
+
+		levelPixels = (*chain)[static_cast<size_t>(level)];
+		return true;
+	};
+}
@@ -0,0 +1,154 @@
+/*
+	K-Engine Thread Pool
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <thread_pool.hpp>
+
+namespace
+{
+	// a nested loop runs on the thread itself (a worker or the caller of the running loop)
+	thread_local bool insideLoop = false;
+}
+
+/*
+	kengine::thread_pool class - member class definition
+*/
+
+kengine::thread_pool::thread_pool(unsigned int workerCount)
+{
+	if (workerCount == 0) {
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	for (unsigned int index = 0; index < workerCount; index++)
+		m_workers.push_back(std::thread(&thread_pool::run, this, index + 1));
+}
+
+kengine::thread_pool::~thread_pool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+
+	m_wake.notify_all();
+
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+void kengine::thread_pool::parallelFor(size_t count, const loop_body& body, size_t grain)
+{
+	if (count == 0)
+		return;
+
+	unsigned int threadCount = getThreadCount();
+
+	if (grain == 0)
+		grain = (count + threadCount - 1) / threadCount;
+
+	std::unique_lock<std::mutex> loopLock(m_loopMutex, std::defer_lock);
+
+	// serial loop: no workers, a single chunk, a nested loop or a loop of another thread
+	if (m_workers.empty() || grain >= count || insideLoop || !loopLock.try_lock()) {
+		body(0, count, 0);
+		return;
+	}
+
+	loop current;
+	current.body = &body;
+	current.count = count;
+	current.grain = grain;
+	current.chunks = (count + grain - 1) / grain;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_loop = &current;
+		m_generation++;
+	}
+
+	m_wake.notify_all();
+
+	insideLoop = true;
+	runChunks(current, 0);
+	insideLoop = false;
+
+	// the loop lives on this stack, so the workers must leave it before returning
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this, &current]() { return current.doneChunks.load() == current.chunks && m_activeWorkers == 0; });
+	m_loop = nullptr;
+}
+
+void kengine::thread_pool::runChunks(loop& current, unsigned int thread)
+{
+	size_t chunk;
+
+	while ((chunk = current.nextChunk.fetch_add(1)) < current.chunks) {
+		size_t begin = chunk * current.grain;
+		size_t end = begin + current.grain < current.count ? begin + current.grain : current.count;
+
+		(*current.body)(begin, end, thread);
+
+		if (current.doneChunks.fetch_add(1) + 1 == current.chunks) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_done.notify_all();
+		}
+	}
+}
+
+void kengine::thread_pool::run(unsigned int thread)
+{
+	insideLoop = true;
+	unsigned int generation = 0;
+
+	while (true) {
+		loop* current = nullptr;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this, generation]() { return !m_running || (m_loop != nullptr && m_generation != generation); });
+
+			if (!m_running)
+				return;
+
+			generation = m_generation;
+			current = m_loop;
+			m_activeWorkers++;
+		}
+
+		runChunks(*current, thread);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_activeWorkers--;
+		m_done.notify_all();
+	}
+}
+
+kengine::thread_pool& kengine::threadPool()
+{
+	static thread_pool pool;
+	return pool;
+}
@@ -0,0 +1,350 @@
+/*
+	K-Engine Uniform Block
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <uniform_block.hpp>
+#include <gpu_memory.hpp>
+#include <gl_state.hpp>
+#include <logger.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+	/*
+		Scalar type, number of components per column and number of columns of a GLSL type
+	*/
+	struct glsl_type_info
+	{
+		const char* scalar;
+		GLint scalarSize;
+		GLint components;
+		GLint columns;
+	};
+
+	glsl_type_info getTypeInfo(GLenum type)
+	{
+		switch (type) {
+		case GL_FLOAT: return { "float", 4, 1, 1 };
+		case GL_FLOAT_VEC2: return { "float", 4, 2, 1 };
+		case GL_FLOAT_VEC3: return { "float", 4, 3, 1 };
+		case GL_FLOAT_VEC4: return { "float", 4, 4, 1 };
+		case GL_DOUBLE: return { "double", 8, 1, 1 };
+		case GL_DOUBLE_VEC2: return { "double", 8, 2, 1 };
+		case GL_DOUBLE_VEC3: return { "double", 8, 3, 1 };
+		case GL_DOUBLE_VEC4: return { "double", 8, 4, 1 };
+		case GL_INT: case GL_BOOL: return { "int32_t", 4, 1, 1 };
+		case GL_INT_VEC2: case GL_BOOL_VEC2: return { "int32_t", 4, 2, 1 };
+		case GL_INT_VEC3: case GL_BOOL_VEC3: return { "int32_t", 4, 3, 1 };
+		case GL_INT_VEC4: case GL_BOOL_VEC4: return { "int32_t", 4, 4, 1 };
+		case GL_UNSIGNED_INT: return { "uint32_t", 4, 1, 1 };
+		case GL_UNSIGNED_INT_VEC2: return { "uint32_t", 4, 2, 1 };
+		case GL_UNSIGNED_INT_VEC3: return { "uint32_t", 4, 3, 1 };
+		case GL_UNSIGNED_INT_VEC4: return { "uint32_t", 4, 4, 1 };
+		case GL_FLOAT_MAT2: return { "float", 4, 2, 2 };
+		case GL_FLOAT_MAT3: return { "float", 4, 3, 3 };
+		case GL_FLOAT_MAT4: return { "float", 4, 4, 4 };
+		case GL_FLOAT_MAT2x3: return { "float", 4, 3, 2 };
+		case GL_FLOAT_MAT2x4: return { "float", 4, 4, 2 };
+		case GL_FLOAT_MAT3x2: return { "float", 4, 2, 3 };
+		case GL_FLOAT_MAT3x4: return { "float", 4, 4, 3 };
+		case GL_FLOAT_MAT4x2: return { "float", 4, 2, 4 };
+		case GL_FLOAT_MAT4x3: return { "float", 4, 3, 4 };
+		case GL_DOUBLE_MAT2: return { "double", 8, 2, 2 };
+		case GL_DOUBLE_MAT3: return { "double", 8, 3, 3 };
+		case GL_DOUBLE_MAT4: return { "double", 8, 4, 4 };
+		case GL_DOUBLE_MAT2x3: return { "double", 8, 3, 2 };
+		case GL_DOUBLE_MAT2x4: return { "double", 8, 4, 2 };
+		case GL_DOUBLE_MAT3x2: return { "double", 8, 2, 3 };
+		case GL_DOUBLE_MAT3x4: return { "double", 8, 4, 3 };
+		case GL_DOUBLE_MAT4x2: return { "double", 8, 2, 4 };
+		case GL_DOUBLE_MAT4x3: return { "double", 8, 3, 4 };
+		default: return { "uint8_t", 1, 0, 0 };
+		}
+	}
+
+	/*
+		Number of bytes of a member, including the padding of the arrays and of the matrix columns
+		(a single element for the unsized array of a shader storage block, its length is chosen at binding time)
+	*/
+	GLint getMemberSize(const kengine::buffer_block_member& member)
+	{
+		glsl_type_info info = getTypeInfo(member.type);
+		GLint elementSize = info.columns > 1 ? info.columns * member.matrixStride : info.components * info.scalarSize;
+
+		if (member.arraySize == 0)
+			return std::max(member.arrayStride, elementSize);
+
+		if (member.arraySize > 1 || member.arrayStride > 0)
+			return (member.arraySize - 1) * member.arrayStride + elementSize;
+
+		return elementSize;
+	}
+}
+
+/*
+	kengine::buffer_block_layout class - member class definition
+*/
+
+bool kengine::buffer_block_layout::reflect(GLuint program, const std::string& blockName, BUFFER_BLOCK_TYPE type)
+{
+	GLenum blockInterface = type == BUFFER_BLOCK_TYPE::UNIFORM ? GL_UNIFORM_BLOCK : GL_SHADER_STORAGE_BLOCK;
+	GLenum memberInterface = type == BUFFER_BLOCK_TYPE::UNIFORM ? GL_UNIFORM : GL_BUFFER_VARIABLE;
+
+	m_name = blockName;
+	m_dataSize = 0;
+	m_binding = 0;
+	m_members.clear();
+
+	GLuint blockIndex = glGetProgramResourceIndex(program, blockInterface, blockName.c_str());
+
+	if (blockIndex == GL_INVALID_INDEX) {
+		K_LOG_OUTPUT_RAW("> the block " << blockName << " is not active in the program " << program);
+		return false;
+	}
+
+	GLenum blockProperties[] = { GL_BUFFER_DATA_SIZE, GL_BUFFER_BINDING, GL_NUM_ACTIVE_VARIABLES };
+	GLint blockResults[3] = { 0 };
+	glGetProgramResourceiv(program, blockInterface, blockIndex, 3, blockProperties, 3, nullptr, blockResults);
+
+	m_dataSize = blockResults[0];
+	m_binding = blockResults[1];
+
+	std::vector<GLint> variables(static_cast<size_t>(blockResults[2]));
+	GLenum activeVariables = GL_ACTIVE_VARIABLES;
+
+	if (!variables.empty())
+		glGetProgramResourceiv(program, blockInterface, blockIndex, 1, &activeVariables, blockResults[2], nullptr, variables.data());
+
+	GLenum properties[] = { GL_NAME_LENGTH, GL_OFFSET, GL_TYPE, GL_ARRAY_SIZE, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE };
+	std::vector<char> name;
+
+	for (GLint variable : variables) {
+		GLint results[6] = { 0 };
+		glGetProgramResourceiv(program, memberInterface, static_cast<GLuint>(variable), 6, properties, 6, nullptr, results);
+
+		name.resize(static_cast<size_t>(results[0] + 1));
+		glGetProgramResourceName(program, memberInterface, static_cast<GLuint>(variable), results[0] + 1, nullptr, name.data());
+
+		buffer_block_member member;
+		member.name = name.data();
+		member.offset = results[1];
+		member.type = static_cast<GLenum>(results[2]);
+		member.arraySize = results[3];
+		member.arrayStride = results[4];
+		member.matrixStride = results[5];
+
+		// the members of a block with an instance name are reported as "block.member"
+		std::string prefix = blockName + ".";
+
+		if (member.name.compare(0, prefix.size(), prefix) == 0)
+			member.name = member.name.substr(prefix.size());
+
+		if (member.name.size() > 3 && member.name.compare(member.name.size() - 3, 3, "[0]") == 0)
+			member.name = member.name.substr(0, member.name.size() - 3);
+
+		member.hash = fnv1a(member.name.c_str());
+		m_members.push_back(member);
+	}
+
+	std::sort(m_members.begin(), m_members.end(), [](const buffer_block_member& a, const buffer_block_member& b) {
+		return a.offset < b.offset;
+	});
+
+	return true;
+}
+
+const kengine::buffer_block_member* kengine::buffer_block_layout::findMember(uint32_t hash) const
+{
+	for (const auto& member : m_members) {
+		if (member.hash == hash)
+			return &member;
+	}
+
+	return nullptr;
+}
+
+bool kengine::buffer_block_layout::validateMember(uint32_t hash, size_t offset, const char* name) const
+{
+	const buffer_block_member* member = findMember(hash);
+
+	if (member == nullptr) {
+		K_LOG_OUTPUT_RAW("> block " << m_name << ": the member " << name << " is not active");
+		return false;
+	}
+
+	if (static_cast<size_t>(member->offset) != offset) {
+		K_LOG_OUTPUT_RAW("> block " << m_name << ": the member " << name << " is at the offset " << offset << " in C++ and " << member->offset << " in GLSL");
+		return false;
+	}
+
+	return true;
+}
+
+bool kengine::buffer_block_layout::validateSize(size_t size) const
+{
+	if (size < static_cast<size_t>(m_dataSize)) {
+		K_LOG_OUTPUT_RAW("> block " << m_name << ": the C++ struct has " << size << " bytes and the block has " << m_dataSize << " bytes");
+		return false;
+	}
+
+	return true;
+}
+
+std::string kengine::buffer_block_layout::generateStruct(const std::string& structName) const
+{
+	std::stringstream output;
+	GLint offset = 0;
+	int padding = 0;
+
+	output << "struct " << structName << "\n{\n";
+
+	for (const auto& member : m_members) {
+		if (member.offset > offset)
+			output << "\tuint8_t padding" << padding++ << "[" << member.offset - offset << "];\n";
+
+		glsl_type_info info = getTypeInfo(member.type);
+		GLint size = getMemberSize(member);
+
+		output << "\t" << info.scalar << " " << member.name;
+
+		if (size / info.scalarSize > 1)
+			output << "[" << size / info.scalarSize << "]";
+
+		output << "; // " << getGLSLType(static_cast<GLint>(member.type)) << " (offset " << member.offset << ")\n";
+		offset = member.offset + size;
+	}
+
+	if (m_dataSize > offset)
+		output << "\tuint8_t padding" << padding << "[" << m_dataSize - offset << "];\n";
+
+	output << "};\n";
+	return output.str();
+}
+
+/*
+	kengine::uniform_ring_buffer class - member class definition
+*/
+
+kengine::uniform_ring_buffer::uniform_ring_buffer(GLsizeiptr frameSize, int frameCount)
+	:
+	m_fences(static_cast<size_t>(frameCount), nullptr)
+{
+	GLint uniformAlignment = 0;
+	GLint storageAlignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+
+	// the same allocation can be bound as a uniform or as a shader storage buffer
+	m_alignment = std::max<GLsizeiptr>(std::max(uniformAlignment, storageAlignment), 16);
+	m_frameSize = (frameSize + m_alignment - 1) / m_alignment * m_alignment;
+
+	GLsizeiptr totalSize = m_frameSize * frameCount;
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	glCreateBuffers(1, &m_buffer);
+	glNamedBufferStorage(m_buffer, totalSize, nullptr, flags);
+	m_data = static_cast<unsigned char*>(glMapNamedBufferRange(m_buffer, 0, totalSize, flags));
+
+	kengine::gpuMemoryTracker().allocate(kengine::GPU_MEMORY_CATEGORY::BUFFER, m_buffer, static_cast<size_t>(totalSize), "uniform_ring_buffer");
+
+	// the first beginFrame moves to the region 0
+	m_frame = frameCount - 1;
+}
+
+kengine::uniform_ring_buffer::~uniform_ring_buffer()
+{
+	for (auto fence : m_fences) {
+		if (fence != nullptr)
+			glDeleteSync(fence);
+	}
+
+	glUnmapNamedBuffer(m_buffer);
+	kengine::deleteTrackedBuffer(m_buffer);
+}
+
+void kengine::uniform_ring_buffer::beginFrame()
+{
+	m_frame = (m_frame + 1) % static_cast<int>(m_fences.size());
+	GLsync& fence = m_fences[static_cast<size_t>(m_frame)];
+
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = uniform_ring_stats();
+
+	if (fence != nullptr) {
+		GLenum status = glClientWaitSync(fence, 0, 0);
+
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+			m_frameStats.stalls++;
+
+			// the region can't be written while the GPU reads it, so a long frame only logs and keeps waiting
+			while ((status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000)) == GL_TIMEOUT_EXPIRED) { // 1 second
+				K_LOG_OUTPUT_RAW("> uniform ring buffer: the GPU is still using the region of the frame " << m_frame);
+			}
+
+			if (status == GL_WAIT_FAILED) {
+				K_LOG_OUTPUT_RAW("> uniform ring buffer: it was not possible to wait for the region of the frame " << m_frame);
+			}
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	m_head = m_frameSize * m_frame;
+	m_end = m_head + m_frameSize;
+}
+
+void kengine::uniform_ring_buffer::endFrame()
+{
+	m_fences[static_cast<size_t>(m_frame)] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+kengine::ring_allocation kengine::uniform_ring_buffer::allocate(GLsizeiptr size)
+{
+	ring_allocation allocation;
+
+	if (m_data == nullptr || m_head + size > m_end) {
+		m_frameStats.overflows++;
+		return allocation;
+	}
+
+	allocation.buffer = m_buffer;
+	allocation.offset = m_head;
+	allocation.size = size;
+	allocation.data = m_data + m_head;
+
+	m_head += (size + m_alignment - 1) / m_alignment * m_alignment;
+	m_frameStats.usedBytes += size;
+	m_frameStats.allocations++;
+
+	return allocation;
+}
+
+void kengine::uniform_ring_buffer::bind(GLuint binding, const ring_allocation& allocation, GLenum target) const
+{
+	if (allocation.isValid())
+		kengine::glState().bindBufferRange(target, binding, allocation.buffer, allocation.offset, allocation.size);
+}
@@ -0,0 +1,266 @@
+/*
+	K-Engine Upload Worker
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <upload_worker.hpp>
+#include <logger.hpp>
+
+#include <memory>
+
+/*
+	kengine::upload_worker class - member class definition
+*/
+
+kengine::upload_worker::upload_worker(rendering_context* sharedContext, size_t frameBudget)
+	:
+	m_context{ sharedContext },
+	m_frameBudget{ frameBudget }
+{
+	if (m_context == nullptr) {
+		K_LOG_OUTPUT_RAW("> upload worker: there is no shared context, the uploads will run on the main thread");
+		return;
+	}
+
+	m_running = true;
+	m_thread = std::thread(&upload_worker::run, this);
+}
+
+kengine::upload_worker::~upload_worker()
+{
+	finish();
+}
+
+void kengine::upload_worker::submit(size_t sizeInBytes, std::function<void()> work, std::function<void()> completion, std::function<void()> cancel)
+{
+	upload_job job;
+	job.sizeInBytes = sizeInBytes;
+	job.work = std::move(work);
+	job.completion = std::move(completion);
+	job.cancel = std::move(cancel);
+	m_queued.push_back(std::move(job));
+}
+
+void kengine::upload_worker::uploadMesh(mesh_node& node, mesh&& m, std::function<void()> completion)
+{
+	// the mesh data must live until the node is attached on the main thread
+	std::shared_ptr<mesh> data = std::make_shared<mesh>(std::move(m));
+	std::shared_ptr<GLuint> buffer = std::make_shared<GLuint>(0);
+	size_t sizeInBytes = data->getSizeInBytes();
+	std::weak_ptr<bool> token = node.getToken();
+
+	auto deleteBuffer = [buffer]() {
+		glDeleteBuffers(1, buffer.get());
+		*buffer = 0;
+	};
+
+	submit(
+		sizeInBytes,
+		[data, buffer, sizeInBytes]() {
+			glCreateBuffers(1, buffer.get());
+			glNamedBufferStorage(*buffer, static_cast<GLsizeiptr>(sizeInBytes), data->getInterleavedData(), 0);
+		},
+		[&node, token, data, buffer, completion, deleteBuffer]() {
+			// the node was deleted while the mesh was uploaded
+			if (token.expired()) {
+				deleteBuffer();
+				return;
+			}
+
+			node.attach(*buffer, *data);
+
+			if (completion)
+				completion();
+		},
+		deleteBuffer);
+}
+
+void kengine::upload_worker::loadShaders(GLSLprogram& program, const ShaderInfo* shaders, std::function<void(bool)> completion)
+{
+	std::shared_ptr<std::vector<ShaderInfo>> info = std::make_shared<std::vector<ShaderInfo>>();
+
+	for (int index = 0; shaders[index].type != GL_NONE; index++)
+		info->push_back(shaders[index]);
+
+	ShaderInfo end = { GL_NONE, "" };
+	info->push_back(end);
+
+	std::shared_ptr<bool> result = std::make_shared<bool>(false);
+
+	// the new program is built into its own object, so the caller's program is only touched on the main thread
+	std::shared_ptr<GLSLprogram> staging = std::make_shared<GLSLprogram>();
+
+	// the shader sources are read by the worker, so the program doesn't count in the byte budget
+	submit(
+		0,
+		[staging, info, result]() {
+			*result = staging->loadShaders(info->data());
+		},
+		[&program, staging, info, result, completion]() {
+			// the previous program is kept if the link failed (as in shader_batch::complete)
+			if (*result) {
+				GLuint handle = staging->programID;
+				staging->programID = 0;
+
+				program.setProgram(handle, (*info)[0].filename);
+				program.binaryFormat = staging->binaryFormat;
+				program.reflectUniforms();
+			}
+
+			if (completion)
+				completion(*result);
+		});
+}
+
+void kengine::upload_worker::update()
+{
+	/*
+		completed jobs (the fences are signaled in order because they come from the same context)
+	*/
+
+	if (m_context != nullptr) {
+		std::vector<upload_job> inFlight;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			inFlight.swap(m_inFlight);
+		}
+
+		size_t index = 0;
+
+		for (; index < inFlight.size(); index++) {
+			GLenum status = glClientWaitSync(inFlight[index].fence, 0, 0);
+
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				break;
+
+			glDeleteSync(inFlight[index].fence);
+			m_releasedCount--;
+
+			if (inFlight[index].completion)
+				inFlight[index].completion();
+		}
+
+		if (index < inFlight.size()) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_inFlight.insert(m_inFlight.begin(), std::make_move_iterator(inFlight.begin() + static_cast<std::ptrdiff_t>(index)), std::make_move_iterator(inFlight.end()));
+		}
+	}
+
+	/*
+		release the queued jobs under the frame budget
+	*/
+
+	size_t releasedBytes = 0;
+	bool released = false;
+
+	while (!m_queued.empty() && (!released || releasedBytes + m_queued.front().sizeInBytes <= m_frameBudget)) {
+		upload_job job = std::move(m_queued.front());
+		m_queued.pop_front();
+
+		releasedBytes += job.sizeInBytes;
+		released = true;
+
+		if (m_context == nullptr) {
+			job.work();
+
+			if (job.completion)
+				job.completion();
+
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_released.push_back(std::move(job));
+		m_releasedCount++;
+	}
+
+	if (released && m_context != nullptr)
+		m_condition.notify_one();
+}
+
+void kengine::upload_worker::finish()
+{
+	if (m_context == nullptr)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+
+	m_condition.notify_one();
+
+	if (m_thread.joinable())
+		m_thread.join();
+
+	// the jobs which were not completed are discarded (the objects created by their work are deleted)
+	for (auto& job : m_inFlight) {
+		glDeleteSync(job.fence);
+
+		if (job.cancel)
+			job.cancel();
+	}
+
+	m_inFlight.clear();
+	m_released.clear();
+	m_queued.clear();
+	m_releasedCount = 0;
+
+	delete m_context;
+	m_context = nullptr;
+}
+
+size_t kengine::upload_worker::getPendingJobs() const
+{
+	return m_queued.size() + m_releasedCount;
+}
+
+void kengine::upload_worker::run()
+{
+	m_context->makeCurrent(true);
+
+	while (true) {
+		upload_job job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return !m_running || !m_released.empty(); });
+
+			if (!m_running)
+				break;
+
+			job = std::move(m_released.front());
+			m_released.pop_front();
+		}
+
+		job.work();
+		job.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush(); // the fence must be flushed to be waited from the main context
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_inFlight.push_back(std::move(job));
+	}
+
+	m_context->makeCurrent(false);
+}
@@ -0,0 +1,172 @@
+/*
+	K-Engine Vertex Format
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <vertex_format.hpp>
+#include <gl_state.hpp>
+#include <k_hash.hpp>
+#include <logger.hpp>
+
+#include <cassert>
+
+/*
+	kengine::vertex_format class - member class definition
+*/
+
+void kengine::vertex_format::addAttribute(GLuint location, GLint size, GLenum type, GLboolean normalized, GLuint relativeOffset)
+{
+	assert(m_count < MAX_ATTRIBUTES);
+
+	vertex_attrib_format& attribute = m_attributes[m_count++];
+	attribute.location = location;
+	attribute.size = size;
+	attribute.type = type;
+	attribute.normalized = normalized;
+	attribute.relativeOffset = relativeOffset;
+}
+
+uint64_t kengine::vertex_format::hash() const
+{
+	// FNV-1a over the attribute fields (the padding of the structs is not hashed)
+	uint64_t h = kengine::fnv1a64(&m_count, sizeof(m_count));
+
+	for (int i = 0; i < m_count; i++) {
+		const vertex_attrib_format& attribute = m_attributes[i];
+		h = kengine::fnv1a64(&attribute.location, sizeof(attribute.location), h);
+		h = kengine::fnv1a64(&attribute.size, sizeof(attribute.size), h);
+		h = kengine::fnv1a64(&attribute.type, sizeof(attribute.type), h);
+		h = kengine::fnv1a64(&attribute.normalized, sizeof(attribute.normalized), h);
+		h = kengine::fnv1a64(&attribute.relativeOffset, sizeof(attribute.relativeOffset), h);
+	}
+
+	return h;
+}
+
+bool kengine::vertex_format::operator==(const vertex_format& format) const
+{
+	if (m_count != format.m_count)
+		return false;
+
+	for (int i = 0; i < m_count; i++) {
+		const vertex_attrib_format& a = m_attributes[i];
+		const vertex_attrib_format& b = format.m_attributes[i];
+
+		if (a.location != b.location || a.size != b.size || a.type != b.type || a.normalized != b.normalized || a.relativeOffset != b.relativeOffset)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+	kengine::vertex_format_registry class - member class definition
+*/
+
+int kengine::vertex_format_registry::acquire(const vertex_format& format)
+{
+	uint64_t hash = format.hash();
+
+	// the number of distinct layouts is small and this is called only at load time
+	for (size_t i = 0; i < m_formats.size(); i++) {
+		if (m_formats[i].hash == hash && m_formats[i].format == format)
+			return static_cast<int>(i);
+	}
+
+	format_entry entry;
+	entry.format = format;
+	entry.hash = hash;
+
+	glCreateVertexArrays(1, &entry.vao);
+
+	for (int i = 0; i < format.getAttributeCount(); i++) {
+		const vertex_attrib_format& attribute = format.getAttribute(i);
+
+		glEnableVertexArrayAttrib(entry.vao, attribute.location);
+		glVertexArrayAttribFormat(entry.vao, attribute.location, attribute.size, attribute.type, attribute.normalized, attribute.relativeOffset);
+		glVertexArrayAttribBinding(entry.vao, attribute.location, 0);
+	}
+
+	m_formats.push_back(entry);
+	return static_cast<int>(m_formats.size() - 1);
+}
+
+void kengine::vertex_format_registry::bind(int formatID, GLuint buffer, GLintptr offset, GLsizei stride)
+{
+	assert(formatID >= 0 && static_cast<size_t>(formatID) < m_formats.size());
+
+	format_entry& entry = m_formats[static_cast<size_t>(formatID)];
+	m_frameStats.binds++;
+
+	if (kengine::glState().bindVertexArray(entry.vao))
+		m_frameStats.formatSwitches++;
+
+	if (entry.buffer != buffer || entry.offset != offset || entry.stride != stride) {
+		glBindVertexBuffer(0, buffer, offset, stride);
+		entry.buffer = buffer;
+		entry.offset = offset;
+		entry.stride = stride;
+		m_frameStats.bufferSwitches++;
+	}
+}
+
+void kengine::vertex_format_registry::releaseBuffer(GLuint buffer)
+{
+	for (auto& entry : m_formats) {
+		if (entry.buffer == buffer) {
+			// the buffer name can be reused by a new buffer object
+			glVertexArrayVertexBuffer(entry.vao, 0, 0, 0, 0);
+			entry.buffer = 0;
+			entry.offset = 0;
+			entry.stride = 0;
+		}
+	}
+}
+
+void kengine::vertex_format_registry::invalidate()
+{
+	for (const auto& entry : m_formats)
+		kengine::glState().releaseVertexArray(entry.vao);
+}
+
+void kengine::vertex_format_registry::clear()
+{
+	for (auto& entry : m_formats) {
+		kengine::glState().releaseVertexArray(entry.vao);
+		glDeleteVertexArrays(1, &entry.vao);
+	}
+
+	m_formats.clear();
+}
+
+void kengine::vertex_format_registry::newFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = vertex_format_stats();
+}
+
+kengine::vertex_format_registry& kengine::vertexFormatRegistry()
+{
+	static vertex_format_registry registry;
+	return registry;
+}
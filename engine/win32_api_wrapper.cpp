@@ -31,6 +31,7 @@
 // std headers
 #include <cassert>
 #include <iostream>
+#include <cstdlib>
 // microsoft windows headers
 #include <tchar.h>
 #include <windowsx.h>
@@ -249,6 +250,84 @@ namespace kengine
 
 	/*
 	*/
+	/*
+		WGL context that shares the objects with the main context.
+		It uses the device context of the application window because WGL doesn't allow a context without a DC.
+	*/
+	class win32_shared_rendering_context : public rendering_context
+	{
+	public:
+		win32_shared_rendering_context(HDC hDCParam, HGLRC sharedContext)
+			: hDC{ hDCParam }, hSharedRC{ sharedContext }
+		{
+		}
+
+		~win32_shared_rendering_context() {
+			if (hRC != nullptr)
+				destroy();
+		}
+
+		win32_shared_rendering_context(const win32_shared_rendering_context& copy) = delete; // copy constructor
+		win32_shared_rendering_context& operator=(const win32_shared_rendering_context& copy) = delete; // copy assignment
+		win32_shared_rendering_context(win32_shared_rendering_context&& move) noexcept = delete;  // move constructor
+		win32_shared_rendering_context& operator=(win32_shared_rendering_context&&) = delete; // move assigment
+
+		int create(const compatibility_profile& profile) {
+			const int attribList[] = {
+				WGL_CONTEXT_MAJOR_VERSION_ARB, KENGINE_OPENGL_MAJOR_VERSION,
+				WGL_CONTEXT_MINOR_VERSION_ARB, KENGINE_OPENGL_MINOR_VERSION,
+				WGL_CONTEXT_FLAGS_ARB, profile.contextFlag,
+				WGL_CONTEXT_PROFILE_MASK_ARB, profile.profileMask,
+				0
+			};
+
+			hRC = wglCreateContextAttribsARB(hDC, hSharedRC, attribList);
+
+			if (hRC == nullptr) {
+				DWORD error = GetLastError();
+				globalUserEventsCallback->debugMessage("It was not possible to create the shared rendering context: " + std::to_string(error) + "\n");
+				return 0;
+			}
+
+			return 1;
+		}
+
+		int destroy() {
+			if (!wglDeleteContext(hRC)) {
+				DWORD error = GetLastError();
+				globalUserEventsCallback->debugMessage("It was not possible to delete the shared rendering context: " + std::to_string(error) + "\n");
+				return 0;
+			}
+
+			hRC = nullptr;
+			return 1;
+		}
+
+		int makeCurrent(bool enable) {
+			HGLRC context = (enable ? hRC : nullptr);
+
+			if (!wglMakeCurrent(enable ? hDC : nullptr, context)) {
+				DWORD error = GetLastError();
+				globalUserEventsCallback->debugMessage("It was not possible to make current the shared rendering context: " + std::to_string(error) + "\n");
+				return 0;
+			}
+
+			return 1;
+		}
+
+		int swapBuffers() {
+			return 1;
+		}
+
+		void clearBuffers() {
+		}
+
+	private:
+		HDC hDC = nullptr;
+		HGLRC hSharedRC = nullptr;
+		HGLRC hRC = nullptr;
+	};
+
 	class win32_rendering_context : public rendering_context
 	{
 	public:
@@ -460,6 +539,7 @@ namespace kengine
 			// wglShareLists 
 
 			hRC = wglCreateContextAttribsARB(win32_win->hDC, hRC, attribList);
+			contextProfile = profile;
 
 			if (hRC == nullptr) {
 				DWORD error = GetLastError();
@@ -478,9 +558,21 @@ namespace kengine
 			glClear(GL_COLOR_BUFFER_BIT);
 		}
 
+		rendering_context* createSharedContext() {
+			win32_shared_rendering_context* context = new win32_shared_rendering_context(win32_win->hDC, hRC);
+
+			if (!context->create(contextProfile)) {
+				delete context;
+				return nullptr;
+			}
+
+			return context;
+		}
+
 	private:
 		win32_window* win32_win = nullptr; // avoid dynamic casts in the methods
 		HGLRC hRC = nullptr;
+		compatibility_profile contextProfile;
 	};
 	
 	rendering_context* renderingContextInstance(window* win) {
@@ -502,6 +594,16 @@ int64_t kengine::getHighResolutionTimerFrequency()
 	return static_cast<int64_t>(frequency.QuadPart);
 }
 
+std::string kengine::getCanonicalPath(const std::string& filename)
+{
+	char path[_MAX_PATH];
+
+	if (_fullpath(path, filename.c_str(), _MAX_PATH) == nullptr || GetFileAttributesA(path) == INVALID_FILE_ATTRIBUTES)
+		return filename;
+
+	return path;
+}
+
 int kengine::createDebugConsole()
 {
 	if (!AllocConsole())
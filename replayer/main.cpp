@@ -0,0 +1,129 @@
+/*
+	K-Engine GL Replayer
+	This file is part of the K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <gl_replay.hpp>
+#include <headless_context.hpp>
+#include <rendering_system.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/*
+	Usage: glreplay <trace> [--size <width> <height>] [--loop <count>]
+*/
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		std::cout << "usage: glreplay <trace> [--size <width> <height>] [--loop <count>]" << std::endl;
+		return 1;
+	}
+
+	int width = 1280;
+	int height = 720;
+	int loopCount = 1;
+
+	for (int index = 2; index < argc; index++) {
+		if (std::strcmp(argv[index], "--size") == 0 && index + 2 < argc) {
+			width = std::atoi(argv[index + 1]);
+			height = std::atoi(argv[index + 2]);
+			index += 2;
+		} else if (std::strcmp(argv[index], "--loop") == 0 && index + 1 < argc) {
+			loopCount = std::max(1, std::atoi(argv[index + 1]));
+			index++;
+		}
+	}
+
+	kengine::headless_rendering_context* context = new kengine::headless_rendering_context(width, height);
+	kengine::rendering_system renderingSystem(context);
+
+	kengine::compatibility_profile profile;
+	profile.profileMask = kengine::CONTEXT_FLAG::CONTEXT_CORE_PROFILE_BIT_ABR;
+
+	if (!renderingSystem.init(kengine::RENDERING_TYPE::OPENGL, profile)) {
+		std::cout << "> GL REPLAY: no rendering context" << std::endl;
+		return 1;
+	}
+
+	std::cout << renderingSystem.info(false);
+
+	kengine::gl_replay replay;
+
+	if (!replay.load(argv[1])) {
+		return 1;
+	}
+
+	replay.setDefaultFramebuffer(context->getFramebuffer());
+
+	if (!replay.replaySetup()) {
+		return 1;
+	}
+
+	// frames: the last loop is reported (the first one may include the shader compilation, etc)
+	std::vector<kengine::gl_replay_frame_stats> frames(replay.getFrameCount());
+
+	for (int loop = 0; loop < loopCount; loop++) {
+		for (size_t frame = 0; frame < replay.getFrameCount(); frame++) {
+			if (!replay.replayFrame(frame, &frames[frame])) {
+				return 1;
+			}
+		}
+	}
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "> FRAMES (CALLS / SUBMIT MS / TOTAL MS):" << std::endl;
+
+	for (size_t frame = 0; frame < frames.size(); frame++) {
+		std::cout << "\t" << frame << ": " << frames[frame].calls << " / " << frames[frame].submitMilliseconds << " / " << frames[frame].milliseconds << std::endl;
+	}
+
+	// calls sorted by the accumulated CPU time
+	const std::vector<kengine::gl_replay_call_stats>& callStats = replay.getCallStats();
+	std::vector<size_t> calls;
+
+	for (size_t call = 0; call < callStats.size(); call++) {
+		if (callStats[call].calls > 0)
+			calls.push_back(call);
+	}
+
+	std::sort(calls.begin(), calls.end(), [&callStats](size_t a, size_t b) { return callStats[a].milliseconds > callStats[b].milliseconds; });
+
+	std::cout << "> CALLS (COUNT / TOTAL MS / MEAN US):" << std::endl;
+
+	for (size_t call : calls) {
+		const kengine::gl_replay_call_stats& stats = callStats[call];
+
+		std::cout << "\t" << kengine::getGLCallName(static_cast<kengine::GL_CALL>(call)) << ": " << stats.calls << " / " <<
+			stats.milliseconds << " / " << stats.milliseconds * 1000.0 / static_cast<double>(stats.calls) << std::endl;
+	}
+
+	renderingSystem.finish();
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+	CLUSTERED LIGHTING
+	Include of the fragment shaders that use kengine::light_clusters (version 430 or later). The fragment
+	looks up its cluster from gl_FragCoord and its view space depth, then loops over the lights of the
+	cluster only. The bindings are the defaults of kengine::light_clusters::bind.
+*/
+
+struct point_light {
+	vec4 positionRadius; // world space position, radius
+	vec4 colorIntensity;
+};
+
+layout (std430, binding = 4) readonly buffer clusterLights {
+	point_light lights[];
+};
+
+layout (std430, binding = 5) readonly buffer clusterGrid {
+	uvec4 gridSize; // x, y, z, lights per cluster
+	vec4 gridParams; // 1 / viewport width, 1 / viewport height, depth slice scale, depth slice bias
+	uvec2 clusters[]; // offset, count
+};
+
+layout (std430, binding = 6) readonly buffer clusterIndices {
+	uint lightIndices[];
+};
+
+/*
+	viewDepth is the distance along -Z in view space
+*/
+uint clusterIndex(vec2 fragCoord, float viewDepth)
+{
+	uvec2 tile = min(uvec2(fragCoord * gridParams.xy * vec2(gridSize.xy)), gridSize.xy - 1u);
+	float slice = floor(log(max(viewDepth, 1e-4)) * gridParams.z + gridParams.w);
+	uint z = uint(clamp(slice, 0.0, float(gridSize.z - 1u)));
+
+	return (z * gridSize.y + tile.y) * gridSize.x + tile.x;
+}
+
+/*
+	Diffuse contribution of the point lights (the falloff reaches 0 at the radius)
+*/
+vec3 clusteredPointLights(vec3 worldPosition, vec3 normal, float viewDepth)
+{
+	uvec2 cluster = clusters[clusterIndex(gl_FragCoord.xy, viewDepth)];
+	vec3 result = vec3(0.0);
+
+	for (uint index = 0u; index < cluster.y; index++) {
+		point_light light = lights[lightIndices[cluster.x + index]];
+		vec3 toLight = light.positionRadius.xyz - worldPosition;
+		float distanceSquared = dot(toLight, toLight);
+		float ratio = distanceSquared / (light.positionRadius.w * light.positionRadius.w);
+		float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+		float attenuation = window * window / max(distanceSquared, 1e-4);
+		float lambert = max(dot(normal, toLight * inversesqrt(max(distanceSquared, 1e-8))), 0.0);
+
+		result += light.colorIntensity.rgb * light.colorIntensity.a * lambert * attenuation;
+	}
+
+	return result;
+}
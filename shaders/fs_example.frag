@@ -9,7 +9,10 @@ layout (location=1) in vec4 color;
 
 layout (location=0) out vec4 fragmentColor;
 
+// streamed by the texture manager (the sampler object is bound to the same unit)
+layout (binding=0) uniform sampler2D diffuse;
+
 void main()
 {
-	fragmentColor = color;
+	fragmentColor = color * texture(diffuse, texCoord);
 }
\ No newline at end of file
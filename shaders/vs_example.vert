@@ -11,9 +11,16 @@ layout (location=2) in vec2 vTexCoord;
 layout (location=0) out vec2 texCoord;
 layout (location=1) out vec4 color;
 
-uniform mat4 projection;
-uniform mat4 eye;
-uniform mat4 model;
+// updated once per frame
+layout (std140, binding=0) uniform camera {
+	mat4 projection;
+	mat4 eye;
+};
+
+// updated once per draw batch
+layout (std140, binding=1) uniform object {
+	mat4 model;
+};
 
 void main() {
 	gl_Position = projection * eye * model * vec4(vPosition, 1.0);
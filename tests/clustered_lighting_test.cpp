@@ -0,0 +1,146 @@
+/*
+	K-Engine Test for the Clustered Lighting
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <clustered_lighting.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+const float NEAR_PLANE = 0.1f;
+const float FAR_PLANE = 100.0f;
+const float CAMERA_Z = 10.0f;
+
+std::vector<kengine::point_light> createLights(size_t count, std::mt19937& generator)
+{
+	std::uniform_real_distribution<float> x(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> y(-30.0f, 30.0f);
+	std::uniform_real_distribution<float> z(-90.0f, 10.0f);
+	std::uniform_real_distribution<float> radius(0.5f, 4.0f);
+	std::vector<kengine::point_light> lights(count);
+
+	for (auto& light : lights) {
+		light.position[0] = x(generator);
+		light.position[1] = y(generator);
+		light.position[2] = z(generator);
+		light.radius = radius(generator);
+	}
+
+	return lights;
+}
+
+/*
+	Every light that contains a point of the frustum must be in the list of the cluster of the point
+	(the property that the fragment shader needs)
+*/
+bool validate(const kengine::light_clusters& clusters, const float* projection, const std::vector<kengine::point_light>& lights, std::mt19937& generator)
+{
+	std::uniform_real_distribution<float> ndc(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> slice(0.0f, 1.0f);
+	const kengine::light_clusters::grid_header& header = clusters.getHeader();
+	size_t missing = 0;
+
+	for (int sample = 0; sample < 20000; sample++) {
+		float ndcX = ndc(generator);
+		float ndcY = ndc(generator);
+		float depth = NEAR_PLANE * std::pow(FAR_PLANE / NEAR_PLANE, slice(generator));
+		float world[3] = { ndcX * depth / projection[0], ndcY * depth / projection[5], CAMERA_Z - depth };
+
+		unsigned int tileX = std::min(static_cast<unsigned int>((ndcX + 1.0f) * 0.5f * header.size[0]), header.size[0] - 1);
+		unsigned int tileY = std::min(static_cast<unsigned int>((ndcY + 1.0f) * 0.5f * header.size[1]), header.size[1] - 1);
+		const kengine::light_cluster& cluster = clusters.getCluster(clusters.getClusterIndex(tileX, tileY, clusters.getSlice(depth)));
+		const uint32_t* first = clusters.getIndices() + cluster.offset;
+		const uint32_t* last = first + cluster.count;
+
+		for (size_t index = 0; index < lights.size(); index++) {
+			const kengine::point_light& light = lights[index];
+			float distanceSquared = 0.0f;
+
+			for (int axis = 0; axis < 3; axis++)
+				distanceSquared += (world[axis] - light.position[axis]) * (world[axis] - light.position[axis]);
+
+			if (distanceSquared < light.radius * light.radius && !std::binary_search(first, last, static_cast<uint32_t>(index)))
+				missing++;
+		}
+	}
+
+	if (missing > 0)
+		std::cout << "> CLUSTERED LIGHTING: " << missing << " lights are missing from their clusters" << std::endl;
+
+	return missing == 0;
+}
+
+/*
+	main
+
+	Binning of 10 to 10000 point lights into 16x9x24 clusters (1280x720, 60 degrees)
+*/
+int main()
+{
+	const int ITERATIONS = 20;
+	const float aspect = 1280.0f / 720.0f;
+	const float focal = 1.0f / std::tan(30.0f * 3.14159265f / 180.0f);
+
+	float projection[16] = { 0.0f };
+	projection[0] = focal / aspect;
+	projection[5] = focal;
+	projection[10] = (FAR_PLANE + NEAR_PLANE) / (NEAR_PLANE - FAR_PLANE);
+	projection[11] = -1.0f;
+	projection[14] = 2.0f * FAR_PLANE * NEAR_PLANE / (NEAR_PLANE - FAR_PLANE);
+
+	float view[16] = { 0.0f };
+	view[0] = view[5] = view[10] = view[15] = 1.0f;
+	view[14] = -CAMERA_Z;
+
+	kengine::light_clusters clusters;
+	clusters.setProjection(projection, NEAR_PLANE, FAR_PLANE, 1280, 720);
+
+	std::mt19937 generator(7);
+	const size_t counts[] = { 10, 100, 1000, 10000 };
+
+	for (size_t count : counts) {
+		std::vector<kengine::point_light> lights = createLights(count, generator);
+		double milliseconds = 0.0;
+
+		for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+			clusters.bin(view, lights.data(), lights.size());
+			milliseconds += clusters.getFrameStats().binMilliseconds;
+		}
+
+		const kengine::clustered_lighting_stats& stats = clusters.getFrameStats();
+
+		std::cout << "> CLUSTERED LIGHTING: " << count << " lights, " << stats.visibleLights << " in the frustum, " << stats.activeClusters << "/" << clusters.getClusterCount() << " active clusters, "
+			<< stats.indices << " indices, " << stats.overflows << " dropped, " << milliseconds / ITERATIONS << " ms" << std::endl;
+
+		if (stats.overflows == 0 && !validate(clusters, projection, lights, generator))
+			return 1;
+	}
+
+	std::cout << "> CLUSTERED LIGHTING: OK" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,176 @@
+/*
+	K-Engine Test for the Dynamic Resolution
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <dynamic_resolution.hpp>
+#include "headless_setup.hpp"
+
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+	Simulated frames: the GPU time is proportional to the number of pixels and it is measured 3 frames late
+	(the latency of the GPU profiler). It returns the mean GPU time of the last 100 frames.
+*/
+double simulate(kengine::resolution_controller& controller, double cpuMilliseconds, double fixedMilliseconds, double pixelMilliseconds, int frames)
+{
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<double> noise(0.95, 1.05);
+	std::deque<double> measures(3, -1.0);
+	double total = 0.0;
+
+	for (int frame = 0; frame < frames; frame++) {
+		double scale = controller.getScale();
+		measures.push_back((fixedMilliseconds + pixelMilliseconds * scale * scale) * noise(generator));
+
+		controller.update(cpuMilliseconds, measures.front());
+		measures.pop_front();
+
+		if (frame >= frames - 100)
+			total += measures.back();
+	}
+
+	return total / 100.0;
+}
+
+bool testController()
+{
+	kengine::dynamic_resolution_settings settings;
+	const double target = settings.targetMilliseconds;
+
+	// GPU bound (32 ms at full resolution): the scale goes down into the band and stays there
+	kengine::resolution_controller heavy(settings);
+	double milliseconds = simulate(heavy, 5.0, 2.0, 30.0, 600);
+
+	std::cout << "> DYNAMIC RESOLUTION: GPU bound, scale " << heavy.getScale() << ", " << milliseconds << " ms, " << heavy.getChanges().size() << " changes" << std::endl;
+
+	if (milliseconds > target * settings.upperThreshold || milliseconds < target * settings.lowerThreshold * 0.9 || heavy.getChanges().size() > 6) {
+		std::cout << "> DYNAMIC RESOLUTION: the GPU bound frames are not in the band" << std::endl;
+		return false;
+	}
+
+	if (heavy.getChanges().front().resultMilliseconds >= heavy.getChanges().front().gpuMilliseconds) {
+		std::cout << "> DYNAMIC RESOLUTION: the first decrease has no effect" << std::endl;
+		return false;
+	}
+
+	// light load: the scale goes back up to the maximum, one small step at a time
+	kengine::resolution_controller light(settings);
+	light.setScale(settings.minScale);
+	simulate(light, 5.0, 1.0, 4.0, 600);
+
+	for (const auto& change : light.getChanges()) {
+		if (change.toScale < change.fromScale || change.toScale - change.fromScale > settings.maxStepUp + 1e-5f) {
+			std::cout << "> DYNAMIC RESOLUTION: invalid increase " << change.fromScale << " -> " << change.toScale << std::endl;
+			return false;
+		}
+	}
+
+	if (light.getScale() != settings.maxScale) {
+		std::cout << "> DYNAMIC RESOLUTION: the scale didn't reach the maximum (" << light.getScale() << ")" << std::endl;
+		return false;
+	}
+
+	// CPU bound: a lower resolution wouldn't help
+	kengine::resolution_controller cpuBound(settings);
+	simulate(cpuBound, 25.0, 2.0, 8.0, 300);
+
+	if (cpuBound.getScale() != settings.maxScale || cpuBound.getStats().cpuBoundFrames == 0) {
+		std::cout << "> DYNAMIC RESOLUTION: the CPU bound frames changed the scale" << std::endl;
+		return false;
+	}
+
+	// too heavy for the minimum scale: it stops at the bound
+	kengine::resolution_controller overloaded(settings);
+	simulate(overloaded, 5.0, 20.0, 80.0, 300);
+
+	if (overloaded.getScale() != settings.minScale) {
+		std::cout << "> DYNAMIC RESOLUTION: the scale is not at the minimum (" << overloaded.getScale() << ")" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	main
+*/
+int main()
+{
+	if (!testController())
+		return 1;
+
+	headless_setup headless(64, 64);
+
+	if (!headless.init("DYNAMIC RESOLUTION"))
+		return SKIP_RETURN_CODE;
+
+	kengine::dynamic_resolution* resolution = new kengine::dynamic_resolution();
+
+	if (!resolution->resize(headless.context->getWidth(), headless.context->getHeight())) {
+		std::cout << "> DYNAMIC RESOLUTION: it was not possible to create the offscreen target" << std::endl;
+		return 1;
+	}
+
+	// the whole target is blue, the scaled region is red: only the region is upscaled
+	glBindFramebuffer(GL_FRAMEBUFFER, resolution->getFramebuffer());
+	glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	resolution->getController().setScale(0.5f);
+	resolution->begin();
+
+	if (resolution->getRenderWidth() != 32 || resolution->getRenderHeight() != 32) {
+		std::cout << "> DYNAMIC RESOLUTION: invalid render size " << resolution->getRenderWidth() << "x" << resolution->getRenderHeight() << std::endl;
+		return 1;
+	}
+
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(0, 0, resolution->getRenderWidth(), resolution->getRenderHeight());
+	glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
+
+	resolution->end(headless.context->getFramebuffer());
+
+	std::vector<unsigned char> pixels;
+	headless.context->readPixels(pixels);
+
+	for (size_t index = 0; index < pixels.size(); index += 4) {
+		if (pixels[index] != 255 || pixels[index + 2] != 0) {
+			std::cout << "> DYNAMIC RESOLUTION: the output is not the upscaled region" << std::endl;
+			return 1;
+		}
+	}
+
+	delete resolution;
+	headless.renderingSystem.finish();
+
+	std::cout << "> DYNAMIC RESOLUTION: OK" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,197 @@
+/*
+	K-Engine Test for the GL Capture and Replay
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <gl_capture.hpp>
+#include <gl_replay.hpp>
+#include "headless_setup.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+const char* vertexSource =
+	"#version 450 core\n"
+	"layout(location = 0) in vec2 position;\n"
+	"void main() { gl_Position = vec4(position, 0.0, 1.0); }\n";
+
+const char* fragmentSource =
+	"#version 450 core\n"
+	"layout(location = 0) uniform vec4 tint;\n"
+	"layout(binding = 0) uniform sampler2D image;\n"
+	"layout(location = 0) out vec4 color;\n"
+	"void main() { color = tint * texture(image, vec2(0.5)); }\n";
+
+/*
+	Count of the pixels that were drawn (green) by the triangle
+*/
+size_t countGreen(const std::vector<unsigned char>& pixels)
+{
+	size_t count = 0;
+
+	for (size_t index = 0; index < pixels.size(); index += 4) {
+		if (pixels[index] == 0 && pixels[index + 1] == 255 && pixels[index + 2] == 0)
+			count++;
+	}
+
+	return count;
+}
+
+/*
+	main
+*/
+int main()
+{
+	const char* filename = "gl_capture_test.kglt";
+	const unsigned int frameCount = 3;
+
+	headless_setup headless(64, 64);
+
+	if (!headless.init("GL CAPTURE"))
+		return SKIP_RETURN_CODE;
+
+	if (!kengine::glCapture().start(filename)) {
+		std::cout << "> GL CAPTURE: it was not possible to start the capture" << std::endl;
+		return 1;
+	}
+
+	// loading (recorded before the first frame marker)
+	const GLfloat triangle[] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f };
+	const GLfloat green[] = { 0.0f, 1.0f, 0.0f, 1.0f };
+
+	// the content written in the mapped range is recorded by the unmap
+	GLuint buffer = 0;
+	glCreateBuffers(1, &buffer);
+	glNamedBufferData(buffer, sizeof(triangle), nullptr, GL_STATIC_DRAW);
+	void* vertices = glMapNamedBufferRange(buffer, 0, sizeof(triangle), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	std::memcpy(vertices, triangle, sizeof(triangle));
+	glUnmapNamedBuffer(buffer);
+
+	// a white texel (the replay draws black if the texture or the sampler is missing)
+	const unsigned char white[] = { 255, 255, 255, 255 };
+
+	GLuint texture = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+	glTextureStorage2D(texture, 1, GL_RGBA8, 1, 1);
+	glTextureSubImage2D(texture, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, white);
+
+	GLuint sampler = 0;
+	glCreateSamplers(1, &sampler);
+	glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	GLuint vertexArray = 0;
+	glCreateVertexArrays(1, &vertexArray);
+	glEnableVertexArrayAttrib(vertexArray, 0);
+	glVertexArrayAttribFormat(vertexArray, 0, 2, GL_FLOAT, GL_FALSE, 0);
+	glVertexArrayAttribBinding(vertexArray, 0, 0);
+	glVertexArrayVertexBuffer(vertexArray, 0, buffer, 0, sizeof(GLfloat) * 2);
+
+	GLuint program = glCreateProgram();
+	GLuint vertexShader = kengine::compileShaderSource(GL_VERTEX_SHADER, vertexSource);
+	GLuint fragmentShader = kengine::compileShaderSource(GL_FRAGMENT_SHADER, fragmentSource);
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	for (unsigned int frame = 0; frame < frameCount; frame++) {
+		headless.renderingSystem.newFrame();
+
+		glBindFramebuffer(GL_FRAMEBUFFER, headless.context->getFramebuffer());
+		glViewport(0, 0, headless.context->getWidth(), headless.context->getHeight());
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		glUseProgram(program);
+		glUniform4fv(0, 1, green);
+		glBindTextureUnit(0, texture);
+		glBindSampler(0, sampler);
+		glBindVertexArray(vertexArray);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+
+	kengine::glCapture().stop();
+
+	kengine::gl_capture_stats captureStats = kengine::glCapture().getStats();
+	std::cout << "> GL CAPTURE: " << captureStats.calls << " calls, " << captureStats.bytes << " bytes, " << captureStats.frames << " frames" << std::endl;
+
+	std::vector<unsigned char> pixels;
+	headless.context->readPixels(pixels);
+	size_t expected = countGreen(pixels);
+
+	glDeleteProgram(program);
+	glDeleteSamplers(1, &sampler);
+	glDeleteTextures(1, &texture);
+	glDeleteVertexArrays(1, &vertexArray);
+	glDeleteBuffers(1, &buffer);
+
+	// the replay must draw the same pixels on a cleared framebuffer
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	headless.context->clearBuffers();
+
+	kengine::gl_replay replay;
+
+	if (!replay.load(filename)) {
+		std::cout << "> GL CAPTURE: invalid trace" << std::endl;
+		return 1;
+	}
+
+	replay.setDefaultFramebuffer(headless.context->getFramebuffer());
+
+	if (replay.getFrameCount() != frameCount || !replay.replaySetup()) {
+		std::cout << "> GL CAPTURE: " << replay.getFrameCount() << " frames in the trace (expected " << frameCount << ")" << std::endl;
+		return 1;
+	}
+
+	for (size_t frame = 0; frame < replay.getFrameCount(); frame++) {
+		kengine::gl_replay_frame_stats frameStats;
+
+		if (!replay.replayFrame(frame, &frameStats)) {
+			std::cout << "> GL CAPTURE: the replay of the frame " << frame << " has failed" << std::endl;
+			return 1;
+		}
+
+		std::cout << "> GL REPLAY: frame " << frame << ", " << frameStats.calls << " calls, " << frameStats.milliseconds << " ms" << std::endl;
+	}
+
+	headless.context->readPixels(pixels);
+
+	uint64_t draws = replay.getCallStats()[static_cast<size_t>(kengine::GL_CALL::DRAW_ARRAYS)].calls;
+
+	if (expected == 0 || countGreen(pixels) != expected || draws != frameCount) {
+		std::cout << "> GL CAPTURE: the replay doesn't match the capture (" << countGreen(pixels) << " of " << expected << " pixels, " << draws << " draws)" << std::endl;
+		return 1;
+	}
+
+	std::remove(filename);
+
+	headless.renderingSystem.finish();
+
+	std::cout << "> GL CAPTURE: OK" << std::endl;
+
+	return 0;
+}
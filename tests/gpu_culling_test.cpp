@@ -0,0 +1,255 @@
+/*
+	K-Engine Test for the GPU Culling
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <gpu_culling.hpp>
+#include <gl_state.hpp>
+#include <mesh.hpp>
+#include <vertex_format.hpp>
+#include "headless_setup.hpp"
+
+#include <iostream>
+#include <vector>
+
+/*
+	The instances read their position from the instance buffer of the culler (the center of the box)
+*/
+const char* vertexSource =
+	"#version 430 core\n"
+	"layout(location = 0) in vec3 position;\n"
+	"layout(location = 7) in uint instance;\n"
+	"struct instance_bounds { vec4 boundsMin; vec4 boundsMax; };\n"
+	"layout(std430, binding = 0) readonly buffer instances { instance_bounds bounds[]; };\n"
+	"uniform mat4 viewProjection;\n"
+	"uniform int useInstances;\n"
+	"uniform vec3 offset;\n"
+	"void main() {\n"
+	"	vec3 center = useInstances != 0 ? (bounds[instance].boundsMin.xyz + bounds[instance].boundsMax.xyz) * 0.5 : offset;\n"
+	"	gl_Position = viewProjection * vec4(position + center, 1.0);\n"
+	"}\n";
+
+const char* fragmentSource =
+	"#version 430 core\n"
+	"layout(location = 0) out vec4 color;\n"
+	"void main() { color = vec4(0.0, 1.0, 0.0, 1.0); }\n";
+
+GLuint createProgram()
+{
+	GLuint program = glCreateProgram();
+	GLuint vertexShader = kengine::compileShaderSource(GL_VERTEX_SHADER, vertexSource);
+	GLuint fragmentShader = kengine::compileShaderSource(GL_FRAGMENT_SHADER, fragmentSource);
+
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	return kengine::checkLinkStatus(program) ? program : 0;
+}
+
+void addInstances(std::vector<kengine::gpu_instance>& instances, float x, float z, size_t count)
+{
+	for (size_t index = 0; index < count; index++) {
+		kengine::gpu_instance instance;
+		float center[3] = { x + static_cast<float>(index % 4) - 1.5f, static_cast<float>(index / 4) - 1.5f, z };
+
+		for (int axis = 0; axis < 3; axis++) {
+			instance.boundsMin[axis] = center[axis] - 0.25f;
+			instance.boundsMax[axis] = center[axis] + 0.25f;
+		}
+
+		instances.push_back(instance);
+	}
+}
+
+/*
+	main
+
+	The wall (z = -10) covers the view: 16 instances are in front of it, 16 behind it and 16 outside the view
+*/
+int main()
+{
+	const int SIZE = 64;
+	const GLuint GROUP_COUNT = 16;
+
+	headless_setup headless(SIZE, SIZE);
+
+	if (!headless.init("GPU CULLING"))
+		return SKIP_RETURN_CODE;
+
+	kengine::gpu_culler* culler = new kengine::gpu_culler();
+	GLuint program = createProgram();
+
+	if (!culler->init() || program == 0) {
+		std::cout << "> GPU CULLING: it was not possible to load the shaders" << std::endl;
+		return 1;
+	}
+
+	// perspective projection (90 degrees) and the camera at the origin
+	const float NEAR_PLANE = 0.1f;
+	const float FAR_PLANE = 100.0f;
+	float viewProjection[16] = { 0.0f };
+	viewProjection[0] = 1.0f;
+	viewProjection[5] = 1.0f;
+	viewProjection[10] = (FAR_PLANE + NEAR_PLANE) / (NEAR_PLANE - FAR_PLANE);
+	viewProjection[11] = -1.0f;
+	viewProjection[14] = 2.0f * FAR_PLANE * NEAR_PLANE / (NEAR_PLANE - FAR_PLANE);
+
+	kengine::mesh wallMesh = kengine::quad(100.0f);
+	kengine::mesh instanceMesh = kengine::triangle(0.5f);
+	kengine::mesh_node* wall = new kengine::mesh_node();
+	kengine::mesh_node* node = new kengine::mesh_node();
+	wall->load(wallMesh);
+	node->load(instanceMesh);
+
+	GLint viewProjectionLocation = glGetUniformLocation(program, "viewProjection");
+	GLint useInstancesLocation = glGetUniformLocation(program, "useInstances");
+	GLint offsetLocation = glGetUniformLocation(program, "offset");
+	const GLint useInstances[2] = { 0, 1 };
+	const GLfloat wallOffset[3] = { 0.0f, 0.0f, -10.0f };
+
+	// depth of the previous frame: the wall
+	glBindFramebuffer(GL_FRAMEBUFFER, headless.context->getFramebuffer());
+	glViewport(0, 0, SIZE, SIZE);
+	glEnable(GL_DEPTH_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	kengine::glState().useProgram(program);
+	glUniformMatrix4fv(viewProjectionLocation, 1, GL_FALSE, viewProjection);
+	glUniform1iv(useInstancesLocation, 1, &useInstances[0]);
+	glUniform3fv(offsetLocation, 1, wallOffset);
+	wall->drawArrays();
+
+	culler->updateHiZ(headless.context->getFramebuffer(), SIZE, SIZE, viewProjection);
+
+	// instances
+	unsigned int draw = culler->addDraw(*node, GROUP_COUNT * 3);
+	std::vector<kengine::gpu_instance> instances;
+	addInstances(instances, 0.0f, -5.0f, GROUP_COUNT);
+	addInstances(instances, 0.0f, -20.0f, GROUP_COUNT);
+	addInstances(instances, 100.0f, -5.0f, GROUP_COUNT);
+
+	for (auto& instance : instances)
+		instance.draw = draw;
+
+	if (!culler->setInstances(instances.data(), instances.size())) {
+		std::cout << "> GPU CULLING: invalid instances" << std::endl;
+		return 1;
+	}
+
+	// the results are only read back by the test (the draws don't need them)
+	kengine::gpu_draw_command command;
+	culler->cull(viewProjection);
+	glGetNamedBufferSubData(culler->getCommandBuffer(), 0, sizeof(command), &command);
+
+	if (command.instanceCount != GROUP_COUNT || command.count != 3) {
+		std::cout << "> GPU CULLING: " << command.instanceCount << " visible instances (expected " << GROUP_COUNT << ")" << std::endl;
+		return 1;
+	}
+
+	// without the Hi-Z, the instances behind the wall are visible
+	culler->resetHiZ();
+	culler->cull(viewProjection);
+	glGetNamedBufferSubData(culler->getCommandBuffer(), 0, sizeof(command), &command);
+
+	if (command.instanceCount != GROUP_COUNT * 2) {
+		std::cout << "> GPU CULLING: " << command.instanceCount << " visible instances without Hi-Z (expected " << GROUP_COUNT * 2 << ")" << std::endl;
+		return 1;
+	}
+
+	// the indirect draw of the visible instances
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	culler->bindInstanceAttribute(kengine::vertexFormatRegistry().getVertexArray(node->getVertexFormat()), 7);
+	kengine::glState().useProgram(program);
+	glUniform1iv(useInstancesLocation, 1, &useInstances[1]);
+	kengine::glState().bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, culler->getInstanceBuffer());
+	culler->draw(draw, *node);
+
+	std::vector<unsigned char> pixels;
+	headless.context->readPixels(pixels);
+	size_t green = 0;
+
+	for (size_t index = 0; index < pixels.size(); index += 4)
+		green += pixels[index + 1] == 255 ? 1 : 0;
+
+	if (green == 0) {
+		std::cout << "> GPU CULLING: the indirect draw is empty" << std::endl;
+		return 1;
+	}
+
+	// a new draw reallocates the visible instances: the vertex array must source the new buffer (the frustum
+	// culled instances are first, so the indices of the previous cull would draw them)
+	culler->addDraw(*node, GROUP_COUNT);
+	instances.clear();
+	addInstances(instances, 100.0f, -5.0f, GROUP_COUNT);
+	addInstances(instances, 0.0f, -5.0f, GROUP_COUNT);
+	addInstances(instances, 0.0f, -20.0f, GROUP_COUNT);
+
+	for (auto& instance : instances)
+		instance.draw = draw;
+
+	culler->setInstances(instances.data(), instances.size());
+	culler->cull(viewProjection);
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	kengine::glState().useProgram(program);
+	culler->draw(draw, *node);
+	headless.context->readPixels(pixels);
+	size_t reallocatedGreen = 0;
+
+	for (size_t index = 0; index < pixels.size(); index += 4)
+		reallocatedGreen += pixels[index + 1] == 255 ? 1 : 0;
+
+	if (reallocatedGreen != green) {
+		std::cout << "> GPU CULLING: " << reallocatedGreen << " pixels after the reallocation (expected " << green << ")" << std::endl;
+		return 1;
+	}
+
+	// the counters are read a few frames later
+	for (int frame = 0; frame < kengine::gpu_culler::STATS_LATENCY; frame++) {
+		culler->cull(viewProjection);
+		glFinish();
+	}
+
+	const kengine::gpu_culling_stats& stats = culler->getFrameStats();
+	std::cout << "> GPU CULLING: " << stats.visible << " visible, " << stats.frustumCulled << " frustum culled, " << stats.occluded << " occluded, " << green << " pixels" << std::endl;
+
+	if (stats.visible != GROUP_COUNT * 2 || stats.frustumCulled != GROUP_COUNT || stats.occluded != 0) {
+		std::cout << "> GPU CULLING: invalid counters" << std::endl;
+		return 1;
+	}
+
+	delete culler;
+	delete wall;
+	delete node;
+	glDeleteProgram(program);
+
+	headless.renderingSystem.finish();
+
+	std::cout << "> GPU CULLING: OK" << std::endl;
+
+	return 0;
+}
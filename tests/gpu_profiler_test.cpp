@@ -0,0 +1,195 @@
+/*
+	K-Engine Test for GPU Profiler
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <gpu_profiler.hpp>
+#include <gl_state.hpp>
+#include "headless_setup.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+	A triangle built from gl_VertexID (no vertex buffer)
+*/
+const char* vertexSource =
+	"#version 430 core\n"
+	"void main() {\n"
+	"	vec2 position = vec2(gl_VertexID == 1 ? 3.0 : -1.0, gl_VertexID == 2 ? 3.0 : -1.0);\n"
+	"	gl_Position = vec4(position, 0.0, 1.0);\n"
+	"}\n";
+
+const char* fragmentSource =
+	"#version 430 core\n"
+	"layout(location = 0) out vec4 color;\n"
+	"void main() { color = vec4(1.0); }\n";
+
+GLuint createProgram()
+{
+	GLuint program = glCreateProgram();
+	GLuint vertexShader = kengine::compileShaderSource(GL_VERTEX_SHADER, vertexSource);
+	GLuint fragmentShader = kengine::compileShaderSource(GL_FRAGMENT_SHADER, fragmentSource);
+
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	return kengine::checkLinkStatus(program) ? program : 0;
+}
+
+/*
+	The outermost scope collects the counters of the two triangles, "blur" is over the limit of 3 scopes
+*/
+void recordFrame(kengine::gpu_profiler& profiler)
+{
+	kengine::gpu_scope frame("frame", profiler);
+
+	{
+		kengine::gpu_scope geometry("geometry", profiler);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+
+	{
+		kengine::gpu_scope post("post", profiler);
+		kengine::gpu_scope blur("blur", profiler);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+}
+
+/*
+	The passes of a frame read back (the scope over the limit is not timed)
+*/
+bool checkStats(const std::vector<kengine::gpu_pass_stats>& stats, bool hasStatistics)
+{
+	const char* names[] = { "frame", "geometry", "post" };
+	const unsigned int depths[] = { 0, 1, 1 };
+
+	if (stats.size() != 3)
+		return false;
+
+	for (size_t index = 0; index < stats.size(); index++) {
+		if (stats[index].name != names[index] || stats[index].depth != depths[index] || stats[index].milliseconds < 0.0)
+			return false;
+
+		// the counter queries can't be nested: only the outermost scope has them
+		if (stats[index].hasCounters != (index == 0))
+			return false;
+	}
+
+	if (stats[0].primitivesGenerated != 2 || stats[1].primitivesGenerated != 0)
+		return false;
+
+	if (hasStatistics && (stats[0].verticesSubmitted != 6 || stats[0].vertexShaderInvocations == 0 || stats[0].fragmentShaderInvocations == 0))
+		return false;
+
+	return true;
+}
+
+/*
+	main
+*/
+int main()
+{
+	const int FRAME_LATENCY = 2;
+	const int FRAME_COUNT = 8;
+
+	headless_setup headless(64, 64);
+
+	if (!headless.init("GPU PROFILER"))
+		return SKIP_RETURN_CODE;
+
+	GLuint program = createProgram();
+	GLuint vao = 0;
+	glCreateVertexArrays(1, &vao);
+
+	kengine::gpu_profiler* profiler = new kengine::gpu_profiler();
+
+	if (program == 0 || !profiler->init(FRAME_LATENCY, 3)) {
+		std::cout << "> GPU PROFILER: invalid program or profiler" << std::endl;
+		return 1;
+	}
+
+	bool hasStatistics = kengine::isExtensionSupported("GL_ARB_pipeline_statistics_query");
+	uint64_t lastFrame = 0;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, headless.context->getFramebuffer());
+	glViewport(0, 0, headless.context->getWidth(), headless.context->getHeight());
+	kengine::glState().useProgram(program);
+	kengine::glState().bindVertexArray(vao);
+
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		recordFrame(*profiler);
+
+		// the results are available when the ring wraps, so no frame is dropped
+		glFinish();
+		profiler->newFrame();
+
+		// the frame N is read back by the newFrame of the frame N + latency
+		if (frame < FRAME_LATENCY) {
+			if (!profiler->getFrameStats().empty()) {
+				std::cout << "> GPU PROFILER: frame read back before the latency" << std::endl;
+				return 1;
+			}
+
+			continue;
+		}
+
+		if (!checkStats(profiler->getFrameStats(), hasStatistics)) {
+			std::cout << "> GPU PROFILER: invalid stats of the frame " << profiler->getLastFrameNumber() << std::endl;
+			return 1;
+		}
+
+		if (frame > FRAME_LATENCY && profiler->getLastFrameNumber() != lastFrame + 1) {
+			std::cout << "> GPU PROFILER: the frame " << profiler->getLastFrameNumber() << " follows the frame " << lastFrame << std::endl;
+			return 1;
+		}
+
+		lastFrame = profiler->getLastFrameNumber();
+	}
+
+	if (lastFrame != FRAME_COUNT - FRAME_LATENCY - 1 || profiler->getDroppedFrames() != 0 || glGetError() != GL_NO_ERROR) {
+		std::cout << "> GPU PROFILER: last frame " << lastFrame << ", " << profiler->getDroppedFrames() << " dropped frames" << std::endl;
+		return 1;
+	}
+
+	for (const kengine::gpu_pass_stats& stats : profiler->getFrameStats())
+		std::cout << "> " << std::string(stats.depth * 2, ' ') << stats.name << ": " << stats.milliseconds << " ms" << std::endl;
+
+	profiler->finish();
+	delete profiler;
+
+	kengine::glState().releaseVertexArray(vao);
+	glDeleteVertexArrays(1, &vao);
+	kengine::glState().releaseProgram(program);
+	glDeleteProgram(program);
+
+	headless.renderingSystem.finish();
+
+	std::cout << "> GPU PROFILER: OK" << std::endl;
+
+	return 0;
+}
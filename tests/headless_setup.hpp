@@ -0,0 +1,66 @@
+/*
+	K-Engine Headless Setup for the Tests
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef K_ENGINE_TESTS_HEADLESS_SETUP_HPP
+#define K_ENGINE_TESTS_HEADLESS_SETUP_HPP
+
+#include <headless_context.hpp>
+#include <rendering_system.hpp>
+
+#include <iostream>
+
+/*
+	Exit code of a test without a rendering context (see SKIP_RETURN_CODE in tests/CMakeLists.txt)
+*/
+const int SKIP_RETURN_CODE = 77;
+
+/*
+	Rendering system of the GL tests on a headless core profile context (no window)
+*/
+struct headless_setup
+{
+	kengine::headless_rendering_context* context; // owned by the rendering system
+	kengine::rendering_system renderingSystem;
+
+	headless_setup(int width, int height) : context{ new kengine::headless_rendering_context(width, height) }, renderingSystem{ context } {}
+
+	/*
+		The name prefixes the message printed when the context can't be created
+	*/
+	bool init(const char* name) {
+		kengine::compatibility_profile profile;
+		profile.profileMask = kengine::CONTEXT_FLAG::CONTEXT_CORE_PROFILE_BIT_ABR;
+
+		// no EGL driver on this machine: the test is skipped (see SKIP_RETURN_CODE)
+		if (!renderingSystem.init(kengine::RENDERING_TYPE::OPENGL, profile)) {
+			std::cout << "> " << name << ": no EGL context" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+};
+
+#endif
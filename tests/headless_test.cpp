@@ -0,0 +1,93 @@
+/*
+	K-Engine Test for the Headless Rendering Context
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "headless_setup.hpp"
+
+#include <iostream>
+#include <vector>
+
+/*
+	Every pixel of the framebuffer must be the clear color
+*/
+bool checkClear(kengine::headless_rendering_context* context, float red, float green, float blue)
+{
+	std::vector<unsigned char> pixels;
+
+	glClearColor(red, green, blue, 1.0f);
+	context->clearBuffers();
+
+	if (!context->readPixels(pixels) || pixels.size() != static_cast<size_t>(context->getWidth()) * context->getHeight() * 4)
+		return false;
+
+	for (size_t index = 0; index < pixels.size(); index += 4) {
+		if (pixels[index] != static_cast<unsigned char>(red * 255.0f) ||
+			pixels[index + 1] != static_cast<unsigned char>(green * 255.0f) ||
+			pixels[index + 2] != static_cast<unsigned char>(blue * 255.0f) ||
+			pixels[index + 3] != 255)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+	main
+*/
+int main()
+{
+	headless_setup headless(64, 32);
+
+	if (!headless.init("HEADLESS"))
+		return SKIP_RETURN_CODE;
+
+	std::cout << headless.renderingSystem.info(false);
+
+	if (!checkClear(headless.context, 1.0f, 0.0f, 0.0f)) {
+		std::cout << "> HEADLESS: invalid readback (64x32)" << std::endl;
+		return 1;
+	}
+
+	if (!headless.context->resize(16, 48) || !checkClear(headless.context, 0.0f, 0.0f, 1.0f)) {
+		std::cout << "> HEADLESS: invalid readback after resize (16x48)" << std::endl;
+		return 1;
+	}
+
+	kengine::rendering_context* sharedContext = headless.renderingSystem.createSharedContext();
+
+	if (sharedContext == nullptr) {
+		std::cout << "> HEADLESS: no shared context" << std::endl;
+		return 1;
+	}
+
+	delete sharedContext;
+
+	headless.renderingSystem.finish();
+
+	std::cout << "> HEADLESS: OK" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,197 @@
+/*
+	K-Engine Test for the Occlusion Culling
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <occlusion_culling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+	Window rectangle (normalized device coordinates) of a box, false if it is outside the view
+*/
+bool project(const float* matrix, const float* boundsMin, const float* boundsMax, float* rect)
+{
+	for (int corner = 0; corner < 8; corner++) {
+		float position[3] = {
+			(corner & 1) ? boundsMax[0] : boundsMin[0],
+			(corner & 2) ? boundsMax[1] : boundsMin[1],
+			(corner & 4) ? boundsMax[2] : boundsMin[2]
+		};
+
+		float clip[4];
+
+		for (int row = 0; row < 4; row++)
+			clip[row] = matrix[row] * position[0] + matrix[4 + row] * position[1] + matrix[8 + row] * position[2] + matrix[12 + row];
+
+		float x = clip[0] / clip[3];
+		float y = clip[1] / clip[3];
+
+		rect[0] = corner == 0 ? x : std::min(rect[0], x);
+		rect[1] = corner == 0 ? y : std::min(rect[1], y);
+		rect[2] = corner == 0 ? x : std::max(rect[2], x);
+		rect[3] = corner == 0 ? y : std::max(rect[3], y);
+	}
+
+	return rect[2] >= -1.0f && rect[0] <= 1.0f && rect[3] >= -1.0f && rect[1] <= 1.0f;
+}
+
+bool overlap(const float* a, const float* b)
+{
+	return a[2] >= b[0] && a[0] <= b[2] && a[3] >= b[1] && a[1] <= b[3];
+}
+
+/*
+	Two triangles of a quad on the plane z
+*/
+void addQuad(std::vector<float>& positions, float x0, float y0, float x1, float y1, float z)
+{
+	const float quad[] = { x0, y0, z, x1, y0, z, x1, y1, z, x0, y0, z, x1, y1, z, x0, y1, z };
+	positions.insert(positions.end(), quad, quad + 18);
+}
+
+/*
+	main
+
+	Reference scene: the camera looks at a wall (z = -10) with a door. The boxes in front of the wall and the
+	boxes seen through the door must be visible, most of the boxes behind the wall must be culled.
+*/
+int main()
+{
+	const size_t BOX_COUNT = 10000;
+	const int FRAME_COUNT = 100;
+	const float NEAR_PLANE = 0.1f;
+	const float FAR_PLANE = 100.0f;
+
+	// perspective projection (90 degrees, 5:3) and the camera at the origin
+	const float aspect = 320.0f / 192.0f;
+	float viewProjection[16] = { 0.0f };
+	viewProjection[0] = 1.0f / aspect;
+	viewProjection[5] = 1.0f;
+	viewProjection[10] = (FAR_PLANE + NEAR_PLANE) / (NEAR_PLANE - FAR_PLANE);
+	viewProjection[11] = -1.0f;
+	viewProjection[14] = 2.0f * FAR_PLANE * NEAR_PLANE / (NEAR_PLANE - FAR_PLANE);
+
+	// the wall around the door (x in [-1, 1], y in [-10, 2])
+	std::vector<float> wall;
+	addQuad(wall, -40.0f, -40.0f, -1.0f, 40.0f, -10.0f);
+	addQuad(wall, 1.0f, -40.0f, 40.0f, 40.0f, -10.0f);
+	addQuad(wall, -1.0f, 2.0f, 1.0f, 40.0f, -10.0f);
+	addQuad(wall, -1.0f, -40.0f, 1.0f, -10.0f, -10.0f);
+
+	const float doorMin[3] = { -1.0f, -10.0f, -10.0f };
+	const float doorMax[3] = { 1.0f, 2.0f, -10.0f };
+	float doorRect[4];
+	project(viewProjection, doorMin, doorMax, doorRect);
+
+	// the occluders cover the pixels whose center is inside (like the GPU), so the boxes that are seen through
+	// less than one pixel of the door can be culled
+	doorRect[0] += 2.0f / 320.0f;
+	doorRect[1] += 2.0f / 192.0f;
+	doorRect[2] -= 2.0f / 320.0f;
+	doorRect[3] -= 2.0f / 192.0f;
+
+	// 10% of the boxes in front of the wall
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> xyDistribution(-30.0f, 30.0f);
+	std::uniform_real_distribution<float> frontDistribution(-9.0f, -2.0f);
+	std::uniform_real_distribution<float> backDistribution(-90.0f, -11.0f);
+	std::uniform_real_distribution<float> sizeDistribution(0.1f, 1.0f);
+
+	std::vector<float> bounds(BOX_COUNT * 6);
+	std::vector<uint8_t> expected(BOX_COUNT);
+	size_t expectedVisible = 0;
+	size_t expectedInside = 0;
+
+	for (size_t index = 0; index < BOX_COUNT; index++) {
+		bool front = (index % 10) == 0;
+		float size = sizeDistribution(random);
+		float center[3] = { xyDistribution(random), xyDistribution(random), front ? frontDistribution(random) : backDistribution(random) };
+		float* box = &bounds[index * 6];
+		float rect[4];
+
+		if (front) {
+			center[0] *= 0.2f;
+			center[1] *= 0.2f;
+		}
+
+		for (int axis = 0; axis < 3; axis++) {
+			box[axis] = center[axis] - size * 0.5f;
+			box[axis + 3] = center[axis] + size * 0.5f;
+		}
+
+		bool inside = project(viewProjection, box, box + 3, rect);
+		expected[index] = inside && (front || overlap(rect, doorRect)) ? 1 : 0;
+		expectedVisible += expected[index];
+		expectedInside += inside ? 1 : 0;
+	}
+
+	kengine::occlusion_culler culler;
+	std::vector<uint8_t> visible(BOX_COUNT);
+	double rasterizeTime = 0.0;
+	double testTime = 0.0;
+
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		culler.newFrame(viewProjection);
+		culler.addOccluder(wall.data(), wall.size() / 3);
+		culler.rasterize();
+		culler.testAABBs(BOX_COUNT, bounds.data(), nullptr, visible.data());
+
+		rasterizeTime += culler.getFrameStats().rasterizeMilliseconds;
+		testTime += culler.getFrameStats().testMilliseconds;
+	}
+
+	const kengine::occlusion_culling_stats& stats = culler.getFrameStats();
+	size_t visibleCount = 0;
+
+	for (size_t index = 0; index < BOX_COUNT; index++) {
+		// a visible box must never be culled
+		if (expected[index] && !visible[index]) {
+			std::cout << "> OCCLUSION: the visible box " << index << " was culled" << std::endl;
+			return 1;
+		}
+
+		visibleCount += visible[index];
+	}
+
+	double culled = 100.0 * static_cast<double>(stats.occluded) / static_cast<double>(expectedInside);
+
+	std::cout << "> OCCLUSION: " << BOX_COUNT << " boxes, " << stats.triangles << " occluder triangles, " << culler.getWidth() << "x" << culler.getHeight() << std::endl;
+	std::cout << "> RASTERIZE (ms): " << rasterizeTime / FRAME_COUNT << std::endl;
+	std::cout << "> TEST (ms): " << testTime / FRAME_COUNT << std::endl;
+	std::cout << "> OUTSIDE: " << stats.outside << std::endl;
+	std::cout << "> OCCLUDED: " << stats.occluded << " (" << culled << "% of the boxes in the view)" << std::endl;
+	std::cout << "> VISIBLE: " << visibleCount << " (" << expectedVisible << " expected)" << std::endl;
+
+	// the conservative tests only keep a few boxes around the door and the wall edges
+	if (visibleCount > expectedVisible + (expectedInside - expectedVisible) / 20) {
+		std::cout << "> OCCLUSION: too many boxes behind the wall are visible" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,254 @@
+/*
+	K-Engine Test for the Render Graph
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <render_graph.hpp>
+#include "headless_setup.hpp"
+
+#include <iostream>
+#include <vector>
+
+using kengine::render_graph;
+using kengine::render_pass_builder;
+using kengine::render_pass_context;
+using kengine::render_resource;
+
+/*
+	The graph orders the passes by their dependencies and culls the debug pass
+*/
+bool testOrderAndCulling()
+{
+	render_graph graph;
+	kengine::render_texture_desc shadowDesc;
+	shadowDesc.width = shadowDesc.height = 1024;
+	shadowDesc.format = GL_DEPTH_COMPONENT32F;
+
+	kengine::render_texture_desc colorDesc;
+	colorDesc.width = colorDesc.height = 64;
+	colorDesc.format = GL_RGBA16F;
+
+	kengine::render_texture_desc depthDesc = colorDesc;
+	depthDesc.format = GL_DEPTH24_STENCIL8;
+
+	render_resource backbuffer = graph.importBackbuffer("backbuffer", 64, 64);
+	render_resource shadow = graph.createTexture("shadow", shadowDesc);
+	render_resource hdr = graph.createTexture("hdr", colorDesc);
+	render_resource depth = graph.createTexture("depth", depthDesc);
+	render_resource bloom = graph.createTexture("bloom", colorDesc);
+	render_resource debug = graph.createTexture("debug", colorDesc);
+	render_resource visible = graph.createBuffer("visible", 4096);
+
+	unsigned int shadows = graph.addPass("shadows", [&](render_pass_builder& builder) { builder.write(shadow); }, nullptr);
+	unsigned int cull = graph.addPass("cull", [&](render_pass_builder& builder) { builder.write(visible); }, nullptr);
+	unsigned int scene = graph.addPass("scene", [&](render_pass_builder& builder) { builder.read(shadow); builder.read(visible); builder.write(hdr); builder.write(depth); }, nullptr);
+	unsigned int debugPass = graph.addPass("debug", [&](render_pass_builder& builder) { builder.read(hdr); builder.write(debug); }, nullptr);
+	unsigned int bloomPass = graph.addPass("bloom", [&](render_pass_builder& builder) { builder.read(hdr); builder.write(bloom); }, nullptr);
+	unsigned int post = graph.addPass("post", [&](render_pass_builder& builder) { builder.read(hdr); builder.read(bloom); builder.write(backbuffer); }, nullptr);
+
+	if (!graph.compile()) {
+		std::cout << "> RENDER GRAPH: the graph doesn't compile" << std::endl;
+		return false;
+	}
+
+	const std::vector<unsigned int> expected = { shadows, cull, scene, bloomPass, post };
+
+	if (graph.getExecutionOrder() != expected || !graph.isPassCulled(debugPass) || graph.getPhysicalIndex(debug) != -1) {
+		std::cout << "> RENDER GRAPH: invalid order or culling" << std::endl;
+		return false;
+	}
+
+	// lifetimes (positions in the execution order)
+	if (graph.getFirstUse(shadow) != 0 || graph.getLastUse(shadow) != 2 || graph.getFirstUse(hdr) != 2 || graph.getLastUse(hdr) != 4) {
+		std::cout << "> RENDER GRAPH: invalid lifetimes" << std::endl;
+		return false;
+	}
+
+	// the transient resources are all live at the same time (no aliasing)
+	if (graph.getStats().transientResources != 5 || graph.getStats().physicalTextures != 4 || graph.getStats().physicalBuffers != 1) {
+		std::cout << "> RENDER GRAPH: invalid physical resources" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Chain of post effects: the targets of the first and the third pass share a texture
+*/
+bool testAliasing()
+{
+	render_graph graph;
+	kengine::render_texture_desc desc;
+	desc.width = desc.height = 256;
+
+	render_resource backbuffer = graph.importBackbuffer("backbuffer", 256, 256);
+	render_resource first = graph.createTexture("first", desc);
+	render_resource second = graph.createTexture("second", desc);
+	render_resource third = graph.createTexture("third", desc);
+
+	graph.addPass("first", [&](render_pass_builder& builder) { builder.write(first); }, nullptr);
+	graph.addPass("second", [&](render_pass_builder& builder) { builder.read(first); builder.write(second); }, nullptr);
+	graph.addPass("third", [&](render_pass_builder& builder) { builder.read(second); builder.write(third); }, nullptr);
+	graph.addPass("present", [&](render_pass_builder& builder) { builder.read(third); builder.write(backbuffer); }, nullptr);
+
+	if (!graph.compile() || graph.getPhysicalIndex(first) != graph.getPhysicalIndex(third) || graph.getPhysicalIndex(first) == graph.getPhysicalIndex(second)) {
+		std::cout << "> RENDER GRAPH: the transient textures are not aliased" << std::endl;
+		return false;
+	}
+
+	const kengine::render_graph_stats& stats = graph.getStats();
+	std::cout << "> RENDER GRAPH: " << stats.transientResources << " transient textures, " << stats.physicalTextures << " physical textures, " << stats.transientBytes << " -> " << stats.physicalBytes << " bytes" << std::endl;
+
+	return stats.physicalTextures == 2 && stats.physicalBytes * 3 == stats.transientBytes * 2;
+}
+
+/*
+	A writes the color, B reads it and C writes it again: B reads the output of A, so it runs before C (write
+	after read) and D reads the output of C
+*/
+bool testWriteAfterRead()
+{
+	render_graph graph;
+	kengine::render_texture_desc desc;
+	desc.width = desc.height = 16;
+
+	render_resource backbuffer = graph.importBackbuffer("backbuffer", 16, 16);
+	render_resource history = graph.importTexture("history", 1, desc);
+	render_resource color = graph.createTexture("color", desc);
+
+	unsigned int a = graph.addPass("A", [&](render_pass_builder& builder) { builder.write(color); }, nullptr);
+	unsigned int b = graph.addPass("B", [&](render_pass_builder& builder) { builder.read(color); builder.write(history); }, nullptr);
+	unsigned int c = graph.addPass("C", [&](render_pass_builder& builder) { builder.write(color); }, nullptr);
+	unsigned int d = graph.addPass("D", [&](render_pass_builder& builder) { builder.read(color); builder.write(backbuffer); }, nullptr);
+
+	const std::vector<unsigned int> expected = { a, b, c, d };
+
+	if (!graph.compile() || graph.getExecutionOrder() != expected) {
+		std::cout << "> RENDER GRAPH: the reader doesn't run between its writer and the next one" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	One frame: the scene is cleared into a transient target and copied into the backbuffer
+*/
+bool renderFrame(render_graph& graph, kengine::headless_rendering_context* context, bool useDepth)
+{
+	kengine::render_texture_desc colorDesc;
+	colorDesc.width = context->getWidth();
+	colorDesc.height = context->getHeight();
+
+	kengine::render_texture_desc depthDesc = colorDesc;
+	depthDesc.format = GL_DEPTH24_STENCIL8;
+
+	graph.reset();
+
+	render_resource backbuffer = graph.importBackbuffer("backbuffer", context->getWidth(), context->getHeight(), context->getFramebuffer());
+	render_resource color = graph.createTexture("color", colorDesc);
+	render_resource depth = graph.createTexture("depth", depthDesc);
+
+	graph.addPass("scene", [&](render_pass_builder& builder) {
+		builder.write(color);
+
+		if (useDepth)
+			builder.write(depth);
+	}, [](const render_pass_context&) {
+		glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	});
+
+	graph.addPass("present", [&](render_pass_builder& builder) {
+		builder.read(color);
+		builder.write(backbuffer);
+	}, [color](const render_pass_context& pass) {
+		GLuint framebuffer = 0;
+		glCreateFramebuffers(1, &framebuffer);
+		glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0, pass.getTexture(color), 0);
+		glBlitNamedFramebuffer(framebuffer, pass.getFramebuffer(), 0, 0, pass.getWidth(), pass.getHeight(), 0, 0, pass.getWidth(), pass.getHeight(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glDeleteFramebuffers(1, &framebuffer);
+	});
+
+	if (!graph.compile())
+		return false;
+
+	glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
+	context->clearBuffers();
+	graph.execute();
+
+	std::vector<unsigned char> pixels;
+	context->readPixels(pixels);
+
+	for (size_t index = 0; index < pixels.size(); index += 4) {
+		if (pixels[index] != 255 || pixels[index + 2] != 0)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+	main
+*/
+int main()
+{
+	if (!testOrderAndCulling() || !testAliasing() || !testWriteAfterRead())
+		return 1;
+
+	headless_setup headless(64, 64);
+
+	if (!headless.init("RENDER GRAPH"))
+		return SKIP_RETURN_CODE;
+
+	render_graph* graph = new render_graph(3);
+
+	// a stable frame reuses the pooled textures
+	for (int frame = 0; frame < 4; frame++) {
+		if (!renderFrame(*graph, headless.context, true) || graph->getPoolSize() != 2) {
+			std::cout << "> RENDER GRAPH: invalid frame " << frame << " (" << graph->getPoolSize() << " pooled objects)" << std::endl;
+			return 1;
+		}
+	}
+
+	// the depth target is not used anymore: it is released after the pool lifetime
+	for (int frame = 0; frame < 3; frame++) {
+		if (!renderFrame(*graph, headless.context, false)) {
+			std::cout << "> RENDER GRAPH: invalid frame without depth" << std::endl;
+			return 1;
+		}
+	}
+
+	if (graph->getPoolSize() != 1) {
+		std::cout << "> RENDER GRAPH: the unused target was not released (" << graph->getPoolSize() << " pooled objects)" << std::endl;
+		return 1;
+	}
+
+	delete graph;
+	headless.renderingSystem.finish();
+
+	std::cout << "> RENDER GRAPH: OK" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,142 @@
+/*
+	K-Engine Benchmark for Render Queue
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <render_queue.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+/*
+	The submitter only counts the calls, so the benchmark measures the CPU cost of the queue
+*/
+struct counting_submitter
+{
+	size_t programs = 0;
+	size_t materials = 0;
+	size_t draws = 0;
+
+	void setProgram(GLuint) { programs++; }
+	void setMaterial(uint32_t) { materials++; }
+	void draw(const kengine::render_packet&) { draws++; }
+};
+
+/*
+	The opaque packets of the same state must be front-to-back and the translucent packets back-to-front
+*/
+bool checkOrder(const kengine::render_queue& queue, const std::vector<float>& depths)
+{
+	const uint64_t translucentBit = uint64_t(1) << (64 - kengine::render_queue::LAYER_BITS - kengine::render_queue::PASS_BITS - 1);
+
+	for (size_t index = 1; index < queue.size(); index++) {
+		uint64_t previousKey = queue.getKey(index - 1);
+		uint64_t key = queue.getKey(index);
+
+		if (previousKey > key)
+			return false;
+
+		const kengine::render_packet& previous = queue.getPacket(index - 1);
+		const kengine::render_packet& current = queue.getPacket(index);
+		float previousDepth = depths[reinterpret_cast<size_t>(previous.userData)];
+		float depth = depths[reinterpret_cast<size_t>(current.userData)];
+		bool sameState = (previousKey >> kengine::render_queue::DEPTH_BITS) == (key >> kengine::render_queue::DEPTH_BITS);
+
+		if ((key & translucentBit) == 0 && sameState && previousDepth > depth + 1e-6f)
+			return false;
+
+		if ((previousKey & translucentBit) && (key & translucentBit) && (previousKey >> 56) == (key >> 56) && previousDepth < depth - 1e-6f)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+	main
+*/
+int main()
+{
+	const size_t PACKET_COUNT = 100000;
+	const int FRAME_COUNT = 30;
+
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> depthDistribution(0.0f, 1.0f);
+
+	std::vector<float> depths(PACKET_COUNT);
+	std::vector<uint64_t> keys(PACKET_COUNT);
+	std::vector<kengine::render_packet> packets(PACKET_COUNT);
+
+	// 64 programs, 512 materials, 8 vertex formats, 4 passes and 10% translucent packets
+	for (size_t index = 0; index < PACKET_COUNT; index++) {
+		bool translucent = (random() % 10) == 0;
+
+		depths[index] = depthDistribution(random);
+		packets[index].program = static_cast<GLuint>(random() % 64) + 1;
+		packets[index].material = static_cast<uint32_t>(random() % 512);
+		packets[index].userData = reinterpret_cast<const void*>(index);
+
+		keys[index] = kengine::render_queue::makeKey(0, static_cast<unsigned int>(random() % 4), translucent, packets[index].program, packets[index].material,
+			static_cast<unsigned int>(random() % 8), depths[index]);
+	}
+
+	kengine::render_queue queue;
+	counting_submitter submitter;
+	double pushTime = 0.0;
+	double sortTime = 0.0;
+	double submitTime = 0.0;
+
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		auto start = std::chrono::high_resolution_clock::now();
+
+		queue.clear();
+
+		for (size_t index = 0; index < PACKET_COUNT; index++)
+			queue.push(keys[index], packets[index]);
+
+		auto pushed = std::chrono::high_resolution_clock::now();
+		queue.sort();
+		auto sorted = std::chrono::high_resolution_clock::now();
+		queue.submit(submitter);
+		auto submitted = std::chrono::high_resolution_clock::now();
+
+		pushTime += std::chrono::duration<double, std::milli>(pushed - start).count();
+		sortTime += std::chrono::duration<double, std::milli>(sorted - pushed).count();
+		submitTime += std::chrono::duration<double, std::milli>(submitted - sorted).count();
+	}
+
+	if (!checkOrder(queue, depths)) {
+		std::cout << "> RENDER QUEUE: invalid order" << std::endl;
+		return 1;
+	}
+
+	std::cout << "> RENDER QUEUE: " << PACKET_COUNT << " packets" << std::endl;
+	std::cout << "> PUSH (ms): " << pushTime / FRAME_COUNT << std::endl;
+	std::cout << "> SORT (ms): " << sortTime / FRAME_COUNT << " (" << queue.getStats().sortPasses << " passes)" << std::endl;
+	std::cout << "> SUBMIT (ms): " << submitTime / FRAME_COUNT << std::endl;
+	std::cout << "> PROGRAM CHANGES: " << queue.getStats().programChanges << std::endl;
+	std::cout << "> MATERIAL CHANGES: " << queue.getStats().materialChanges << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,212 @@
+/*
+	K-Engine Test for Render Thread
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <render_thread.hpp>
+#include <gl_state.hpp>
+#include <vertex_format.hpp>
+#include "headless_setup.hpp"
+
+#include <iostream>
+#include <vector>
+
+/*
+	A triangle that covers the view, filled with the texel of the texture bound to the unit 0
+*/
+const char* vertexSource =
+	"#version 430 core\n"
+	"layout(location = 0) in vec2 position;\n"
+	"void main() { gl_Position = vec4(position, 0.0, 1.0); }\n";
+
+const char* fragmentSource =
+	"#version 430 core\n"
+	"layout(binding = 0) uniform sampler2D image;\n"
+	"layout(location = 0) out vec4 color;\n"
+	"void main() { color = texelFetch(image, ivec2(0), 0); }\n";
+
+GLuint createProgram()
+{
+	GLuint program = glCreateProgram();
+	GLuint vertexShader = kengine::compileShaderSource(GL_VERTEX_SHADER, vertexSource);
+	GLuint fragmentShader = kengine::compileShaderSource(GL_FRAGMENT_SHADER, fragmentSource);
+
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	return kengine::checkLinkStatus(program) ? program : 0;
+}
+
+GLuint createTexture(const unsigned char* color)
+{
+	GLuint texture = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+	glTextureStorage2D(texture, 1, GL_RGBA8, 1, 1);
+	glTextureSubImage2D(texture, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, color);
+
+	return texture;
+}
+
+/*
+	Every pixel has the color of the texture
+*/
+bool checkPixels(const std::vector<unsigned char>& pixels, const unsigned char* color)
+{
+	if (pixels.empty())
+		return false;
+
+	for (size_t index = 0; index < pixels.size(); index += 4) {
+		if (pixels[index] != color[0] || pixels[index + 1] != color[1] || pixels[index + 2] != color[2])
+			return false;
+	}
+
+	return true;
+}
+
+/*
+	main
+
+	The render thread draws two frames recorded by the main thread. The texture is deleted and created again
+	between them on the render thread, so the new texture can reuse the name of the old one.
+*/
+int main()
+{
+	const unsigned char red[4] = { 255, 0, 0, 255 };
+	const unsigned char green[4] = { 0, 255, 0, 255 };
+	const float vertices[6] = { -1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f };
+
+	headless_setup headless(64, 64);
+
+	if (!headless.init("RENDER THREAD"))
+		return SKIP_RETURN_CODE;
+
+	kengine::render_thread* renderThread = new kengine::render_thread(&headless.renderingSystem);
+
+	if (!renderThread->start()) {
+		std::cout << "> RENDER THREAD: the context can't be current on the render thread" << std::endl;
+		return 1;
+	}
+
+	kengine::pipeline_state state;
+	kengine::vertex_format format;
+	format.addAttribute(0, 2, GL_FLOAT, GL_FALSE, 0);
+
+	int formatID = -1;
+	GLuint program = 0;
+	GLuint buffer = 0;
+	GLuint texture = 0;
+	bool renderThreadOwnsState = false;
+	bool released = true;
+	std::vector<unsigned char> pixels;
+
+	// the GL objects are created on the render thread
+	renderThread->enqueue([&]() {
+		renderThreadOwnsState = kengine::glState().isOwnerThread();
+		formatID = kengine::vertexFormatRegistry().acquire(format);
+		program = createProgram();
+		texture = createTexture(red);
+
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, sizeof(vertices), vertices, 0);
+		glViewport(0, 0, headless.context->getWidth(), headless.context->getHeight());
+	});
+
+	renderThread->sync();
+
+	if (!renderThreadOwnsState || program == 0) {
+		std::cout << "> RENDER THREAD: invalid state cache owner or program" << std::endl;
+		return 1;
+	}
+
+	for (int frame = 0; frame < 2; frame++) {
+		kengine::frame_packet& packet = renderThread->beginFrame(0);
+		packet.commandBuffers.resize(1);
+
+		kengine::command_buffer& commands = packet.commandBuffers[0];
+		commands.useProgram(program);
+		commands.bindTexture(0, texture);
+		commands.applyState(state);
+		commands.drawArrays(GL_TRIANGLES, formatID, buffer, 0, 2 * sizeof(float), 0, 3);
+
+		renderThread->endFrame();
+
+		// the tasks run before the packets, so the frame must be drawn before the readback is sent
+		renderThread->sync();
+		renderThread->enqueue([&]() { headless.context->readPixels(pixels); });
+		renderThread->sync();
+
+		if (!checkPixels(pixels, frame == 0 ? red : green)) {
+			std::cout << "> RENDER THREAD: invalid frame " << frame << std::endl;
+			return 1;
+		}
+
+		// the deleted texture is released from the state cache of the render thread: a new texture with the
+		// same name (the driver can reuse it) is bound again
+		renderThread->enqueue([&]() {
+			kengine::glState().releaseTexture(texture);
+			released = released && kengine::glState().bindTexture(0, texture);
+
+			kengine::glState().releaseTexture(texture);
+			glDeleteTextures(1, &texture);
+			texture = createTexture(green);
+		});
+
+		renderThread->sync();
+	}
+
+	if (!released) {
+		std::cout << "> RENDER THREAD: the texture was not released from the state cache" << std::endl;
+		return 1;
+	}
+
+	if (renderThread->getStats().frames != 2) {
+		std::cout << "> RENDER THREAD: " << renderThread->getStats().frames << " frames drawn" << std::endl;
+		return 1;
+	}
+
+	renderThread->stop();
+
+	if (!kengine::glState().isOwnerThread() || !headless.context->readPixels(pixels) || !checkPixels(pixels, green)) {
+		std::cout << "> RENDER THREAD: invalid state after stop" << std::endl;
+		return 1;
+	}
+
+	delete renderThread;
+
+	kengine::glState().releaseTexture(texture);
+	glDeleteTextures(1, &texture);
+	kengine::vertexFormatRegistry().releaseBuffer(buffer);
+	kengine::glState().releaseBuffer(buffer);
+	glDeleteBuffers(1, &buffer);
+	kengine::glState().releaseProgram(program);
+	glDeleteProgram(program);
+
+	headless.renderingSystem.finish();
+
+	std::cout << "> RENDER THREAD: OK" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,229 @@
+/*
+	K-Engine Test for the Texture Atlas
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <texture_atlas.hpp>
+#include "headless_setup.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using kengine::atlas_image;
+using kengine::atlas_rect;
+using kengine::texture_array_atlas;
+
+namespace
+{
+	const int LAYER_SIZE = 64;
+
+	std::vector<unsigned char> solidImage(int width, int height, unsigned char value)
+	{
+		return std::vector<unsigned char>(static_cast<size_t>(width) * static_cast<size_t>(height) * 4, value);
+	}
+
+	/*
+		Every texel of the level inside the padded rectangle of the image must be the value of the image
+	*/
+	bool checkRegion(const texture_array_atlas& atlas, atlas_image image, int width, int height, int level, unsigned char value)
+	{
+		const kengine::atlas_region& region = atlas.getRegion(image);
+		int layers = atlas.getAllocatedLayers(region.group);
+		int size = LAYER_SIZE >> level;
+		std::vector<unsigned char> pixels(static_cast<size_t>(size) * static_cast<size_t>(size) * 4 * static_cast<size_t>(layers));
+		glGetTextureImage(atlas.getTexture(region.group), level, GL_RGBA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(pixels.size()), pixels.data());
+
+		int scale = 1 << level;
+		int x0 = static_cast<int>(std::lround(region.offset[0] * LAYER_SIZE));
+		int y0 = static_cast<int>(std::lround(region.offset[1] * LAYER_SIZE));
+
+		for (int y = y0 / scale; y < (y0 + height + scale - 1) / scale; y++) {
+			for (int x = x0 / scale; x < (x0 + width + scale - 1) / scale; x++) {
+				size_t index = ((static_cast<size_t>(region.layer) * static_cast<size_t>(size) + static_cast<size_t>(y)) * static_cast<size_t>(size) + static_cast<size_t>(x)) * 4;
+
+				if (pixels[index] != value)
+					return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+/*
+	Random rectangles: no overlap, inside the area and a dense packing
+*/
+bool testSkylinePacker()
+{
+	kengine::skyline_packer packer(512, 512);
+	std::vector<atlas_rect> rects;
+	std::srand(7);
+
+	while (true) {
+		int width = 8 + std::rand() % 56;
+		int height = 8 + std::rand() % 56;
+		atlas_rect rect;
+
+		if (!packer.insert(width, height, rect))
+			break;
+
+		if (rect.x < 0 || rect.y < 0 || rect.x + rect.width > 512 || rect.y + rect.height > 512)
+			return false;
+
+		for (const auto& other : rects) {
+			if (rect.x < other.x + other.width && other.x < rect.x + rect.width && rect.y < other.y + other.height && other.y < rect.y + rect.height)
+				return false;
+		}
+
+		rects.push_back(rect);
+	}
+
+	std::cout << "> TEXTURE ATLAS: " << rects.size() << " rectangles, occupancy " << packer.getOccupancy() << std::endl;
+
+	// the first rectangle that doesn't fit stops the packing, so the occupancy is lower than an offline packing
+	return packer.getOccupancy() > 0.6f;
+}
+
+bool testRemapTexCoords()
+{
+	kengine::mesh quad = kengine::quad(1.0f);
+	size_t size = quad.getSize();
+
+	kengine::atlas_region region;
+	region.layer = 3;
+	region.offset[0] = 0.5f;
+	region.offset[1] = 0.25f;
+	region.scale[0] = region.scale[1] = 0.25f;
+
+	if (!kengine::remapTexCoords(quad, region))
+		return false;
+
+	const kengine::vattrib<float>* texCoords = quad.getVertexAttribute(2);
+
+	// (1, 1) is the last vertex of the quad
+	if (texCoords == nullptr || texCoords->count != 3 || texCoords->getSize() != 6 || quad.getSize() != size + 6)
+		return false;
+
+	const float* last = &texCoords->attributeArray[5 * 3];
+
+	return last[0] == 0.75f && last[1] == 0.5f && last[2] == 3.0f;
+}
+
+int main()
+{
+	if (!testSkylinePacker()) {
+		std::cout << "> TEXTURE ATLAS: invalid skyline packing" << std::endl;
+		return 1;
+	}
+
+	if (!testRemapTexCoords()) {
+		std::cout << "> TEXTURE ATLAS: invalid texture coordinates" << std::endl;
+		return 1;
+	}
+
+	headless_setup headless(64, 64);
+
+	if (!headless.init("TEXTURE ATLAS"))
+		return SKIP_RETURN_CODE;
+
+	// a border of 4 texels: 3 levels, the images are aligned to 4 texels
+	texture_array_atlas* atlas = new texture_array_atlas(LAYER_SIZE, 4);
+
+	atlas_image red = atlas->add("red", 16, 16, solidImage(16, 16, 200));
+	atlas_image green = atlas->add("green", 16, 12, solidImage(16, 12, 100));
+	atlas_image full = atlas->add("full", LAYER_SIZE, LAYER_SIZE, solidImage(LAYER_SIZE, LAYER_SIZE, 50));
+	atlas_image srgb = atlas->add("srgb", 8, 8, solidImage(8, 8, 150), GL_SRGB8_ALPHA8);
+
+	if (!atlas->build() || atlas->getLevelCount() != 3 || atlas->getGroupCount() != 2 || atlas->getLayerCount(0) != 2) {
+		std::cout << "> TEXTURE ATLAS: invalid groups" << std::endl;
+		return 1;
+	}
+
+	const kengine::atlas_region& fullRegion = atlas->getRegion(full);
+
+	// the images of the same format share one texture
+	if (atlas->getRegion(red).group != atlas->getRegion(green).group || atlas->getRegion(srgb).group == atlas->getRegion(red).group
+		|| fullRegion.offset[0] != 0.0f || fullRegion.scale[0] != 1.0f || atlas->getRegion(red).layer == fullRegion.layer) {
+		std::cout << "> TEXTURE ATLAS: invalid regions" << std::endl;
+		return 1;
+	}
+
+	// the borders repeat the edges, so the level 2 doesn't mix the neighbours
+	if (!checkRegion(*atlas, red, 16, 16, 0, 200) || !checkRegion(*atlas, green, 16, 12, 0, 100) || !checkRegion(*atlas, red, 16, 16, 2, 200)
+		|| !checkRegion(*atlas, green, 16, 12, 2, 100) || !checkRegion(*atlas, full, LAYER_SIZE, LAYER_SIZE, 1, 50) || !checkRegion(*atlas, srgb, 8, 8, 0, 150)) {
+		std::cout << "> TEXTURE ATLAS: invalid texels" << std::endl;
+		return 1;
+	}
+
+	/*
+		the images added after the build fill the free space, then new layers (the previous layers are copied)
+	*/
+
+	std::vector<atlas_image> images;
+
+	for (int index = 0; index < 12; index++)
+		images.push_back(atlas->add("image" + std::to_string(index), 24, 24, solidImage(24, 24, static_cast<unsigned char>(10 + index))));
+
+	if (!atlas->build() || atlas->getLayerCount(0) < 4) {
+		std::cout << "> TEXTURE ATLAS: invalid incremental build" << std::endl;
+		return 1;
+	}
+
+	for (int index = 0; index < 12; index++) {
+		if (!checkRegion(*atlas, images[static_cast<size_t>(index)], 24, 24, 0, static_cast<unsigned char>(10 + index))) {
+			std::cout << "> TEXTURE ATLAS: invalid texels of the image " << index << std::endl;
+			return 1;
+		}
+	}
+
+	if (!checkRegion(*atlas, red, 16, 16, 0, 200) || !checkRegion(*atlas, full, LAYER_SIZE, LAYER_SIZE, 0, 50)) {
+		std::cout << "> TEXTURE ATLAS: the previous layers were not copied" << std::endl;
+		return 1;
+	}
+
+	// an image larger than a layer is rejected
+	atlas->add("large", LAYER_SIZE + 1, 8, solidImage(LAYER_SIZE + 1, 8, 0));
+
+	if (atlas->build()) {
+		std::cout << "> TEXTURE ATLAS: the large image was packed" << std::endl;
+		return 1;
+	}
+
+	kengine::texture_array_stats stats = atlas->getStats();
+
+	std::cout << "> TEXTURE ATLAS: " << stats.images << " images in " << stats.layers << " layers (" << stats.groups << " groups, occupancy " << stats.occupancy << ")" << std::endl;
+
+	if (stats.images != 16 || !atlas->bind(0, 0)) {
+		std::cout << "> TEXTURE ATLAS: invalid stats" << std::endl;
+		return 1;
+	}
+
+	delete atlas;
+	headless.renderingSystem.finish();
+
+	std::cout << "> TEXTURE ATLAS: OK" << std::endl;
+
+	return 0;
+}
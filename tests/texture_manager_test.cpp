@@ -0,0 +1,259 @@
+/*
+	K-Engine Test for the Texture Manager
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <texture_manager.hpp>
+#include <gpu_memory.hpp>
+#include <upload_worker.hpp>
+#include "headless_setup.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using kengine::texture_handle;
+using kengine::texture_manager;
+
+namespace
+{
+	const int SIZE = 1024; // 11 levels, the tail starts at the level 4 (64x64)
+
+	unsigned char levelValue(int level)
+	{
+		return static_cast<unsigned char>(level * 16 + 8);
+	}
+
+	/*
+		Each level is filled with its own value, so the readback shows which level was uploaded
+	*/
+	bool solidLevel(int level, std::vector<unsigned char>& pixels)
+	{
+		int size = SIZE >> level;
+		pixels.assign(static_cast<size_t>(size) * static_cast<size_t>(size) * 4, levelValue(level));
+		return true;
+	}
+
+	size_t chainBytes(int firstLevel)
+	{
+		size_t bytes = 0;
+
+		for (int level = firstLevel; (SIZE >> level) > 0; level++)
+			bytes += static_cast<size_t>(SIZE >> level) * static_cast<size_t>(SIZE >> level) * 4;
+
+		return bytes;
+	}
+
+	/*
+		The level "level" of the texture is the level "level - residentLevel" of the GL texture
+	*/
+	bool checkLevel(const texture_manager& manager, texture_handle handle, int level)
+	{
+		int size = SIZE >> level;
+		std::vector<unsigned char> pixels(static_cast<size_t>(size) * static_cast<size_t>(size) * 4);
+		glGetTextureImage(manager.getTexture(handle), level - manager.getResidentLevel(handle), GL_RGBA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(pixels.size()), pixels.data());
+
+		for (unsigned char value : pixels) {
+			if (value != levelValue(level))
+				return false;
+		}
+
+		return true;
+	}
+
+	void run(texture_manager& manager, int frames)
+	{
+		for (int frame = 0; frame < frames; frame++)
+			manager.update();
+	}
+}
+
+bool testMipChainLoader()
+{
+	// 4x2 image: the 2x1 level averages the 2x2 blocks and the 1x1 level averages the 2x1 level
+	std::vector<unsigned char> pixels(4 * 2 * 4);
+
+	for (int index = 0; index < 8; index++) {
+		for (int channel = 0; channel < 4; channel++)
+			pixels[static_cast<size_t>(index * 4 + channel)] = static_cast<unsigned char>(index < 2 || (index >= 4 && index < 6) ? 0 : 200);
+	}
+
+	texture_manager::level_loader loader = kengine::mipChainLoader(4, 2, pixels);
+	std::vector<unsigned char> level;
+
+	if (!loader(1, level) || level.size() != 2 * 4 || level[0] != 0 || level[4] != 200)
+		return false;
+
+	if (!loader(2, level) || level.size() != 4 || level[0] != 100)
+		return false;
+
+	return !loader(3, level);
+}
+
+int main()
+{
+	if (!testMipChainLoader()) {
+		std::cout << "> TEXTURE MANAGER: invalid mip chain" << std::endl;
+		return 1;
+	}
+
+	headless_setup headless(64, 64);
+
+	if (!headless.init("TEXTURE MANAGER"))
+		return SKIP_RETURN_CODE;
+
+	texture_manager* manager = new texture_manager(chainBytes(0) + chainBytes(1), 64);
+	manager->setFrameUploadBudget(16 * 1024 * 1024);
+
+	kengine::texture_desc desc;
+	desc.width = desc.height = SIZE;
+
+	/*
+		the tail is loaded first, then one level per update down to the level that the screen needs
+	*/
+
+	texture_handle near = manager->create("near", desc, solidLevel);
+	manager->update();
+
+	if (manager->getLevelCount(near) != 11 || manager->getResidentLevel(near) != 4 || manager->getStats().residentBytes != chainBytes(4)) {
+		std::cout << "> TEXTURE MANAGER: the tail is not resident" << std::endl;
+		return 1;
+	}
+
+	manager->setScreenSize(near, 2048.0f);
+
+	for (int level = 3; level >= 0; level--) {
+		manager->update();
+
+		if (manager->getResidentLevel(near) != level) {
+			std::cout << "> TEXTURE MANAGER: the level " << level << " was not streamed in" << std::endl;
+			return 1;
+		}
+	}
+
+	if (!checkLevel(*manager, near, 0) || !checkLevel(*manager, near, 6) || manager->getStats().pendingUploads != 0) {
+		std::cout << "> TEXTURE MANAGER: invalid levels after the streaming" << std::endl;
+		return 1;
+	}
+
+	if (kengine::gpuMemoryTracker().getOwnerUsage("texture_manager") != manager->getStats().residentBytes) {
+		std::cout << "> TEXTURE MANAGER: the tracked memory is not the resident memory" << std::endl;
+		return 1;
+	}
+
+	/*
+		the budget holds the level 0 of one texture and the level 1 of another one
+	*/
+
+	texture_handle far = manager->create("far", desc, solidLevel);
+	manager->setScreenSize(far, 512.0f);
+	run(*manager, 8);
+
+	if (manager->getResidentLevel(far) != 1 || manager->getStats().evictions != 0) {
+		std::cout << "> TEXTURE MANAGER: invalid streaming under the budget" << std::endl;
+		return 1;
+	}
+
+	// the textures swap: the levels that "near" doesn't need anymore make room for "far"
+	manager->setScreenSize(near, 256.0f);
+	manager->setScreenSize(far, 1024.0f);
+	run(*manager, 8);
+
+	if (manager->getResidentLevel(near) != 2 || manager->getResidentLevel(far) != 0 || manager->getStats().evictions != 2) {
+		std::cout << "> TEXTURE MANAGER: invalid eviction (" << manager->getResidentLevel(near) << ", " << manager->getResidentLevel(far) << ")" << std::endl;
+		return 1;
+	}
+
+	// both textures need the level 0: "near" stops at the level 1 instead of evicting "far" back and forth
+	manager->setScreenSize(near, 1024.0f);
+	run(*manager, 8);
+
+	if (manager->getResidentLevel(near) != 1 || manager->getResidentLevel(far) != 0 || manager->getStats().evictions != 2
+		|| manager->getStats().residentBytes > manager->getBudget()) {
+		std::cout << "> TEXTURE MANAGER: unstable residency under the budget" << std::endl;
+		return 1;
+	}
+
+	if (!checkLevel(*manager, near, 1) || !checkLevel(*manager, far, 0) || !checkLevel(*manager, far, 10)) {
+		std::cout << "> TEXTURE MANAGER: invalid levels after the eviction" << std::endl;
+		return 1;
+	}
+
+	/*
+		the samplers are shared by the equal descriptions
+	*/
+
+	kengine::sampler_desc trilinear;
+	kengine::sampler_desc clamped;
+	clamped.wrapS = clamped.wrapT = GL_CLAMP_TO_EDGE;
+
+	if (manager->getSampler(trilinear) == 0 || manager->getSampler(trilinear) != manager->getSampler(kengine::sampler_desc())
+		|| manager->getSampler(clamped) == manager->getSampler(trilinear) || manager->getStats().samplers != 2) {
+		std::cout << "> TEXTURE MANAGER: invalid sampler cache" << std::endl;
+		return 1;
+	}
+
+	if (!manager->bind(0, near, clamped)) {
+		std::cout << "> TEXTURE MANAGER: the resident texture can't be bound" << std::endl;
+		return 1;
+	}
+
+	manager->destroy(near);
+	manager->destroy(far);
+
+	if (manager->getStats().residentBytes != 0 || kengine::gpuMemoryTracker().getOwnerUsage("texture_manager") != 0) {
+		std::cout << "> TEXTURE MANAGER: the destroyed textures are still tracked" << std::endl;
+		return 1;
+	}
+
+	/*
+		the levels are loaded on the thread of the upload worker
+	*/
+
+	kengine::upload_worker* worker = new kengine::upload_worker(headless.renderingSystem.createSharedContext());
+	manager->setUploadWorker(worker);
+
+	texture_handle streamed = manager->create("streamed", desc, solidLevel);
+	manager->setScreenSize(streamed, 512.0f);
+
+	for (int frame = 0; frame < 5000 && manager->getResidentLevel(streamed) != 1; frame++) {
+		manager->update();
+		worker->update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	if (manager->getResidentLevel(streamed) != 1 || !checkLevel(*manager, streamed, 1) || !checkLevel(*manager, streamed, 5)) {
+		std::cout << "> TEXTURE MANAGER: invalid asynchronous streaming" << std::endl;
+		return 1;
+	}
+
+	delete manager;
+	delete worker;
+
+	headless.renderingSystem.finish();
+
+	std::cout << "> TEXTURE MANAGER: OK" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,360 @@
+/*
+	K-Engine Test for Thread Pool and Command Buffer
+	This file provide an test environment for K-Engine.
+
+	Copyright (C) 2020-2025 Fabio Takeshi Ishikawa
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <thread_pool.hpp>
+#include <command_buffer.hpp>
+#include <vertex_format.hpp>
+#include "headless_setup.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*
+	Size of a recorded command: the header and the command, both rounded to 8 bytes
+*/
+template <typename T>
+size_t recordSize()
+{
+	return ((sizeof(kengine::command_header) + 7) & ~size_t(7)) + ((sizeof(T) + 7) & ~size_t(7));
+}
+
+/*
+	Every index is visited once, the chunks follow the grain and the loop is done when parallelFor returns
+*/
+bool testChunks(kengine::thread_pool& pool, size_t count, size_t grain)
+{
+	std::unique_ptr<std::atomic<int>[]> visits(new std::atomic<int>[count]);
+	std::atomic<bool> valid{ true };
+
+	for (size_t index = 0; index < count; index++)
+		visits[index] = 0;
+
+	pool.parallelFor(count, [&](size_t begin, size_t end, unsigned int thread) {
+		if (begin >= end || end > count || thread >= pool.getThreadCount())
+			valid = false;
+
+		// the last chunk is the only one shorter than the grain
+		if (grain && (begin % grain != 0 || (end - begin != grain && end != count)))
+			valid = false;
+
+		for (size_t index = begin; index < end; index++)
+			visits[index]++;
+	}, grain);
+
+	for (size_t index = 0; index < count; index++) {
+		if (visits[index] != 1)
+			return false;
+	}
+
+	return valid;
+}
+
+/*
+	A loop of a worker or of another thread runs on its calling thread as a single chunk
+*/
+bool testSerialFallback(kengine::thread_pool& pool)
+{
+	std::atomic<int> nested{ 0 };
+	std::atomic<int> concurrent{ 0 };
+	std::atomic<bool> valid{ true };
+	std::atomic<bool> started{ false };
+
+	pool.parallelFor(64, [&](size_t begin, size_t end, unsigned int) {
+		for (size_t index = begin; index < end; index++) {
+			std::thread::id caller = std::this_thread::get_id();
+
+			pool.parallelFor(16, [&](size_t nestedBegin, size_t nestedEnd, unsigned int nestedThread) {
+				if (nestedBegin != 0 || nestedEnd != 16 || nestedThread != 0 || std::this_thread::get_id() != caller)
+					valid = false;
+
+				nested++;
+			}, 1);
+		}
+
+		// the pool is busy with this loop, so the loop of another thread can't use the workers
+		if (!started.exchange(true)) {
+			std::thread other([&]() {
+				std::thread::id caller = std::this_thread::get_id();
+
+				pool.parallelFor(32, [&](size_t otherBegin, size_t otherEnd, unsigned int otherThread) {
+					if (otherBegin != 0 || otherEnd != 32 || otherThread != 0 || std::this_thread::get_id() != caller)
+						valid = false;
+
+					concurrent++;
+				}, 1);
+			});
+
+			other.join();
+		}
+	}, 4);
+
+	return valid && nested == 64 && concurrent == 1 && started;
+}
+
+/*
+	The buffers recorded by the workers keep their commands aligned to 8 bytes
+*/
+bool testCommandBuffers(kengine::thread_pool& pool)
+{
+	const size_t BUFFER_COUNT = 16;
+	const size_t DRAW_COUNT = 100;
+
+	kengine::pipeline_state state;
+	kengine::mesh_node node;
+	std::vector<kengine::command_buffer> buffers(BUFFER_COUNT);
+	std::atomic<bool> valid{ true };
+
+	const size_t commandSizes[] = {
+		recordSize<kengine::use_program_command>(),
+		recordSize<kengine::bind_buffer_range_command>(),
+		recordSize<kengine::bind_texture_command>(),
+		recordSize<kengine::bind_sampler_command>(),
+		recordSize<kengine::apply_state_command>(),
+		recordSize<kengine::draw_node_command>(),
+		recordSize<kengine::draw_arrays_command>()
+	};
+
+	size_t drawSize = commandSizes[1] + commandSizes[5] + commandSizes[6];
+	size_t frameSize = commandSizes[0] + commandSizes[2] + commandSizes[3] + commandSizes[4] + DRAW_COUNT * drawSize;
+
+	for (size_t size : commandSizes) {
+		if (size % 8 != 0 || size > 0xFFFF)
+			return false;
+	}
+
+	// the second frame reuses the memory of the first one
+	for (int frame = 0; frame < 2; frame++) {
+		pool.parallelFor(BUFFER_COUNT, [&](size_t begin, size_t end, unsigned int) {
+			for (size_t index = begin; index < end; index++) {
+				kengine::command_buffer& buffer = buffers[index];
+				size_t expected = 0;
+
+				buffer.reset();
+
+				if (!buffer.empty() || buffer.getSize() != 0)
+					valid = false;
+
+				auto check = [&](size_t size) {
+					expected += size;
+
+					if (buffer.getSize() != expected || buffer.getSize() % 8 != 0)
+						valid = false;
+				};
+
+				buffer.useProgram(static_cast<GLuint>(index + 1));
+				check(commandSizes[0]);
+				buffer.bindTexture(0, 7);
+				check(commandSizes[2]);
+				buffer.bindSampler(0, 3);
+				check(commandSizes[3]);
+				buffer.applyState(state);
+				check(commandSizes[4]);
+
+				for (size_t draw = 0; draw < DRAW_COUNT; draw++) {
+					buffer.bindBufferRange(GL_UNIFORM_BUFFER, 1, 5, static_cast<GLintptr>(draw * 256), 256);
+					check(commandSizes[1]);
+					buffer.drawNode(node);
+					check(commandSizes[5]);
+					buffer.drawArrays(GL_TRIANGLES, 0, 9, 0, 32, static_cast<GLint>(draw * 3), 3);
+					check(commandSizes[6]);
+				}
+			}
+		}, 1);
+
+		for (const kengine::command_buffer& buffer : buffers) {
+			if (buffer.getCommandCount() != 4 + DRAW_COUNT * 3 || buffer.getSize() != frameSize)
+				return false;
+		}
+	}
+
+	return valid;
+}
+
+/*
+	A triangle that covers the view, filled with the texel of the texture bound to the unit 0
+*/
+const char* vertexSource =
+	"#version 430 core\n"
+	"layout(location = 0) in vec2 position;\n"
+	"void main() { gl_Position = vec4(position, 0.0, 1.0); }\n";
+
+const char* fragmentSource =
+	"#version 430 core\n"
+	"layout(binding = 0) uniform sampler2D image;\n"
+	"layout(std140, binding = 1) uniform draw_block { vec4 tint; };\n"
+	"layout(location = 0) out vec4 color;\n"
+	"void main() { color = texelFetch(image, ivec2(0), 0) * tint; }\n";
+
+GLuint createProgram()
+{
+	GLuint program = glCreateProgram();
+	GLuint vertexShader = kengine::compileShaderSource(GL_VERTEX_SHADER, vertexSource);
+	GLuint fragmentShader = kengine::compileShaderSource(GL_FRAGMENT_SHADER, fragmentSource);
+
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	return kengine::checkLinkStatus(program) ? program : 0;
+}
+
+/*
+	The buffers recorded by the workers are replayed in order through the state cache: the first buffer binds
+	the state and the same state of the next buffers is elided. A second replay elides every state call.
+*/
+bool testReplay(kengine::thread_pool& pool, kengine::headless_rendering_context* context)
+{
+	const size_t BUFFER_COUNT = 8;
+	const GLsizei DRAW_COUNT = 4;
+	const unsigned char red[4] = { 255, 0, 0, 255 };
+	const float vertices[6] = { -1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f };
+	const float tint[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+	kengine::pipeline_state state;
+	kengine::vertex_format format;
+	format.addAttribute(0, 2, GL_FLOAT, GL_FALSE, 0);
+
+	int formatID = kengine::vertexFormatRegistry().acquire(format);
+	GLuint program = createProgram();
+	GLuint texture = 0;
+	GLuint sampler = 0;
+	GLuint buffers[2] = {};
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+	glTextureStorage2D(texture, 1, GL_RGBA8, 1, 1);
+	glTextureSubImage2D(texture, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, red);
+	glCreateSamplers(1, &sampler);
+	glCreateBuffers(2, buffers);
+	glNamedBufferStorage(buffers[0], sizeof(vertices), vertices, 0);
+	glNamedBufferStorage(buffers[1], sizeof(tint), tint, 0);
+	glViewport(0, 0, context->getWidth(), context->getHeight());
+
+	std::vector<kengine::command_buffer> commandBuffers(BUFFER_COUNT);
+
+	pool.parallelFor(BUFFER_COUNT, [&](size_t begin, size_t end, unsigned int) {
+		for (size_t index = begin; index < end; index++) {
+			kengine::command_buffer& buffer = commandBuffers[index];
+
+			buffer.useProgram(program);
+			buffer.bindTexture(0, texture);
+			buffer.bindSampler(0, sampler);
+			buffer.applyState(state);
+			buffer.bindBufferRange(GL_UNIFORM_BUFFER, 1, buffers[1], 0, sizeof(tint));
+
+			for (GLsizei draw = 0; draw < DRAW_COUNT; draw++)
+				buffer.drawArrays(GL_TRIANGLES, formatID, buffers[0], 0, 2 * sizeof(float), 0, 3);
+		}
+	}, 1);
+
+	kengine::gl_state_stats replays[2];
+
+	for (kengine::gl_state_stats& stats : replays) {
+		kengine::glState().newFrame();
+		kengine::executeCommandBuffers(commandBuffers.data(), commandBuffers.size());
+		kengine::glState().newFrame();
+		stats = kengine::glState().getFrameStats();
+	}
+
+	std::vector<unsigned char> pixels;
+	bool valid = program != 0 && context->readPixels(pixels) && !pixels.empty() && glGetError() == GL_NO_ERROR;
+
+	for (size_t index = 0; valid && index < pixels.size(); index += 4)
+		valid = pixels[index] == 255 && pixels[index + 1] == 0 && pixels[index + 2] == 0;
+
+	// every buffer sends the same calls to the cache, only the first one can issue them
+	unsigned int calls = replays[0].issued + replays[0].elided;
+
+	if (!valid || calls % BUFFER_COUNT != 0 || replays[0].issued < 5 || replays[0].issued > calls / BUFFER_COUNT ||
+		replays[1].issued != 0 || replays[1].elided != calls) {
+		std::cout << "> COMMAND BUFFER: " << replays[0].issued << "/" << replays[1].issued << " issued, " <<
+			replays[0].elided << "/" << replays[1].elided << " elided calls" << std::endl;
+		valid = false;
+	}
+
+	kengine::glState().releaseTexture(texture);
+	glDeleteTextures(1, &texture);
+	kengine::glState().releaseSampler(sampler);
+	glDeleteSamplers(1, &sampler);
+	kengine::vertexFormatRegistry().releaseBuffer(buffers[0]);
+	kengine::glState().releaseBuffer(buffers[0]);
+	kengine::glState().releaseBuffer(buffers[1]);
+	glDeleteBuffers(2, buffers);
+	kengine::glState().releaseProgram(program);
+	glDeleteProgram(program);
+
+	return valid;
+}
+
+/*
+	main
+*/
+int main()
+{
+	kengine::thread_pool pool(3);
+	kengine::thread_pool smallPool(1);
+
+	if (pool.getThreadCount() != 4) {
+		std::cout << "> THREAD POOL: invalid thread count" << std::endl;
+		return 1;
+	}
+
+	if (!testChunks(pool, 10000, 64) || !testChunks(pool, 10000, 0) || !testChunks(pool, 3, 1) || !testChunks(smallPool, 1000, 7)) {
+		std::cout << "> THREAD POOL: invalid chunks" << std::endl;
+		return 1;
+	}
+
+	if (!testSerialFallback(pool)) {
+		std::cout << "> THREAD POOL: invalid serial fallback" << std::endl;
+		return 1;
+	}
+
+	if (!testCommandBuffers(pool)) {
+		std::cout << "> COMMAND BUFFER: invalid commands" << std::endl;
+		return 1;
+	}
+
+	std::cout << "> THREAD POOL: " << pool.getThreadCount() << " threads" << std::endl;
+
+	headless_setup headless(64, 64);
+
+	if (!headless.init("COMMAND BUFFER"))
+		return SKIP_RETURN_CODE;
+
+	if (!testReplay(pool, headless.context)) {
+		std::cout << "> COMMAND BUFFER: invalid replay" << std::endl;
+		return 1;
+	}
+
+	headless.renderingSystem.finish();
+
+	std::cout << "> COMMAND BUFFER: ok" << std::endl;
+
+	return 0;
+}